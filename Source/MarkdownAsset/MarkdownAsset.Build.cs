@@ -11,6 +11,11 @@ public class MarkdownAsset : ModuleRules
         PublicDependencyModuleNames.AddRange( new string[] {
             "Core",
             "CoreUObject",
+            "DeveloperSettings",
+            "Engine",
+            "Slate",
+            "SlateCore",
+            "UMG",
         });
 
         //PrivateIncludePaths.AddRange( new string[] {
@@ -0,0 +1,109 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Async/AsyncActionLoadMarkdown.h"
+
+#include "Async/MarkdownAsyncLoader.h"
+#include "MarkdownAsset.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UAsyncActionLoadMarkdown* UAsyncActionLoadMarkdown::LoadMarkdownAsync( UObject* WorldContextObject, TSoftObjectPtr<UMarkdownAsset> Markdown )
+{
+	UAsyncActionLoadMarkdown* Action = NewObject<UAsyncActionLoadMarkdown>();
+	Action->Markdown = Markdown;
+	Action->RegisterWithGameInstance( WorldContextObject );
+
+	return Action;
+}
+
+void UAsyncActionLoadMarkdown::Activate()
+{
+	Request = FMarkdownAsyncLoader::Load( { Markdown.ToSoftObjectPath() }, FOnMarkdownLoaded::CreateUObject( this, &UAsyncActionLoadMarkdown::HandleLoaded ) );
+}
+
+void UAsyncActionLoadMarkdown::Cancel()
+{
+	if( Request.IsValid() )
+	{
+		Request->Cancel();
+		Request.Reset();
+	}
+
+	Super::Cancel();
+}
+
+bool UAsyncActionLoadMarkdown::IsActive() const
+{
+	return Request.IsValid() && !Request->IsComplete() && !Request->IsCancelled();
+}
+
+void UAsyncActionLoadMarkdown::HandleLoaded( const TArray<UMarkdownAsset*>& Assets )
+{
+	UMarkdownAsset* Loaded = Assets.Num() > 0 ? Assets[ 0 ] : nullptr;
+
+	if( Loaded != nullptr )
+	{
+		OnLoaded.Broadcast( Loaded );
+	}
+	else
+	{
+		OnFailed.Broadcast( nullptr );
+	}
+
+	Request.Reset();
+	SetReadyToDestroy();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UAsyncActionPrefetchMarkdown* UAsyncActionPrefetchMarkdown::PrefetchMarkdownAsync( UObject* WorldContextObject, const TArray<TSoftObjectPtr<UMarkdownAsset>>& Markdown )
+{
+	UAsyncActionPrefetchMarkdown* Action = NewObject<UAsyncActionPrefetchMarkdown>();
+
+	for( const TSoftObjectPtr<UMarkdownAsset>& Asset : Markdown )
+	{
+		Action->Paths.Add( Asset.ToSoftObjectPath() );
+	}
+
+	Action->RegisterWithGameInstance( WorldContextObject );
+	return Action;
+}
+
+void UAsyncActionPrefetchMarkdown::Activate()
+{
+	Request = FMarkdownAsyncLoader::Load( Paths, FOnMarkdownLoaded::CreateUObject( this, &UAsyncActionPrefetchMarkdown::HandleLoaded ) );
+}
+
+void UAsyncActionPrefetchMarkdown::Cancel()
+{
+	if( Request.IsValid() )
+	{
+		Request->Cancel();
+		Request.Reset();
+	}
+
+	Super::Cancel();
+}
+
+bool UAsyncActionPrefetchMarkdown::IsActive() const
+{
+	return Request.IsValid() && !Request->IsComplete() && !Request->IsCancelled();
+}
+
+void UAsyncActionPrefetchMarkdown::HandleLoaded( const TArray<UMarkdownAsset*>& Assets )
+{
+	TArray<UMarkdownAsset*> Loaded;
+
+	for( UMarkdownAsset* Asset : Assets )
+	{
+		if( Asset != nullptr )
+		{
+			Loaded.Add( Asset );
+		}
+	}
+
+	OnCompleted.Broadcast( Loaded );
+
+	Request.Reset();
+	SetReadyToDestroy();
+}
@@ -0,0 +1,205 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Async/MarkdownAsyncLoader.h"
+
+#include "Async/Async.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "MarkdownAsset.h"
+#include "Parser/MarkdownDocumentCache.h"
+#include "Parser/MarkdownParser.h"
+#include "Tasks/Task.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLoadRequest::Cancel()
+{
+	check( IsInGameThread() );
+
+	bCancelled = true;
+	OnLoaded.Unbind();
+
+	if( Handle.IsValid() )
+	{
+		Handle->CancelHandle();
+		Handle.Reset();
+	}
+
+	if( VariantHandle.IsValid() )
+	{
+		VariantHandle->CancelHandle();
+		VariantHandle.Reset();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TSharedRef<FMarkdownLoadRequest> FMarkdownAsyncLoader::Load( const TArray<FSoftObjectPath>& Paths, FOnMarkdownLoaded OnLoaded )
+{
+	check( IsInGameThread() );
+
+	TSharedRef<FMarkdownLoadRequest> Request = MakeShared<FMarkdownLoadRequest>();
+	Request->Paths    = Paths;
+	Request->OnLoaded = MoveTemp( OnLoaded );
+
+	TArray<FSoftObjectPath> ToLoad;
+	for( const FSoftObjectPath& Path : Paths )
+	{
+		if( !Path.IsNull() )
+		{
+			ToLoad.AddUnique( Path );
+		}
+	}
+
+	if( ToLoad.IsEmpty() )
+	{
+		Complete( Request );
+		return Request;
+	}
+
+	Request->Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad( ToLoad, FStreamableDelegate::CreateLambda( [ Request ]()
+	{
+		HandleStreamed( Request );
+	}));
+
+	// nothing needed loading, the callback may or may not have been called
+	if( !Request->Handle.IsValid() && !Request->bStreamed )
+	{
+		HandleStreamed( Request );
+	}
+
+	return Request;
+}
+
+void FMarkdownAsyncLoader::HandleStreamed( const TSharedRef<FMarkdownLoadRequest>& Request )
+{
+	if( Request->IsCancelled() || Request->bStreamed )
+	{
+		return;
+	}
+
+	Request->bStreamed = true;
+
+	// translations are separate assets, only the ones for the current language are brought in
+	TArray<FSoftObjectPath> Variants;
+
+	for( const FSoftObjectPath& Path : Request->Paths )
+	{
+		if( const UMarkdownAsset* Asset = Cast<UMarkdownAsset>( Path.ResolveObject() ) )
+		{
+			const TSoftObjectPtr<UMarkdownAsset> Variant = Asset->FindLocalizedVariant();
+
+			if( !Variant.IsNull() && Variant.Get() == nullptr )
+			{
+				Variants.AddUnique( Variant.ToSoftObjectPath() );
+			}
+		}
+	}
+
+	if( Variants.IsEmpty() )
+	{
+		ParseDocuments( Request );
+		return;
+	}
+
+	Request->VariantHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad( Variants, FStreamableDelegate::CreateLambda( [ Request ]()
+	{
+		ParseDocuments( Request );
+	}));
+
+	if( !Request->VariantHandle.IsValid() && !Request->bParsing )
+	{
+		ParseDocuments( Request );
+	}
+}
+
+void FMarkdownAsyncLoader::ParseDocuments( const TSharedRef<FMarkdownLoadRequest>& Request )
+{
+	if( Request->IsCancelled() || Request->bParsing )
+	{
+		return;
+	}
+
+	Request->bParsing = true;
+
+	// texts are copied here, the worker never touches the assets
+	TArray<FString> Sources;
+
+	for( const FSoftObjectPath& Path : Request->Paths )
+	{
+		const UMarkdownAsset* Asset = Cast<UMarkdownAsset>( Path.ResolveObject() );
+
+		if( Asset == nullptr )
+		{
+			continue;
+		}
+
+		if( const UMarkdownAsset* Variant = Asset->FindLocalizedVariant().Get() )
+		{
+			Asset = Variant;
+		}
+
+		if( !Asset->FindDocument().IsValid() )
+		{
+			Sources.AddUnique( Asset->Text.ToString() );
+		}
+	}
+
+	if( Sources.IsEmpty() )
+	{
+		Complete( Request );
+		return;
+	}
+
+	UE::Tasks::Launch( UE_SOURCE_LOCATION, [ Request, Sources = MoveTemp( Sources ) ]() mutable
+	{
+		TArray<TSharedRef<const FMarkdownDocument>> Documents;
+		Documents.Reserve( Sources.Num() );
+
+		for( const FString& Source : Sources )
+		{
+			if( Request->IsCancelled() )
+			{
+				return;
+			}
+
+			TSharedRef<FMarkdownDocument> Document = MakeShared<FMarkdownDocument>();
+			FMarkdownParser::Parse( Source, *Document );
+			Document->Shrink();
+
+			Documents.Add( Document );
+		}
+
+		AsyncTask( ENamedThreads::GameThread, [ Request, Sources = MoveTemp( Sources ), Documents = MoveTemp( Documents ) ]()
+		{
+			if( Request->IsCancelled() )
+			{
+				return;
+			}
+
+			for( int32 Index = 0; Index < Sources.Num(); ++Index )
+			{
+				FMarkdownDocumentCache::Get().Add( Sources[ Index ], Documents[ Index ] );
+			}
+
+			Complete( Request );
+		});
+	});
+}
+
+void FMarkdownAsyncLoader::Complete( const TSharedRef<FMarkdownLoadRequest>& Request )
+{
+	TArray<UMarkdownAsset*> Assets;
+	Assets.Reserve( Request->Paths.Num() );
+
+	for( const FSoftObjectPath& Path : Request->Paths )
+	{
+		Assets.Add( Cast<UMarkdownAsset>( Path.ResolveObject() ) );
+	}
+
+	Request->bComplete = true;
+
+	// the callback may drop the last reference to something that holds the request, so take the delegate first
+	FOnMarkdownLoaded OnLoaded = MoveTemp( Request->OnLoaded );
+	OnLoaded.ExecuteIfBound( Assets );
+}
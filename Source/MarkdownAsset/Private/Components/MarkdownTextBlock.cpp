@@ -0,0 +1,184 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Components/MarkdownTextBlock.h"
+
+#include "HAL/PlatformProcess.h"
+#include "MarkdownAsset.h"
+#include "Parser/MarkdownDocumentCache.h"
+#include "Styling/SlateStyleRegistry.h"
+#include "Widgets/MarkdownViewCache.h"
+#include "Widgets/MarkdownViewStyle.h"
+#include "Widgets/SMarkdownView.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownTextBlock"
+
+void UMarkdownTextBlock::SetMarkdown( UMarkdownAsset* InMarkdown )
+{
+	Markdown = InMarkdown;
+	UpdateDocument();
+}
+
+void UMarkdownTextBlock::SetText( const FText& InText )
+{
+	Text = InText;
+	UpdateDocument();
+}
+
+void UMarkdownTextBlock::SetPadding( const FMargin& InPadding )
+{
+	Padding = InPadding;
+
+	if( MyMarkdownView.IsValid() )
+	{
+		MyMarkdownView->SetPadding( Padding );
+	}
+}
+
+void UMarkdownTextBlock::SetStyleSetName( const FName InStyleSetName )
+{
+	StyleSetName = InStyleSetName;
+
+	if( MyMarkdownView.IsValid() )
+	{
+		MyMarkdownView->SetStyle( GetViewStyle() );
+	}
+}
+
+void UMarkdownTextBlock::ScrollToTop()
+{
+	if( MyMarkdownView.IsValid() )
+	{
+		MyMarkdownView->ScrollToTop();
+	}
+}
+
+void UMarkdownTextBlock::SynchronizeProperties()
+{
+	Super::SynchronizeProperties();
+
+	if( MyMarkdownView.IsValid() )
+	{
+		MyMarkdownView->SetPadding( Padding );
+		MyMarkdownView->SetStyle( GetViewStyle() );
+		UpdateDocument();
+	}
+}
+
+void UMarkdownTextBlock::ReleaseSlateResources( bool bReleaseChildren )
+{
+	Super::ReleaseSlateResources( bReleaseChildren );
+
+	WatchMarkdown( nullptr );
+
+	// kept with its layout for the next time the document is shown, by this block or another
+	if( MyMarkdownView.IsValid() )
+	{
+		LaidOutWidth = MyMarkdownView->GetLaidOutWidth();
+		FMarkdownViewCache::Get().Park( MyMarkdownView.ToSharedRef() );
+	}
+
+	MyMarkdownView.Reset();
+}
+
+#if WITH_EDITOR
+
+const FText UMarkdownTextBlock::GetPaletteCategory()
+{
+	return LOCTEXT( "Common", "Common" );
+}
+
+#endif
+
+TSharedRef<SWidget> UMarkdownTextBlock::RebuildWidget()
+{
+	const ISlateStyle* ViewStyle = GetViewStyle();
+	const FOnMarkdownLinkClicked OnViewLinkClicked = BIND_UOBJECT_DELEGATE( FOnMarkdownLinkClicked, HandleLinkClicked );
+
+	MyMarkdownView = FMarkdownViewCache::Get().Take( *GetDocumentToShow(), ViewStyle, LaidOutWidth );
+
+	if( MyMarkdownView.IsValid() )
+	{
+		MyMarkdownView->SetPadding( Padding );
+		MyMarkdownView->SetOnLinkClicked( OnViewLinkClicked );
+	}
+	else
+	{
+		MyMarkdownView = SNew( SMarkdownView )
+			.Style( ViewStyle )
+			.Padding( Padding )
+			.OnLinkClicked( OnViewLinkClicked );
+	}
+
+	return MyMarkdownView.ToSharedRef();
+}
+
+void UMarkdownTextBlock::UpdateDocument()
+{
+	if( !MyMarkdownView.IsValid() )
+	{
+		return;
+	}
+
+	// the same document shown again (or in another widget) comes out of the cache, or the asset if it was cooked with
+	// it, and the view keeps its rows when it is handed the document it already has
+	WatchMarkdown( Markdown );
+	MyMarkdownView->SetDocument( GetDocumentToShow() );
+}
+
+TSharedRef<const FMarkdownDocument> UMarkdownTextBlock::GetDocumentToShow() const
+{
+	if( Markdown != nullptr )
+	{
+		return Markdown->GetLocalized()->GetDocument();
+	}
+
+	return FMarkdownDocumentCache::Get().FindOrParse( Text.ToString() );
+}
+
+const ISlateStyle* UMarkdownTextBlock::GetViewStyle() const
+{
+	if( !StyleSetName.IsNone() )
+	{
+		if( const ISlateStyle* Found = FSlateStyleRegistry::FindSlateStyle( StyleSetName ) )
+		{
+			return Found;
+		}
+	}
+
+	return &FMarkdownViewStyle::Get();
+}
+
+void UMarkdownTextBlock::WatchMarkdown( UMarkdownAsset* InMarkdown )
+{
+	if( WatchedMarkdown.Get() == InMarkdown )
+	{
+		return;
+	}
+
+	if( UMarkdownAsset* Previous = WatchedMarkdown.Get() )
+	{
+		Previous->OnLocalizedVariantChanged.Remove( LocalizedVariantChangedHandle );
+	}
+
+	WatchedMarkdown = InMarkdown;
+	LocalizedVariantChangedHandle.Reset();
+
+	if( InMarkdown != nullptr )
+	{
+		LocalizedVariantChangedHandle = InMarkdown->OnLocalizedVariantChanged.AddUObject( this, &UMarkdownTextBlock::UpdateDocument );
+	}
+}
+
+void UMarkdownTextBlock::HandleLinkClicked( const FString& Url )
+{
+	if( OnLinkClicked.IsBound() )
+	{
+		OnLinkClicked.Broadcast( Url );
+	}
+	else if( Url.StartsWith( TEXT( "http://" ) ) || Url.StartsWith( TEXT( "https://" ) ) )
+	{
+		FPlatformProcess::LaunchURL( *Url, nullptr, nullptr );
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
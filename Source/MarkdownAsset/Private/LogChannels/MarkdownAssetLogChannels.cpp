@@ -0,0 +1,5 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownAssetLogChannels.h"
+
+DEFINE_LOG_CATEGORY(MarkdownAssetLog);
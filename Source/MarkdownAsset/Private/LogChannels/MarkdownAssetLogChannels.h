@@ -0,0 +1,7 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Logging/LogMacros.h"
+
+MARKDOWNASSET_API DECLARE_LOG_CATEGORY_EXTERN(MarkdownAssetLog, Log, All)
@@ -0,0 +1,688 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownAsset.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Hash/CityHash.h"
+#include "Internationalization/Culture.h"
+#include "Internationalization/Internationalization.h"
+#include "MarkdownAssetSettings.h"
+#include "Misc/Guid.h"
+#include "Parser/MarkdownDocumentCache.h"
+#include "Parser/MarkdownLinks.h"
+#include "Parser/MarkdownParser.h"
+#include "Serialization/CustomVersion.h"
+#include "Templates/UnrealTemplate.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace MarkdownAssetVersion
+{
+	enum Type : int32
+	{
+		Initial = 0,
+		CookedDocument, // cooked packages may have the parsed document after the properties
+		ViewerSlugs,    // heading slugs are made the way the viewer makes them
+
+		VersionPlusOne,
+		Latest = VersionPlusOne - 1
+	};
+
+	static const FGuid GUID( 0x5A0B3C61, 0x7E2D4F18, 0x9C4B1A77, 0x2D86E0F3 );
+	static const FCustomVersionRegistration Register( GUID, Latest, TEXT( "MarkdownAsset" ) );
+}
+
+namespace MarkdownAsset
+{
+	static uint64 HashSource( const FString& Source )
+	{
+		return CityHash64( reinterpret_cast<const char*>( *Source ), Source.Len() * sizeof( TCHAR ) );
+	}
+
+#if WITH_EDITORONLY_DATA
+
+	// the number of values first, so an asset with none still has the tag
+	static FString MakeListTag( const TArray<FString>& Values )
+	{
+		FString Tag = FString::FromInt( Values.Num() );
+
+		for( const FString& Value : Values )
+		{
+			Tag.AppendChar( TEXT( '\n' ) );
+			Tag.Append( Value );
+		}
+
+		return Tag;
+	}
+
+#endif
+
+	static bool ParseListTag( const FAssetData& AssetData, const FName Name, TArray<FString>& OutValues )
+	{
+		OutValues.Reset();
+
+		FString Tag;
+
+		if( !AssetData.GetTagValue( Name, Tag ) || Tag.IsEmpty() )
+		{
+			return false;
+		}
+
+		Tag.ParseIntoArrayLines( OutValues, false );
+		OutValues.RemoveAt( 0 );
+
+		return true;
+	}
+
+	static FString CollapseWhitespace( const FString& In )
+	{
+		FString Out;
+		Out.Reserve( In.Len() );
+
+		for( const TCHAR C : In )
+		{
+			if( !FChar::IsWhitespace( C ) )
+			{
+				Out.AppendChar( C );
+			}
+			else if( !Out.IsEmpty() && Out[ Out.Len() - 1 ] != TEXT( ' ' ) )
+			{
+				Out.AppendChar( TEXT( ' ' ) );
+			}
+		}
+
+		Out.TrimEndInline();
+		return Out;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const FName UMarkdownAsset::LinksTag( TEXT( "MarkdownLinks" ) );
+const FName UMarkdownAsset::HeadingsTag( TEXT( "MarkdownAnchors" ) );
+const FName UMarkdownAsset::DocumentedAssetsTag( TEXT( "MarkdownDocumentedAssets" ) );
+const FName UMarkdownAsset::DocumentedHashesTag( TEXT( "MarkdownDocumentedHashes" ) );
+
+bool UMarkdownAsset::GetLinks( const FAssetData& AssetData, TArray<FString>& OutDestinations )
+{
+	return MarkdownAsset::ParseListTag( AssetData, LinksTag, OutDestinations );
+}
+
+bool UMarkdownAsset::GetHeadingSlugs( const FAssetData& AssetData, TArray<FString>& OutSlugs )
+{
+	return MarkdownAsset::ParseListTag( AssetData, HeadingsTag, OutSlugs );
+}
+
+bool UMarkdownAsset::GetDocumentedAssets( const FAssetData& AssetData, TArray<FString>& OutAssets )
+{
+	return MarkdownAsset::ParseListTag( AssetData, DocumentedAssetsTag, OutAssets );
+}
+
+bool UMarkdownAsset::GetDocumentedAssetHashes( const FAssetData& AssetData, TArray<FString>& OutHashes )
+{
+	return MarkdownAsset::ParseListTag( AssetData, DocumentedHashesTag, OutHashes );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TSharedRef<const FMarkdownDocument> UMarkdownAsset::GetDocument() const
+{
+	if( TSharedPtr<const FMarkdownDocument> Document = FindDocument() )
+	{
+		return Document.ToSharedRef();
+	}
+
+	return FMarkdownDocumentCache::Get().FindOrParse( Text.ToString() );
+}
+
+TSharedPtr<const FMarkdownDocument> UMarkdownAsset::FindDocument() const
+{
+	if( CookedDocument.IsValid() )
+	{
+		// hashing is a lot cheaper than parsing, and catches the text being shown in another language
+		if( bCookedSourceStripped || MarkdownAsset::HashSource( Text.ToString() ) == CookedSourceHash )
+		{
+			return CookedDocument;
+		}
+	}
+
+	return FMarkdownDocumentCache::Get().Find( Text.ToString() );
+}
+
+void UMarkdownAsset::SetText( const FText& InText )
+{
+	const FString OldSource = Text.BuildSourceString();
+	const FString NewSource = InText.BuildSourceString();
+
+	Text = InText;
+
+	if( MarkdownAsset::HashSource( OldSource ) == HeadingsSourceHash )
+	{
+		// an edit is usually a few characters in one place, so only that part needs looking at
+		const int32 MaxCommon = FMath::Min( OldSource.Len(), NewSource.Len() );
+
+		int32 Prefix = 0;
+		while( Prefix < MaxCommon && OldSource[ Prefix ] == NewSource[ Prefix ] )
+		{
+			++Prefix;
+		}
+
+		int32 Suffix = 0;
+		while( Suffix < MaxCommon - Prefix && OldSource[ OldSource.Len() - 1 - Suffix ] == NewSource[ NewSource.Len() - 1 - Suffix ] )
+		{
+			++Suffix;
+		}
+
+		FMarkdownHeadingIndex::Update( NewSource, Prefix, OldSource.Len() - Prefix - Suffix, NewSource.Len() - Prefix - Suffix, Headings );
+	}
+	else
+	{
+		FMarkdownHeadingIndex::Build( NewSource, Headings );
+	}
+
+	HeadingsSourceHash = MarkdownAsset::HashSource( NewSource );
+	IndexedText = FTextSnapshot();
+}
+
+void UMarkdownAsset::RefreshHeadings()
+{
+	const FString Source = Text.BuildSourceString();
+	const uint64 Hash    = MarkdownAsset::HashSource( Source );
+
+	if( Hash != HeadingsSourceHash )
+	{
+		FMarkdownHeadingIndex::Build( Source, Headings );
+		HeadingsSourceHash = Hash;
+		IndexedText = FTextSnapshot();
+	}
+}
+
+const TArray<FMarkdownHeading>& UMarkdownAsset::GetHeadings() const
+{
+	if( !IndexedText.IdenticalTo( Text ) )
+	{
+		IndexedText = FTextSnapshot( Text );
+
+		// offsets are into the text being shown, which is not the saved one if it is translated (or if Text was set
+		// directly, in the editor). Stripped assets keep their headings for the outline, but have no sections.
+		const FString& Displayed = Text.ToString();
+		bHeadingsMatchText = bCookedSourceStripped || MarkdownAsset::HashSource( Displayed ) == HeadingsSourceHash;
+
+		if( bHeadingsMatchText )
+		{
+			DisplayedHeadings.Empty();
+		}
+		else
+		{
+			FMarkdownHeadingIndex::Build( Displayed, DisplayedHeadings );
+		}
+
+		const TArray<FMarkdownHeading>& Current = bHeadingsMatchText ? Headings : DisplayedHeadings;
+
+		HeadingsBySlug.Reset();
+		for( int32 Index = 0; Index < Current.Num(); ++Index )
+		{
+			HeadingsBySlug.Add( Current[ Index ].Slug, Index );
+		}
+	}
+
+	return bHeadingsMatchText ? Headings : DisplayedHeadings;
+}
+
+const FMarkdownHeading* UMarkdownAsset::FindHeadingBySlug( const FString& Slug ) const
+{
+	const TArray<FMarkdownHeading>& Current = GetHeadings();
+	const int32* Index = HeadingsBySlug.Find( Slug );
+
+	return Index != nullptr ? &Current[ *Index ] : nullptr;
+}
+
+bool UMarkdownAsset::FindHeading( const FString& Slug, FMarkdownHeading& OutHeading ) const
+{
+	const FMarkdownHeading* Heading = FindHeadingBySlug( Slug );
+
+	if( Heading == nullptr )
+	{
+		return false;
+	}
+
+	OutHeading = *Heading;
+	return true;
+}
+
+bool UMarkdownAsset::GetSection( const FString& Slug, FString& OutMarkdown ) const
+{
+	const FMarkdownHeading* Heading = FindHeadingBySlug( Slug );
+	const FString& Source = Text.ToString();
+
+	if( Heading == nullptr || Heading->Offset + Heading->SectionLength > Source.Len() )
+	{
+		OutMarkdown.Reset();
+		return false;
+	}
+
+	OutMarkdown = Source.Mid( Heading->GetBodyOffset(), Heading->GetBodyLength() );
+	return true;
+}
+
+FString UMarkdownAsset::GetPlainTextExcerpt( const FString& Slug, const int32 MaxLength ) const
+{
+	const TArray<FMarkdownHeading>& Current = GetHeadings();
+	const FString& Source = Text.ToString();
+
+	int32 Start  = 0;
+	int32 Length = Source.Len();
+
+	if( !Slug.IsEmpty() )
+	{
+		const FMarkdownHeading* Heading = FindHeadingBySlug( Slug );
+
+		if( Heading == nullptr )
+		{
+			return FString();
+		}
+
+		Start  = Heading->GetBodyOffset();
+		Length = Heading->GetBodyLength();
+	}
+	else if( Current.Num() > 0 )
+	{
+		// the introduction, or the first section if there is nothing before it
+		Length = FMath::Min( Current[ 0 ].Offset, Source.Len() );
+
+		if( FStringView( *Source, Length ).TrimStartAndEnd().IsEmpty() )
+		{
+			Start  = Current[ 0 ].GetBodyOffset();
+			Length = Current[ 0 ].GetBodyLength();
+		}
+	}
+
+	if( Start + Length > Source.Len() || MaxLength <= 0 )
+	{
+		return FString();
+	}
+
+	// markup takes some room, but there is no point parsing much more than can end up in the excerpt
+	Length = FMath::Min( Length, MaxLength * 4 + 256 );
+
+	FMarkdownDocument Document;
+	FMarkdownParser::Parse( FStringView( *Source + Start, Length ), Document );
+
+	FString Excerpt = MarkdownAsset::CollapseWhitespace( Document.GetPlainText() );
+
+	if( Excerpt.Len() > MaxLength )
+	{
+		int32 Cut = MaxLength;
+		while( Cut > 0 && Excerpt[ Cut ] != TEXT( ' ' ) )
+		{
+			--Cut;
+		}
+
+		Excerpt.LeftInline( Cut > 0 ? Cut : MaxLength );
+		Excerpt.TrimEndInline();
+		Excerpt.Append( TEXT( "..." ) );
+	}
+
+	return Excerpt;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UMarkdownAsset* UMarkdownAsset::GetLocalized()
+{
+	check( IsInGameThread() );
+
+	if( LocalizedVariants.IsEmpty() )
+	{
+		return this;
+	}
+
+	// variants are only followed for assets someone has asked for
+	if( !bWatchingCulture )
+	{
+		FInternationalization::Get().OnCultureChanged().AddUObject( this, &UMarkdownAsset::HandleCultureChanged );
+		bWatchingCulture = true;
+	}
+
+	RequestVariant( FindVariantCulture( FInternationalization::Get().GetCurrentLanguage()->GetName() ) );
+
+	return ActiveVariant != nullptr ? ActiveVariant.Get() : this;
+}
+
+TSoftObjectPtr<UMarkdownAsset> UMarkdownAsset::FindLocalizedVariant() const
+{
+	if( LocalizedVariants.IsEmpty() )
+	{
+		return nullptr;
+	}
+
+	const FString Culture = FindVariantCulture( FInternationalization::Get().GetCurrentLanguage()->GetName() );
+	return Culture.IsEmpty() ? nullptr : LocalizedVariants.FindRef( Culture );
+}
+
+FString UMarkdownAsset::FindVariantCulture( const FString& Culture ) const
+{
+	if( LocalizedVariants.Contains( Culture ) )
+	{
+		return Culture;
+	}
+
+	if( const FString* Fallback = CultureFallbacks.Find( Culture ) )
+	{
+		if( LocalizedVariants.Contains( *Fallback ) )
+		{
+			return *Fallback;
+		}
+	}
+
+#if WITH_EDITOR
+
+	// the table is made on save, variants added since are still worked out here
+	for( const FString& Parent : FInternationalization::Get().GetPrioritizedCultureNames( Culture ) )
+	{
+		if( LocalizedVariants.Contains( Parent ) )
+		{
+			return Parent;
+		}
+	}
+
+#endif
+
+	return FString();
+}
+
+void UMarkdownAsset::RequestVariant( const FString& Culture )
+{
+	if( Culture == ActiveCulture )
+	{
+		if( VariantRequest.IsValid() )
+		{
+			// switched back before the other one arrived
+			VariantRequest->Cancel();
+			VariantRequest.Reset();
+		}
+
+		return;
+	}
+
+	if( VariantRequest.IsValid() )
+	{
+		if( Culture == RequestedCulture )
+		{
+			return;
+		}
+
+		VariantRequest->Cancel();
+		VariantRequest.Reset();
+	}
+
+	if( Culture.IsEmpty() )
+	{
+		SetActiveVariant( Culture, nullptr );
+		return;
+	}
+
+	const TSoftObjectPtr<UMarkdownAsset> Variant = LocalizedVariants.FindRef( Culture );
+
+	if( UMarkdownAsset* Loaded = Variant.Get() )
+	{
+		SetActiveVariant( Culture, Loaded );
+		return;
+	}
+
+	// the current one stays up until the new one is in
+	RequestedCulture = Culture;
+	VariantRequest   = FMarkdownAsyncLoader::Load( { Variant.ToSoftObjectPath() }, FOnMarkdownLoaded::CreateWeakLambda( this, [ this, Culture ]( const TArray<UMarkdownAsset*>& Assets )
+	{
+		VariantRequest.Reset();
+		SetActiveVariant( Culture, Assets[ 0 ] );
+	}));
+
+	if( ActiveCulture == Culture )
+	{
+		// it was already loaded and parsed, so the callback came straight away
+		VariantRequest.Reset();
+	}
+}
+
+void UMarkdownAsset::SetActiveVariant( const FString& Culture, UMarkdownAsset* Variant )
+{
+	// one that failed to load still counts, this asset is shown in its place rather than asking again
+	ActiveCulture = Culture;
+	ActiveVariant = Variant;
+
+	OnLocalizedVariantChanged.Broadcast();
+}
+
+void UMarkdownAsset::HandleCultureChanged()
+{
+	RequestVariant( FindVariantCulture( FInternationalization::Get().GetCurrentLanguage()->GetName() ) );
+}
+
+void UMarkdownAsset::BeginDestroy()
+{
+	if( bWatchingCulture && FInternationalization::IsAvailable() )
+	{
+		FInternationalization::Get().OnCultureChanged().RemoveAll( this );
+		bWatchingCulture = false;
+	}
+
+	if( VariantRequest.IsValid() )
+	{
+		VariantRequest->Cancel();
+		VariantRequest.Reset();
+	}
+
+	Super::BeginDestroy();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#if WITH_EDITOR
+
+void UMarkdownAsset::PreSave( FObjectPreSaveContext SaveContext )
+{
+	Super::PreSave( SaveContext );
+
+	// factories and importers set Text directly
+	RefreshHeadings();
+	BuildCultureFallbacks();
+	BuildLinks();
+	BuildDocumentedAssetHashes();
+}
+
+void UMarkdownAsset::BuildLinks()
+{
+	Links.Reset();
+	LinkedAssets.Reset();
+
+	TArray<FMarkdownLink> Found;
+	FMarkdownLinks::Collect( *FMarkdownDocumentCache::Get().FindOrParse( Text.BuildSourceString() ), Found );
+
+	for( const FMarkdownLink& Link : Found )
+	{
+		if( Link.Type == EMarkdownLinkType::External )
+		{
+			continue;
+		}
+
+		Links.AddUnique( Link.Destination );
+
+		const FSoftObjectPath Path( Link.Target );
+
+		if( Link.Type == EMarkdownLinkType::Asset && Path.IsValid() )
+		{
+			LinkedAssets.AddUnique( Path );
+		}
+	}
+}
+
+void UMarkdownAsset::BuildDocumentedAssetHashes()
+{
+	DocumentedAssetHashes.Reset( DocumentedAssets.Num() );
+
+	// saving the documentation is taken as it being brought up to date with the assets as they are on disk
+	const IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+
+	for( const FSoftObjectPath& Asset : DocumentedAssets )
+	{
+		const TOptional<FAssetPackageData> PackageData = AssetRegistry != nullptr ? AssetRegistry->GetAssetPackageDataCopy( Asset.GetLongPackageFName() ) : TOptional<FAssetPackageData>();
+		DocumentedAssetHashes.Add( PackageData.IsSet() && !PackageData->PackageSavedHash.IsZero() ? LexToString( PackageData->PackageSavedHash ) : FString() );
+	}
+}
+
+void UMarkdownAsset::BuildCultureFallbacks()
+{
+	CultureFallbacks.Reset();
+
+	if( LocalizedVariants.IsEmpty() )
+	{
+		return;
+	}
+
+	// only cultures that end up on a variant other than their own are kept, which for a dozen languages is a few
+	// dozen regional ones
+	TArray<FString> CultureNames;
+	FInternationalization::Get().GetCultureNames( CultureNames );
+
+	for( const FString& Name : CultureNames )
+	{
+		if( LocalizedVariants.Contains( Name ) )
+		{
+			continue;
+		}
+
+		for( const FString& Parent : FInternationalization::Get().GetPrioritizedCultureNames( Name ) )
+		{
+			if( LocalizedVariants.Contains( Parent ) )
+			{
+				CultureFallbacks.Add( Name, Parent );
+				break;
+			}
+		}
+	}
+}
+
+#endif
+
+void UMarkdownAsset::GetDocumentationTags( TArray<FAssetRegistryTag>& OutTags ) const
+{
+#if WITH_EDITORONLY_DATA
+
+	TArray<FString> Slugs;
+	Slugs.Reserve( Headings.Num() );
+
+	for( const FMarkdownHeading& Heading : Headings )
+	{
+		Slugs.Add( Heading.Slug );
+	}
+
+	OutTags.Add( FAssetRegistryTag( LinksTag, MarkdownAsset::MakeListTag( Links ), FAssetRegistryTag::TT_Hidden ) );
+	OutTags.Add( FAssetRegistryTag( HeadingsTag, MarkdownAsset::MakeListTag( Slugs ), FAssetRegistryTag::TT_Hidden ) );
+
+	TArray<FString> Assets;
+	Assets.Reserve( DocumentedAssets.Num() );
+
+	for( const FSoftObjectPath& Asset : DocumentedAssets )
+	{
+		Assets.Add( Asset.ToString() );
+	}
+
+	OutTags.Add( FAssetRegistryTag( DocumentedAssetsTag, MarkdownAsset::MakeListTag( Assets ), FAssetRegistryTag::TT_Hidden ) );
+	OutTags.Add( FAssetRegistryTag( DocumentedHashesTag, MarkdownAsset::MakeListTag( DocumentedAssetHashes ), FAssetRegistryTag::TT_Hidden ) );
+
+#endif
+}
+
+#if UE_VERSION_OLDER_THAN( 5, 4, 0 )
+
+void UMarkdownAsset::GetAssetRegistryTags( TArray<FAssetRegistryTag>& OutTags ) const
+{
+	Super::GetAssetRegistryTags( OutTags );
+	GetDocumentationTags( OutTags );
+}
+
+#else
+
+void UMarkdownAsset::GetAssetRegistryTags( FAssetRegistryTagsContext Context ) const
+{
+	Super::GetAssetRegistryTags( Context );
+
+	TArray<FAssetRegistryTag> Tags;
+	GetDocumentationTags( Tags );
+
+	for( const FAssetRegistryTag& Tag : Tags )
+	{
+		Context.AddTag( Tag );
+	}
+}
+
+#endif
+
+void UMarkdownAsset::Serialize( FArchive& Ar )
+{
+	Ar.UsingCustomVersion( MarkdownAssetVersion::GUID );
+
+#if WITH_EDITOR
+
+	const UMarkdownAssetSettings* Settings = UMarkdownAssetSettings::Get();
+
+	// the document is written in memory order, so is left out when cooking for a platform with the other byte order
+	if( Ar.IsCooking() && Settings->ShouldCookParsedDocuments() && !Ar.IsByteSwapping() )
+	{
+		const FString Source = Text.BuildSourceString();
+
+		FMarkdownDocument Document;
+		FMarkdownParser::Parse( Source, Document );
+
+		bool bHasDocument = true;
+		bool bStripped    = Settings->ShouldStripSourceText();
+		uint64 SourceHash = MarkdownAsset::HashSource( Source );
+
+		{
+			TGuardValue<FText> StrippedText( Text, bStripped ? FText::GetEmpty() : Text );
+			Super::Serialize( Ar );
+		}
+
+		Ar << bHasDocument << bStripped << SourceHash;
+		Document.Serialize( Ar );
+		return;
+	}
+
+#endif
+
+	Super::Serialize( Ar );
+
+	// saved headings have the old slugs, they are made again the next time they are needed
+	if( Ar.IsLoading() && Ar.CustomVer( MarkdownAssetVersion::GUID ) < MarkdownAssetVersion::ViewerSlugs )
+	{
+		HeadingsSourceHash = 0;
+	}
+
+	if( Ar.CustomVer( MarkdownAssetVersion::GUID ) < MarkdownAssetVersion::CookedDocument )
+	{
+		return;
+	}
+
+	bool bHasDocument = false;
+	Ar << bHasDocument;
+
+	if( !bHasDocument || !Ar.IsLoading() )
+	{
+		return;
+	}
+
+	bool bStripped    = false;
+	uint64 SourceHash = 0;
+	Ar << bStripped << SourceHash;
+
+	TSharedRef<FMarkdownDocument> Document = MakeShared<FMarkdownDocument>();
+
+	if( Document->Serialize( Ar ) )
+	{
+		CookedDocument        = Document;
+		CookedSourceHash      = SourceHash;
+		bCookedSourceStripped = bStripped;
+	}
+}
@@ -1,15 +1,31 @@
 // Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
 
+#include "Misc/CoreDelegates.h"
 #include "Modules/ModuleInterface.h"
 #include "Modules/ModuleManager.h"
+#include "Widgets/MarkdownViewCache.h"
+#include "Widgets/MarkdownViewStyle.h"
 
 class FMarkdownAssetModule : public IModuleInterface
 {
 	public:
 
-		virtual void StartupModule() override {}
-		virtual void ShutdownModule() override {}
+		virtual void StartupModule() override
+		{
+			// parked views are widgets, they should go while slate is still around
+			PreExitHandle = FCoreDelegates::OnPreExit.AddLambda( []() { FMarkdownViewCache::Get().Empty(); } );
+		}
+		virtual void ShutdownModule() override
+		{
+			FCoreDelegates::OnPreExit.Remove( PreExitHandle );
+			FMarkdownViewCache::Get().Empty();
+			FMarkdownViewStyle::Shutdown();
+		}
 		virtual bool SupportsDynamicReloading() override { return true; }
+
+	private:
+
+		FDelegateHandle PreExitHandle;
 };
 
 IMPLEMENT_MODULE( FMarkdownAssetModule, MarkdownAsset );
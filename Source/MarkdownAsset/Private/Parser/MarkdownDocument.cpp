@@ -0,0 +1,170 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Parser/MarkdownDocument.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownDocument::Empty()
+{
+	Nodes.Reset();
+	Strings.Reset();
+}
+
+int32 FMarkdownDocument::AddNode( const EMarkdownNodeType Type, const int32 Parent )
+{
+	const int32 Index = Nodes.AddDefaulted();
+
+	FMarkdownNode& Node = Nodes[ Index ];
+	Node.Type   = Type;
+	Node.Parent = Parent;
+
+	if( Parent != INDEX_NONE )
+	{
+		FMarkdownNode& ParentNode = Nodes[ Parent ];
+
+		if( ParentNode.LastChild != INDEX_NONE )
+		{
+			Nodes[ ParentNode.LastChild ].NextSibling = Index;
+		}
+		else
+		{
+			ParentNode.FirstChild = Index;
+		}
+
+		ParentNode.LastChild = Index;
+	}
+
+	return Index;
+}
+
+FMarkdownStringRef FMarkdownDocument::AddString( const FStringView String )
+{
+	FMarkdownStringRef Ref;
+	Ref.Offset = Strings.Num();
+	Ref.Length = String.Len();
+
+	Strings.Append( String.GetData(), String.Len() );
+
+	return Ref;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace MarkdownDocument
+{
+	// bump when the node types or flags change meaning, size changes are caught anyway
+	// 2: nesting is capped, documents cooked before that are parsed again
+	static constexpr uint32 FormatVersion = 2;
+
+	// nodes are saved byte for byte, so any padding would write whatever was in memory into the package
+	static_assert( sizeof( FMarkdownNode ) == 4 + 7 * sizeof( int32 ) + 2 * sizeof( FMarkdownStringRef ), "FMarkdownNode must not have padding" );
+}
+
+bool FMarkdownDocument::Serialize( FArchive& Ar )
+{
+	uint32 Version  = MarkdownDocument::FormatVersion;
+	uint32 NodeSize = sizeof( FMarkdownNode );
+	uint32 CharSize = sizeof( TCHAR );
+	int32  NumNodes = Ar.IsByteSwapping() ? 0 : Nodes.Num();
+	int32  NumChars = Ar.IsByteSwapping() ? 0 : Strings.Num();
+
+	Ar << Version << NodeSize << CharSize << NumNodes << NumChars;
+
+	if( Ar.IsLoading() )
+	{
+		Empty();
+
+		const bool bCompatible = Version == MarkdownDocument::FormatVersion && NodeSize == sizeof( FMarkdownNode ) &&
+			CharSize == sizeof( TCHAR ) && !Ar.IsByteSwapping() && NumNodes > 0 && NumChars >= 0;
+
+		if( !bCompatible )
+		{
+			Ar.Seek( Ar.Tell() + int64( FMath::Max( NumNodes, 0 ) ) * NodeSize + int64( FMath::Max( NumChars, 0 ) ) * CharSize );
+			return false;
+		}
+
+		Nodes.SetNumUninitialized( NumNodes );
+		Strings.SetNumUninitialized( NumChars );
+	}
+
+	Ar.Serialize( Nodes.GetData(), int64( NumNodes ) * sizeof( FMarkdownNode ) );
+	Ar.Serialize( Strings.GetData(), int64( NumChars ) * sizeof( TCHAR ) );
+
+	if( Ar.IsError() )
+	{
+		Empty();
+		return false;
+	}
+
+	return NumNodes > 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownDocument::GetPlainText( const int32 Index ) const
+{
+	FString Out;
+	AppendPlainText( Index, Out );
+	return Out;
+}
+
+void FMarkdownDocument::AppendPlainText( const int32 Index, FString& Out ) const
+{
+	// walked through the links rather than recursively, a node is left once everything under it has been added
+	auto Leave = [ &Out ]( const FMarkdownNode& Node )
+	{
+		// keep blocks apart, cells on a row are separated by spaces
+		if( Node.IsBlock() && Node.Type != EMarkdownNodeType::Document && !Out.IsEmpty() && !Out.EndsWith( TEXT( "\n" ) ) )
+		{
+			Out.AppendChar( Node.Type == EMarkdownNodeType::TableCell ? TEXT( ' ' ) : TEXT( '\n' ) );
+		}
+	};
+
+	int32 Current = Index;
+
+	while( true )
+	{
+		const FMarkdownNode& Node = Nodes[ Current ];
+
+		switch( Node.Type )
+		{
+			case EMarkdownNodeType::Text:
+			case EMarkdownNodeType::Code:
+			case EMarkdownNodeType::CodeBlock:
+				Out.Append( Strings.GetData() + Node.Literal.Offset, Node.Literal.Length );
+				break;
+
+			case EMarkdownNodeType::SoftBreak:
+				Out.AppendChar( TEXT( ' ' ) );
+				break;
+
+			case EMarkdownNodeType::HardBreak:
+				Out.AppendChar( TEXT( '\n' ) );
+				break;
+
+			default:
+				break;
+		}
+
+		if( Node.FirstChild != INDEX_NONE )
+		{
+			Current = Node.FirstChild;
+			continue;
+		}
+
+		Leave( Node );
+
+		while( Current != Index && Nodes[ Current ].NextSibling == INDEX_NONE )
+		{
+			Current = Nodes[ Current ].Parent;
+			Leave( Nodes[ Current ] );
+		}
+
+		if( Current == Index )
+		{
+			return;
+		}
+
+		Current = Nodes[ Current ].NextSibling;
+	}
+}
@@ -0,0 +1,107 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Parser/MarkdownDocumentCache.h"
+
+#include "Hash/CityHash.h"
+#include "Parser/MarkdownParser.h"
+
+FMarkdownDocumentCache& FMarkdownDocumentCache::Get()
+{
+	static FMarkdownDocumentCache Instance;
+	return Instance;
+}
+
+TSharedRef<const FMarkdownDocument> FMarkdownDocumentCache::FindOrParse( const FString& Source )
+{
+	if( TSharedPtr<const FMarkdownDocument> Found = Find( Source ) )
+	{
+		return Found.ToSharedRef();
+	}
+
+	TSharedRef<FMarkdownDocument> Document = MakeShared<FMarkdownDocument>();
+	FMarkdownParser::Parse( Source, *Document );
+	Document->Shrink();
+
+	Add( Source, Document );
+	return Document;
+}
+
+TSharedPtr<const FMarkdownDocument> FMarkdownDocumentCache::Find( const FString& Source )
+{
+	check( IsInGameThread() );
+
+	for( auto It = Entries.CreateKeyIterator( Hash( Source ) ); It; ++It )
+	{
+		FEntry& Entry = It.Value();
+
+		if( Entry.Source.Equals( Source, ESearchCase::CaseSensitive ) )
+		{
+			Entry.LastUsed = ++UseCounter;
+			return Entry.Document;
+		}
+	}
+
+	return nullptr;
+}
+
+void FMarkdownDocumentCache::Add( const FString& Source, const TSharedRef<const FMarkdownDocument>& Document )
+{
+	check( IsInGameThread() );
+
+	if( Find( Source ).IsValid() )
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.Add( Hash( Source ) );
+	Entry.Source   = Source;
+	Entry.Document = Document;
+	Entry.Size     = Document->GetAllocatedSize() + Source.GetAllocatedSize();
+	Entry.LastUsed = ++UseCounter;
+
+	Used += Entry.Size;
+	Trim();
+}
+
+void FMarkdownDocumentCache::Empty()
+{
+	Entries.Empty();
+	Used = 0;
+}
+
+void FMarkdownDocumentCache::SetBudget( const SIZE_T InBudget )
+{
+	Budget = InBudget;
+	Trim();
+}
+
+void FMarkdownDocumentCache::Trim()
+{
+	// views hold on to their documents, so dropping an entry only means the next one to ask parses it again. The
+	// newest entry always stays even if it is over the budget on its own.
+	while( Used > Budget && Entries.Num() > 1 )
+	{
+		uint64 Oldest = MAX_uint64;
+
+		for( const TPair<uint64, FEntry>& Pair : Entries )
+		{
+			Oldest = FMath::Min( Oldest, Pair.Value.LastUsed );
+		}
+
+		// use counts are unique, so this is exactly one entry
+		for( auto It = Entries.CreateIterator(); It; ++It )
+		{
+			if( It.Value().LastUsed == Oldest )
+			{
+				Used -= It.Value().Size;
+				It.RemoveCurrent();
+				break;
+			}
+		}
+	}
+}
+
+uint64 FMarkdownDocumentCache::Hash( const FString& Source )
+{
+	return CityHash64( reinterpret_cast<const char*>( *Source ), Source.Len() * sizeof( TCHAR ) );
+}
@@ -0,0 +1,162 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Parser/MarkdownFrontMatter.h"
+
+#include "MarkdownParserInternal.h"
+#include "MarkdownScan.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace MarkdownFrontMatter
+{
+	using namespace MarkdownParser;
+
+	static FStringView Trim( FStringView Value )
+	{
+		while( !Value.IsEmpty() && IsSpaceOrTab( Value[ 0 ] ) )
+		{
+			Value.RightChopInline( 1 );
+		}
+
+		while( !Value.IsEmpty() && IsSpaceOrTab( Value[ Value.Len() - 1 ] ) )
+		{
+			Value.LeftChopInline( 1 );
+		}
+
+		return Value;
+	}
+
+	static FString Unquote( FStringView Value )
+	{
+		Value = Trim( Value );
+
+		if( Value.Len() >= 2 && ( Value[ 0 ] == TEXT( '"' ) || Value[ 0 ] == TEXT( '\'' ) ) && Value[ Value.Len() - 1 ] == Value[ 0 ] )
+		{
+			Value = Value.Mid( 1, Value.Len() - 2 );
+		}
+
+		return FString( Value );
+	}
+
+	static bool IsFence( const FStringView Line )
+	{
+		const FStringView Trimmed = Trim( Line );
+		return Trimmed.Equals( TEXT( "---" ) ) || Trimmed.Equals( TEXT( "..." ) );
+	}
+
+	static void AddValue( TArray<FString>& Values, const FStringView Value )
+	{
+		FString Unquoted = Unquote( Value );
+
+		if( !Unquoted.IsEmpty() )
+		{
+			Values.Add( MoveTemp( Unquoted ) );
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+int32 FMarkdownFrontMatter::Parse( const FStringView Text, TMap<FString, TArray<FString>>& OutValues )
+{
+	using namespace MarkdownFrontMatter;
+
+	OutValues.Reset();
+
+	const TCHAR* Data = Text.GetData();
+	const int32 Len   = Text.Len();
+
+	TArray<FString>* List = nullptr;
+	int32 Pos = 0;
+
+	while( Pos < Len )
+	{
+		const int32 LineStart = Pos;
+		const int32 NewLine   = FindChar( Data, Pos, Len, TEXT( '\n' ) );
+		const int32 LineEnd   = NewLine > LineStart && Data[ NewLine - 1 ] == TEXT( '\r' ) ? NewLine - 1 : NewLine;
+		const FStringView Line( Data + LineStart, LineEnd - LineStart );
+
+		Pos = NewLine < Len ? NewLine + 1 : Len;
+
+		// the first line opens the block, the next fence closes it
+		if( LineStart == 0 )
+		{
+			if( !Trim( Line ).Equals( TEXT( "---" ) ) )
+			{
+				return 0;
+			}
+
+			continue;
+		}
+
+		if( IsFence( Line ) )
+		{
+			return Pos;
+		}
+
+		const FStringView Trimmed = Trim( Line );
+
+		if( Trimmed.IsEmpty() || Trimmed[ 0 ] == TEXT( '#' ) )
+		{
+			continue;
+		}
+
+		if( Trimmed[ 0 ] == TEXT( '-' ) && ( Trimmed.Len() == 1 || IsSpaceOrTab( Trimmed[ 1 ] ) ) )
+		{
+			if( List != nullptr )
+			{
+				AddValue( *List, Trimmed.RightChop( 1 ) );
+			}
+
+			continue;
+		}
+
+		int32 Colon = INDEX_NONE;
+
+		// nested keys belong to something this doesn't read
+		if( IsSpaceOrTab( Line[ 0 ] ) || !Trimmed.FindChar( TEXT( ':' ), Colon ) )
+		{
+			List = nullptr;
+			continue;
+		}
+
+		List = &OutValues.FindOrAdd( FString( Trim( Trimmed.Left( Colon ) ) ) );
+
+		const FStringView Value = Trim( Trimmed.RightChop( Colon + 1 ) );
+
+		if( Value.Len() >= 2 && Value[ 0 ] == TEXT( '[' ) && Value[ Value.Len() - 1 ] == TEXT( ']' ) )
+		{
+			FStringView Items = Value.Mid( 1, Value.Len() - 2 );
+			int32 Comma = INDEX_NONE;
+
+			while( Items.FindChar( TEXT( ',' ), Comma ) )
+			{
+				AddValue( *List, Items.Left( Comma ) );
+				Items.RightChopInline( Comma + 1 );
+			}
+
+			AddValue( *List, Items );
+		}
+		else if( !Value.IsEmpty() )
+		{
+			AddValue( *List, Value );
+		}
+	}
+
+	// never closed, so it was not front matter after all
+	OutValues.Reset();
+	return 0;
+}
+
+void FMarkdownFrontMatter::GetTags( const FStringView Text, TArray<FString>& OutTags )
+{
+	OutTags.Reset();
+
+	TMap<FString, TArray<FString>> Values;
+
+	if( Parse( Text, Values ) > 0 )
+	{
+		OutTags.Append( Values.FindRef( TEXT( "tags" ) ) );
+		OutTags.Append( Values.FindRef( TEXT( "keywords" ) ) );
+	}
+}
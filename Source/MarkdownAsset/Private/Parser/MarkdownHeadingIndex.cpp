@@ -0,0 +1,493 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Parser/MarkdownHeadingIndex.h"
+
+#include "Algo/AllOf.h"
+#include "Internationalization/Text.h"
+#include "MarkdownParserInternal.h"
+#include "MarkdownScan.h"
+#include "Parser/MarkdownDocument.h"
+#include "Parser/MarkdownParser.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace MarkdownHeadingIndex
+{
+	using namespace MarkdownParser;
+
+	static int32 CountRun( const TCHAR* Data, int32 Pos, const int32 End, const TCHAR C )
+	{
+		const int32 Start = Pos;
+
+		while( Pos < End && Data[ Pos ] == C )
+		{
+			++Pos;
+		}
+
+		return Pos - Start;
+	}
+
+	static bool IsBlankFrom( const TCHAR* Data, int32 Pos, const int32 End )
+	{
+		while( Pos < End && IsSpaceOrTab( Data[ Pos ] ) )
+		{
+			++Pos;
+		}
+
+		return Pos == End;
+	}
+
+	static bool IsThematicBreak( const TCHAR* Data, int32 Pos, const int32 End )
+	{
+		const TCHAR C = Data[ Pos ];
+		int32 Count   = 0;
+
+		if( C != TEXT( '-' ) && C != TEXT( '*' ) && C != TEXT( '_' ) )
+		{
+			return false;
+		}
+
+		for( ; Pos < End; ++Pos )
+		{
+			if( Data[ Pos ] == C )
+			{
+				++Count;
+			}
+			else if( !IsSpaceOrTab( Data[ Pos ] ) )
+			{
+				return false;
+			}
+		}
+
+		return Count >= 3;
+	}
+
+	static bool IsListMarker( const TCHAR* Data, int32 Pos, const int32 End )
+	{
+		const TCHAR C = Data[ Pos ];
+
+		if( C == TEXT( '-' ) || C == TEXT( '+' ) || C == TEXT( '*' ) )
+		{
+			return Pos + 1 == End || IsSpaceOrTab( Data[ Pos + 1 ] );
+		}
+
+		const int32 Digits = [ & ]{ int32 N = 0; while( Pos + N < End && IsAsciiDigit( Data[ Pos + N ] ) ) { ++N; } return N; }();
+
+		if( Digits == 0 || Digits > 9 || Pos + Digits == End )
+		{
+			return false;
+		}
+
+		const int32 After = Pos + Digits;
+		return ( Data[ After ] == TEXT( '.' ) || Data[ After ] == TEXT( ')' ) ) && ( After + 1 == End || IsSpaceOrTab( Data[ After + 1 ] ) );
+	}
+
+	static FStringView Trim( const TCHAR* Data, int32 Start, int32 End )
+	{
+		while( Start < End && IsSpaceOrTab( Data[ Start ] ) )
+		{
+			++Start;
+		}
+
+		while( End > Start && IsSpaceOrTab( Data[ End - 1 ] ) )
+		{
+			--End;
+		}
+
+		return FStringView( Data + Start, End - Start );
+	}
+
+	/**
+	 * Walks the text a line at a time and stops on each heading. Containers only need to be tracked far enough to
+	 * know that a line is not the start of a top level paragraph, since that is all an underline needs.
+	 */
+	class FScanner
+	{
+	public:
+
+		FScanner( const FStringView InText, const int32 InPos )
+			: Text( InText )
+			, Pos( InPos )
+		{
+		}
+
+		bool Next( FMarkdownHeading& Out );
+
+	private:
+
+		void Reset()
+		{
+			ParagraphStart = INDEX_NONE;
+			bInContainer   = false;
+		}
+
+		FStringView Text;
+		int32 Pos;
+
+		int32 ParagraphStart = INDEX_NONE;
+		bool bInContainer    = false; // a quote, list item or html block, until the next blank line
+		bool bInFence        = false;
+		TCHAR FenceChar      = 0;
+		int32 FenceLength    = 0;
+	};
+
+	bool FScanner::Next( FMarkdownHeading& Out )
+	{
+		const TCHAR* Data = Text.GetData();
+		const int32 Len   = Text.Len();
+
+		while( Pos < Len )
+		{
+			const int32 LineStart = Pos;
+			const int32 NewLine   = FindChar( Data, Pos, Len, TEXT( '\n' ) );
+			const int32 LineNext  = NewLine < Len ? NewLine + 1 : Len;
+			const int32 LineEnd   = NewLine > LineStart && Data[ NewLine - 1 ] == TEXT( '\r' ) ? NewLine - 1 : NewLine;
+
+			Pos = LineNext;
+
+			int32 Indent = 0;
+			int32 P      = LineStart;
+
+			while( P < LineEnd && IsSpaceOrTab( Data[ P ] ) )
+			{
+				Indent += Data[ P ] == TEXT( '\t' ) ? 4 - Indent % 4 : 1;
+				++P;
+			}
+
+			if( bInFence )
+			{
+				if( Indent < 4 && P < LineEnd && Data[ P ] == FenceChar )
+				{
+					const int32 Run = CountRun( Data, P, LineEnd, FenceChar );
+					bInFence = !( Run >= FenceLength && IsBlankFrom( Data, P + Run, LineEnd ) );
+				}
+
+				continue;
+			}
+
+			if( P == LineEnd )
+			{
+				Reset();
+				continue;
+			}
+
+			// indented code, or a paragraph carrying on, neither changes anything
+			if( Indent >= 4 )
+			{
+				continue;
+			}
+
+			const TCHAR C = Data[ P ];
+
+			if( C == TEXT( '`' ) || C == TEXT( '~' ) )
+			{
+				const int32 Run = CountRun( Data, P, LineEnd, C );
+
+				if( Run >= 3 && ( C == TEXT( '~' ) || FindChar( Data, P + Run, LineEnd, TEXT( '`' ) ) == LineEnd ) )
+				{
+					Reset();
+					bInFence    = true;
+					FenceChar   = C;
+					FenceLength = Run;
+					continue;
+				}
+			}
+
+			if( C == TEXT( '#' ) )
+			{
+				const int32 Run = CountRun( Data, P, LineEnd, C );
+
+				if( Run <= 6 && ( P + Run == LineEnd || IsSpaceOrTab( Data[ P + Run ] ) ) )
+				{
+					// drop the optional closing #s, they need a space before them unless they are all there is
+					int32 End = LineEnd;
+					while( End > P + Run && IsSpaceOrTab( Data[ End - 1 ] ) ) { --End; }
+					int32 Close = End;
+					while( Close > P + Run && Data[ Close - 1 ] == TEXT( '#' ) ) { --Close; }
+					if( Close == P + Run || IsSpaceOrTab( Data[ Close - 1 ] ) ) { End = Close; }
+
+					Out.Level         = Run;
+					Out.Title         = FString( Trim( Data, P + Run, End ) );
+					Out.Offset        = LineStart;
+					Out.HeadingLength = LineNext - LineStart;
+
+					Reset();
+					return true;
+				}
+			}
+
+			if( ( C == TEXT( '=' ) || C == TEXT( '-' ) ) && ParagraphStart != INDEX_NONE && IsBlankFrom( Data, P + CountRun( Data, P, LineEnd, C ), LineEnd ) )
+			{
+				FString Title;
+
+				for( int32 Line = ParagraphStart; Line < LineStart; )
+				{
+					const int32 Next = FindChar( Data, Line, LineStart, TEXT( '\n' ) );
+					const int32 End  = Next > Line && Data[ Next - 1 ] == TEXT( '\r' ) ? Next - 1 : Next;
+
+					const FStringView Part = Trim( Data, Line, End );
+					if( !Title.IsEmpty() ) { Title.AppendChar( TEXT( ' ' ) ); }
+					Title.Append( Part.GetData(), Part.Len() );
+
+					Line = Next + 1;
+				}
+
+				Out.Level         = C == TEXT( '=' ) ? 1 : 2;
+				Out.Title         = MoveTemp( Title );
+				Out.Offset        = ParagraphStart;
+				Out.HeadingLength = LineNext - ParagraphStart;
+
+				Reset();
+				return true;
+			}
+
+			if( IsThematicBreak( Data, P, LineEnd ) )
+			{
+				Reset();
+				continue;
+			}
+
+			if( C == TEXT( '>' ) || C == TEXT( '<' ) || IsListMarker( Data, P, LineEnd ) )
+			{
+				ParagraphStart = INDEX_NONE;
+				bInContainer   = true;
+				continue;
+			}
+
+			if( ParagraphStart == INDEX_NONE && !bInContainer )
+			{
+				ParagraphStart = LineStart;
+			}
+		}
+
+		return false;
+	}
+
+	// markdown-it-anchor slugs the text the heading renders to, the text and code in it, so the markup and link
+	// destinations are left out. Most headings have no markup and are used as they are.
+	static FString GetRenderedText( const FStringView Title )
+	{
+		bool bPlain = true;
+
+		for( const TCHAR C : Title )
+		{
+			if( C == TEXT( '\\' ) || C == TEXT( '`' ) || C == TEXT( '*' ) || C == TEXT( '_' ) || C == TEXT( '~' ) || C == TEXT( '[' ) || C == TEXT( '!' ) || C == TEXT( '<' ) || C == TEXT( '&' ) )
+			{
+				bPlain = false;
+				break;
+			}
+		}
+
+		if( bPlain )
+		{
+			return FString( Title );
+		}
+
+		FString Source = TEXT( "# " );
+		Source.Append( Title.GetData(), Title.Len() );
+
+		const FMarkdownDocument Document = FMarkdownParser::Parse( Source );
+		FString Text;
+
+		Document.ForEachDescendant( FMarkdownDocument::Root, [ & ]( const int32 Index )
+		{
+			const EMarkdownNodeType Type = Document[ Index ].Type;
+
+			// the viewer has html turned off, so tags are shown as text
+			if( Type != EMarkdownNodeType::Text && Type != EMarkdownNodeType::Code && Type != EMarkdownNodeType::Html )
+			{
+				return;
+			}
+
+			// image descriptions are not part of it
+			for( int32 Parent = Document[ Index ].Parent; Parent != INDEX_NONE; Parent = Document[ Parent ].Parent )
+			{
+				if( Document[ Parent ].Type == EMarkdownNodeType::Image )
+				{
+					return;
+				}
+			}
+
+			Text.Append( Document.GetLiteral( Index ) );
+		});
+
+		return Text;
+	}
+
+	// encodeURIComponent, everything but letters, digits and - _ . ! ~ * ' ( ) is percent encoded as utf-8
+	static void AppendUriComponent( const FStringView Text, FString& Out )
+	{
+		const FTCHARToUTF8 Utf8( Text.GetData(), Text.Len() );
+
+		for( int32 Index = 0; Index < Utf8.Length(); ++Index )
+		{
+			const uint8 Byte = static_cast<uint8>( Utf8.Get()[ Index ] );
+
+			switch( Byte )
+			{
+				case '-': case '_': case '.': case '!': case '~': case '*': case '\'': case '(': case ')':
+					Out.AppendChar( static_cast<TCHAR>( Byte ) );
+					break;
+
+				default:
+					if( IsAsciiAlnum( static_cast<TCHAR>( Byte ) ) )
+					{
+						Out.AppendChar( static_cast<TCHAR>( Byte ) );
+					}
+					else
+					{
+						Out.Appendf( TEXT( "%%%02X" ), Byte );
+					}
+					break;
+			}
+		}
+	}
+
+	/** section ranges and slugs depend on all the headings, so are redone after every change */
+	static void Finish( const FStringView Text, TArray<FMarkdownHeading>& Headings )
+	{
+		TArray<int32, TInlineAllocator<8>> Open;
+
+		for( int32 Index = 0; Index < Headings.Num(); ++Index )
+		{
+			FMarkdownHeading& Heading = Headings[ Index ];
+
+			while( Open.Num() > 0 && Headings[ Open.Last() ].Level >= Heading.Level )
+			{
+				FMarkdownHeading& Parent = Headings[ Open.Pop() ];
+				Parent.SectionLength = Heading.Offset - Parent.Offset;
+			}
+
+			Open.Add( Index );
+		}
+
+		for( const int32 Index : Open )
+		{
+			Headings[ Index ].SectionLength = Text.Len() - Headings[ Index ].Offset;
+		}
+
+		// markdown-it-anchor's uniqueSlug, a repeat gets the first of -1, -2 and so on that isn't already taken
+		TSet<FString> Taken;
+
+		for( FMarkdownHeading& Heading : Headings )
+		{
+			const FString Slug = FMarkdownHeadingIndex::MakeSlug( Heading.Title );
+			FString Unique = Slug;
+
+			for( int32 Count = 1; Taken.Contains( Unique ); ++Count )
+			{
+				Unique = FString::Printf( TEXT( "%s-%d" ), *Slug, Count );
+			}
+
+			Taken.Add( Unique );
+			Heading.Slug = MoveTemp( Unique );
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownHeadingIndex::Build( const FStringView Text, TArray<FMarkdownHeading>& OutHeadings )
+{
+	OutHeadings.Reset();
+
+	MarkdownHeadingIndex::FScanner Scanner( Text, 0 );
+	FMarkdownHeading Heading;
+
+	while( Scanner.Next( Heading ) )
+	{
+		OutHeadings.Add( MoveTemp( Heading ) );
+	}
+
+	MarkdownHeadingIndex::Finish( Text, OutHeadings );
+}
+
+void FMarkdownHeadingIndex::Update( const FStringView Text, const int32 ChangeOffset, const int32 RemovedLength, const int32 InsertedLength, TArray<FMarkdownHeading>& InOutHeadings )
+{
+	const int32 Delta        = InsertedLength - RemovedLength;
+	const int32 OldChangeEnd = ChangeOffset + RemovedLength;
+	const int32 NewChangeEnd = ChangeOffset + InsertedLength;
+
+	// headings that end before the change are untouched, and scanning can pick up again right after the last of them
+	int32 Kept = 0;
+	while( Kept < InOutHeadings.Num() && InOutHeadings[ Kept ].GetBodyOffset() < ChangeOffset )
+	{
+		++Kept;
+	}
+
+	TArray<FMarkdownHeading> Old( InOutHeadings.GetData() + Kept, InOutHeadings.Num() - Kept );
+	InOutHeadings.SetNum( Kept );
+
+	const int32 Resume = Kept > 0 ? InOutHeadings.Last().GetBodyOffset() : 0;
+	MarkdownHeadingIndex::FScanner Scanner( Text, Resume );
+	FMarkdownHeading Heading;
+	int32 OldIndex = 0;
+
+	while( Scanner.Next( Heading ) )
+	{
+		// past the change, a heading where there was one before means everything after it is the same
+		if( Heading.Offset >= NewChangeEnd )
+		{
+			const int32 OldOffset = Heading.Offset - Delta;
+
+			while( OldIndex < Old.Num() && Old[ OldIndex ].Offset < OldOffset )
+			{
+				++OldIndex;
+			}
+
+			if( OldIndex < Old.Num() && Old[ OldIndex ].Offset == OldOffset && Old[ OldIndex ].HeadingLength == Heading.HeadingLength )
+			{
+				for( ; OldIndex < Old.Num(); ++OldIndex )
+				{
+					FMarkdownHeading& Same = InOutHeadings.Add_GetRef( MoveTemp( Old[ OldIndex ] ) );
+					Same.Offset += Delta;
+				}
+
+				break;
+			}
+		}
+
+		InOutHeadings.Add( MoveTemp( Heading ) );
+	}
+
+	MarkdownHeadingIndex::Finish( Text, InOutHeadings );
+}
+
+FString FMarkdownHeadingIndex::MakeSlug( const FStringView Title )
+{
+	using namespace MarkdownHeadingIndex;
+
+	// the viewer's anchors come from markdown-it-anchor's default slugify, which is
+	// encodeURIComponent( String( s ).trim().toLowerCase().replace( /\s+/g, '-' ) )
+	FString Text = GetRenderedText( Title ).TrimStartAndEnd();
+
+	// FString only lowercases ASCII where toLowerCase does all of Unicode, which takes ICU (through FText)
+	const bool bAscii = Algo::AllOf( Text, []( const TCHAR C ) { return C < 128; } );
+	Text = bAscii ? Text.ToLower() : FText::FromString( MoveTemp( Text ) ).ToLower().ToString();
+
+	FString Dashed;
+	Dashed.Reserve( Text.Len() );
+
+	for( int32 Index = 0; Index < Text.Len(); ++Index )
+	{
+		if( FChar::IsWhitespace( Text[ Index ] ) )
+		{
+			Dashed.AppendChar( TEXT( '-' ) );
+
+			while( Index + 1 < Text.Len() && FChar::IsWhitespace( Text[ Index + 1 ] ) )
+			{
+				++Index;
+			}
+		}
+		else
+		{
+			Dashed.AppendChar( Text[ Index ] );
+		}
+	}
+
+	FString Slug;
+	Slug.Reserve( Dashed.Len() );
+	AppendUriComponent( Dashed, Slug );
+
+	return Slug;
+}
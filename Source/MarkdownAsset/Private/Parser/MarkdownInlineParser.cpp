@@ -0,0 +1,1690 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownParserInternal.h"
+#include "MarkdownScan.h"
+
+#include "String/Find.h"
+
+namespace MarkdownParser
+{
+	//-----------------------------------------------------------------------------------------------------------------
+	// helpers
+
+	int32 ToSourceOffset( const TArrayView<const FSourceSegment> Segments, const int32 ContentOffset )
+	{
+		if( Segments.Num() == 0 )
+		{
+			return ContentOffset;
+		}
+
+		// last segment that starts at or before the offset
+		int32 Lo = 0;
+		int32 Hi = Segments.Num() - 1;
+
+		while( Lo < Hi )
+		{
+			const int32 Mid = ( Lo + Hi + 1 ) / 2;
+
+			if( Segments[ Mid ].ContentOffset <= ContentOffset )
+			{
+				Lo = Mid;
+			}
+			else
+			{
+				Hi = Mid - 1;
+			}
+		}
+
+		return Segments[ Lo ].SourceOffset + ( ContentOffset - Segments[ Lo ].ContentOffset );
+	}
+
+	static void AppendCodepoint( FString& Out, uint32 Codepoint )
+	{
+		if( Codepoint == 0 || Codepoint > 0x10FFFF || ( Codepoint >= 0xD800 && Codepoint <= 0xDFFF ) )
+		{
+			Codepoint = 0xFFFD;
+		}
+
+		if constexpr( sizeof( TCHAR ) == 2 )
+		{
+			if( Codepoint >= 0x10000 )
+			{
+				Codepoint -= 0x10000;
+				Out.AppendChar( TCHAR( 0xD800 + ( Codepoint >> 10 ) ) );
+				Out.AppendChar( TCHAR( 0xDC00 + ( Codepoint & 0x3FF ) ) );
+				return;
+			}
+		}
+
+		Out.AppendChar( TCHAR( Codepoint ) );
+	}
+
+	static void SkipWhitespace( const FStringView Text, int32& Pos )
+	{
+		while( Pos < Text.Len() && IsWhitespace( Text[ Pos ] ) )
+		{
+			++Pos;
+		}
+	}
+
+	static void SkipSpacesAndTabs( const FStringView Text, int32& Pos )
+	{
+		while( Pos < Text.Len() && IsSpaceOrTab( Text[ Pos ] ) )
+		{
+			++Pos;
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// entities, only the common named ones, anything else is left as it is
+
+	struct FNamedEntity
+	{
+		const TCHAR* Name;
+		uint32 Codepoint;
+	};
+
+	static const FNamedEntity NamedEntities[] =
+	{
+		{ TEXT( "amp" ),    '&' },    { TEXT( "lt" ),     '<' },    { TEXT( "gt" ),     '>' },    { TEXT( "quot" ),   '"' },
+		{ TEXT( "apos" ),   '\'' },   { TEXT( "nbsp" ),   0x00A0 }, { TEXT( "copy" ),   0x00A9 }, { TEXT( "reg" ),    0x00AE },
+		{ TEXT( "trade" ),  0x2122 }, { TEXT( "hellip" ), 0x2026 }, { TEXT( "mdash" ),  0x2014 }, { TEXT( "ndash" ),  0x2013 },
+		{ TEXT( "laquo" ),  0x00AB }, { TEXT( "raquo" ),  0x00BB }, { TEXT( "lsquo" ),  0x2018 }, { TEXT( "rsquo" ),  0x2019 },
+		{ TEXT( "ldquo" ),  0x201C }, { TEXT( "rdquo" ),  0x201D }, { TEXT( "bull" ),   0x2022 }, { TEXT( "middot" ), 0x00B7 },
+		{ TEXT( "times" ),  0x00D7 }, { TEXT( "divide" ), 0x00F7 }, { TEXT( "deg" ),    0x00B0 }, { TEXT( "plusmn" ), 0x00B1 },
+		{ TEXT( "para" ),   0x00B6 }, { TEXT( "sect" ),   0x00A7 }, { TEXT( "euro" ),   0x20AC }, { TEXT( "pound" ),  0x00A3 },
+		{ TEXT( "yen" ),    0x00A5 }, { TEXT( "cent" ),   0x00A2 }, { TEXT( "larr" ),   0x2190 }, { TEXT( "rarr" ),   0x2192 },
+		{ TEXT( "uarr" ),   0x2191 }, { TEXT( "darr" ),   0x2193 }, { TEXT( "harr" ),   0x2194 }, { TEXT( "le" ),     0x2264 },
+		{ TEXT( "ge" ),     0x2265 }, { TEXT( "ne" ),     0x2260 }, { TEXT( "shy" ),    0x00AD }, { TEXT( "check" ),  0x2713 },
+	};
+
+	bool DecodeEntity( const FStringView Text, int32& Pos, FString& Out )
+	{
+		int32 Index = Pos + 1;
+
+		if( Index < Text.Len() && Text[ Index ] == TEXT( '#' ) )
+		{
+			++Index;
+
+			const bool bHex  = Index < Text.Len() && ( Text[ Index ] == TEXT( 'x' ) || Text[ Index ] == TEXT( 'X' ) );
+			const int32 Max  = bHex ? 6 : 7;
+			uint32 Codepoint = 0;
+			int32 Digits     = 0;
+
+			if( bHex )
+			{
+				++Index;
+			}
+
+			for( ; Index < Text.Len() && Digits < Max; ++Index, ++Digits )
+			{
+				const TCHAR C = Text[ Index ];
+
+				if( IsAsciiDigit( C ) )
+				{
+					Codepoint = Codepoint * ( bHex ? 16 : 10 ) + ( C - TEXT( '0' ) );
+				}
+				else if( bHex && C >= TEXT( 'a' ) && C <= TEXT( 'f' ) )
+				{
+					Codepoint = Codepoint * 16 + ( C - TEXT( 'a' ) + 10 );
+				}
+				else if( bHex && C >= TEXT( 'A' ) && C <= TEXT( 'F' ) )
+				{
+					Codepoint = Codepoint * 16 + ( C - TEXT( 'A' ) + 10 );
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			if( Digits == 0 || Index >= Text.Len() || Text[ Index ] != TEXT( ';' ) )
+			{
+				return false;
+			}
+
+			AppendCodepoint( Out, Codepoint );
+			Pos = Index + 1;
+			return true;
+		}
+
+		const int32 NameStart = Index;
+
+		while( Index < Text.Len() && Index - NameStart < 32 && IsAsciiAlnum( Text[ Index ] ) )
+		{
+			++Index;
+		}
+
+		if( Index == NameStart || Index >= Text.Len() || Text[ Index ] != TEXT( ';' ) )
+		{
+			return false;
+		}
+
+		const FStringView Name = Text.Mid( NameStart, Index - NameStart );
+
+		for( const FNamedEntity& Entity : NamedEntities )
+		{
+			if( Name.Equals( Entity.Name, ESearchCase::CaseSensitive ) )
+			{
+				AppendCodepoint( Out, Entity.Codepoint );
+				Pos = Index + 1;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void AppendUnescaped( const FStringView Text, FString& Out )
+	{
+		for( int32 Index = 0; Index < Text.Len(); )
+		{
+			const TCHAR C = Text[ Index ];
+
+			if( C == TEXT( '\\' ) && Index + 1 < Text.Len() && IsAsciiPunctuation( Text[ Index + 1 ] ) )
+			{
+				Out.AppendChar( Text[ Index + 1 ] );
+				Index += 2;
+			}
+			else if( C == TEXT( '&' ) && DecodeEntity( Text, Index, Out ) )
+			{
+				// Index moved past the entity
+			}
+			else
+			{
+				Out.AppendChar( C );
+				++Index;
+			}
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// links
+
+	FString NormalizeLabel( const FStringView Label )
+	{
+		FString Result;
+		Result.Reserve( Label.Len() );
+
+		bool bSpace = false;
+
+		for( const TCHAR C : Label )
+		{
+			if( IsWhitespace( C ) )
+			{
+				bSpace = !Result.IsEmpty();
+				continue;
+			}
+
+			if( bSpace )
+			{
+				Result.AppendChar( TEXT( ' ' ) );
+				bSpace = false;
+			}
+
+			Result.AppendChar( FChar::ToLower( C ) );
+		}
+
+		return Result;
+	}
+
+	int32 ScanLinkLabel( const FStringView Text, const int32 Pos )
+	{
+		if( Pos >= Text.Len() || Text[ Pos ] != TEXT( '[' ) )
+		{
+			return INDEX_NONE;
+		}
+
+		for( int32 Index = Pos + 1; Index < Text.Len(); ++Index )
+		{
+			const TCHAR C = Text[ Index ];
+
+			if( C == TEXT( '\\' ) && Index + 1 < Text.Len() && IsAsciiPunctuation( Text[ Index + 1 ] ) )
+			{
+				++Index;
+			}
+			else if( C == TEXT( '[' ) )
+			{
+				return INDEX_NONE;
+			}
+			else if( C == TEXT( ']' ) )
+			{
+				return Index - Pos - 1 <= 999 ? Index + 1 : INDEX_NONE;
+			}
+		}
+
+		return INDEX_NONE;
+	}
+
+	bool ParseLinkDestination( const FStringView Text, int32& Pos, FString& OutDestination )
+	{
+		if( Pos >= Text.Len() )
+		{
+			return false;
+		}
+
+		if( Text[ Pos ] == TEXT( '<' ) )
+		{
+			for( int32 Index = Pos + 1; Index < Text.Len(); ++Index )
+			{
+				const TCHAR C = Text[ Index ];
+
+				if( C == TEXT( '\\' ) && Index + 1 < Text.Len() && IsAsciiPunctuation( Text[ Index + 1 ] ) )
+				{
+					++Index;
+				}
+				else if( C == TEXT( '>' ) )
+				{
+					AppendUnescaped( Text.Mid( Pos + 1, Index - Pos - 1 ), OutDestination );
+					Pos = Index + 1;
+					return true;
+				}
+				else if( C == TEXT( '<' ) || C == TEXT( '\n' ) )
+				{
+					return false;
+				}
+			}
+
+			return false;
+		}
+
+		int32 Index = Pos;
+		int32 Depth = 0;
+
+		while( Index < Text.Len() )
+		{
+			const TCHAR C = Text[ Index ];
+
+			if( C == TEXT( '\\' ) && Index + 1 < Text.Len() && IsAsciiPunctuation( Text[ Index + 1 ] ) )
+			{
+				Index += 2;
+			}
+			else if( C == TEXT( '(' ) )
+			{
+				if( ++Depth > 32 )
+				{
+					return false;
+				}
+				++Index;
+			}
+			else if( C == TEXT( ')' ) )
+			{
+				if( Depth == 0 )
+				{
+					break;
+				}
+				--Depth;
+				++Index;
+			}
+			else if( C <= TEXT( ' ' ) || IsWhitespace( C ) )
+			{
+				break;
+			}
+			else
+			{
+				++Index;
+			}
+		}
+
+		if( Index == Pos || Depth != 0 )
+		{
+			return false;
+		}
+
+		AppendUnescaped( Text.Mid( Pos, Index - Pos ), OutDestination );
+		Pos = Index;
+		return true;
+	}
+
+	bool ParseLinkTitle( const FStringView Text, int32& Pos, FString& OutTitle )
+	{
+		if( Pos >= Text.Len() )
+		{
+			return false;
+		}
+
+		const TCHAR Open  = Text[ Pos ];
+		const TCHAR Close = Open == TEXT( '(' ) ? TEXT( ')' ) : Open;
+
+		if( Open != TEXT( '"' ) && Open != TEXT( '\'' ) && Open != TEXT( '(' ) )
+		{
+			return false;
+		}
+
+		for( int32 Index = Pos + 1; Index < Text.Len(); ++Index )
+		{
+			const TCHAR C = Text[ Index ];
+
+			if( C == TEXT( '\\' ) && Index + 1 < Text.Len() && IsAsciiPunctuation( Text[ Index + 1 ] ) )
+			{
+				++Index;
+			}
+			else if( C == Close )
+			{
+				AppendUnescaped( Text.Mid( Pos + 1, Index - Pos - 1 ), OutTitle );
+				Pos = Index + 1;
+				return true;
+			}
+			else if( Open == TEXT( '(' ) && C == TEXT( '(' ) )
+			{
+				return false;
+			}
+		}
+
+		return false;
+	}
+
+	int32 ParseLinkReferences( const FStringView Content, FLinkReferenceMap& References )
+	{
+		int32 Pos = 0;
+
+		while( Pos < Content.Len() && Content[ Pos ] == TEXT( '[' ) )
+		{
+			const int32 LabelEnd = ScanLinkLabel( Content, Pos );
+
+			if( LabelEnd == INDEX_NONE || LabelEnd >= Content.Len() || Content[ LabelEnd ] != TEXT( ':' ) )
+			{
+				break;
+			}
+
+			const FStringView Label = Content.Mid( Pos + 1, LabelEnd - Pos - 2 );
+
+			if( IsBlank( Label ) )
+			{
+				break;
+			}
+
+			int32 Index = LabelEnd + 1;
+			SkipWhitespace( Content, Index );
+
+			FString Destination;
+			if( !ParseLinkDestination( Content, Index, Destination ) )
+			{
+				break;
+			}
+
+			// the title is optional and has to be separated from the destination by whitespace
+			FString Title;
+			int32 End        = INDEX_NONE;
+			int32 TitleStart = Index;
+
+			SkipWhitespace( Content, TitleStart );
+
+			if( TitleStart > Index && ParseLinkTitle( Content, TitleStart, Title ) )
+			{
+				SkipSpacesAndTabs( Content, TitleStart );
+
+				if( TitleStart >= Content.Len() || Content[ TitleStart ] == TEXT( '\n' ) )
+				{
+					End = TitleStart;
+				}
+			}
+
+			// no title (or junk after it), then the destination has to end the line
+			if( End == INDEX_NONE )
+			{
+				Title.Reset();
+				SkipSpacesAndTabs( Content, Index );
+
+				if( Index < Content.Len() && Content[ Index ] != TEXT( '\n' ) )
+				{
+					break;
+				}
+
+				End = Index;
+			}
+
+			FString Key = NormalizeLabel( Label );
+
+			if( !References.Contains( Key ) )
+			{
+				References.Add( MoveTemp( Key ), FLinkReference{ MoveTemp( Destination ), MoveTemp( Title ) } );
+			}
+
+			Pos = FMath::Min( End + 1, Content.Len() );
+		}
+
+		return Pos;
+	}
+
+	int32 ScanHtmlTag( const FStringView Text, const int32 Pos )
+	{
+		auto FindFrom = [&Text]( const int32 From, const TCHAR* Terminator ) -> int32
+		{
+			const int32 Found = UE::String::FindFirst( Text.RightChop( From ), Terminator );
+			return Found == INDEX_NONE ? INDEX_NONE : From + Found + FCString::Strlen( Terminator );
+		};
+
+		int32 Index = Pos + 1;
+
+		if( Index >= Text.Len() )
+		{
+			return 0;
+		}
+
+		int32 End = INDEX_NONE;
+
+		if( StartsWithNoCase( Text, Index, TEXTVIEW( "!--" ) ) )
+		{
+			End = FindFrom( Index + 3, TEXT( "-->" ) );
+		}
+		else if( Text[ Index ] == TEXT( '?' ) )
+		{
+			End = FindFrom( Index + 1, TEXT( "?>" ) );
+		}
+		else if( StartsWithNoCase( Text, Index, TEXTVIEW( "![CDATA[" ) ) )
+		{
+			End = FindFrom( Index + 8, TEXT( "]]>" ) );
+		}
+		else if( Text[ Index ] == TEXT( '!' ) && Index + 1 < Text.Len() && IsAsciiAlpha( Text[ Index + 1 ] ) )
+		{
+			End = FindFrom( Index + 1, TEXT( ">" ) );
+		}
+		else
+		{
+			const bool bClosing = Text[ Index ] == TEXT( '/' );
+
+			if( bClosing )
+			{
+				++Index;
+			}
+
+			if( Index >= Text.Len() || !IsAsciiAlpha( Text[ Index ] ) )
+			{
+				return 0;
+			}
+
+			while( Index < Text.Len() && ( IsAsciiAlnum( Text[ Index ] ) || Text[ Index ] == TEXT( '-' ) ) )
+			{
+				++Index;
+			}
+
+			if( bClosing )
+			{
+				SkipWhitespace( Text, Index );
+				return Index < Text.Len() && Text[ Index ] == TEXT( '>' ) ? Index + 1 - Pos : 0;
+			}
+
+			// attributes
+			for( ;; )
+			{
+				const int32 BeforeSpace = Index;
+				SkipWhitespace( Text, Index );
+
+				if( Index >= Text.Len() )
+				{
+					return 0;
+				}
+
+				if( Text[ Index ] == TEXT( '>' ) )
+				{
+					return Index + 1 - Pos;
+				}
+
+				if( Text[ Index ] == TEXT( '/' ) )
+				{
+					return Index + 1 < Text.Len() && Text[ Index + 1 ] == TEXT( '>' ) ? Index + 2 - Pos : 0;
+				}
+
+				const TCHAR First = Text[ Index ];
+				if( Index == BeforeSpace || !( IsAsciiAlpha( First ) || First == TEXT( '_' ) || First == TEXT( ':' ) ) )
+				{
+					return 0;
+				}
+
+				while( Index < Text.Len() && ( IsAsciiAlnum( Text[ Index ] ) || Text[ Index ] == TEXT( '_' ) || Text[ Index ] == TEXT( '.' ) || Text[ Index ] == TEXT( ':' ) || Text[ Index ] == TEXT( '-' ) ) )
+				{
+					++Index;
+				}
+
+				int32 ValueStart = Index;
+				SkipWhitespace( Text, ValueStart );
+
+				if( ValueStart >= Text.Len() || Text[ ValueStart ] != TEXT( '=' ) )
+				{
+					continue;
+				}
+
+				Index = ValueStart + 1;
+				SkipWhitespace( Text, Index );
+
+				if( Index >= Text.Len() )
+				{
+					return 0;
+				}
+
+				const TCHAR Quote = Text[ Index ];
+
+				if( Quote == TEXT( '"' ) || Quote == TEXT( '\'' ) )
+				{
+					const int32 Close = UE::String::FindFirstChar( Text.RightChop( Index + 1 ), Quote );
+
+					if( Close == INDEX_NONE )
+					{
+						return 0;
+					}
+
+					Index += Close + 2;
+				}
+				else
+				{
+					const int32 UnquotedStart = Index;
+
+					while( Index < Text.Len() && !IsWhitespace( Text[ Index ] ) && FCString::Strchr( TEXT( "\"'=<>`" ), Text[ Index ] ) == nullptr )
+					{
+						++Index;
+					}
+
+					if( Index == UnquotedStart )
+					{
+						return 0;
+					}
+				}
+			}
+		}
+
+		return End == INDEX_NONE ? 0 : End - Pos;
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// inline parser
+
+	FInlineParser::FInlineParser( FMarkdownDocument& InDocument, const FLinkReferenceMap& InReferences, const FMarkdownParserOptions& InOptions )
+		: Document( InDocument )
+		, References( InReferences )
+		, Options( InOptions )
+	{
+	}
+
+	void FInlineParser::Parse( const FStringView Content, const TArrayView<const FSourceSegment> Segments, const int32 Parent )
+	{
+		Subject   = Content;
+		Map       = Segments;
+		Pos       = 0;
+		TextStart = 0;
+
+		Inlines.Reset();
+		Delimiters.Reset();
+		Brackets.Reset();
+		LastDelimiter = INDEX_NONE;
+
+		// everything is added under a temporary root first, emphasis and links move nodes around as they are matched
+		AddInline( EMarkdownNodeType::Document, 0, Subject.Len() );
+
+		const int32 Len = Subject.Len();
+
+		while( Pos < Len )
+		{
+			// plain text is left pending and flushed by whatever comes next, so runs of it can be skipped in one go
+			Pos = FindInlineSpecial( Subject.GetData(), Pos, Len );
+
+			if( Pos == Len )
+			{
+				break;
+			}
+
+			const TCHAR C = Subject[ Pos ];
+
+			switch( C )
+			{
+				case TEXT( '\n' ):
+					HandleNewline();
+					break;
+
+				case TEXT( '\\' ):
+					HandleBackslash();
+					break;
+
+				case TEXT( '`' ):
+					HandleBackticks();
+					break;
+
+				case TEXT( '*' ):
+				case TEXT( '_' ):
+					HandleDelimiters( C );
+					break;
+
+				case TEXT( '~' ):
+					if( Options.bStrikethrough )
+					{
+						HandleDelimiters( C );
+					}
+					else
+					{
+						++Pos;
+					}
+					break;
+
+				case TEXT( '[' ):
+					HandleOpenBracket( false );
+					break;
+
+				case TEXT( '!' ):
+					if( Pos + 1 < Len && Subject[ Pos + 1 ] == TEXT( '[' ) )
+					{
+						HandleOpenBracket( true );
+					}
+					else
+					{
+						++Pos;
+					}
+					break;
+
+				case TEXT( ']' ):
+					HandleCloseBracket();
+					break;
+
+				case TEXT( '<' ):
+					if( !HandleAngleBracket() )
+					{
+						++Pos;
+					}
+					break;
+
+				case TEXT( '&' ):
+					HandleEntity();
+					break;
+
+				case TEXT( ':' ):
+				case TEXT( '.' ):
+					if( !HandleBareLink() )
+					{
+						++Pos;
+					}
+					break;
+
+				default:
+					++Pos;
+					break;
+			}
+		}
+
+		FlushText( Len );
+		ProcessEmphasis( INDEX_NONE );
+
+		Emit( Parent );
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// tree
+
+	int32 FInlineParser::AddInline( const EMarkdownNodeType Type, const int32 Start, const int32 End )
+	{
+		const int32 Index = Inlines.AddDefaulted();
+
+		FInline& Inline = Inlines[ Index ];
+		Inline.Type  = Type;
+		Inline.Start = Start;
+		Inline.End   = End;
+
+		if( Index != 0 )
+		{
+			AppendChild( 0, Index );
+		}
+
+		return Index;
+	}
+
+	int32 FInlineParser::AddText( const int32 Start, const int32 End )
+	{
+		return AddText( Subject.Mid( Start, End - Start ), Start, End );
+	}
+
+	int32 FInlineParser::AddText( const FStringView Text, const int32 Start, const int32 End )
+	{
+		const int32 Index = AddInline( EMarkdownNodeType::Text, Start, End );
+		Inlines[ Index ].Literal = Document.AddString( Text );
+		return Index;
+	}
+
+	void FInlineParser::AppendChild( const int32 Parent, const int32 Child )
+	{
+		FInline& Node = Inlines[ Child ];
+		Node.Parent = Parent;
+		Node.Next   = INDEX_NONE;
+		Node.Prev   = Inlines[ Parent ].LastChild;
+
+		if( Node.Prev != INDEX_NONE )
+		{
+			Inlines[ Node.Prev ].Next = Child;
+		}
+		else
+		{
+			Inlines[ Parent ].FirstChild = Child;
+		}
+
+		Inlines[ Parent ].LastChild = Child;
+	}
+
+	void FInlineParser::InsertAfter( const int32 Sibling, const int32 Node )
+	{
+		const int32 Parent = Inlines[ Sibling ].Parent;
+		const int32 Next   = Inlines[ Sibling ].Next;
+
+		Inlines[ Node ].Parent = Parent;
+		Inlines[ Node ].Prev   = Sibling;
+		Inlines[ Node ].Next   = Next;
+		Inlines[ Sibling ].Next = Node;
+
+		if( Next != INDEX_NONE )
+		{
+			Inlines[ Next ].Prev = Node;
+		}
+		else
+		{
+			Inlines[ Parent ].LastChild = Node;
+		}
+	}
+
+	void FInlineParser::Unlink( const int32 Node )
+	{
+		FInline& Inline = Inlines[ Node ];
+
+		if( Inline.Prev != INDEX_NONE )
+		{
+			Inlines[ Inline.Prev ].Next = Inline.Next;
+		}
+		else if( Inline.Parent != INDEX_NONE )
+		{
+			Inlines[ Inline.Parent ].FirstChild = Inline.Next;
+		}
+
+		if( Inline.Next != INDEX_NONE )
+		{
+			Inlines[ Inline.Next ].Prev = Inline.Prev;
+		}
+		else if( Inline.Parent != INDEX_NONE )
+		{
+			Inlines[ Inline.Parent ].LastChild = Inline.Prev;
+		}
+
+		Inline.Parent = INDEX_NONE;
+		Inline.Prev   = INDEX_NONE;
+		Inline.Next   = INDEX_NONE;
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// scanning, plain text is gathered from TextStart and only turned into a node when something else comes along
+
+	void FInlineParser::FlushText( const int32 End )
+	{
+		if( End > TextStart )
+		{
+			AddText( TextStart, End );
+		}
+
+		TextStart = End;
+	}
+
+	void FInlineParser::SkipSpaces()
+	{
+		SkipSpacesAndTabs( Subject, Pos );
+	}
+
+	void FInlineParser::HandleNewline()
+	{
+		// two or more spaces before the line break make it a hard break, either way they are not part of the text
+		int32 TextEnd = Pos;
+
+		while( TextEnd > TextStart && Subject[ TextEnd - 1 ] == TEXT( ' ' ) )
+		{
+			--TextEnd;
+		}
+
+		FlushText( TextEnd );
+		AddInline( Pos - TextEnd >= 2 ? EMarkdownNodeType::HardBreak : EMarkdownNodeType::SoftBreak, TextEnd, Pos + 1 );
+
+		++Pos;
+		SkipSpaces();
+		TextStart = Pos;
+	}
+
+	void FInlineParser::HandleBackslash()
+	{
+		const int32 Next = Pos + 1;
+
+		if( Next < Subject.Len() && Subject[ Next ] == TEXT( '\n' ) )
+		{
+			FlushText( Pos );
+			AddInline( EMarkdownNodeType::HardBreak, Pos, Next + 1 );
+			Pos = Next + 1;
+			SkipSpaces();
+			TextStart = Pos;
+		}
+		else if( Next < Subject.Len() && IsAsciiPunctuation( Subject[ Next ] ) )
+		{
+			FlushText( Pos );
+			AddText( Subject.Mid( Next, 1 ), Pos, Next + 1 );
+			Pos       = Next + 1;
+			TextStart = Pos;
+		}
+		else
+		{
+			++Pos;
+		}
+	}
+
+	void FInlineParser::HandleBackticks()
+	{
+		const int32 Len = Subject.Len();
+
+		int32 RunEnd = Pos;
+		while( RunEnd < Len && Subject[ RunEnd ] == TEXT( '`' ) )
+		{
+			++RunEnd;
+		}
+
+		const int32 RunLength = RunEnd - Pos;
+
+		// look for a closing run of exactly the same length
+		for( int32 Index = FindChar( Subject.GetData(), RunEnd, Len, TEXT( '`' ) ); Index < Len; Index = FindChar( Subject.GetData(), Index, Len, TEXT( '`' ) ) )
+		{
+
+			int32 CloseEnd = Index;
+			while( CloseEnd < Len && Subject[ CloseEnd ] == TEXT( '`' ) )
+			{
+				++CloseEnd;
+			}
+
+			if( CloseEnd - Index != RunLength )
+			{
+				Index = CloseEnd;
+				continue;
+			}
+
+			// line endings become spaces, and one space is stripped from each end if both have one
+			Scratch.Reset();
+			Scratch.Append( Subject.GetData() + RunEnd, Index - RunEnd );
+
+			for( TCHAR& C : Scratch )
+			{
+				if( C == TEXT( '\n' ) )
+				{
+					C = TEXT( ' ' );
+				}
+			}
+
+			if( Scratch.Len() >= 2 && Scratch[ 0 ] == TEXT( ' ' ) && Scratch[ Scratch.Len() - 1 ] == TEXT( ' ' ) && !IsBlank( Scratch ) )
+			{
+				Scratch.MidInline( 1, Scratch.Len() - 2 );
+			}
+
+			FlushText( Pos );
+
+			const int32 Code = AddInline( EMarkdownNodeType::Code, Pos, CloseEnd );
+			Inlines[ Code ].Literal = Document.AddString( Scratch );
+
+			Pos       = CloseEnd;
+			TextStart = Pos;
+			return;
+		}
+
+		// no match, the backticks are just text
+		Pos = RunEnd;
+	}
+
+	void FInlineParser::HandleDelimiters( const TCHAR C )
+	{
+		const int32 Len = Subject.Len();
+
+		int32 RunEnd = Pos;
+		while( RunEnd < Len && Subject[ RunEnd ] == C )
+		{
+			++RunEnd;
+		}
+
+		const int32 Count = RunEnd - Pos;
+
+		if( C == TEXT( '~' ) && Count > 2 )
+		{
+			Pos = RunEnd;
+			return;
+		}
+
+		const TCHAR Before = Pos > 0 ? Subject[ Pos - 1 ] : TEXT( '\n' );
+		const TCHAR After  = RunEnd < Len ? Subject[ RunEnd ] : TEXT( '\n' );
+
+		const bool bBeforeSpace = IsWhitespace( Before );
+		const bool bBeforePunct = IsPunctuation( Before );
+		const bool bAfterSpace  = IsWhitespace( After );
+		const bool bAfterPunct  = IsPunctuation( After );
+
+		const bool bLeftFlanking  = !bAfterSpace && ( !bAfterPunct || bBeforeSpace || bBeforePunct );
+		const bool bRightFlanking = !bBeforeSpace && ( !bBeforePunct || bAfterSpace || bAfterPunct );
+
+		bool bCanOpen  = bLeftFlanking;
+		bool bCanClose = bRightFlanking;
+
+		// intraword underscores do not count
+		if( C == TEXT( '_' ) )
+		{
+			bCanOpen  = bLeftFlanking && ( !bRightFlanking || bBeforePunct );
+			bCanClose = bRightFlanking && ( !bLeftFlanking || bAfterPunct );
+		}
+
+		FlushText( Pos );
+		const int32 Node = AddText( Pos, RunEnd );
+
+		Pos       = RunEnd;
+		TextStart = Pos;
+
+		if( bCanOpen || bCanClose )
+		{
+			const int32 Index = Delimiters.AddDefaulted();
+
+			FDelimiter& Delimiter = Delimiters[ Index ];
+			Delimiter.Node          = Node;
+			Delimiter.Char          = C;
+			Delimiter.Count         = Count;
+			Delimiter.OriginalCount = Count;
+			Delimiter.bCanOpen      = bCanOpen;
+			Delimiter.bCanClose     = bCanClose;
+			Delimiter.Prev          = LastDelimiter;
+
+			if( LastDelimiter != INDEX_NONE )
+			{
+				Delimiters[ LastDelimiter ].Next = Index;
+			}
+
+			LastDelimiter = Index;
+		}
+	}
+
+	void FInlineParser::HandleOpenBracket( const bool bImage )
+	{
+		const int32 Length = bImage ? 2 : 1;
+
+		FlushText( Pos );
+
+		if( Brackets.Num() > 0 )
+		{
+			Brackets.Last().bBracketAfter = true;
+		}
+
+		FBracket& Bracket = Brackets.AddDefaulted_GetRef();
+		Bracket.Node              = AddText( Pos, Pos + Length );
+		Bracket.PreviousDelimiter = LastDelimiter;
+		Bracket.Position          = Pos + Length;
+		Bracket.bImage            = bImage;
+
+		Pos      += Length;
+		TextStart = Pos;
+	}
+
+	void FInlineParser::HandleCloseBracket()
+	{
+		FlushText( Pos );
+
+		auto Literal = [this]()
+		{
+			AddText( Pos, Pos + 1 );
+			++Pos;
+			TextStart = Pos;
+		};
+
+		if( Brackets.Num() == 0 )
+		{
+			Literal();
+			return;
+		}
+
+		const FBracket Opener = Brackets.Last();
+
+		if( !Opener.bActive )
+		{
+			Brackets.Pop();
+			Literal();
+			return;
+		}
+
+		const int32 Len   = Subject.Len();
+		const int32 After = Pos + 1;
+
+		FString Destination;
+		FString Title;
+		int32 End = INDEX_NONE;
+
+		// inline link [text](destination "title")
+		if( After < Len && Subject[ After ] == TEXT( '(' ) )
+		{
+			int32 Index = After + 1;
+			SkipWhitespace( Subject, Index );
+
+			if( Index < Len && Subject[ Index ] == TEXT( ')' ) )
+			{
+				End = Index + 1;
+			}
+			else if( ParseLinkDestination( Subject, Index, Destination ) )
+			{
+				const int32 BeforeTitle = Index;
+				SkipWhitespace( Subject, Index );
+
+				if( Index > BeforeTitle && Index < Len && Subject[ Index ] != TEXT( ')' ) )
+				{
+					if( ParseLinkTitle( Subject, Index, Title ) )
+					{
+						SkipWhitespace( Subject, Index );
+					}
+				}
+
+				if( Index < Len && Subject[ Index ] == TEXT( ')' ) )
+				{
+					End = Index + 1;
+				}
+			}
+
+			if( End == INDEX_NONE )
+			{
+				Destination.Reset();
+				Title.Reset();
+			}
+		}
+
+		// reference link [text][label], [label][] or [label]
+		if( End == INDEX_NONE )
+		{
+			const int32 LabelEnd = ScanLinkLabel( Subject, After );
+
+			FStringView Label;
+			int32 ReferenceEnd = INDEX_NONE;
+
+			if( LabelEnd != INDEX_NONE && LabelEnd - After > 2 )
+			{
+				Label        = Subject.Mid( After + 1, LabelEnd - After - 2 );
+				ReferenceEnd = LabelEnd;
+			}
+			else if( !Opener.bBracketAfter )
+			{
+				Label        = Subject.Mid( Opener.Position, Pos - Opener.Position );
+				ReferenceEnd = LabelEnd == After + 2 ? LabelEnd : After;
+			}
+
+			if( !Label.IsEmpty() && Label.Len() <= 999 )
+			{
+				if( const FLinkReference* Reference = References.Find( NormalizeLabel( Label ) ) )
+				{
+					Destination = Reference->Destination;
+					Title       = Reference->Title;
+					End         = ReferenceEnd;
+				}
+			}
+		}
+
+		if( End == INDEX_NONE )
+		{
+			Brackets.Pop();
+			Literal();
+			return;
+		}
+
+		const int32 Link = AddInline( Opener.bImage ? EMarkdownNodeType::Image : EMarkdownNodeType::Link, Inlines[ Opener.Node ].Start, End );
+		Inlines[ Link ].Literal = Document.AddString( Title );
+		Inlines[ Link ].Extra   = Document.AddString( Destination );
+
+		// everything after the opening bracket becomes the link text
+		Unlink( Link );
+
+		for( int32 Child = Inlines[ Opener.Node ].Next; Child != INDEX_NONE; )
+		{
+			const int32 Next = Inlines[ Child ].Next;
+			Unlink( Child );
+			AppendChild( Link, Child );
+			Child = Next;
+		}
+
+		AppendChild( 0, Link );
+
+		ProcessEmphasis( Opener.PreviousDelimiter );
+
+		Brackets.Pop();
+		Unlink( Opener.Node );
+
+		// no links in links
+		if( !Opener.bImage )
+		{
+			for( FBracket& Bracket : Brackets )
+			{
+				if( !Bracket.bImage )
+				{
+					Bracket.bActive = false;
+				}
+			}
+		}
+
+		Pos       = End;
+		TextStart = Pos;
+	}
+
+	bool FInlineParser::HandleAngleBracket()
+	{
+		const int32 Len = Subject.Len();
+
+		auto AddAutolink = [this]( const int32 End, const FStringView Destination, const FStringView Text )
+		{
+			FlushText( Pos );
+
+			const int32 Link = AddInline( EMarkdownNodeType::Link, Pos, End );
+			Inlines[ Link ].Flags   = EMarkdownNodeFlags::Autolink;
+			Inlines[ Link ].Extra   = Document.AddString( Destination );
+			Inlines[ Link ].Literal = Document.AddString( FStringView() );
+
+			const int32 Child = AddText( Text, Pos + 1, End - 1 );
+			Unlink( Child );
+			AppendChild( Link, Child );
+
+			Pos       = End;
+			TextStart = Pos;
+		};
+
+		// <scheme:...>
+		int32 Index = Pos + 1;
+
+		if( Index < Len && IsAsciiAlpha( Subject[ Index ] ) )
+		{
+			int32 SchemeEnd = Index + 1;
+
+			while( SchemeEnd < Len && SchemeEnd - Index < 32 && ( IsAsciiAlnum( Subject[ SchemeEnd ] ) || Subject[ SchemeEnd ] == TEXT( '+' ) || Subject[ SchemeEnd ] == TEXT( '.' ) || Subject[ SchemeEnd ] == TEXT( '-' ) ) )
+			{
+				++SchemeEnd;
+			}
+
+			if( SchemeEnd - Index >= 2 && SchemeEnd < Len && Subject[ SchemeEnd ] == TEXT( ':' ) )
+			{
+				int32 End = SchemeEnd + 1;
+
+				while( End < Len && Subject[ End ] > TEXT( ' ' ) && Subject[ End ] != TEXT( '<' ) && Subject[ End ] != TEXT( '>' ) )
+				{
+					++End;
+				}
+
+				if( End < Len && Subject[ End ] == TEXT( '>' ) )
+				{
+					const FStringView Url = Subject.Mid( Pos + 1, End - Pos - 1 );
+					AddAutolink( End + 1, Url, Url );
+					return true;
+				}
+			}
+		}
+
+		// <user@domain>
+		{
+			int32 End = Index;
+
+			while( End < Len && ( IsAsciiAlnum( Subject[ End ] ) || FCString::Strchr( TEXT( ".!#$%&'*+/=?^_`{|}~-" ), Subject[ End ] ) != nullptr ) )
+			{
+				++End;
+			}
+
+			if( End > Index && End < Len && Subject[ End ] == TEXT( '@' ) )
+			{
+				const int32 DomainStart = ++End;
+
+				while( End < Len && ( IsAsciiAlnum( Subject[ End ] ) || Subject[ End ] == TEXT( '-' ) || Subject[ End ] == TEXT( '.' ) ) )
+				{
+					++End;
+				}
+
+				if( End > DomainStart && End < Len && Subject[ End ] == TEXT( '>' ) )
+				{
+					const FStringView Email = Subject.Mid( Pos + 1, End - Pos - 1 );
+					FString Destination = TEXT( "mailto:" );
+					Destination.Append( Email.GetData(), Email.Len() );
+
+					AddAutolink( End + 1, Destination, Email );
+					return true;
+				}
+			}
+		}
+
+		// raw html
+		if( const int32 Length = ScanHtmlTag( Subject, Pos ) )
+		{
+			FlushText( Pos );
+
+			const int32 Html = AddInline( EMarkdownNodeType::Html, Pos, Pos + Length );
+			Inlines[ Html ].Literal = Document.AddString( Subject.Mid( Pos, Length ) );
+
+			Pos      += Length;
+			TextStart = Pos;
+			return true;
+		}
+
+		return false;
+	}
+
+	void FInlineParser::HandleEntity()
+	{
+		int32 End = Pos;
+
+		Scratch.Reset();
+
+		if( DecodeEntity( Subject, End, Scratch ) )
+		{
+			FlushText( Pos );
+			AddText( Scratch, Pos, End );
+			Pos       = End;
+			TextStart = Pos;
+		}
+		else
+		{
+			++Pos;
+		}
+	}
+
+	bool FInlineParser::HandleBareLink()
+	{
+		if( !Options.bAutolinks )
+		{
+			return false;
+		}
+
+		// the scan stops on the : of a scheme or the . after www, by which point the prefix is in the pending text
+		int32 Start = INDEX_NONE;
+		int32 DomainStart = INDEX_NONE;
+		bool bWww = false;
+
+		if( Subject[ Pos ] == TEXT( ':' ) )
+		{
+			if( Pos - 5 >= TextStart && StartsWithNoCase( Subject, Pos - 5, TEXTVIEW( "https://" ) ) )
+			{
+				Start = Pos - 5;
+			}
+			else if( Pos - 4 >= TextStart && StartsWithNoCase( Subject, Pos - 4, TEXTVIEW( "http://" ) ) )
+			{
+				Start = Pos - 4;
+			}
+
+			DomainStart = Pos + 3;
+		}
+		else if( Pos - 3 >= TextStart && StartsWithNoCase( Subject, Pos - 3, TEXTVIEW( "www." ) ) )
+		{
+			Start       = Pos - 3;
+			DomainStart = Pos + 1;
+			bWww        = true;
+		}
+
+		if( Start == INDEX_NONE )
+		{
+			return false;
+		}
+
+		// only at the start of a word
+		if( Start > 0 )
+		{
+			const TCHAR Before = Subject[ Start - 1 ];
+
+			if( !IsWhitespace( Before ) && Before != TEXT( '*' ) && Before != TEXT( '_' ) && Before != TEXT( '~' ) && Before != TEXT( '(' ) )
+			{
+				return false;
+			}
+		}
+
+		const int32 Len = Subject.Len();
+		int32 End = DomainStart;
+
+		while( End < Len && ( IsAsciiAlnum( Subject[ End ] ) || Subject[ End ] == TEXT( '-' ) || Subject[ End ] == TEXT( '_' ) || Subject[ End ] == TEXT( '.' ) || Subject[ End ] > 127 ) )
+		{
+			++End;
+		}
+
+		if( End == DomainStart )
+		{
+			return false;
+		}
+
+		while( End < Len && !IsWhitespace( Subject[ End ] ) && Subject[ End ] != TEXT( '<' ) )
+		{
+			++End;
+		}
+
+		// trailing punctuation is not part of the link, nor is an unbalanced closing bracket
+		while( End > DomainStart )
+		{
+			const TCHAR Last = Subject[ End - 1 ];
+
+			if( FCString::Strchr( TEXT( "?!.,:*_~'\"" ), Last ) != nullptr )
+			{
+				--End;
+			}
+			else if( Last == TEXT( ')' ) )
+			{
+				int32 Balance = 0;
+
+				for( int32 Index = Start; Index < End; ++Index )
+				{
+					Balance += Subject[ Index ] == TEXT( '(' ) ? 1 : Subject[ Index ] == TEXT( ')' ) ? -1 : 0;
+				}
+
+				if( Balance >= 0 )
+				{
+					break;
+				}
+
+				--End;
+			}
+			else if( Last == TEXT( ';' ) )
+			{
+				int32 Amp = End - 2;
+
+				while( Amp > DomainStart && IsAsciiAlnum( Subject[ Amp ] ) )
+				{
+					--Amp;
+				}
+
+				if( Amp <= DomainStart || Subject[ Amp ] != TEXT( '&' ) )
+				{
+					break;
+				}
+
+				End = Amp;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		if( End <= DomainStart )
+		{
+			return false;
+		}
+
+		const FStringView Url = Subject.Mid( Start, End - Start );
+
+		FlushText( Start );
+
+		const int32 Link = AddInline( EMarkdownNodeType::Link, Start, End );
+		Inlines[ Link ].Flags   = EMarkdownNodeFlags::Autolink;
+		Inlines[ Link ].Literal = Document.AddString( FStringView() );
+
+		if( bWww )
+		{
+			FString Destination = TEXT( "http://" );
+			Destination.Append( Url.GetData(), Url.Len() );
+			Inlines[ Link ].Extra = Document.AddString( Destination );
+		}
+		else
+		{
+			Inlines[ Link ].Extra = Document.AddString( Url );
+		}
+
+		const int32 Child = AddText( Url, Start, End );
+		Unlink( Child );
+		AppendChild( Link, Child );
+
+		Pos       = End;
+		TextStart = Pos;
+		return true;
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// emphasis, see "process emphasis" in the CommonMark spec
+
+	void FInlineParser::RemoveDelimiter( const int32 Index )
+	{
+		const FDelimiter& Delimiter = Delimiters[ Index ];
+
+		if( Delimiter.Prev != INDEX_NONE )
+		{
+			Delimiters[ Delimiter.Prev ].Next = Delimiter.Next;
+		}
+
+		if( Delimiter.Next != INDEX_NONE )
+		{
+			Delimiters[ Delimiter.Next ].Prev = Delimiter.Prev;
+		}
+		else
+		{
+			LastDelimiter = Delimiter.Prev;
+		}
+	}
+
+	void FInlineParser::ProcessEmphasis( const int32 StackBottom )
+	{
+		// [ char ][ closer can open ][ length % 3 ]
+		int32 OpenersBottom[ 3 ][ 2 ][ 3 ];
+
+		for( int32 A = 0; A < 3; ++A )
+		{
+			for( int32 B = 0; B < 2; ++B )
+			{
+				for( int32 C = 0; C < 3; ++C )
+				{
+					OpenersBottom[ A ][ B ][ C ] = StackBottom;
+				}
+			}
+		}
+
+		int32 Closer = LastDelimiter;
+
+		while( Closer != INDEX_NONE && Delimiters[ Closer ].Prev != StackBottom )
+		{
+			Closer = Delimiters[ Closer ].Prev;
+		}
+
+		while( Closer != INDEX_NONE )
+		{
+			FDelimiter& CloserDelimiter = Delimiters[ Closer ];
+
+			if( !CloserDelimiter.bCanClose )
+			{
+				Closer = CloserDelimiter.Next;
+				continue;
+			}
+
+			const TCHAR C = CloserDelimiter.Char;
+			int32& Bottom = OpenersBottom[ C == TEXT( '*' ) ? 0 : C == TEXT( '_' ) ? 1 : 2 ][ CloserDelimiter.bCanOpen ? 1 : 0 ][ CloserDelimiter.OriginalCount % 3 ];
+
+			int32 Opener = CloserDelimiter.Prev;
+			bool bFound  = false;
+
+			while( Opener != INDEX_NONE && Opener != StackBottom && Opener != Bottom )
+			{
+				const FDelimiter& OpenerDelimiter = Delimiters[ Opener ];
+
+				if( OpenerDelimiter.bCanOpen && OpenerDelimiter.Char == C )
+				{
+					if( C == TEXT( '~' ) )
+					{
+						bFound = OpenerDelimiter.Count == CloserDelimiter.Count;
+					}
+					else
+					{
+						const int32 Sum = OpenerDelimiter.OriginalCount + CloserDelimiter.OriginalCount;
+						const bool bOddMatch = ( CloserDelimiter.bCanOpen || OpenerDelimiter.bCanClose ) && Sum % 3 == 0 && !( OpenerDelimiter.OriginalCount % 3 == 0 && CloserDelimiter.OriginalCount % 3 == 0 );
+						bFound = !bOddMatch;
+					}
+
+					if( bFound )
+					{
+						break;
+					}
+				}
+
+				Opener = OpenerDelimiter.Prev;
+			}
+
+			const int32 OldCloser = Closer;
+
+			if( !bFound )
+			{
+				Closer = CloserDelimiter.Next;
+				Bottom = Delimiters[ OldCloser ].Prev;
+
+				if( !Delimiters[ OldCloser ].bCanOpen )
+				{
+					RemoveDelimiter( OldCloser );
+				}
+
+				continue;
+			}
+
+			FDelimiter& OpenerDelimiter = Delimiters[ Opener ];
+
+			const int32 Use = C == TEXT( '~' ) ? CloserDelimiter.Count : ( CloserDelimiter.Count >= 2 && OpenerDelimiter.Count >= 2 ? 2 : 1 );
+			const EMarkdownNodeType Type = C == TEXT( '~' ) ? EMarkdownNodeType::Strikethrough : Use == 2 ? EMarkdownNodeType::Strong : EMarkdownNodeType::Emphasis;
+
+			OpenerDelimiter.Count -= Use;
+			CloserDelimiter.Count -= Use;
+
+			const int32 OpenerNode = OpenerDelimiter.Node;
+			const int32 CloserNode = CloserDelimiter.Node;
+
+			// the delimiters used are the ones nearest the text
+			Inlines[ OpenerNode ].Literal.Length -= Use;
+			Inlines[ OpenerNode ].End            -= Use;
+			Inlines[ CloserNode ].Literal.Offset += Use;
+			Inlines[ CloserNode ].Literal.Length -= Use;
+			Inlines[ CloserNode ].Start          += Use;
+
+			const int32 Emphasis = AddInline( Type, Inlines[ OpenerNode ].End, Inlines[ CloserNode ].Start );
+			Unlink( Emphasis );
+
+			for( int32 Child = Inlines[ OpenerNode ].Next; Child != INDEX_NONE && Child != CloserNode; )
+			{
+				const int32 Next = Inlines[ Child ].Next;
+				Unlink( Child );
+				AppendChild( Emphasis, Child );
+				Child = Next;
+			}
+
+			InsertAfter( OpenerNode, Emphasis );
+
+			// anything between them can no longer match
+			for( int32 Between = Delimiters[ Closer ].Prev; Between != Opener; )
+			{
+				const int32 Prev = Delimiters[ Between ].Prev;
+				RemoveDelimiter( Between );
+				Between = Prev;
+			}
+
+			if( Delimiters[ Opener ].Count == 0 )
+			{
+				Unlink( OpenerNode );
+				RemoveDelimiter( Opener );
+			}
+
+			if( Delimiters[ Closer ].Count == 0 )
+			{
+				const int32 Next = Delimiters[ Closer ].Next;
+				Unlink( CloserNode );
+				RemoveDelimiter( Closer );
+				Closer = Next;
+			}
+		}
+
+		while( LastDelimiter != INDEX_NONE && LastDelimiter != StackBottom )
+		{
+			RemoveDelimiter( LastDelimiter );
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// output
+
+	void FInlineParser::Emit( const int32 Parent )
+	{
+		// walked without recursion so no amount of nesting in the text can run out of stack, and anything that would
+		// end up deeper than MaxNesting in the document keeps its text but loses the markup around it
+
+		int32 Depth = 1;
+
+		for( int32 Node = Parent; Document[ Node ].Parent != INDEX_NONE; Node = Document[ Node ].Parent )
+		{
+			++Depth;
+		}
+
+		struct FLevel
+		{
+			int32 Parent;
+			int32 Depth;
+		};
+
+		TArray<FLevel, TInlineAllocator<16>> Levels;
+		Levels.Add( { Parent, Depth } );
+
+		int32 Current = Inlines[ 0 ].FirstChild;
+
+		while( Current != INDEX_NONE )
+		{
+			const FLevel Level    = Levels.Last();
+			const int32 NodeIndex = EmitNode( Current, Level.Parent, Level.Depth );
+			const FInline& Inline = Inlines[ Current ];
+
+			if( Inline.FirstChild != INDEX_NONE )
+			{
+				Levels.Add( NodeIndex != INDEX_NONE ? FLevel{ NodeIndex, Level.Depth + 1 } : Level );
+				Current = Inline.FirstChild;
+				continue;
+			}
+
+			// on to the next sibling, or the next sibling of the nearest parent that has one
+			while( Current != 0 && Inlines[ Current ].Next == INDEX_NONE )
+			{
+				Current = Inlines[ Current ].Parent;
+				Levels.Pop();
+			}
+
+			if( Current == 0 )
+			{
+				break;
+			}
+
+			Current = Inlines[ Current ].Next;
+		}
+	}
+
+	int32 FInlineParser::EmitNode( const int32 Index, const int32 Parent, const int32 Depth )
+	{
+		const FInline& Inline = Inlines[ Index ];
+
+		const int32 SourceStart = ToSourceOffset( Map, Inline.Start );
+		const int32 SourceEnd   = ToSourceOffset( Map, Inline.End );
+
+		if( Inline.Type == EMarkdownNodeType::Text )
+		{
+			if( Inline.Literal.Length == 0 )
+			{
+				return INDEX_NONE;
+			}
+
+			// neighbouring text that ended up next to each other in the string pool becomes one node
+			const int32 Last = Document[ Parent ].LastChild;
+
+			if( Last != INDEX_NONE && Document[ Last ].Type == EMarkdownNodeType::Text )
+			{
+				FMarkdownNode& LastNode = Document.GetMutableNode( Last );
+
+				if( LastNode.Literal.Offset + LastNode.Literal.Length == Inline.Literal.Offset )
+				{
+					LastNode.Literal.Length += Inline.Literal.Length;
+					LastNode.SourceLength    = FMath::Max( LastNode.SourceLength, SourceEnd - LastNode.SourceOffset );
+					return INDEX_NONE;
+				}
+			}
+		}
+		else if( Inline.FirstChild != INDEX_NONE && Depth >= MaxNesting )
+		{
+			// its children go straight into the parent
+			return INDEX_NONE;
+		}
+
+		const int32 NodeIndex = Document.AddNode( Inline.Type, Parent );
+
+		FMarkdownNode& Node = Document.GetMutableNode( NodeIndex );
+		Node.Flags        = Inline.Flags;
+		Node.Literal      = Inline.Literal;
+		Node.Extra        = Inline.Extra;
+		Node.SourceOffset = SourceStart;
+		Node.SourceLength = SourceEnd - SourceStart;
+
+		return NodeIndex;
+	}
+}
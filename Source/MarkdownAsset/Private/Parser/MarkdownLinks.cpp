@@ -0,0 +1,129 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Parser/MarkdownLinks.h"
+
+#include "Parser/MarkdownDocument.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace MarkdownLinks
+{
+	static bool HasScheme( const FStringView Destination )
+	{
+		// letters, digits, "+", "-" or "." up to the colon, so "C:/" and "/Script/A.B'C'" are not schemes
+		for( int32 Index = 0; Index < Destination.Len(); ++Index )
+		{
+			const TCHAR C = Destination[ Index ];
+
+			if( C == TEXT( ':' ) )
+			{
+				return Index > 1;
+			}
+
+			if( !FChar::IsAlnum( C ) && C != TEXT( '+' ) && C != TEXT( '-' ) && C != TEXT( '.' ) )
+			{
+				return false;
+			}
+		}
+
+		return false;
+	}
+
+	static int32 HexValue( const TCHAR C )
+	{
+		return FChar::IsDigit( C ) ? C - TEXT( '0' ) : FChar::IsHexDigit( C ) ? FChar::ToLower( C ) - TEXT( 'a' ) + 10 : INDEX_NONE;
+	}
+
+	static FString DecodePath( const FStringView Path )
+	{
+		// only single bytes, which covers the spaces and brackets that get escaped in file names
+		FString Decoded;
+		Decoded.Reserve( Path.Len() );
+
+		for( int32 Index = 0; Index < Path.Len(); ++Index )
+		{
+			if( Path[ Index ] == TEXT( '%' ) && Index + 2 < Path.Len() && HexValue( Path[ Index + 1 ] ) >= 0 && HexValue( Path[ Index + 2 ] ) >= 0 )
+			{
+				Decoded.AppendChar( TCHAR( HexValue( Path[ Index + 1 ] ) * 16 + HexValue( Path[ Index + 2 ] ) ) );
+				Index += 2;
+			}
+			else
+			{
+				Decoded.AppendChar( Path[ Index ] );
+			}
+		}
+
+		return Decoded;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLinks::Collect( const FMarkdownDocument& Document, TArray<FMarkdownLink>& OutLinks )
+{
+	OutLinks.Reset();
+
+	Document.ForEachDescendant( FMarkdownDocument::Root, [ & ]( const int32 Index )
+	{
+		const FMarkdownNode& Node = Document[ Index ];
+
+		if( Node.Type == EMarkdownNodeType::Link || Node.Type == EMarkdownNodeType::Image )
+		{
+			FMarkdownLink& Link = OutLinks.Add_GetRef( Classify( Document.GetExtra( Index ) ) );
+			Link.SourceOffset = Node.SourceOffset;
+		}
+	});
+}
+
+FMarkdownLink FMarkdownLinks::Classify( const FStringView Destination )
+{
+	using namespace MarkdownLinks;
+
+	FMarkdownLink Link;
+	Link.Destination = FString( Destination );
+
+	if( Destination.StartsWith( TEXT( "/Script" ) ) )
+	{
+		// the viewer opens whatever is between the quotes, a reference without them is an object path already
+		int32 Start = INDEX_NONE;
+		int32 End   = INDEX_NONE;
+
+		const bool bQuoted = Destination.FindChar( TEXT( '\'' ), Start ) && Destination.FindLastChar( TEXT( '\'' ), End ) && End > Start;
+
+		Link.Type   = EMarkdownLinkType::Asset;
+		Link.Target = bQuoted ? FString( Destination.Mid( Start + 1, End - Start - 1 ) ) : FString( Destination );
+		return Link;
+	}
+
+	if( HasScheme( Destination ) )
+	{
+		Link.Type = EMarkdownLinkType::External;
+		return Link;
+	}
+
+	int32 Hash = INDEX_NONE;
+	FStringView Path = Destination;
+
+	if( Path.FindChar( TEXT( '#' ), Hash ) )
+	{
+		Link.Anchor = FString( Path.RightChop( Hash + 1 ) );
+		Path.LeftInline( Hash );
+	}
+
+	int32 Query = INDEX_NONE;
+
+	if( Path.FindChar( TEXT( '?' ), Query ) )
+	{
+		Path.LeftInline( Query );
+	}
+
+	if( Path.IsEmpty() )
+	{
+		Link.Type = EMarkdownLinkType::Anchor;
+		return Link;
+	}
+
+	Link.Type   = Path.EndsWith( TEXT( ".md" ), ESearchCase::IgnoreCase ) ? EMarkdownLinkType::Document : EMarkdownLinkType::File;
+	Link.Target = DecodePath( Path );
+	return Link;
+}
@@ -0,0 +1,1552 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Parser/MarkdownParser.h"
+
+#include "MarkdownParserInternal.h"
+#include "MarkdownScan.h"
+#include "String/Find.h"
+
+namespace MarkdownParser
+{
+	//-----------------------------------------------------------------------------------------------------------------
+	// html blocks
+
+	static const TCHAR* const HtmlBlockTags[] =
+	{
+		TEXT( "address" ), TEXT( "article" ), TEXT( "aside" ), TEXT( "base" ), TEXT( "basefont" ), TEXT( "blockquote" ),
+		TEXT( "body" ), TEXT( "caption" ), TEXT( "center" ), TEXT( "col" ), TEXT( "colgroup" ), TEXT( "dd" ), TEXT( "details" ),
+		TEXT( "dialog" ), TEXT( "dir" ), TEXT( "div" ), TEXT( "dl" ), TEXT( "dt" ), TEXT( "fieldset" ), TEXT( "figcaption" ),
+		TEXT( "figure" ), TEXT( "footer" ), TEXT( "form" ), TEXT( "frame" ), TEXT( "frameset" ), TEXT( "h1" ), TEXT( "h2" ),
+		TEXT( "h3" ), TEXT( "h4" ), TEXT( "h5" ), TEXT( "h6" ), TEXT( "head" ), TEXT( "header" ), TEXT( "hr" ), TEXT( "html" ),
+		TEXT( "iframe" ), TEXT( "legend" ), TEXT( "li" ), TEXT( "link" ), TEXT( "main" ), TEXT( "menu" ), TEXT( "menuitem" ),
+		TEXT( "nav" ), TEXT( "noframes" ), TEXT( "ol" ), TEXT( "optgroup" ), TEXT( "option" ), TEXT( "p" ), TEXT( "param" ),
+		TEXT( "search" ), TEXT( "section" ), TEXT( "summary" ), TEXT( "table" ), TEXT( "tbody" ), TEXT( "td" ), TEXT( "tfoot" ),
+		TEXT( "th" ), TEXT( "thead" ), TEXT( "title" ), TEXT( "tr" ), TEXT( "track" ), TEXT( "ul" ),
+	};
+
+	static const TCHAR* const HtmlRawTags[] = { TEXT( "script" ), TEXT( "pre" ), TEXT( "style" ), TEXT( "textarea" ) };
+	static const TCHAR* const HtmlRawEnds[] = { TEXT( "</script>" ), TEXT( "</pre>" ), TEXT( "</style>" ), TEXT( "</textarea>" ) };
+
+	/** Which of the seven kinds of html block in the CommonMark spec starts the line, or 0. */
+	static int32 GetHtmlBlockKind( const FStringView Rest, const bool bAllowKind7 )
+	{
+		if( Rest.Len() < 2 || Rest[ 0 ] != TEXT( '<' ) )
+		{
+			return 0;
+		}
+
+		auto IsTagEnd = [&Rest]( const int32 Index )
+		{
+			return Index >= Rest.Len() || IsSpaceOrTab( Rest[ Index ] ) || Rest[ Index ] == TEXT( '>' );
+		};
+
+		for( const TCHAR* Tag : HtmlRawTags )
+		{
+			const FStringView Name( Tag );
+
+			if( StartsWithNoCase( Rest, 1, Name ) && IsTagEnd( Name.Len() + 1 ) )
+			{
+				return 1;
+			}
+		}
+
+		if( StartsWithNoCase( Rest, 0, TEXTVIEW( "<!--" ) ) )
+		{
+			return 2;
+		}
+
+		if( Rest[ 1 ] == TEXT( '?' ) )
+		{
+			return 3;
+		}
+
+		if( StartsWithNoCase( Rest, 0, TEXTVIEW( "<![CDATA[" ) ) )
+		{
+			return 5;
+		}
+
+		if( Rest[ 1 ] == TEXT( '!' ) && Rest.Len() > 2 && IsAsciiAlpha( Rest[ 2 ] ) )
+		{
+			return 4;
+		}
+
+		const int32 NameStart = Rest[ 1 ] == TEXT( '/' ) ? 2 : 1;
+		int32 NameEnd = NameStart;
+
+		while( NameEnd < Rest.Len() && IsAsciiAlnum( Rest[ NameEnd ] ) )
+		{
+			++NameEnd;
+		}
+
+		if( NameEnd > NameStart && ( IsTagEnd( NameEnd ) || StartsWithNoCase( Rest, NameEnd, TEXTVIEW( "/>" ) ) ) )
+		{
+			const FStringView Name = Rest.Mid( NameStart, NameEnd - NameStart );
+
+			for( const TCHAR* Tag : HtmlBlockTags )
+			{
+				if( Name.Equals( Tag, ESearchCase::IgnoreCase ) )
+				{
+					return 6;
+				}
+			}
+		}
+
+		if( bAllowKind7 && Rest[ 1 ] != TEXT( '!' ) && Rest[ 1 ] != TEXT( '?' ) )
+		{
+			const int32 Length = ScanHtmlTag( Rest, 0 );
+
+			if( Length > 0 && IsBlank( Rest.RightChop( Length ) ) )
+			{
+				return 7;
+			}
+		}
+
+		return 0;
+	}
+
+	static bool IsHtmlBlockEnd( const int32 Kind, const FStringView Text )
+	{
+		switch( Kind )
+		{
+			case 1:
+				for( const TCHAR* End : HtmlRawEnds )
+				{
+					if( UE::String::FindFirst( Text, End, ESearchCase::IgnoreCase ) != INDEX_NONE )
+					{
+						return true;
+					}
+				}
+				return false;
+
+			case 2: return UE::String::FindFirst( Text, TEXTVIEW( "-->" ) ) != INDEX_NONE;
+			case 3: return UE::String::FindFirst( Text, TEXTVIEW( "?>" ) ) != INDEX_NONE;
+			case 4: return UE::String::FindFirstChar( Text, TEXT( '>' ) ) != INDEX_NONE;
+			case 5: return UE::String::FindFirst( Text, TEXTVIEW( "]]>" ) ) != INDEX_NONE;
+
+			default:
+				return false;
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// tables
+
+	/** Splits a table row on unescaped pipes, the cells are trimmed ranges of the row. */
+	static void SplitTableRow( const FStringView Row, TArray<TPair<int32, int32>>& OutCells )
+	{
+		OutCells.Reset();
+
+		int32 Index = 0;
+
+		while( Index < Row.Len() && IsSpaceOrTab( Row[ Index ] ) )
+		{
+			++Index;
+		}
+
+		if( Index < Row.Len() && Row[ Index ] == TEXT( '|' ) )
+		{
+			++Index;
+		}
+
+		while( Index < Row.Len() && !IsBlank( Row.RightChop( Index ) ) )
+		{
+			int32 Start = Index;
+
+			while( Index < Row.Len() && Row[ Index ] != TEXT( '|' ) )
+			{
+				Index += Row[ Index ] == TEXT( '\\' ) && Index + 1 < Row.Len() ? 2 : 1;
+			}
+
+			int32 End = FMath::Min( Index, Row.Len() );
+
+			while( Start < End && IsSpaceOrTab( Row[ Start ] ) )
+			{
+				++Start;
+			}
+
+			while( End > Start && IsSpaceOrTab( Row[ End - 1 ] ) )
+			{
+				--End;
+			}
+
+			OutCells.Emplace( Start, End );
+
+			// step over the pipe
+			++Index;
+		}
+	}
+
+	/** Reads the alignments out of a |:--|--:| row, false if it is not one. */
+	static bool ParseTableDelimiterRow( const FStringView Row, TArray<TPair<int32, int32>>& Cells, TArray<EMarkdownNodeFlags>& OutAlignments )
+	{
+		SplitTableRow( Row, Cells );
+
+		if( Cells.Num() == 0 )
+		{
+			return false;
+		}
+
+		OutAlignments.Reset( Cells.Num() );
+
+		for( const TPair<int32, int32>& Cell : Cells )
+		{
+			int32 Start = Cell.Key;
+			int32 End   = Cell.Value;
+
+			EMarkdownNodeFlags Alignment = EMarkdownNodeFlags::None;
+
+			if( Start < End && Row[ Start ] == TEXT( ':' ) )
+			{
+				Alignment |= EMarkdownNodeFlags::AlignLeft;
+				++Start;
+			}
+
+			if( End > Start && Row[ End - 1 ] == TEXT( ':' ) )
+			{
+				Alignment |= EMarkdownNodeFlags::AlignRight;
+				--End;
+			}
+
+			if( Start == End )
+			{
+				return false;
+			}
+
+			for( int32 Index = Start; Index < End; ++Index )
+			{
+				if( Row[ Index ] != TEXT( '-' ) )
+				{
+					return false;
+				}
+			}
+
+			OutAlignments.Add( Alignment );
+		}
+
+		return true;
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	/** A block that can still take more lines. */
+	struct FOpenBlock
+	{
+		EMarkdownNodeType Type = EMarkdownNodeType::Document;
+		EMarkdownNodeFlags Flags = EMarkdownNodeFlags::None;
+
+		/** containers are added to the document when they open, leaves when they close and their content is known */
+		int32 Node = INDEX_NONE;
+
+		int32 SourceStart = 0;
+		int32 SourceEnd = 0;
+		int32 StartLine = 0;
+
+		// lists and list items
+		TCHAR ListChar = 0;
+		int32 ListStart = 0;
+		int32 MarkerOffset = 0;
+		int32 Padding = 0;
+		bool bLoose = false;
+
+		// code and html
+		TCHAR FenceChar = 0;
+		int32 FenceLength = 0;
+		int32 FenceOffset = 0;
+		int32 HtmlKind = 0;
+		FString Info;
+
+		// tables
+		TArray<EMarkdownNodeFlags> Alignments;
+
+		bool bHasChildren = false;
+		bool bLastLineBlank = false;
+	};
+
+	/**
+	 * Splits the text into blocks line by line, following the CommonMark parsing strategy (and commonmark.js).
+	 * Paragraphs, headings and cells are collected and run through the inline parser at the end, once all the link
+	 * reference definitions are known.
+	 */
+	class FBlockParser
+	{
+	public:
+
+		FBlockParser( FMarkdownDocument& InDocument, const FMarkdownParserOptions& InOptions )
+			: Document( InDocument )
+			, Options( InOptions )
+		{
+		}
+
+		void Parse( const FStringView Text );
+
+	private:
+
+		enum class EContinue : uint8
+		{
+			Matched,
+			NotMatched,
+			Closed,     // the line closed the block (a closing code fence), nothing else to do with it
+		};
+
+		enum class EStart : uint8
+		{
+			None,
+			Container,
+			Leaf,
+		};
+
+		void ProcessLine( const FStringView InLine, const int32 InLineOffset );
+		void EndLine();
+
+		// line position, columns are tracked for tab stops
+		void FindNextNonspace();
+		void AdvanceNextNonspace();
+		void AdvanceOffset( int32 Count, const bool bColumns );
+
+		TCHAR Peek( const int32 Index ) const
+		{
+			return Index < Line.Len() ? Line[ Index ] : 0;
+		}
+
+		int32 SourceAt( const int32 Index ) const
+		{
+			return LineOffset + Index;
+		}
+
+		// block structure
+		EContinue Continue( const int32 Index );
+		EStart TryStart( const int32 Container );
+
+		bool StartAtxHeading();
+		bool StartFencedCode();
+		bool StartHtmlBlock( const int32 Container );
+		bool StartSetextHeading();
+		bool StartTable();
+		bool StartThematicBreak();
+		bool StartListItem( const int32 Container );
+
+		int32 PrepareParent( const EMarkdownNodeType Type );
+		FOpenBlock& AddChild( const EMarkdownNodeType Type, const int32 SourceStart );
+		int32 AddLeaf( const EMarkdownNodeType Type, const int32 SourceStart, const int32 SourceEnd );
+
+		void CloseUnmatchedBlocks();
+		void FinalizeTop();
+
+		// content
+		void AddLine();
+		void AddTableRow( const FStringView Row, const int32 RowSource, const bool bHeader );
+		void ConsumeLinkReferences( FOpenBlock& Block );
+		int32 GetTrimmedLeafLength() const;
+
+		void QueueInline( const int32 Node, const FStringView Content, const TArrayView<const FSourceSegment> Segments );
+		void QueueInline( const int32 Node, const FStringView Content, const int32 SourceOffset );
+		void ParseInlines();
+
+	private:
+
+		FMarkdownDocument& Document;
+		const FMarkdownParserOptions& Options;
+
+		TArray<FOpenBlock> Stack;
+		FLinkReferenceMap References;
+
+		// current line
+		FStringView Line;
+		int32 LineOffset = 0;
+		int32 LineNumber = 0;
+		int32 Offset = 0;
+		int32 Column = 0;
+		int32 NextNonspace = 0;
+		int32 NextNonspaceColumn = 0;
+		int32 Indent = 0;
+		bool bIndented = false;
+		bool bBlank = false;
+		bool bPartiallyConsumedTab = false;
+		bool bLineConsumed = false;
+		bool bAllClosed = true;
+		int32 LastMatched = 0;
+
+		// content of the open leaf block, there is only ever one
+		FString Leaf;
+		TArray<FSourceSegment> LeafSegments;
+
+		// inline content waiting for the second pass
+		struct FPendingInline
+		{
+			int32 Node;
+			int32 ContentOffset;
+			int32 ContentLength;
+			int32 SegmentOffset;
+			int32 SegmentCount;
+		};
+
+		TArray<FPendingInline> Pending;
+		FString InlineContent;
+		TArray<FSourceSegment> InlineSegments;
+
+		TArray<TPair<int32, int32>> Cells;
+	};
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	static bool CanContain( const EMarkdownNodeType Parent, const EMarkdownNodeType Child )
+	{
+		switch( Parent )
+		{
+			case EMarkdownNodeType::Document:
+			case EMarkdownNodeType::BlockQuote:
+			case EMarkdownNodeType::ListItem:
+				return Child != EMarkdownNodeType::ListItem;
+
+			case EMarkdownNodeType::List:
+				return Child == EMarkdownNodeType::ListItem;
+
+			default:
+				return false;
+		}
+	}
+
+	static bool IsAddedOnOpen( const EMarkdownNodeType Type )
+	{
+		return Type == EMarkdownNodeType::BlockQuote || Type == EMarkdownNodeType::List || Type == EMarkdownNodeType::ListItem || Type == EMarkdownNodeType::Table;
+	}
+
+	/** Quick test for characters that could start a block, anything else is paragraph text. */
+	static bool MaybeSpecial( const TCHAR C )
+	{
+		switch( C )
+		{
+			case TEXT( '#' ): case TEXT( '`' ): case TEXT( '~' ): case TEXT( '*' ): case TEXT( '+' ): case TEXT( '_' ):
+			case TEXT( '=' ): case TEXT( '<' ): case TEXT( '>' ): case TEXT( '-' ): case TEXT( '|' ): case TEXT( ':' ):
+				return true;
+
+			default:
+				return IsAsciiDigit( C );
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void FBlockParser::Parse( const FStringView Text )
+	{
+		Document.Empty();
+		Document.Reserve( Text.Len() / 16 + 16, Text.Len() + Text.Len() / 8 );
+
+		FOpenBlock& Root = Stack.AddDefaulted_GetRef();
+		Root.Type = EMarkdownNodeType::Document;
+		Root.Node = Document.AddNode( EMarkdownNodeType::Document, INDEX_NONE );
+
+		const TCHAR* Data = Text.GetData();
+		const int32 Len   = Text.Len();
+
+		for( int32 LineStart = 0; LineStart < Len; )
+		{
+			const int32 LineEnd = FindChar( Data, LineStart, Len, TEXT( '\n' ) );
+
+			const int32 ContentEnd = LineEnd > LineStart && Data[ LineEnd - 1 ] == TEXT( '\r' ) ? LineEnd - 1 : LineEnd;
+
+			ProcessLine( Text.Mid( LineStart, ContentEnd - LineStart ), LineStart );
+
+			LineStart = LineEnd + 1;
+		}
+
+		Stack[ 0 ].SourceEnd = Len;
+
+		while( Stack.Num() > 0 )
+		{
+			FinalizeTop();
+		}
+
+		ParseInlines();
+	}
+
+	void FBlockParser::ProcessLine( const FStringView InLine, const int32 InLineOffset )
+	{
+		Line                  = InLine;
+		LineOffset            = InLineOffset;
+		Offset                = 0;
+		Column                = 0;
+		bBlank                = false;
+		bPartiallyConsumedTab = false;
+		bLineConsumed         = false;
+
+		++LineNumber;
+
+		// see how many of the open blocks the line continues
+		LastMatched = 0;
+
+		for( int32 Index = 1; Index < Stack.Num(); ++Index )
+		{
+			const EContinue Result = Continue( Index );
+
+			if( Result == EContinue::Closed )
+			{
+				EndLine();
+				FinalizeTop();
+				return;
+			}
+
+			if( Result == EContinue::NotMatched )
+			{
+				break;
+			}
+
+			LastMatched = Index;
+		}
+
+		bAllClosed = LastMatched == Stack.Num() - 1;
+
+		// then look for new blocks starting
+		int32 Container   = LastMatched;
+		bool bMatchedLeaf = Stack[ Container ].Type == EMarkdownNodeType::CodeBlock || Stack[ Container ].Type == EMarkdownNodeType::HtmlBlock;
+
+		while( !bMatchedLeaf )
+		{
+			FindNextNonspace();
+
+			if( !bIndented && !MaybeSpecial( Peek( NextNonspace ) ) )
+			{
+				AdvanceNextNonspace();
+				break;
+			}
+
+			const EStart Result = TryStart( Container );
+
+			if( Result == EStart::None )
+			{
+				AdvanceNextNonspace();
+				break;
+			}
+
+			Container    = Stack.Num() - 1;
+			bMatchedLeaf = Result == EStart::Leaf;
+		}
+
+		// what is left of the line is content
+		if( bLineConsumed )
+		{
+			// heading, rule etc
+		}
+		else if( !bAllClosed && !bBlank && Stack.Last().Type == EMarkdownNodeType::Paragraph )
+		{
+			// lazy continuation
+			AddLine();
+		}
+		else
+		{
+			CloseUnmatchedBlocks();
+
+			switch( Stack.Last().Type )
+			{
+				case EMarkdownNodeType::Paragraph:
+				case EMarkdownNodeType::CodeBlock:
+					AddLine();
+					break;
+
+				case EMarkdownNodeType::HtmlBlock:
+					AddLine();
+
+					if( IsHtmlBlockEnd( Stack.Last().HtmlKind, Line.RightChop( Offset ) ) )
+					{
+						EndLine();
+						FinalizeTop();
+						return;
+					}
+					break;
+
+				case EMarkdownNodeType::Table:
+					AddTableRow( Line.RightChop( Offset ), SourceAt( Offset ), false );
+					break;
+
+				default:
+					if( !bBlank )
+					{
+						AddChild( EMarkdownNodeType::Paragraph, SourceAt( NextNonspace ) );
+						AdvanceNextNonspace();
+						AddLine();
+					}
+					break;
+			}
+		}
+
+		EndLine();
+	}
+
+	void FBlockParser::EndLine()
+	{
+		if( !bBlank )
+		{
+			const int32 End = SourceAt( Line.Len() );
+
+			for( FOpenBlock& Block : Stack )
+			{
+				Block.SourceEnd = End;
+			}
+		}
+
+		// blank lines between the items of a list, or between the blocks of an item, make the list loose
+		const FOpenBlock& Tip = Stack.Last();
+
+		const bool bLastLineBlank = bBlank && !(
+			Tip.Type == EMarkdownNodeType::BlockQuote ||
+			( Tip.Type == EMarkdownNodeType::CodeBlock && EnumHasAnyFlags( Tip.Flags, EMarkdownNodeFlags::Fenced ) ) ||
+			( Tip.Type == EMarkdownNodeType::ListItem && !Tip.bHasChildren && Tip.StartLine == LineNumber )
+		);
+
+		for( FOpenBlock& Block : Stack )
+		{
+			Block.bLastLineBlank = bLastLineBlank;
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// line position
+
+	void FBlockParser::FindNextNonspace()
+	{
+		int32 Index   = Offset;
+		int32 Columns = Column;
+
+		while( Index < Line.Len() )
+		{
+			const TCHAR C = Line[ Index ];
+
+			if( C == TEXT( ' ' ) )
+			{
+				++Index;
+				++Columns;
+			}
+			else if( C == TEXT( '\t' ) )
+			{
+				++Index;
+				Columns += 4 - ( Columns % 4 );
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		bBlank             = Index >= Line.Len();
+		NextNonspace       = Index;
+		NextNonspaceColumn = Columns;
+		Indent             = NextNonspaceColumn - Column;
+		bIndented          = Indent >= 4;
+	}
+
+	void FBlockParser::AdvanceNextNonspace()
+	{
+		Offset                = NextNonspace;
+		Column                = NextNonspaceColumn;
+		bPartiallyConsumedTab = false;
+	}
+
+	void FBlockParser::AdvanceOffset( int32 Count, const bool bColumns )
+	{
+		while( Count > 0 && Offset < Line.Len() )
+		{
+			if( Line[ Offset ] == TEXT( '\t' ) )
+			{
+				const int32 CharsToTab = 4 - ( Column % 4 );
+
+				if( bColumns )
+				{
+					bPartiallyConsumedTab = CharsToTab > Count;
+
+					const int32 CharsToAdvance = FMath::Min( Count, CharsToTab );
+					Column += CharsToAdvance;
+					Offset += bPartiallyConsumedTab ? 0 : 1;
+					Count  -= CharsToAdvance;
+				}
+				else
+				{
+					bPartiallyConsumedTab = false;
+					Column += CharsToTab;
+					Offset += 1;
+					Count  -= 1;
+				}
+			}
+			else
+			{
+				bPartiallyConsumedTab = false;
+				Offset += 1;
+				Column += 1;
+				Count  -= 1;
+			}
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// continuation
+
+	FBlockParser::EContinue FBlockParser::Continue( const int32 Index )
+	{
+		FindNextNonspace();
+
+		const FOpenBlock& Block = Stack[ Index ];
+
+		switch( Block.Type )
+		{
+			case EMarkdownNodeType::BlockQuote:
+				if( !bIndented && Peek( NextNonspace ) == TEXT( '>' ) )
+				{
+					AdvanceNextNonspace();
+					AdvanceOffset( 1, false );
+
+					if( IsSpaceOrTab( Peek( Offset ) ) )
+					{
+						AdvanceOffset( 1, true );
+					}
+
+					return EContinue::Matched;
+				}
+				return EContinue::NotMatched;
+
+			case EMarkdownNodeType::List:
+				return EContinue::Matched;
+
+			case EMarkdownNodeType::ListItem:
+				if( bBlank )
+				{
+					// an item that started with a blank line can not have another
+					if( !Block.bHasChildren )
+					{
+						return EContinue::NotMatched;
+					}
+
+					AdvanceNextNonspace();
+					return EContinue::Matched;
+				}
+
+				if( Indent >= Block.MarkerOffset + Block.Padding )
+				{
+					AdvanceOffset( Block.MarkerOffset + Block.Padding, true );
+					return EContinue::Matched;
+				}
+				return EContinue::NotMatched;
+
+			case EMarkdownNodeType::CodeBlock:
+				if( EnumHasAnyFlags( Block.Flags, EMarkdownNodeFlags::Fenced ) )
+				{
+					if( Indent <= 3 && Peek( NextNonspace ) == Block.FenceChar )
+					{
+						int32 End = NextNonspace;
+
+						while( End < Line.Len() && Line[ End ] == Block.FenceChar )
+						{
+							++End;
+						}
+
+						if( End - NextNonspace >= Block.FenceLength && IsBlank( Line.RightChop( End ) ) )
+						{
+							return EContinue::Closed;
+						}
+					}
+
+					// take out as much indentation as the opening fence had
+					for( int32 Spaces = Block.FenceOffset; Spaces > 0 && IsSpaceOrTab( Peek( Offset ) ); --Spaces )
+					{
+						AdvanceOffset( 1, true );
+					}
+
+					return EContinue::Matched;
+				}
+
+				if( bIndented )
+				{
+					AdvanceOffset( 4, true );
+					return EContinue::Matched;
+				}
+
+				if( bBlank )
+				{
+					AdvanceNextNonspace();
+					return EContinue::Matched;
+				}
+				return EContinue::NotMatched;
+
+			case EMarkdownNodeType::HtmlBlock:
+				return bBlank && Block.HtmlKind >= 6 ? EContinue::NotMatched : EContinue::Matched;
+
+			case EMarkdownNodeType::Paragraph:
+			case EMarkdownNodeType::Table:
+				return bBlank ? EContinue::NotMatched : EContinue::Matched;
+
+			default:
+				return EContinue::NotMatched;
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// block starts, tried in order of precedence
+
+	FBlockParser::EStart FBlockParser::TryStart( const int32 Container )
+	{
+		const TCHAR C = Peek( NextNonspace );
+		const EMarkdownNodeType ContainerType = Stack[ Container ].Type;
+
+		// a list item opens two levels, the list and the item
+		const bool bCanNest = Stack.Num() + 2 <= MaxBlockNesting;
+
+		if( !bIndented )
+		{
+			if( C == TEXT( '>' ) && bCanNest )
+			{
+				const int32 Start = SourceAt( NextNonspace );
+
+				AdvanceNextNonspace();
+				AdvanceOffset( 1, false );
+
+				if( IsSpaceOrTab( Peek( Offset ) ) )
+				{
+					AdvanceOffset( 1, true );
+				}
+
+				CloseUnmatchedBlocks();
+				AddChild( EMarkdownNodeType::BlockQuote, Start );
+				return EStart::Container;
+			}
+
+			if( C == TEXT( '#' ) && StartAtxHeading() )
+			{
+				return EStart::Leaf;
+			}
+
+			if( ( C == TEXT( '`' ) || C == TEXT( '~' ) ) && StartFencedCode() )
+			{
+				return EStart::Leaf;
+			}
+
+			if( C == TEXT( '<' ) && StartHtmlBlock( Container ) )
+			{
+				return EStart::Leaf;
+			}
+
+			if( ( C == TEXT( '=' ) || C == TEXT( '-' ) ) && ContainerType == EMarkdownNodeType::Paragraph && StartSetextHeading() )
+			{
+				return EStart::Leaf;
+			}
+
+			if( ( C == TEXT( '|' ) || C == TEXT( ':' ) || C == TEXT( '-' ) ) && Options.bTables && ContainerType == EMarkdownNodeType::Paragraph && StartTable() )
+			{
+				return EStart::Leaf;
+			}
+
+			if( ( C == TEXT( '*' ) || C == TEXT( '-' ) || C == TEXT( '_' ) ) && StartThematicBreak() )
+			{
+				return EStart::Leaf;
+			}
+		}
+
+		if( bCanNest && ( !bIndented || ContainerType == EMarkdownNodeType::List ) && StartListItem( Container ) )
+		{
+			return EStart::Container;
+		}
+
+		if( bIndented && !bBlank && Stack.Last().Type != EMarkdownNodeType::Paragraph )
+		{
+			AdvanceOffset( 4, true );
+			CloseUnmatchedBlocks();
+			AddChild( EMarkdownNodeType::CodeBlock, SourceAt( Offset ) );
+			return EStart::Leaf;
+		}
+
+		return EStart::None;
+	}
+
+	bool FBlockParser::StartAtxHeading()
+	{
+		const FStringView Rest = Line.RightChop( NextNonspace );
+
+		int32 Level = 0;
+		while( Level < Rest.Len() && Rest[ Level ] == TEXT( '#' ) )
+		{
+			++Level;
+		}
+
+		if( Level > 6 || ( Level < Rest.Len() && !IsSpaceOrTab( Rest[ Level ] ) ) )
+		{
+			return false;
+		}
+
+		CloseUnmatchedBlocks();
+
+		// content without the optional closing sequence of #s
+		int32 Start = Level;
+		int32 End   = Rest.Len();
+
+		while( Start < End && IsSpaceOrTab( Rest[ Start ] ) )
+		{
+			++Start;
+		}
+
+		while( End > Start && IsSpaceOrTab( Rest[ End - 1 ] ) )
+		{
+			--End;
+		}
+
+		int32 Closing = End;
+		while( Closing > Start && Rest[ Closing - 1 ] == TEXT( '#' ) )
+		{
+			--Closing;
+		}
+
+		if( Closing == Start )
+		{
+			End = Start;
+		}
+		else if( Closing < End && IsSpaceOrTab( Rest[ Closing - 1 ] ) )
+		{
+			End = Closing;
+
+			while( End > Start && IsSpaceOrTab( Rest[ End - 1 ] ) )
+			{
+				--End;
+			}
+		}
+
+		const int32 Node = AddLeaf( EMarkdownNodeType::Heading, SourceAt( NextNonspace ), SourceAt( Line.Len() ) );
+		Document.GetMutableNode( Node ).Value = Level;
+
+		QueueInline( Node, Rest.Mid( Start, End - Start ), SourceAt( NextNonspace + Start ) );
+
+		bLineConsumed = true;
+		return true;
+	}
+
+	bool FBlockParser::StartFencedCode()
+	{
+		const FStringView Rest = Line.RightChop( NextNonspace );
+		const TCHAR Fence      = Rest[ 0 ];
+
+		int32 Length = 0;
+		while( Length < Rest.Len() && Rest[ Length ] == Fence )
+		{
+			++Length;
+		}
+
+		if( Length < 3 )
+		{
+			return false;
+		}
+
+		FStringView Info = Rest.RightChop( Length ).TrimStartAndEnd();
+
+		if( Fence == TEXT( '`' ) && UE::String::FindFirstChar( Info, TEXT( '`' ) ) != INDEX_NONE )
+		{
+			return false;
+		}
+
+		const int32 FenceOffset = Indent;
+
+		CloseUnmatchedBlocks();
+
+		FOpenBlock& Block = AddChild( EMarkdownNodeType::CodeBlock, SourceAt( NextNonspace ) );
+		Block.Flags      |= EMarkdownNodeFlags::Fenced;
+		Block.FenceChar   = Fence;
+		Block.FenceLength = Length;
+		Block.FenceOffset = FenceOffset;
+
+		AppendUnescaped( Info, Block.Info );
+
+		bLineConsumed = true;
+		return true;
+	}
+
+	bool FBlockParser::StartHtmlBlock( const int32 Container )
+	{
+		// the last kind can not interrupt a paragraph, lazy or not
+		const bool bAllowKind7 = Stack[ Container ].Type != EMarkdownNodeType::Paragraph && !( !bAllClosed && !bBlank && Stack.Last().Type == EMarkdownNodeType::Paragraph );
+		const int32 Kind = GetHtmlBlockKind( Line.RightChop( NextNonspace ), bAllowKind7 );
+
+		if( Kind == 0 )
+		{
+			return false;
+		}
+
+		CloseUnmatchedBlocks();
+
+		// the line is added as it is, indentation and all
+		AddChild( EMarkdownNodeType::HtmlBlock, SourceAt( NextNonspace ) ).HtmlKind = Kind;
+		return true;
+	}
+
+	bool FBlockParser::StartSetextHeading()
+	{
+		const FStringView Rest = Line.RightChop( NextNonspace );
+		const TCHAR C          = Rest[ 0 ];
+
+		int32 End = 0;
+		while( End < Rest.Len() && Rest[ End ] == C )
+		{
+			++End;
+		}
+
+		if( !IsBlank( Rest.RightChop( End ) ) )
+		{
+			return false;
+		}
+
+		CloseUnmatchedBlocks();
+		ConsumeLinkReferences( Stack.Last() );
+
+		const int32 Length = GetTrimmedLeafLength();
+
+		if( Length == 0 )
+		{
+			return false;
+		}
+
+		const FOpenBlock Paragraph = Stack.Pop();
+
+		const int32 Node = AddLeaf( EMarkdownNodeType::Heading, Paragraph.SourceStart, SourceAt( Line.Len() ) );
+
+		FMarkdownNode& Heading = Document.GetMutableNode( Node );
+		Heading.Value  = C == TEXT( '=' ) ? 1 : 2;
+		Heading.Flags |= EMarkdownNodeFlags::Setext;
+
+		QueueInline( Node, FStringView( Leaf ).Left( Length ), LeafSegments );
+
+		bLineConsumed = true;
+		return true;
+	}
+
+	bool FBlockParser::StartTable()
+	{
+		const FStringView Delimiters = Line.RightChop( NextNonspace );
+
+		TArray<EMarkdownNodeFlags> Alignments;
+		if( !ParseTableDelimiterRow( Delimiters, Cells, Alignments ) )
+		{
+			return false;
+		}
+
+		// the header is the last line of the paragraph, which ends with a line break
+		const FStringView Content = Leaf;
+
+		int32 HeaderStart = Content.Len() - 1;
+		while( HeaderStart > 0 && Content[ HeaderStart - 1 ] != TEXT( '\n' ) )
+		{
+			--HeaderStart;
+		}
+
+		const FStringView Header = Content.Mid( HeaderStart, Content.Len() - 1 - HeaderStart );
+
+		SplitTableRow( Header, Cells );
+
+		if( Cells.Num() != Alignments.Num() )
+		{
+			return false;
+		}
+
+		// without a pipe it is more likely to be a setext heading or a list
+		if( UE::String::FindFirstChar( Header, TEXT( '|' ) ) == INDEX_NONE && UE::String::FindFirstChar( Delimiters, TEXT( '|' ) ) == INDEX_NONE )
+		{
+			return false;
+		}
+
+		CloseUnmatchedBlocks();
+
+		const FString HeaderText( Header );
+		const int32 HeaderSource = ToSourceOffset( LeafSegments, HeaderStart );
+
+		// anything above the header is still a paragraph
+		Leaf.LeftInline( HeaderStart );
+		Stack.Last().SourceEnd = FMath::Max( Stack.Last().SourceStart, HeaderSource - 1 );
+		FinalizeTop();
+
+		FOpenBlock& Table = AddChild( EMarkdownNodeType::Table, HeaderSource );
+		Table.Alignments = MoveTemp( Alignments );
+
+		AddTableRow( HeaderText, HeaderSource, true );
+
+		bLineConsumed = true;
+		return true;
+	}
+
+	bool FBlockParser::StartThematicBreak()
+	{
+		const FStringView Rest = Line.RightChop( NextNonspace );
+		const TCHAR C          = Rest[ 0 ];
+
+		int32 Count = 0;
+
+		for( const TCHAR Char : Rest )
+		{
+			if( Char == C )
+			{
+				++Count;
+			}
+			else if( !IsSpaceOrTab( Char ) )
+			{
+				return false;
+			}
+		}
+
+		if( Count < 3 )
+		{
+			return false;
+		}
+
+		CloseUnmatchedBlocks();
+		AddLeaf( EMarkdownNodeType::ThematicBreak, SourceAt( NextNonspace ), SourceAt( Line.Len() ) );
+
+		bLineConsumed = true;
+		return true;
+	}
+
+	bool FBlockParser::StartListItem( const int32 Container )
+	{
+		if( Indent >= 4 )
+		{
+			return false;
+		}
+
+		const FStringView Rest  = Line.RightChop( NextNonspace );
+		const bool bInterrupts  = Stack[ Container ].Type == EMarkdownNodeType::Paragraph;
+
+		TCHAR Marker       = 0;
+		int32 MarkerLength = 0;
+		int32 Start        = 0;
+		bool bOrdered      = false;
+
+		if( Rest[ 0 ] == TEXT( '*' ) || Rest[ 0 ] == TEXT( '+' ) || Rest[ 0 ] == TEXT( '-' ) )
+		{
+			Marker       = Rest[ 0 ];
+			MarkerLength = 1;
+		}
+		else if( IsAsciiDigit( Rest[ 0 ] ) )
+		{
+			int32 Digits = 0;
+
+			while( Digits < Rest.Len() && Digits < 9 && IsAsciiDigit( Rest[ Digits ] ) )
+			{
+				Start = Start * 10 + ( Rest[ Digits ] - TEXT( '0' ) );
+				++Digits;
+			}
+
+			// only a list starting at 1 can interrupt a paragraph
+			if( Digits >= Rest.Len() || ( Rest[ Digits ] != TEXT( '.' ) && Rest[ Digits ] != TEXT( ')' ) ) || ( bInterrupts && Start != 1 ) )
+			{
+				return false;
+			}
+
+			Marker       = Rest[ Digits ];
+			MarkerLength = Digits + 1;
+			bOrdered     = true;
+		}
+		else
+		{
+			return false;
+		}
+
+		if( MarkerLength < Rest.Len() && !IsSpaceOrTab( Rest[ MarkerLength ] ) )
+		{
+			return false;
+		}
+
+		// an empty item can not interrupt a paragraph
+		if( bInterrupts && IsBlank( Rest.RightChop( MarkerLength ) ) )
+		{
+			return false;
+		}
+
+		const int32 MarkerOffset = Indent;
+		const int32 MarkerSource = SourceAt( NextNonspace );
+
+		AdvanceNextNonspace();
+		AdvanceOffset( MarkerLength, true );
+
+		const int32 SpacesStartColumn = Column;
+		const int32 SpacesStartOffset = Offset;
+
+		do
+		{
+			AdvanceOffset( 1, true );
+		}
+		while( Column - SpacesStartColumn < 5 && IsSpaceOrTab( Peek( Offset ) ) );
+
+		const bool bBlankItem         = Offset >= Line.Len();
+		const int32 SpacesAfterMarker = Column - SpacesStartColumn;
+
+		int32 Padding = MarkerLength + SpacesAfterMarker;
+
+		// five or more spaces is indented code inside the item, the content starts one space after the marker
+		if( SpacesAfterMarker >= 5 || SpacesAfterMarker < 1 || bBlankItem )
+		{
+			Padding               = MarkerLength + 1;
+			Column                = SpacesStartColumn;
+			Offset                = SpacesStartOffset;
+			bPartiallyConsumedTab = false;
+
+			if( IsSpaceOrTab( Peek( Offset ) ) )
+			{
+				AdvanceOffset( 1, true );
+			}
+		}
+
+		// [ ] or [x] at the start of the item
+		EMarkdownNodeFlags TaskFlags = EMarkdownNodeFlags::None;
+
+		if( Options.bTaskLists && !bBlankItem )
+		{
+			const FStringView Task = Line.RightChop( Offset );
+
+			if( Task.Len() > 4 && Task[ 0 ] == TEXT( '[' ) && Task[ 2 ] == TEXT( ']' ) && IsSpaceOrTab( Task[ 3 ] ) && !IsBlank( Task.RightChop( 4 ) ) )
+			{
+				const TCHAR Check = Task[ 1 ];
+
+				if( Check == TEXT( ' ' ) || Check == TEXT( 'x' ) || Check == TEXT( 'X' ) )
+				{
+					TaskFlags = Check == TEXT( ' ' ) ? EMarkdownNodeFlags::Task : EMarkdownNodeFlags::Task | EMarkdownNodeFlags::Checked;
+					AdvanceOffset( 3, false );
+				}
+			}
+		}
+
+		CloseUnmatchedBlocks();
+
+		// a different marker starts a new list
+		const FOpenBlock& Tip = Stack.Last();
+
+		if( Tip.Type != EMarkdownNodeType::List || Tip.ListChar != Marker || EnumHasAnyFlags( Tip.Flags, EMarkdownNodeFlags::Ordered ) != bOrdered )
+		{
+			FOpenBlock& List = AddChild( EMarkdownNodeType::List, MarkerSource );
+			List.ListChar  = Marker;
+			List.ListStart = Start;
+			List.Flags     = bOrdered ? EMarkdownNodeFlags::Ordered : EMarkdownNodeFlags::None;
+		}
+
+		FOpenBlock& Item = AddChild( EMarkdownNodeType::ListItem, MarkerSource );
+		Item.ListChar     = Marker;
+		Item.MarkerOffset = MarkerOffset;
+		Item.Padding      = Padding;
+		Item.Flags        = TaskFlags;
+
+		return true;
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// structure
+
+	int32 FBlockParser::PrepareParent( const EMarkdownNodeType Type )
+	{
+		while( !CanContain( Stack.Last().Type, Type ) )
+		{
+			FinalizeTop();
+		}
+
+		FOpenBlock& Parent = Stack.Last();
+
+		if( Parent.bLastLineBlank )
+		{
+			if( Parent.Type == EMarkdownNodeType::List )
+			{
+				Parent.bLoose = true;
+			}
+			else if( Parent.Type == EMarkdownNodeType::ListItem && Parent.bHasChildren )
+			{
+				Stack[ Stack.Num() - 2 ].bLoose = true;
+			}
+		}
+
+		Parent.bHasChildren = true;
+
+		return Stack.Num() - 1;
+	}
+
+	FOpenBlock& FBlockParser::AddChild( const EMarkdownNodeType Type, const int32 SourceStart )
+	{
+		const int32 ParentNode = Stack[ PrepareParent( Type ) ].Node;
+
+		FOpenBlock& Block = Stack.AddDefaulted_GetRef();
+		Block.Type        = Type;
+		Block.SourceStart = SourceStart;
+		Block.SourceEnd   = SourceStart;
+		Block.StartLine   = LineNumber;
+
+		if( IsAddedOnOpen( Type ) )
+		{
+			Block.Node = Document.AddNode( Type, ParentNode );
+		}
+		else
+		{
+			Leaf.Reset();
+			LeafSegments.Reset();
+		}
+
+		return Block;
+	}
+
+	int32 FBlockParser::AddLeaf( const EMarkdownNodeType Type, const int32 SourceStart, const int32 SourceEnd )
+	{
+		const int32 Node = Document.AddNode( Type, Stack[ PrepareParent( Type ) ].Node );
+
+		FMarkdownNode& Leaf = Document.GetMutableNode( Node );
+		Leaf.SourceOffset = SourceStart;
+		Leaf.SourceLength = SourceEnd - SourceStart;
+
+		return Node;
+	}
+
+	void FBlockParser::CloseUnmatchedBlocks()
+	{
+		if( !bAllClosed )
+		{
+			while( Stack.Num() - 1 > LastMatched )
+			{
+				FinalizeTop();
+			}
+
+			bAllClosed = true;
+		}
+	}
+
+	void FBlockParser::FinalizeTop()
+	{
+		FOpenBlock Block = Stack.Pop();
+
+		const int32 ParentNode = Stack.Num() > 0 ? Stack.Last().Node : INDEX_NONE;
+		int32 Node             = Block.Node;
+
+		switch( Block.Type )
+		{
+			case EMarkdownNodeType::Paragraph:
+			{
+				ConsumeLinkReferences( Block );
+
+				// a paragraph of nothing but link definitions goes away
+				if( const int32 Length = GetTrimmedLeafLength() )
+				{
+					Node = Document.AddNode( EMarkdownNodeType::Paragraph, ParentNode );
+					QueueInline( Node, FStringView( Leaf ).Left( Length ), LeafSegments );
+				}
+				break;
+			}
+
+			case EMarkdownNodeType::CodeBlock:
+			{
+				int32 Length = Leaf.Len();
+
+				// indented code loses any blank lines at the end
+				if( !EnumHasAnyFlags( Block.Flags, EMarkdownNodeFlags::Fenced ) )
+				{
+					while( Length > 0 )
+					{
+						int32 LineStart = Length - 1;
+						while( LineStart > 0 && Leaf[ LineStart - 1 ] != TEXT( '\n' ) )
+						{
+							--LineStart;
+						}
+
+						if( !IsBlank( FStringView( Leaf ).Mid( LineStart, Length - LineStart ) ) )
+						{
+							break;
+						}
+
+						Length = LineStart;
+					}
+				}
+
+				Node = Document.AddNode( EMarkdownNodeType::CodeBlock, ParentNode );
+
+				FMarkdownNode& Code = Document.GetMutableNode( Node );
+				Code.Literal = Document.AddString( FStringView( Leaf ).Left( Length ) );
+				Code.Extra   = Document.AddString( Block.Info );
+				break;
+			}
+
+			case EMarkdownNodeType::HtmlBlock:
+			{
+				Node = Document.AddNode( EMarkdownNodeType::HtmlBlock, ParentNode );
+				Document.GetMutableNode( Node ).Literal = Document.AddString( FStringView( Leaf ).TrimEnd() );
+				break;
+			}
+
+			case EMarkdownNodeType::List:
+			{
+				if( !Block.bLoose )
+				{
+					Block.Flags |= EMarkdownNodeFlags::Tight;
+				}
+
+				Document.GetMutableNode( Node ).Value = Block.ListStart;
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		if( Node != INDEX_NONE )
+		{
+			FMarkdownNode& Finished = Document.GetMutableNode( Node );
+			Finished.Flags       |= Block.Flags;
+			Finished.SourceOffset = Block.SourceStart;
+			Finished.SourceLength = FMath::Max( 0, Block.SourceEnd - Block.SourceStart );
+		}
+
+		if( Stack.Num() > 0 )
+		{
+			Stack.Last().SourceEnd = FMath::Max( Stack.Last().SourceEnd, Block.SourceEnd );
+		}
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// content
+
+	void FBlockParser::AddLine()
+	{
+		if( bPartiallyConsumedTab )
+		{
+			// the rest of a tab that was partly used as indentation
+			++Offset;
+
+			LeafSegments.Add( { Leaf.Len(), SourceAt( Offset - 1 ) } );
+
+			for( int32 Spaces = 4 - ( Column % 4 ); Spaces > 0; --Spaces )
+			{
+				Leaf.AppendChar( TEXT( ' ' ) );
+			}
+		}
+
+		LeafSegments.Add( { Leaf.Len(), SourceAt( Offset ) } );
+
+		Leaf.Append( Line.GetData() + Offset, Line.Len() - Offset );
+		Leaf.AppendChar( TEXT( '\n' ) );
+	}
+
+	void FBlockParser::AddTableRow( const FStringView Row, const int32 RowSource, const bool bHeader )
+	{
+		const FOpenBlock& Table = Stack.Last();
+		const int32 RowNode     = Document.AddNode( EMarkdownNodeType::TableRow, Table.Node );
+
+		{
+			FMarkdownNode& Node = Document.GetMutableNode( RowNode );
+			Node.Flags        = bHeader ? EMarkdownNodeFlags::Header : EMarkdownNodeFlags::None;
+			Node.SourceOffset = RowSource;
+			Node.SourceLength = Row.Len();
+		}
+
+		SplitTableRow( Row, Cells );
+
+		// rows are cut or padded to the width of the header
+		for( int32 Column = 0; Column < Table.Alignments.Num(); ++Column )
+		{
+			const int32 CellNode = Document.AddNode( EMarkdownNodeType::TableCell, RowNode );
+
+			FMarkdownNode& Cell = Document.GetMutableNode( CellNode );
+			Cell.Flags = Table.Alignments[ Column ];
+
+			if( Column < Cells.Num() )
+			{
+				const int32 Start = Cells[ Column ].Key;
+				const int32 End   = Cells[ Column ].Value;
+
+				Cell.SourceOffset = RowSource + Start;
+				Cell.SourceLength = End - Start;
+
+				QueueInline( CellNode, Row.Mid( Start, End - Start ), RowSource + Start );
+			}
+			else
+			{
+				Cell.SourceOffset = RowSource + Row.Len();
+			}
+		}
+	}
+
+	void FBlockParser::ConsumeLinkReferences( FOpenBlock& Block )
+	{
+		if( Leaf.IsEmpty() || Leaf[ 0 ] != TEXT( '[' ) )
+		{
+			return;
+		}
+
+		const int32 Consumed = ParseLinkReferences( Leaf, References );
+
+		if( Consumed == 0 )
+		{
+			return;
+		}
+
+		const int32 SourceStart = ToSourceOffset( LeafSegments, Consumed );
+
+		Leaf.RemoveAt( 0, Consumed );
+
+		int32 Keep = 0;
+
+		for( const FSourceSegment& Segment : LeafSegments )
+		{
+			if( Segment.ContentOffset > Consumed )
+			{
+				LeafSegments[ Keep++ ] = { Segment.ContentOffset - Consumed, Segment.SourceOffset };
+			}
+		}
+
+		LeafSegments.SetNum( Keep );
+		LeafSegments.Insert( { 0, SourceStart }, 0 );
+
+		Block.SourceStart = SourceStart;
+	}
+
+	int32 FBlockParser::GetTrimmedLeafLength() const
+	{
+		int32 Length = Leaf.Len();
+
+		while( Length > 0 && IsWhitespace( Leaf[ Length - 1 ] ) )
+		{
+			--Length;
+		}
+
+		return Length;
+	}
+
+	void FBlockParser::QueueInline( const int32 Node, const FStringView Content, const TArrayView<const FSourceSegment> Segments )
+	{
+		FPendingInline& Inline = Pending.AddDefaulted_GetRef();
+		Inline.Node          = Node;
+		Inline.ContentOffset = InlineContent.Len();
+		Inline.ContentLength = Content.Len();
+		Inline.SegmentOffset = InlineSegments.Num();
+		Inline.SegmentCount  = Segments.Num();
+
+		InlineContent.Append( Content.GetData(), Content.Len() );
+		InlineSegments.Append( Segments.GetData(), Segments.Num() );
+	}
+
+	void FBlockParser::QueueInline( const int32 Node, const FStringView Content, const int32 SourceOffset )
+	{
+		const FSourceSegment Segment = { 0, SourceOffset };
+		QueueInline( Node, Content, MakeArrayView( &Segment, 1 ) );
+	}
+
+	void FBlockParser::ParseInlines()
+	{
+		FInlineParser Parser( Document, References, Options );
+
+		const FStringView Content = InlineContent;
+
+		for( const FPendingInline& Inline : Pending )
+		{
+			Parser.Parse( Content.Mid( Inline.ContentOffset, Inline.ContentLength ), MakeArrayView( InlineSegments.GetData() + Inline.SegmentOffset, Inline.SegmentCount ), Inline.Node );
+		}
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownParser::Parse( const FStringView Text, FMarkdownDocument& OutDocument, const FMarkdownParserOptions& Options )
+{
+	MarkdownParser::FBlockParser Parser( OutDocument, Options );
+	Parser.Parse( Text );
+}
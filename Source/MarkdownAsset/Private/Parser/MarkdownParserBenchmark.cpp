@@ -0,0 +1,234 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "LogChannels/MarkdownAssetLogChannels.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Parser/MarkdownParser.h"
+
+#include "MarkdownScan.h"
+
+// Markdown.Parser.Benchmark [File] [Iterations]
+//
+// parses the file (or a generated document of about a megabyte) repeatedly and logs the throughput, the viewer has
+// the same measurement for markdown-it (yarn bench <file> in Viewer) so the two can be compared on the same input
+//
+// Markdown.Parser.BenchmarkScan [File] [Iterations]
+//
+// runs the scanning kernels on their own, scalar against vector, over the same input. They walk the whole text stop
+// by stop like the parser does, so the numbers include the cost of stopping as well as the cost of skipping
+
+#if !UE_BUILD_SHIPPING
+
+namespace MarkdownParser
+{
+	static FString MakeBenchmarkDocument( const int32 TargetLength )
+	{
+		static const TCHAR* Words[] =
+		{
+			TEXT( "lorem" ), TEXT( "ipsum" ), TEXT( "dolor" ), TEXT( "sit" ), TEXT( "amet" ), TEXT( "consectetur" ), TEXT( "adipiscing" ),
+			TEXT( "elit" ), TEXT( "sed" ), TEXT( "do" ), TEXT( "eiusmod" ), TEXT( "tempor" ), TEXT( "**bold**" ), TEXT( "*emphasis*" ),
+			TEXT( "`code`" ), TEXT( "[link](https://example.com)" ), TEXT( "~~gone~~" ), TEXT( "https://www.unrealengine.com" ),
+		};
+
+		FRandomStream Random( 1234 );
+		FString Text;
+		Text.Reserve( TargetLength + 1024 );
+
+		auto AddWords = [&]( const int32 Count )
+		{
+			for( int32 Index = 0; Index < Count; ++Index )
+			{
+				Text += Words[ Random.RandHelper( UE_ARRAY_COUNT( Words ) ) ];
+				Text.AppendChar( Index + 1 < Count ? TEXT( ' ' ) : TEXT( '\n' ) );
+			}
+		};
+
+		while( Text.Len() < TargetLength )
+		{
+			const float Block = Random.FRand();
+
+			if( Block < 0.1f )
+			{
+				Text += Random.RandBool() ? TEXT( "## " ) : TEXT( "### " );
+				AddWords( 4 );
+			}
+			else if( Block < 0.5f )
+			{
+				AddWords( Random.RandRange( 20, 60 ) );
+				AddWords( Random.RandRange( 20, 60 ) );
+			}
+			else if( Block < 0.7f )
+			{
+				for( int32 Item = 0; Item < 5; ++Item )
+				{
+					Text += Random.RandBool() ? TEXT( "- " ) : TEXT( "- [ ] " );
+					AddWords( Random.RandRange( 5, 15 ) );
+				}
+			}
+			else if( Block < 0.8f )
+			{
+				Text += TEXT( "```cpp\n" );
+
+				for( int32 Line = 0; Line < 10; ++Line )
+				{
+					Text += FString::Printf( TEXT( "int32 Value%d = %d;\n" ), Line, Random.RandRange( 0, 1000 ) );
+				}
+
+				Text += TEXT( "```\n" );
+			}
+			else
+			{
+				Text += TEXT( "| Name | Type | Default |\n|:-----|:----:|--------:|\n" );
+
+				for( int32 Row = 0; Row < 5; ++Row )
+				{
+					Text += TEXT( "| " );
+					Text += Words[ Random.RandHelper( UE_ARRAY_COUNT( Words ) ) ];
+					Text += TEXT( " | int32 | " );
+					Text += FString::FromInt( Random.RandRange( 0, 100 ) );
+					Text += TEXT( " |\n" );
+				}
+			}
+
+			Text.AppendChar( TEXT( '\n' ) );
+		}
+
+		return Text;
+	}
+
+	static bool ReadBenchmarkArgs( const TCHAR* Command, const TArray<FString>& Args, FString& OutText, FString& OutSource, int32& InOutIterations )
+	{
+		OutSource = TEXT( "generated document" );
+
+		for( const FString& Arg : Args )
+		{
+			if( Arg.IsNumeric() )
+			{
+				InOutIterations = FMath::Max( 1, FCString::Atoi( *Arg ) );
+			}
+			else if( FFileHelper::LoadFileToString( OutText, *Arg ) )
+			{
+				OutSource = Arg;
+			}
+			else
+			{
+				UE_LOG( MarkdownAssetLog, Error, TEXT( "%s: could not read '%s'" ), Command, *Arg );
+				return false;
+			}
+		}
+
+		if( OutText.IsEmpty() )
+		{
+			OutText = MakeBenchmarkDocument( 1024 * 1024 );
+		}
+
+		return true;
+	}
+
+	static void RunBenchmark( const TArray<FString>& Args )
+	{
+		FString Text;
+		FString Source;
+		int32 Iterations = 20;
+
+		if( !ReadBenchmarkArgs( TEXT( "Markdown.Parser.Benchmark" ), Args, Text, Source, Iterations ) )
+		{
+			return;
+		}
+
+		FMarkdownDocument Document;
+
+		// warm up, and leaves the arrays allocated like they would be for a re-parse
+		FMarkdownParser::Parse( Text, Document );
+
+		const double Start = FPlatformTime::Seconds();
+
+		for( int32 Iteration = 0; Iteration < Iterations; ++Iteration )
+		{
+			FMarkdownParser::Parse( Text, Document );
+		}
+
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		const double Megabytes = double( Text.Len() ) * Iterations / ( 1024.0 * 1024.0 );
+
+		UE_LOG( MarkdownAssetLog, Display, TEXT( "Markdown.Parser.Benchmark: %s, %d characters" ), *Source, Text.Len() );
+		UE_LOG( MarkdownAssetLog, Display, TEXT( "  parse %.2f ms, %.1f MB/s (in characters, the same as the viewer reports)" ), Elapsed * 1000.0 / Iterations, Megabytes / Elapsed );
+		UE_LOG( MarkdownAssetLog, Display, TEXT( "  %d nodes, %.1f KB for the tree and strings" ), Document.Num(), Document.GetAllocatedSize() / 1024.0 );
+	}
+
+	template<typename FindFunc>
+	static void RunScanKernel( const TCHAR* Name, const FString& Text, const int32 Iterations, FindFunc&& Find, int64& OutStops )
+	{
+		const TCHAR* Data = *Text;
+		const int32 Len   = Text.Len();
+
+		const double Start = FPlatformTime::Seconds();
+
+		for( int32 Iteration = 0; Iteration < Iterations; ++Iteration )
+		{
+			OutStops = 0;
+
+			for( int32 Pos = Find( Data, 0, Len ); Pos < Len; Pos = Find( Data, Pos + 1, Len ) )
+			{
+				++OutStops;
+			}
+		}
+
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		const double Gigabytes = double( Len ) * sizeof( TCHAR ) * Iterations / ( 1024.0 * 1024.0 * 1024.0 );
+
+		UE_LOG( MarkdownAssetLog, Display, TEXT( "  %-28s %8.3f ms, %6.2f GB/s, %lld stops" ), Name, Elapsed * 1000.0 / Iterations, Gigabytes / Elapsed, OutStops );
+	}
+
+	static void RunScanBenchmark( const TArray<FString>& Args )
+	{
+		FString Text;
+		FString Source;
+		int32 Iterations = 100;
+
+		if( !ReadBenchmarkArgs( TEXT( "Markdown.Parser.BenchmarkScan" ), Args, Text, Source, Iterations ) )
+		{
+			return;
+		}
+
+		UE_LOG( MarkdownAssetLog, Display, TEXT( "Markdown.Parser.BenchmarkScan: %s, %d characters, vector kernels are %s" ), *Source, Text.Len(), GetScanKernelName() );
+
+		auto FindNewlineScalar = []( const TCHAR* Data, const int32 Start, const int32 End ) { return Scalar::FindChar( Data, Start, End, TEXT( '\n' ) ); };
+		auto FindNewline       = []( const TCHAR* Data, const int32 Start, const int32 End ) { return FindChar( Data, Start, End, TEXT( '\n' ) ); };
+
+		int64 ScalarStops = 0;
+		int64 VectorStops = 0;
+
+		RunScanKernel( TEXT( "line end (scalar)" ), Text, Iterations, FindNewlineScalar, ScalarStops );
+		RunScanKernel( TEXT( "line end" ), Text, Iterations, FindNewline, VectorStops );
+
+		if( ScalarStops != VectorStops )
+		{
+			UE_LOG( MarkdownAssetLog, Error, TEXT( "  line end kernels disagree" ) );
+		}
+
+		RunScanKernel( TEXT( "inline special (scalar)" ), Text, Iterations, &Scalar::FindInlineSpecial, ScalarStops );
+		RunScanKernel( TEXT( "inline special" ), Text, Iterations, &FindInlineSpecial, VectorStops );
+
+		if( ScalarStops != VectorStops )
+		{
+			UE_LOG( MarkdownAssetLog, Error, TEXT( "  inline special kernels disagree" ) );
+		}
+	}
+
+	static FAutoConsoleCommand BenchmarkCommand(
+		TEXT( "Markdown.Parser.Benchmark" ),
+		TEXT( "Measures the native markdown parser. Arguments: [File] [Iterations]" ),
+		FConsoleCommandWithArgsDelegate::CreateStatic( &RunBenchmark )
+	);
+
+	static FAutoConsoleCommand BenchmarkScanCommand(
+		TEXT( "Markdown.Parser.BenchmarkScan" ),
+		TEXT( "Measures the markdown parser's scanning kernels, scalar against vector. Arguments: [File] [Iterations]" ),
+		FConsoleCommandWithArgsDelegate::CreateStatic( &RunScanBenchmark )
+	);
+}
+
+#endif
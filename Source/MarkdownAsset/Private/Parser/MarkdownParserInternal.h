@@ -0,0 +1,241 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Parser/MarkdownDocument.h"
+#include "Parser/MarkdownParser.h"
+
+namespace MarkdownParser
+{
+	//-----------------------------------------------------------------------------------------------------------------
+	// characters
+
+	FORCEINLINE bool IsSpaceOrTab( const TCHAR C )
+	{
+		return C == TEXT( ' ' ) || C == TEXT( '\t' );
+	}
+
+	FORCEINLINE bool IsAsciiPunctuation( const TCHAR C )
+	{
+		return ( C >= TEXT( '!' ) && C <= TEXT( '/' ) ) || ( C >= TEXT( ':' ) && C <= TEXT( '@' ) ) ||
+		       ( C >= TEXT( '[' ) && C <= TEXT( '`' ) ) || ( C >= TEXT( '{' ) && C <= TEXT( '~' ) );
+	}
+
+	FORCEINLINE bool IsAsciiDigit( const TCHAR C )
+	{
+		return C >= TEXT( '0' ) && C <= TEXT( '9' );
+	}
+
+	FORCEINLINE bool IsAsciiAlpha( const TCHAR C )
+	{
+		return ( C >= TEXT( 'a' ) && C <= TEXT( 'z' ) ) || ( C >= TEXT( 'A' ) && C <= TEXT( 'Z' ) );
+	}
+
+	FORCEINLINE bool IsAsciiAlnum( const TCHAR C )
+	{
+		return IsAsciiAlpha( C ) || IsAsciiDigit( C );
+	}
+
+	FORCEINLINE bool IsWhitespace( const TCHAR C )
+	{
+		return C == TEXT( ' ' ) || C == TEXT( '\t' ) || C == TEXT( '\n' ) || C == TEXT( '\r' ) || C == TEXT( '\f' ) || C == TEXT( '\v' ) || ( C > 127 && FChar::IsWhitespace( C ) );
+	}
+
+	FORCEINLINE bool IsPunctuation( const TCHAR C )
+	{
+		return IsAsciiPunctuation( C ) || ( C > 127 && FChar::IsPunct( C ) );
+	}
+
+	FORCEINLINE bool IsBlank( const FStringView Text )
+	{
+		for( const TCHAR C : Text )
+		{
+			if( !IsWhitespace( C ) )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	FORCEINLINE bool StartsWithNoCase( const FStringView Text, const int32 Pos, const FStringView Prefix )
+	{
+		return Text.Len() - Pos >= Prefix.Len() && Text.Mid( Pos, Prefix.Len() ).Equals( Prefix, ESearchCase::IgnoreCase );
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// nesting
+
+	/**
+	 * How deep a node can be in the document. Past half of it a line that would open another block quote or list
+	 * item is read as text, and emphasis and links that would go past it keep only their text. Whatever walks the
+	 * tree recursively (the view, plain text, the link and search builders on workers) can then never run out of
+	 * stack, much as markdown-it's maxNesting does.
+	 */
+	static constexpr int32 MaxNesting = 64;
+	static constexpr int32 MaxBlockNesting = MaxNesting / 2;
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// block content is gathered line by line with the container markers and indentation taken out, this maps
+	// positions in that content back to the source text
+
+	struct FSourceSegment
+	{
+		int32 ContentOffset;
+		int32 SourceOffset;
+	};
+
+	int32 ToSourceOffset( const TArrayView<const FSourceSegment> Segments, const int32 ContentOffset );
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// links
+
+	struct FLinkReference
+	{
+		FString Destination;
+		FString Title;
+	};
+
+	/** keyed by normalized label */
+	using FLinkReferenceMap = TMap<FString, FLinkReference>;
+
+	/** Case folds and collapses whitespace so labels can be compared. */
+	FString NormalizeLabel( const FStringView Label );
+
+	/** Position after the closing ] of a label starting at Pos, or INDEX_NONE. */
+	int32 ScanLinkLabel( const FStringView Text, const int32 Pos );
+
+	/** Parses <dest> or a bare destination with balanced brackets, Pos is moved past it. */
+	bool ParseLinkDestination( const FStringView Text, int32& Pos, FString& OutDestination );
+
+	/** Parses "title", 'title' or (title), Pos is moved past it. */
+	bool ParseLinkTitle( const FStringView Text, int32& Pos, FString& OutTitle );
+
+	/** Appends the text with backslash escapes and entities resolved. */
+	void AppendUnescaped( const FStringView Text, FString& Out );
+
+	/** Decodes the entity at Pos (which points at &), on success Pos is moved past it. */
+	bool DecodeEntity( const FStringView Text, int32& Pos, FString& Out );
+
+	/**
+	 * Reads link reference definitions off the front of a paragraph and adds them to the map (first one wins).
+	 * Returns how many characters of the content they used.
+	 */
+	int32 ParseLinkReferences( const FStringView Content, FLinkReferenceMap& References );
+
+	/** Length of the html tag, comment, processing instruction etc at Pos, or 0 if there is not one. */
+	int32 ScanHtmlTag( const FStringView Text, const int32 Pos );
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	/**
+	 * Turns the text of a paragraph, heading or table cell into inline nodes.
+	 * Uses the delimiter stack from the CommonMark spec for emphasis and links.
+	 */
+	class FInlineParser
+	{
+	public:
+
+		FInlineParser( FMarkdownDocument& InDocument, const FLinkReferenceMap& InReferences, const FMarkdownParserOptions& InOptions );
+
+		void Parse( const FStringView Content, const TArrayView<const FSourceSegment> Segments, const int32 Parent );
+
+	private:
+
+		struct FInline
+		{
+			EMarkdownNodeType Type = EMarkdownNodeType::Text;
+			EMarkdownNodeFlags Flags = EMarkdownNodeFlags::None;
+
+			FMarkdownStringRef Literal;
+			FMarkdownStringRef Extra;
+
+			/** range in the content */
+			int32 Start = 0;
+			int32 End = 0;
+
+			int32 Parent = INDEX_NONE;
+			int32 Prev = INDEX_NONE;
+			int32 Next = INDEX_NONE;
+			int32 FirstChild = INDEX_NONE;
+			int32 LastChild = INDEX_NONE;
+		};
+
+		struct FDelimiter
+		{
+			int32 Node = INDEX_NONE;
+			TCHAR Char = 0;
+			int32 Count = 0;
+			int32 OriginalCount = 0;
+			bool bCanOpen = false;
+			bool bCanClose = false;
+			int32 Prev = INDEX_NONE;
+			int32 Next = INDEX_NONE;
+		};
+
+		struct FBracket
+		{
+			int32 Node = INDEX_NONE;
+			int32 PreviousDelimiter = INDEX_NONE;
+			int32 Position = 0; // just after the [
+			bool bImage = false;
+			bool bActive = true;
+			bool bBracketAfter = false;
+		};
+
+		// tree
+		int32 AddInline( const EMarkdownNodeType Type, const int32 Start, const int32 End );
+		int32 AddText( const int32 Start, const int32 End );
+		int32 AddText( const FStringView Text, const int32 Start, const int32 End );
+		void AppendChild( const int32 Parent, const int32 Child );
+		void InsertAfter( const int32 Sibling, const int32 Node );
+		void Unlink( const int32 Node );
+
+		// scanning
+		void FlushText( const int32 End );
+		void HandleNewline();
+		void HandleBackslash();
+		void HandleBackticks();
+		void HandleDelimiters( const TCHAR C );
+		void HandleOpenBracket( const bool bImage );
+		void HandleCloseBracket();
+		bool HandleAngleBracket();
+		void HandleEntity();
+		bool HandleBareLink();
+
+		void SkipSpaces();
+
+		// delimiters
+		void ProcessEmphasis( const int32 StackBottom );
+		void RemoveDelimiter( const int32 Index );
+
+		// output
+		void Emit( const int32 Parent );
+		int32 EmitNode( const int32 Inline, const int32 Parent, const int32 Depth );
+
+	private:
+
+		FMarkdownDocument& Document;
+		const FLinkReferenceMap& References;
+		const FMarkdownParserOptions& Options;
+
+		FStringView Subject;
+		TArrayView<const FSourceSegment> Map;
+
+		int32 Pos = 0;
+		int32 TextStart = 0;
+
+		TArray<FInline> Inlines;
+		TArray<FDelimiter> Delimiters;
+		TArray<FBracket> Brackets;
+		int32 LastDelimiter = INDEX_NONE;
+
+		FString Scratch;
+	};
+}
@@ -0,0 +1,263 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownScan.h"
+
+#if PLATFORM_CPU_X86_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS && !PLATFORM_TCHAR_IS_4_BYTES
+	#if defined( PLATFORM_ALWAYS_HAS_AVX_2 ) && PLATFORM_ALWAYS_HAS_AVX_2
+		#define MARKDOWN_SCAN_AVX2 1
+		#include <immintrin.h>
+	#else
+		#define MARKDOWN_SCAN_SSE2 1
+		#include <emmintrin.h>
+	#endif
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON && !PLATFORM_TCHAR_IS_4_BYTES
+	#define MARKDOWN_SCAN_NEON 1
+	#include <arm_neon.h>
+#endif
+
+#ifndef MARKDOWN_SCAN_AVX2
+	#define MARKDOWN_SCAN_AVX2 0
+#endif
+
+#ifndef MARKDOWN_SCAN_SSE2
+	#define MARKDOWN_SCAN_SSE2 0
+#endif
+
+#ifndef MARKDOWN_SCAN_NEON
+	#define MARKDOWN_SCAN_NEON 0
+#endif
+
+#define MARKDOWN_SCAN_VECTOR ( MARKDOWN_SCAN_AVX2 || MARKDOWN_SCAN_SSE2 || MARKDOWN_SCAN_NEON )
+
+namespace MarkdownParser
+{
+	//-----------------------------------------------------------------------------------------------------------------
+	// scalar
+
+	// one bit per ascii character: \n ! & * . : < [ \ ] ^ _ ` ~
+	// ^ is never special, it is in here so the scalar and vector kernels stop in the same places (see below)
+	static constexpr uint32 InlineSpecialBits[ 4 ] = { 0x00000400, 0x14004442, 0xF8000000, 0x40000001 };
+
+	FORCEINLINE static bool IsInlineSpecial( const TCHAR C )
+	{
+		return uint32( C ) < 128 && ( InlineSpecialBits[ uint32( C ) >> 5 ] & ( 1u << ( uint32( C ) & 31 ) ) ) != 0;
+	}
+
+	int32 Scalar::FindChar( const TCHAR* Data, const int32 Start, const int32 End, const TCHAR C )
+	{
+		int32 Index = Start;
+
+		while( Index < End && Data[ Index ] != C )
+		{
+			++Index;
+		}
+
+		return Index;
+	}
+
+	int32 Scalar::FindInlineSpecial( const TCHAR* Data, const int32 Start, const int32 End )
+	{
+		int32 Index = Start;
+
+		while( Index < End && !IsInlineSpecial( Data[ Index ] ) )
+		{
+			++Index;
+		}
+
+		return Index;
+	}
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// vector, each instruction set wraps the handful of operations the kernels need on 16 bit lanes
+
+#if MARKDOWN_SCAN_VECTOR
+
+	static_assert( sizeof( TCHAR ) == sizeof( uint16 ), "the vector kernels expect 16 bit characters" );
+
+#if MARKDOWN_SCAN_AVX2
+
+	struct FScanVector
+	{
+		using FVector = __m256i;
+
+		static constexpr int32 Width = 16;
+		static constexpr const TCHAR* Name = TEXT( "AVX2" );
+
+		static FORCEINLINE FVector Load( const TCHAR* Data )             { return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( Data ) ); }
+		static FORCEINLINE FVector Splat( const uint16 Value )           { return _mm256_set1_epi16( static_cast<int16>( Value ) ); }
+		static FORCEINLINE FVector Equal( const FVector A, const FVector B ) { return _mm256_cmpeq_epi16( A, B ); }
+		static FORCEINLINE FVector Or( const FVector A, const FVector B )    { return _mm256_or_si256( A, B ); }
+		static FORCEINLINE FVector Sub( const FVector A, const FVector B )   { return _mm256_sub_epi16( A, B ); }
+
+		/** unsigned A <= B */
+		static FORCEINLINE FVector LessEqual( const FVector A, const FVector B )
+		{
+			return _mm256_cmpeq_epi16( _mm256_subs_epu16( A, B ), _mm256_setzero_si256() );
+		}
+
+		/** index of the first lane set in the mask, or Width */
+		static FORCEINLINE int32 FirstLane( const FVector Mask )
+		{
+			const uint32 Bits = static_cast<uint32>( _mm256_movemask_epi8( Mask ) );
+			return Bits != 0 ? int32( FMath::CountTrailingZeros( Bits ) >> 1 ) : Width;
+		}
+	};
+
+#elif MARKDOWN_SCAN_SSE2
+
+	struct FScanVector
+	{
+		using FVector = __m128i;
+
+		static constexpr int32 Width = 8;
+		static constexpr const TCHAR* Name = TEXT( "SSE2" );
+
+		static FORCEINLINE FVector Load( const TCHAR* Data )             { return _mm_loadu_si128( reinterpret_cast<const __m128i*>( Data ) ); }
+		static FORCEINLINE FVector Splat( const uint16 Value )           { return _mm_set1_epi16( static_cast<int16>( Value ) ); }
+		static FORCEINLINE FVector Equal( const FVector A, const FVector B ) { return _mm_cmpeq_epi16( A, B ); }
+		static FORCEINLINE FVector Or( const FVector A, const FVector B )    { return _mm_or_si128( A, B ); }
+		static FORCEINLINE FVector Sub( const FVector A, const FVector B )   { return _mm_sub_epi16( A, B ); }
+
+		/** unsigned A <= B */
+		static FORCEINLINE FVector LessEqual( const FVector A, const FVector B )
+		{
+			return _mm_cmpeq_epi16( _mm_subs_epu16( A, B ), _mm_setzero_si128() );
+		}
+
+		/** index of the first lane set in the mask, or Width */
+		static FORCEINLINE int32 FirstLane( const FVector Mask )
+		{
+			const uint32 Bits = static_cast<uint32>( _mm_movemask_epi8( Mask ) );
+			return Bits != 0 ? int32( FMath::CountTrailingZeros( Bits ) >> 1 ) : Width;
+		}
+	};
+
+#elif MARKDOWN_SCAN_NEON
+
+	struct FScanVector
+	{
+		using FVector = uint16x8_t;
+
+		static constexpr int32 Width = 8;
+		static constexpr const TCHAR* Name = TEXT( "NEON" );
+
+		static FORCEINLINE FVector Load( const TCHAR* Data )             { return vld1q_u16( reinterpret_cast<const uint16*>( Data ) ); }
+		static FORCEINLINE FVector Splat( const uint16 Value )           { return vdupq_n_u16( Value ); }
+		static FORCEINLINE FVector Equal( const FVector A, const FVector B ) { return vceqq_u16( A, B ); }
+		static FORCEINLINE FVector Or( const FVector A, const FVector B )    { return vorrq_u16( A, B ); }
+		static FORCEINLINE FVector Sub( const FVector A, const FVector B )   { return vsubq_u16( A, B ); }
+
+		/** unsigned A <= B */
+		static FORCEINLINE FVector LessEqual( const FVector A, const FVector B )
+		{
+			return vcleq_u16( A, B );
+		}
+
+		/** index of the first lane set in the mask, or Width */
+		static FORCEINLINE int32 FirstLane( const FVector Mask )
+		{
+			// narrowing leaves a byte per lane, so the mask fits in a scalar register
+			const uint64 Bits = vget_lane_u64( vreinterpret_u64_u8( vmovn_u16( Mask ) ), 0 );
+			return Bits != 0 ? int32( FMath::CountTrailingZeros64( Bits ) >> 3 ) : Width;
+		}
+	};
+
+#endif
+
+	template<typename V>
+	static int32 FindCharVector( const TCHAR* Data, const int32 Start, const int32 End, const TCHAR C )
+	{
+		const typename V::FVector Needle = V::Splat( static_cast<uint16>( C ) );
+
+		int32 Index = Start;
+
+		for( ; Index + V::Width <= End; Index += V::Width )
+		{
+			const int32 Lane = V::FirstLane( V::Equal( V::Load( Data + Index ), Needle ) );
+
+			if( Lane < V::Width )
+			{
+				return Index + Lane;
+			}
+		}
+
+		return Scalar::FindChar( Data, Index, End, C );
+	}
+
+	template<typename V>
+	static int32 FindInlineSpecialVector( const TCHAR* Data, const int32 Start, const int32 End )
+	{
+		// [ \ ] ^ _ ` are tested as one range, which costs a compare instead of six but lets ^ through too
+		const typename V::FVector RangeFirst = V::Splat( '[' );
+		const typename V::FVector RangeLast  = V::Splat( '`' - '[' );
+
+		const typename V::FVector Newline   = V::Splat( '\n' );
+		const typename V::FVector Bang      = V::Splat( '!' );
+		const typename V::FVector Ampersand = V::Splat( '&' );
+		const typename V::FVector Star      = V::Splat( '*' );
+		const typename V::FVector Dot       = V::Splat( '.' );
+		const typename V::FVector Colon     = V::Splat( ':' );
+		const typename V::FVector Less      = V::Splat( '<' );
+		const typename V::FVector Tilde     = V::Splat( '~' );
+
+		int32 Index = Start;
+
+		for( ; Index + V::Width <= End; Index += V::Width )
+		{
+			const typename V::FVector Chunk = V::Load( Data + Index );
+
+			typename V::FVector Mask = V::LessEqual( V::Sub( Chunk, RangeFirst ), RangeLast );
+			Mask = V::Or( Mask, V::Or( V::Equal( Chunk, Newline ), V::Equal( Chunk, Bang ) ) );
+			Mask = V::Or( Mask, V::Or( V::Equal( Chunk, Ampersand ), V::Equal( Chunk, Star ) ) );
+			Mask = V::Or( Mask, V::Or( V::Equal( Chunk, Dot ), V::Equal( Chunk, Colon ) ) );
+			Mask = V::Or( Mask, V::Or( V::Equal( Chunk, Less ), V::Equal( Chunk, Tilde ) ) );
+
+			const int32 Lane = V::FirstLane( Mask );
+
+			if( Lane < V::Width )
+			{
+				return Index + Lane;
+			}
+		}
+
+		return Scalar::FindInlineSpecial( Data, Index, End );
+	}
+
+#endif
+
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	int32 FindChar( const TCHAR* Data, const int32 Start, const int32 End, const TCHAR C )
+	{
+#if MARKDOWN_SCAN_VECTOR
+		return FindCharVector<FScanVector>( Data, Start, End, C );
+#else
+		return Scalar::FindChar( Data, Start, End, C );
+#endif
+	}
+
+	int32 FindInlineSpecial( const TCHAR* Data, const int32 Start, const int32 End )
+	{
+#if MARKDOWN_SCAN_VECTOR
+		return FindInlineSpecialVector<FScanVector>( Data, Start, End );
+#else
+		return Scalar::FindInlineSpecial( Data, Start, End );
+#endif
+	}
+
+	const TCHAR* GetScanKernelName()
+	{
+#if MARKDOWN_SCAN_VECTOR
+		return FScanVector::Name;
+#else
+		return TEXT( "scalar" );
+#endif
+	}
+}
+
+#undef MARKDOWN_SCAN_VECTOR
+#undef MARKDOWN_SCAN_NEON
+#undef MARKDOWN_SCAN_SSE2
+#undef MARKDOWN_SCAN_AVX2
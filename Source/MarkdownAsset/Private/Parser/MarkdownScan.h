@@ -0,0 +1,31 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Scanning kernels for the parser's hot loops. The vector versions look at 8 (SSE2, NEON) or 16 (AVX2) characters
+// at a time, which is picked at compile time, and fall back to the scalar versions for the tail of the range and on
+// platforms where TCHAR is not 16 bits.
+
+namespace MarkdownParser
+{
+	/** Index of the first C in [Start, End), or End. */
+	int32 FindChar( const TCHAR* Data, const int32 Start, const int32 End, const TCHAR C );
+
+	/**
+	 * Index of the first character in [Start, End) the inline parser may need to act on, or End.
+	 * Can stop on a few characters that turn out to be plain text, but never skips one that is not.
+	 */
+	int32 FindInlineSpecial( const TCHAR* Data, const int32 Start, const int32 End );
+
+	/** Name of the vector kernels compiled in, "scalar" if there are none. */
+	const TCHAR* GetScanKernelName();
+
+	/** Reference versions, for the benchmark and platforms without vector kernels. */
+	namespace Scalar
+	{
+		int32 FindChar( const TCHAR* Data, const int32 Start, const int32 End, const TCHAR C );
+		int32 FindInlineSpecial( const TCHAR* Data, const int32 Start, const int32 End );
+	}
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Parser/MarkdownHeadingIndex.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// the expected slugs are what the viewer gives the headings, from markdown-it-anchor's default slugify run in node,
+// and the ones with capitals outside ASCII are the ones FString::ToLower leaves alone
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownHeadingSlugTest, "MarkdownAsset.Parser.HeadingIndex.Slug", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownHeadingSlugTest::RunTest( const FString& Parameters )
+{
+	struct FCase
+	{
+		const TCHAR* Title;
+		const TCHAR* Slug;
+	};
+
+	static const FCase Cases[] =
+	{
+		{ TEXT( "Hello World" ),                                       TEXT( "hello-world" ) },
+		{ TEXT( "  Trim   Me  " ),                                     TEXT( "trim-me" ) },
+		{ TEXT( "C++ & You?" ),                                        TEXT( "c%2B%2B-%26-you%3F" ) },
+		{ TEXT( "Getting Started!" ),                                  TEXT( "getting-started!" ) },
+		{ TEXT( "Title with `code`" ),                                 TEXT( "title-with-code" ) },
+		{ TEXT( "**Bold** Move" ),                                     TEXT( "bold-move" ) },
+		{ TEXT( "\u00DCber Gr\u00F6\u00DFe" ),                         TEXT( "%C3%BCber-gr%C3%B6%C3%9Fe" ) },
+		{ TEXT( "\u015Acie\u017Cka Do Pliku" ),                        TEXT( "%C5%9Bcie%C5%BCka-do-pliku" ) },
+		{ TEXT( "\u0391\u0392\u0393 \u0394\u03AD\u03BB\u03C4\u03B1" ), TEXT( "%CE%B1%CE%B2%CE%B3-%CE%B4%CE%AD%CE%BB%CF%84%CE%B1" ) },
+	};
+
+	for( const FCase& Case : Cases )
+	{
+		TestEqual( Case.Title, FMarkdownHeadingIndex::MakeSlug( Case.Title ), FString( Case.Slug ) );
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownHeadingBuildTest, "MarkdownAsset.Parser.HeadingIndex.Build", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownHeadingBuildTest::RunTest( const FString& Parameters )
+{
+	const FString Text = TEXT(
+		"# \u00DCber\n"
+		"text\n"
+		"```\n"
+		"# not a heading\n"
+		"```\n"
+		"## Setup\n"
+		"Setup\n"
+		"=====\n"
+		"## \u00DCber\n"
+	);
+
+	TArray<FMarkdownHeading> Headings;
+	FMarkdownHeadingIndex::Build( Text, Headings );
+
+	if( !TestEqual( TEXT( "headings" ), Headings.Num(), 4 ) )
+	{
+		return false;
+	}
+
+	// repeats take the first of -1, -2 and so on that is free
+	TestEqual( TEXT( "first" ), Headings[ 0 ].Slug, FString( TEXT( "%C3%BCber" ) ) );
+	TestEqual( TEXT( "second" ), Headings[ 1 ].Slug, FString( TEXT( "setup" ) ) );
+	TestEqual( TEXT( "underlined" ), Headings[ 2 ].Slug, FString( TEXT( "setup-1" ) ) );
+	TestEqual( TEXT( "repeat" ), Headings[ 3 ].Slug, FString( TEXT( "%C3%BCber-1" ) ) );
+
+	TestEqual( TEXT( "underlined level" ), Headings[ 2 ].Level, 1 );
+	TestEqual( TEXT( "section runs to the next heading of its level" ), Headings[ 0 ].SectionLength, Headings[ 2 ].Offset );
+
+	// a heading added in the first section gives the same headings as building again
+	FString Edited = Text;
+	Edited.InsertAt( 7, TEXT( "## Added\n" ) );
+
+	TArray<FMarkdownHeading> Updated = Headings;
+	FMarkdownHeadingIndex::Update( Edited, 7, 0, 9, Updated );
+
+	TArray<FMarkdownHeading> Rebuilt;
+	FMarkdownHeadingIndex::Build( Edited, Rebuilt );
+
+	if( TestEqual( TEXT( "headings after the edit" ), Updated.Num(), Rebuilt.Num() ) )
+	{
+		for( int32 Index = 0; Index < Rebuilt.Num(); ++Index )
+		{
+			TestEqual( TEXT( "slug after the edit" ), Updated[ Index ].Slug, Rebuilt[ Index ].Slug );
+			TestEqual( TEXT( "offset after the edit" ), Updated[ Index ].Offset, Rebuilt[ Index ].Offset );
+			TestEqual( TEXT( "section after the edit" ), Updated[ Index ].SectionLength, Rebuilt[ Index ].SectionLength );
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,534 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Parser/MarkdownDocument.h"
+#include "Parser/MarkdownParser.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MarkdownParserTests
+{
+	static void AppendEscaped( const FStringView Text, FString& Out )
+	{
+		for( const TCHAR C : Text )
+		{
+			switch( C )
+			{
+				case TEXT( '&' ): Out += TEXT( "&amp;" );  break;
+				case TEXT( '<' ): Out += TEXT( "&lt;" );   break;
+				case TEXT( '>' ): Out += TEXT( "&gt;" );   break;
+				case TEXT( '"' ): Out += TEXT( "&quot;" ); break;
+				default:          Out.AppendChar( C );     break;
+			}
+		}
+	}
+
+	/** HTML the way the CommonMark reference renderer (commonmark.js) writes it, so spec examples compare as they are. */
+	class FHtmlWriter
+	{
+	public:
+
+		explicit FHtmlWriter( const FMarkdownDocument& InDocument )
+			: Document( InDocument )
+		{
+		}
+
+		FString Write()
+		{
+			Out.Reset();
+			WriteChildren( FMarkdownDocument::Root );
+			return Out;
+		}
+
+	private:
+
+		// a line break unless there is one already
+		void Cr()
+		{
+			if( !Out.IsEmpty() && !Out.EndsWith( TEXT( "\n" ) ) )
+			{
+				Out.AppendChar( TEXT( '\n' ) );
+			}
+		}
+
+		void WriteChildren( const int32 Index )
+		{
+			Document.ForEachChild( Index, [ this ]( const int32 Child )
+			{
+				WriteNode( Child );
+			});
+		}
+
+		bool IsInTightList( const int32 Index ) const
+		{
+			const int32 Item = Document[ Index ].Parent;
+			const int32 List = Item != INDEX_NONE && Document[ Item ].Type == EMarkdownNodeType::ListItem ? Document[ Item ].Parent : INDEX_NONE;
+			return List != INDEX_NONE && Document[ List ].HasFlag( EMarkdownNodeFlags::Tight );
+		}
+
+		void WriteAltText( const int32 Index )
+		{
+			Document.ForEachDescendant( Index, [ this, Index ]( const int32 Node )
+			{
+				const EMarkdownNodeType Type = Document[ Node ].Type;
+
+				if( Node != Index && ( Type == EMarkdownNodeType::Text || Type == EMarkdownNodeType::Code ) )
+				{
+					AppendEscaped( Document.GetLiteral( Node ), Out );
+				}
+				else if( Type == EMarkdownNodeType::SoftBreak || Type == EMarkdownNodeType::HardBreak )
+				{
+					Out.AppendChar( TEXT( '\n' ) );
+				}
+			});
+		}
+
+		void WriteTitle( const int32 Index )
+		{
+			if( !Document.GetLiteral( Index ).IsEmpty() )
+			{
+				Out += TEXT( " title=\"" );
+				AppendEscaped( Document.GetLiteral( Index ), Out );
+				Out += TEXT( "\"" );
+			}
+		}
+
+		void WriteCell( const int32 Index, const TCHAR* Tag )
+		{
+			const FMarkdownNode& Cell = Document[ Index ];
+
+			Out += FString::Printf( TEXT( "<%s" ), Tag );
+
+			if( Cell.HasFlag( EMarkdownNodeFlags::AlignCenter ) )
+			{
+				Out += TEXT( " align=\"center\"" );
+			}
+			else if( Cell.HasFlag( EMarkdownNodeFlags::AlignLeft ) )
+			{
+				Out += TEXT( " align=\"left\"" );
+			}
+			else if( Cell.HasFlag( EMarkdownNodeFlags::AlignRight ) )
+			{
+				Out += TEXT( " align=\"right\"" );
+			}
+
+			Out += TEXT( ">" );
+			WriteChildren( Index );
+			Out += FString::Printf( TEXT( "</%s>" ), Tag );
+			Cr();
+		}
+
+		void WriteTable( const int32 Index )
+		{
+			Cr();
+			Out += TEXT( "<table>" );
+			Cr();
+
+			bool bInBody = false;
+
+			Document.ForEachChild( Index, [ this, &bInBody ]( const int32 Row )
+			{
+				const bool bHeader = Document[ Row ].HasFlag( EMarkdownNodeFlags::Header );
+
+				if( bHeader )
+				{
+					Out += TEXT( "<thead>\n" );
+				}
+				else if( !bInBody )
+				{
+					Out += TEXT( "<tbody>\n" );
+					bInBody = true;
+				}
+
+				Out += TEXT( "<tr>\n" );
+
+				Document.ForEachChild( Row, [ this, bHeader ]( const int32 Cell )
+				{
+					WriteCell( Cell, bHeader ? TEXT( "th" ) : TEXT( "td" ) );
+				});
+
+				Out += TEXT( "</tr>\n" );
+
+				if( bHeader )
+				{
+					Out += TEXT( "</thead>\n" );
+				}
+			});
+
+			if( bInBody )
+			{
+				Out += TEXT( "</tbody>\n" );
+			}
+
+			Out += TEXT( "</table>" );
+			Cr();
+		}
+
+		void WriteNode( const int32 Index )
+		{
+			const FMarkdownNode& Node = Document[ Index ];
+
+			switch( Node.Type )
+			{
+				case EMarkdownNodeType::BlockQuote:
+					Cr();
+					Out += TEXT( "<blockquote>" );
+					Cr();
+					WriteChildren( Index );
+					Cr();
+					Out += TEXT( "</blockquote>" );
+					Cr();
+					break;
+
+				case EMarkdownNodeType::List:
+				{
+					const TCHAR* Tag = Node.HasFlag( EMarkdownNodeFlags::Ordered ) ? TEXT( "ol" ) : TEXT( "ul" );
+
+					Cr();
+					Out += Node.HasFlag( EMarkdownNodeFlags::Ordered ) && Node.Value != 1 ? FString::Printf( TEXT( "<ol start=\"%d\">" ), Node.Value ) : FString::Printf( TEXT( "<%s>" ), Tag );
+					Cr();
+					WriteChildren( Index );
+					Cr();
+					Out += FString::Printf( TEXT( "</%s>" ), Tag );
+					Cr();
+					break;
+				}
+
+				case EMarkdownNodeType::ListItem:
+					Out += TEXT( "<li>" );
+					WriteChildren( Index );
+					Out += TEXT( "</li>" );
+					Cr();
+					break;
+
+				case EMarkdownNodeType::Paragraph:
+					if( IsInTightList( Index ) )
+					{
+						WriteChildren( Index );
+					}
+					else
+					{
+						Cr();
+						Out += TEXT( "<p>" );
+						WriteChildren( Index );
+						Out += TEXT( "</p>" );
+						Cr();
+					}
+					break;
+
+				case EMarkdownNodeType::Heading:
+					Cr();
+					Out += FString::Printf( TEXT( "<h%d>" ), Node.Value );
+					WriteChildren( Index );
+					Out += FString::Printf( TEXT( "</h%d>" ), Node.Value );
+					Cr();
+					break;
+
+				case EMarkdownNodeType::ThematicBreak:
+					Cr();
+					Out += TEXT( "<hr />" );
+					Cr();
+					break;
+
+				case EMarkdownNodeType::CodeBlock:
+				{
+					// the language is the first word of the info string
+					FStringView Language = Document.GetExtra( Index );
+					int32 Space;
+
+					if( Language.FindChar( TEXT( ' ' ), Space ) )
+					{
+						Language = Language.Left( Space );
+					}
+
+					Cr();
+					Out += TEXT( "<pre><code" );
+
+					if( !Language.IsEmpty() )
+					{
+						Out += TEXT( " class=\"language-" );
+						AppendEscaped( Language, Out );
+						Out += TEXT( "\"" );
+					}
+
+					Out += TEXT( ">" );
+					AppendEscaped( Document.GetLiteral( Index ), Out );
+					Out += TEXT( "</code></pre>" );
+					Cr();
+					break;
+				}
+
+				case EMarkdownNodeType::HtmlBlock:
+					Cr();
+					Out += Document.GetLiteral( Index );
+					Cr();
+					break;
+
+				case EMarkdownNodeType::Table:
+					WriteTable( Index );
+					break;
+
+				case EMarkdownNodeType::Text:
+					AppendEscaped( Document.GetLiteral( Index ), Out );
+					break;
+
+				case EMarkdownNodeType::SoftBreak:
+					Out.AppendChar( TEXT( '\n' ) );
+					break;
+
+				case EMarkdownNodeType::HardBreak:
+					Out += TEXT( "<br />\n" );
+					break;
+
+				case EMarkdownNodeType::Code:
+					Out += TEXT( "<code>" );
+					AppendEscaped( Document.GetLiteral( Index ), Out );
+					Out += TEXT( "</code>" );
+					break;
+
+				case EMarkdownNodeType::Emphasis:
+					Out += TEXT( "<em>" );
+					WriteChildren( Index );
+					Out += TEXT( "</em>" );
+					break;
+
+				case EMarkdownNodeType::Strong:
+					Out += TEXT( "<strong>" );
+					WriteChildren( Index );
+					Out += TEXT( "</strong>" );
+					break;
+
+				case EMarkdownNodeType::Strikethrough:
+					Out += TEXT( "<del>" );
+					WriteChildren( Index );
+					Out += TEXT( "</del>" );
+					break;
+
+				case EMarkdownNodeType::Link:
+					Out += TEXT( "<a href=\"" );
+					AppendEscaped( Document.GetExtra( Index ), Out );
+					Out += TEXT( "\"" );
+					WriteTitle( Index );
+					Out += TEXT( ">" );
+					WriteChildren( Index );
+					Out += TEXT( "</a>" );
+					break;
+
+				case EMarkdownNodeType::Image:
+					Out += TEXT( "<img src=\"" );
+					AppendEscaped( Document.GetExtra( Index ), Out );
+					Out += TEXT( "\" alt=\"" );
+					WriteAltText( Index );
+					Out += TEXT( "\"" );
+					WriteTitle( Index );
+					Out += TEXT( " />" );
+					break;
+
+				case EMarkdownNodeType::Html:
+					Out += Document.GetLiteral( Index );
+					break;
+
+				default:
+					WriteChildren( Index );
+					break;
+			}
+		}
+
+		const FMarkdownDocument& Document;
+		FString Out;
+	};
+
+	static FString ToHtml( const FStringView Markdown )
+	{
+		const FMarkdownDocument Document = FMarkdownParser::Parse( Markdown );
+		return FHtmlWriter( Document ).Write();
+	}
+
+	static int32 GetDepth( const FMarkdownDocument& Document )
+	{
+		int32 MaxDepth = 0;
+
+		for( int32 Index = 0; Index < Document.Num(); ++Index )
+		{
+			int32 Depth = 0;
+
+			for( int32 Parent = Document[ Index ].Parent; Parent != INDEX_NONE; Parent = Document[ Parent ].Parent )
+			{
+				++Depth;
+			}
+
+			MaxDepth = FMath::Max( MaxDepth, Depth );
+		}
+
+		return MaxDepth;
+	}
+
+	struct FExample
+	{
+		const TCHAR* Markdown;
+		const TCHAR* Html;
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// examples from the CommonMark spec (and the GFM one for the extensions), with the output it gives for them
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownParserBlocksTest, "MarkdownAsset.Parser.CommonMark.Blocks", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownParserBlocksTest::RunTest( const FString& Parameters )
+{
+	static const MarkdownParserTests::FExample Examples[] =
+	{
+		// tabs
+		{ TEXT( "\tfoo\tbaz\t\tbim\n" ),                       TEXT( "<pre><code>foo\tbaz\t\tbim\n</code></pre>\n" ) },
+
+		// thematic breaks
+		{ TEXT( "***\n---\n___\n" ),                           TEXT( "<hr />\n<hr />\n<hr />\n" ) },
+
+		// headings
+		{ TEXT( "# foo\n## foo\n###### foo\n" ),               TEXT( "<h1>foo</h1>\n<h2>foo</h2>\n<h6>foo</h6>\n" ) },
+		{ TEXT( "#5 bolt\n\n#hashtag\n" ),                     TEXT( "<p>#5 bolt</p>\n<p>#hashtag</p>\n" ) },
+		{ TEXT( "Foo *bar*\n=========\n\nFoo *bar*\n---------\n" ), TEXT( "<h1>Foo <em>bar</em></h1>\n<h2>Foo <em>bar</em></h2>\n" ) },
+
+		// code
+		{ TEXT( "    a simple\n      indented code block\n" ), TEXT( "<pre><code>a simple\n  indented code block\n</code></pre>\n" ) },
+		{ TEXT( "Foo\n    bar\n" ),                            TEXT( "<p>Foo\nbar</p>\n" ) },
+		{ TEXT( "```ruby\ndef foo(x)\n  return 3\nend\n```\n" ), TEXT( "<pre><code class=\"language-ruby\">def foo(x)\n  return 3\nend\n</code></pre>\n" ) },
+		{ TEXT( "```\naaa\n~~~\n```\n" ),                      TEXT( "<pre><code>aaa\n~~~\n</code></pre>\n" ) },
+		{ TEXT( "```\n<\n >\n```\n" ),                         TEXT( "<pre><code>&lt;\n &gt;\n</code></pre>\n" ) },
+
+		// html blocks
+		{ TEXT( "<div>\n*hello*\n</div>\n" ),                  TEXT( "<div>\n*hello*\n</div>\n" ) },
+
+		// link reference definitions
+		{ TEXT( "[foo]: /url \"title\"\n\n[foo]\n" ),          TEXT( "<p><a href=\"/url\" title=\"title\">foo</a></p>\n" ) },
+		{ TEXT( "[FOO]: /url\n\n[Foo]\n" ),                    TEXT( "<p><a href=\"/url\">Foo</a></p>\n" ) },
+
+		// paragraphs
+		{ TEXT( "aaa\n\nbbb\n" ),                              TEXT( "<p>aaa</p>\n<p>bbb</p>\n" ) },
+
+		// block quotes
+		{ TEXT( "> # Foo\n> bar\n> baz\n" ),                   TEXT( "<blockquote>\n<h1>Foo</h1>\n<p>bar\nbaz</p>\n</blockquote>\n" ) },
+		{ TEXT( "> bar\nbaz\n> foo\n" ),                       TEXT( "<blockquote>\n<p>bar\nbaz\nfoo</p>\n</blockquote>\n" ) },
+
+		// lists
+		{ TEXT( "- foo\n- bar\n+ baz\n" ),                     TEXT( "<ul>\n<li>foo</li>\n<li>bar</li>\n</ul>\n<ul>\n<li>baz</li>\n</ul>\n" ) },
+		{ TEXT( "1. foo\n2. bar\n3) baz\n" ),                  TEXT( "<ol>\n<li>foo</li>\n<li>bar</li>\n</ol>\n<ol start=\"3\">\n<li>baz</li>\n</ol>\n" ) },
+		{ TEXT( "- a\n- b\n\n- c\n" ),                         TEXT( "<ul>\n<li>\n<p>a</p>\n</li>\n<li>\n<p>b</p>\n</li>\n<li>\n<p>c</p>\n</li>\n</ul>\n" ) },
+		{ TEXT( "- a\n  - b\n" ),                              TEXT( "<ul>\n<li>a\n<ul>\n<li>b</li>\n</ul>\n</li>\n</ul>\n" ) },
+
+		// tables (GFM)
+		{ TEXT( "| foo | bar |\n| --- | --- |\n| baz | bim |\n" ),
+		  TEXT( "<table>\n<thead>\n<tr>\n<th>foo</th>\n<th>bar</th>\n</tr>\n</thead>\n<tbody>\n<tr>\n<td>baz</td>\n<td>bim</td>\n</tr>\n</tbody>\n</table>\n" ) },
+		{ TEXT( "| abc | defghi |\n:-: | -----------:\nbar | baz\n" ),
+		  TEXT( "<table>\n<thead>\n<tr>\n<th align=\"center\">abc</th>\n<th align=\"right\">defghi</th>\n</tr>\n</thead>\n<tbody>\n<tr>\n<td align=\"center\">bar</td>\n<td align=\"right\">baz</td>\n</tr>\n</tbody>\n</table>\n" ) },
+	};
+
+	for( const MarkdownParserTests::FExample& Example : Examples )
+	{
+		TestEqual( Example.Markdown, MarkdownParserTests::ToHtml( Example.Markdown ), FString( Example.Html ) );
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownParserInlinesTest, "MarkdownAsset.Parser.CommonMark.Inlines", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownParserInlinesTest::RunTest( const FString& Parameters )
+{
+	static const MarkdownParserTests::FExample Examples[] =
+	{
+		// escapes and entities
+		{ TEXT( "\\*not emphasized*\n" ),                      TEXT( "<p>*not emphasized*</p>\n" ) },
+		{ TEXT( "&amp; &lt; &#35;\n" ),                        TEXT( "<p>&amp; &lt; #</p>\n" ) },
+
+		// code spans
+		{ TEXT( "`foo`\n" ),                                   TEXT( "<p><code>foo</code></p>\n" ) },
+		{ TEXT( "`` foo ` bar ``\n" ),                         TEXT( "<p><code>foo ` bar</code></p>\n" ) },
+		{ TEXT( "`<a href=\"`\">`\n" ),                        TEXT( "<p><code>&lt;a href=&quot;</code>&quot;&gt;`</p>\n" ) },
+
+		// emphasis
+		{ TEXT( "*foo bar*\n" ),                               TEXT( "<p><em>foo bar</em></p>\n" ) },
+		{ TEXT( "a * foo bar*\n" ),                            TEXT( "<p>a * foo bar*</p>\n" ) },
+		{ TEXT( "foo*bar*\n" ),                                TEXT( "<p>foo<em>bar</em></p>\n" ) },
+		{ TEXT( "**foo bar**\n" ),                             TEXT( "<p><strong>foo bar</strong></p>\n" ) },
+		{ TEXT( "*foo**bar**baz*\n" ),                         TEXT( "<p><em>foo<strong>bar</strong>baz</em></p>\n" ) },
+		{ TEXT( "**foo*\n" ),                                  TEXT( "<p>*<em>foo</em></p>\n" ) },
+		{ TEXT( "~~Hi~~ Hello, world!\n" ),                    TEXT( "<p><del>Hi</del> Hello, world!</p>\n" ) },
+
+		// links and images
+		{ TEXT( "[link](/uri \"title\")\n" ),                  TEXT( "<p><a href=\"/uri\" title=\"title\">link</a></p>\n" ) },
+		{ TEXT( "[link]()\n" ),                                TEXT( "<p><a href=\"\">link</a></p>\n" ) },
+		{ TEXT( "[link *foo **bar** `#`*](/uri)\n" ),          TEXT( "<p><a href=\"/uri\">link <em>foo <strong>bar</strong> <code>#</code></em></a></p>\n" ) },
+		{ TEXT( "![foo](/url \"title\")\n" ),                  TEXT( "<p><img src=\"/url\" alt=\"foo\" title=\"title\" /></p>\n" ) },
+		{ TEXT( "<http://foo.bar.baz>\n" ),                    TEXT( "<p><a href=\"http://foo.bar.baz\">http://foo.bar.baz</a></p>\n" ) },
+		{ TEXT( "see https://example.com/a now\n" ),           TEXT( "<p>see <a href=\"https://example.com/a\">https://example.com/a</a> now</p>\n" ) },
+
+		// raw html
+		{ TEXT( "<a><bab><c2c>\n" ),                           TEXT( "<p><a><bab><c2c></p>\n" ) },
+
+		// line breaks
+		{ TEXT( "foo  \nbaz\n" ),                              TEXT( "<p>foo<br />\nbaz</p>\n" ) },
+		{ TEXT( "foo\\\nbaz\n" ),                              TEXT( "<p>foo<br />\nbaz</p>\n" ) },
+		{ TEXT( "foo \n baz\n" ),                              TEXT( "<p>foo\nbaz</p>\n" ) },
+	};
+
+	for( const MarkdownParserTests::FExample& Example : Examples )
+	{
+		TestEqual( Example.Markdown, MarkdownParserTests::ToHtml( Example.Markdown ), FString( Example.Html ) );
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownParserTaskListTest, "MarkdownAsset.Parser.TaskList", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownParserTaskListTest::RunTest( const FString& Parameters )
+{
+	const FMarkdownDocument Document = FMarkdownParser::Parse( TEXT( "- [ ] foo\n- [x] bar\n" ) );
+
+	TArray<int32> Items;
+	Document.ForEachDescendant( FMarkdownDocument::Root, [ & ]( const int32 Index )
+	{
+		if( Document[ Index ].Type == EMarkdownNodeType::ListItem )
+		{
+			Items.Add( Index );
+		}
+	});
+
+	if( !TestEqual( TEXT( "items" ), Items.Num(), 2 ) )
+	{
+		return false;
+	}
+
+	TestTrue( TEXT( "first is a task" ), Document[ Items[ 0 ] ].HasFlag( EMarkdownNodeFlags::Task ) );
+	TestFalse( TEXT( "first is not ticked" ), Document[ Items[ 0 ] ].HasFlag( EMarkdownNodeFlags::Checked ) );
+	TestTrue( TEXT( "second is ticked" ), Document[ Items[ 1 ] ].HasFlag( EMarkdownNodeFlags::Task | EMarkdownNodeFlags::Checked ) );
+	TestEqual( TEXT( "the checkbox is not text" ), Document.GetPlainText( Items[ 0 ] ).TrimStartAndEnd(), FString( TEXT( "foo" ) ) );
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownParserNestingTest, "MarkdownAsset.Parser.Nesting", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownParserNestingTest::RunTest( const FString& Parameters )
+{
+	// far deeper than anyone writes, past the parser's MaxNesting (64) the markup is dropped and the text kept
+	const FString Quotes = FString::ChrN( 10000, TEXT( '>' ) ) + TEXT( " deep\n" );
+	const FString Lists  = [] { FString Text; for( int32 Level = 0; Level < 1000; ++Level ) { Text += FString::ChrN( Level * 2, TEXT( ' ' ) ) + TEXT( "- deep\n" ); } return Text; }();
+	const FString Inline = FString::ChrN( 2000, TEXT( '*' ) ) + TEXT( "deep" ) + FString::ChrN( 2000, TEXT( '*' ) ) + TEXT( "\n" );
+	const FString Links  = FString::ChrN( 5000, TEXT( '[' ) ) + TEXT( "deep" ) + FString::ChrN( 5000, TEXT( ']' ) ) + TEXT( "\n" );
+
+	for( const FString* Text : { &Quotes, &Lists, &Inline, &Links } )
+	{
+		const FMarkdownDocument Document = FMarkdownParser::Parse( *Text );
+
+		TestTrue( TEXT( "the text is kept" ), Document.GetPlainText().Contains( TEXT( "deep" ) ) );
+		TestTrue( TEXT( "the nesting is capped" ), MarkdownParserTests::GetDepth( Document ) <= 64 );
+	}
+
+	return true;
+}
+
+#endif
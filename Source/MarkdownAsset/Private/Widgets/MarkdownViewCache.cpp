@@ -0,0 +1,88 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Widgets/MarkdownViewCache.h"
+
+#include "Widgets/SMarkdownView.h"
+
+namespace MarkdownViewCache
+{
+	// widths are the allotted geometry, which moves about by fractions of a pixel with dpi scaling
+	static constexpr float WidthTolerance = 0.5f;
+}
+
+FMarkdownViewCache& FMarkdownViewCache::Get()
+{
+	static FMarkdownViewCache Instance;
+	return Instance;
+}
+
+TSharedPtr<SMarkdownView> FMarkdownViewCache::Take( const FMarkdownDocument& Document, const ISlateStyle* Style, const float Width )
+{
+	check( IsInGameThread() );
+
+	int32 Found = INDEX_NONE;
+
+	// newest first, a matching width wins over any other
+	for( int32 Index = Views.Num() - 1; Index >= 0; --Index )
+	{
+		const SMarkdownView& View = *Views[ Index ];
+
+		if( &View.GetDocument() != &Document || View.GetStyle() != Style )
+		{
+			continue;
+		}
+
+		if( FMath::IsNearlyEqual( View.GetLaidOutWidth(), Width, MarkdownViewCache::WidthTolerance ) )
+		{
+			Found = Index;
+			break;
+		}
+
+		if( Found == INDEX_NONE )
+		{
+			Found = Index;
+		}
+	}
+
+	if( Found == INDEX_NONE )
+	{
+		return nullptr;
+	}
+
+	TSharedRef<SMarkdownView> View = Views[ Found ];
+	Views.RemoveAt( Found );
+
+	return View;
+}
+
+void FMarkdownViewCache::Park( const TSharedRef<SMarkdownView>& View )
+{
+	check( IsInGameThread() );
+
+	// whoever had it is gone
+	View->SetOnLinkClicked( FOnMarkdownLinkClicked() );
+
+	Views.Remove( View );
+	Views.Add( View );
+
+	Trim();
+}
+
+void FMarkdownViewCache::Empty()
+{
+	Views.Empty();
+}
+
+void FMarkdownViewCache::SetCapacity( const int32 InCapacity )
+{
+	Capacity = FMath::Max( InCapacity, 0 );
+	Trim();
+}
+
+void FMarkdownViewCache::Trim()
+{
+	if( Views.Num() > Capacity )
+	{
+		Views.RemoveAt( 0, Views.Num() - Capacity );
+	}
+}
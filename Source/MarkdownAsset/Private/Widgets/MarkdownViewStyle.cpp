@@ -0,0 +1,174 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Widgets/MarkdownViewStyle.h"
+
+#include "Brushes/SlateColorBrush.h"
+#include "Brushes/SlateNoResource.h"
+#include "Brushes/SlateRoundedBoxBrush.h"
+#include "Styling/CoreStyle.h"
+#include "Styling/SlateStyleRegistry.h"
+#include "Styling/SlateTypes.h"
+#include "Styling/StyleColors.h"
+
+namespace MarkdownViewStyle
+{
+	static TSharedPtr<FMarkdownViewStyle> Instance;
+
+	struct FBlockStyle
+	{
+		const TCHAR* Name;
+		int32 Size;
+		bool bBold;
+	};
+
+	static const FBlockStyle BlockStyles[] =
+	{
+		{ TEXT( "Paragraph" ),   10, false },
+		{ TEXT( "Heading1" ),    20, true  },
+		{ TEXT( "Heading2" ),    16, true  },
+		{ TEXT( "Heading3" ),    13, true  },
+		{ TEXT( "Heading4" ),    11, true  },
+		{ TEXT( "Heading5" ),    10, true  },
+		{ TEXT( "Heading6" ),    10, true  },
+		{ TEXT( "TableHeader" ), 10, true  },
+	};
+
+	static const TCHAR* GetTypeface( const bool bBold, const bool bItalic )
+	{
+		return bBold ? ( bItalic ? TEXT( "BoldItalic" ) : TEXT( "Bold" ) ) : ( bItalic ? TEXT( "Italic" ) : TEXT( "Regular" ) );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------------
+
+const ISlateStyle& FMarkdownViewStyle::Get()
+{
+	if( !MarkdownViewStyle::Instance.IsValid() )
+	{
+		MarkdownViewStyle::Instance = MakeShared<FMarkdownViewStyle>();
+	}
+
+	return *MarkdownViewStyle::Instance;
+}
+
+void FMarkdownViewStyle::Shutdown()
+{
+	MarkdownViewStyle::Instance.Reset();
+}
+
+FString FMarkdownViewStyle::GetInlineStyleName( const FString& BlockStyle, const bool bStrong, const bool bEmphasis, const bool bStrikethrough, const bool bCode )
+{
+	// code spans can't contain other formatting
+	if( bCode )
+	{
+		return BlockStyle + TEXT( ".Code" );
+	}
+
+	if( !bStrong && !bEmphasis && !bStrikethrough )
+	{
+		return BlockStyle;
+	}
+
+	FString Name = BlockStyle;
+	Name += TEXT( "." );
+
+	if( bStrong )
+	{
+		Name += TEXT( "Strong" );
+	}
+
+	if( bEmphasis )
+	{
+		Name += TEXT( "Emphasis" );
+	}
+
+	if( bStrikethrough )
+	{
+		Name += TEXT( "Strikethrough" );
+	}
+
+	return Name;
+}
+
+//-----------------------------------------------------------------------------------------------------------------
+
+FMarkdownViewStyle::FMarkdownViewStyle()
+	: FSlateStyleSet( "MarkdownViewStyle" )
+{
+	using namespace MarkdownViewStyle;
+
+	const FTextBlockStyle& NormalText = FCoreStyle::Get().GetWidgetStyle<FTextBlockStyle>( "NormalText" );
+	const FSlateColorBrush StrikeBrush( FStyleColors::Foreground );
+
+	for( const FBlockStyle& Block : BlockStyles )
+	{
+		const FString BlockName = Block.Name;
+		const FSlateColor Color = Block.bBold ? FStyleColors::ForegroundHover : FStyleColors::Foreground;
+
+		// every combination of strong, emphasis and strikethrough, the first is the block style itself
+		for( int32 Bits = 0; Bits < 8; ++Bits )
+		{
+			const bool bStrong = ( Bits & 1 ) != 0;
+			const bool bEmphasis = ( Bits & 2 ) != 0;
+			const bool bStrikethrough = ( Bits & 4 ) != 0;
+
+			FTextBlockStyle Style = FTextBlockStyle( NormalText )
+				.SetFont( FCoreStyle::GetDefaultFontStyle( GetTypeface( Block.bBold || bStrong, bEmphasis ), Block.Size ) )
+				.SetColorAndOpacity( Color );
+
+			if( bStrikethrough )
+			{
+				Style.SetStrikeBrush( StrikeBrush );
+			}
+
+			Set( *GetInlineStyleName( BlockName, bStrong, bEmphasis, bStrikethrough, false ), Style );
+		}
+
+		Set( *GetInlineStyleName( BlockName, false, false, false, true ), FTextBlockStyle( NormalText )
+			.SetFont( FCoreStyle::GetDefaultFontStyle( "Mono", Block.Size - 1 ) )
+			.SetColorAndOpacity( FStyleColors::AccentOrange ) );
+	}
+
+	Set( "CodeBlock", FTextBlockStyle( NormalText )
+		.SetFont( FCoreStyle::GetDefaultFontStyle( "Mono", 9 ) )
+		.SetColorAndOpacity( FStyleColors::Foreground ) );
+
+	Set( "ImageMissing", FTextBlockStyle( NormalText )
+		.SetFont( FCoreStyle::GetDefaultFontStyle( "Italic", 10 ) )
+		.SetColorAndOpacity( FSlateColor::UseSubduedForeground() ) );
+
+	// stands in for image assets that are still streaming in
+	Set( "ImageLoading", new FSlateRoundedBoxBrush( FStyleColors::Recessed, 4.0f, FVector2D( 64.0f, 64.0f ) ) );
+
+	Set( "Link", FHyperlinkStyle( FCoreStyle::Get().GetWidgetStyle<FHyperlinkStyle>( "Hyperlink" ) )
+		.SetTextStyle( FTextBlockStyle( NormalText )
+			.SetFont( FCoreStyle::GetDefaultFontStyle( "Regular", 10 ) )
+			.SetColorAndOpacity( FStyleColors::AccentBlue ) ) );
+
+	// rows are not selectable, so no highlights at all
+	const FSlateNoResource NoBrush;
+
+	Set( "Row", FTableRowStyle( FCoreStyle::Get().GetWidgetStyle<FTableRowStyle>( "TableView.Row" ) )
+		.SetEvenRowBackgroundBrush( NoBrush )
+		.SetEvenRowBackgroundHoveredBrush( NoBrush )
+		.SetOddRowBackgroundBrush( NoBrush )
+		.SetOddRowBackgroundHoveredBrush( NoBrush )
+		.SetActiveBrush( NoBrush )
+		.SetActiveHoveredBrush( NoBrush )
+		.SetInactiveBrush( NoBrush )
+		.SetInactiveHoveredBrush( NoBrush ) );
+
+	Set( "Background", new FSlateColorBrush( FStyleColors::Panel ) );
+	Set( "CodeBackground", new FSlateRoundedBoxBrush( FStyleColors::Recessed, 4.0f ) );
+	Set( "QuoteBar", new FSlateColorBrush( FStyleColors::AccentGray ) );
+	Set( "TableBorder", new FSlateRoundedBoxBrush( FStyleColors::Transparent, 0.0f, FStyleColors::Dropdown, 1.0f ) );
+	Set( "TableHeaderBackground", new FSlateColorBrush( FStyleColors::Header ) );
+	Set( "Separator", new FSlateColorBrush( FStyleColors::Hover ) );
+
+	FSlateStyleRegistry::RegisterSlateStyle( *this );
+}
+
+FMarkdownViewStyle::~FMarkdownViewStyle()
+{
+	FSlateStyleRegistry::UnRegisterSlateStyle( *this );
+}
@@ -0,0 +1,742 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Widgets/SMarkdownView.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/Texture.h"
+#include "Fonts/FontMeasure.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Text/ITextDecorator.h"
+#include "Framework/Text/TextDecorators.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/PackageName.h"
+#include "Parser/MarkdownDocumentCache.h"
+#include "Rendering/SlateRenderer.h"
+#include "Styling/SlateTypes.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Layout/SGridPanel.h"
+#include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/MarkdownViewStyle.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Text/SRichTextBlock.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+
+namespace MarkdownView
+{
+	// inline formatting bits passed down through AppendMarkup
+	static constexpr uint8 Strong = 1;
+	static constexpr uint8 Emphasis = 2;
+	static constexpr uint8 Strikethrough = 4;
+	static constexpr uint8 Code = 8;
+
+	// spacing between blocks
+	static constexpr float BlockSpacing = 8.0f;
+	static constexpr float HeadingSpacing = 16.0f;
+	static constexpr float TightSpacing = 2.0f;
+
+	// row content kept for rows that scroll out of view, past this it is all let go
+	static constexpr int32 MaxCachedRows = 512;
+
+	/** Escapes text for rich text markup. */
+	static void AppendEscaped( const FStringView Text, FString& Out )
+	{
+		for( const TCHAR C : Text )
+		{
+			switch( C )
+			{
+				case TEXT( '&' ): Out += TEXT( "&amp;" ); break;
+				case TEXT( '<' ): Out += TEXT( "&lt;" ); break;
+				case TEXT( '>' ): Out += TEXT( "&gt;" ); break;
+				case TEXT( '"' ): Out += TEXT( "&quot;" ); break;
+				default: Out.AppendChar( C ); break;
+			}
+		}
+	}
+
+	static FText ToText( const FStringView Text )
+	{
+		FString String;
+		String.Append( Text.GetData(), Text.Len() );
+		return FText::FromString( MoveTemp( String ) );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------------
+
+void SMarkdownView::Construct( const FArguments& InArgs )
+{
+	Style         = InArgs._Style != nullptr ? InArgs._Style : &FMarkdownViewStyle::Get();
+	Padding       = InArgs._Padding;
+	Text          = InArgs._Text;
+	OnLinkClicked = InArgs._OnLinkClicked;
+
+	ChildSlot
+	[
+		SAssignNew( Background, SBorder )
+		.BorderImage( Style->GetBrush( "Background" ) )
+		.Padding( 0.0f )
+		[
+			SAssignNew( ListView, SListView<TSharedPtr<FMarkdownViewRow>> )
+			.ListItemsSource( &Rows )
+			.SelectionMode( ESelectionMode::None )
+			.OnGenerateRow( this, &SMarkdownView::MakeRow )
+		]
+	];
+
+	DisplayedText = Text.Get();
+	Refresh();
+}
+
+void SMarkdownView::Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime )
+{
+	SCompoundWidget::Tick( AllottedGeometry, InCurrentTime, InDeltaTime );
+
+	LaidOutWidth = AllottedGeometry.GetLocalSize().X;
+
+	// rows showing placeholders are made again, several images arriving together only cost one rebuild
+	if( bImagesChanged )
+	{
+		bImagesChanged = false;
+		RowContent.Reset();
+		ListView->RebuildList();
+	}
+
+	if( !Text.IsBound() )
+	{
+		return;
+	}
+
+	// identical is cheap and covers an unchanged property, Refresh still compares the strings for bindings that
+	// build a new text every time
+	FText Current = Text.Get();
+
+	if( !Current.IdenticalTo( DisplayedText ) )
+	{
+		DisplayedText = MoveTemp( Current );
+		Refresh();
+	}
+}
+
+void SMarkdownView::SetText( const TAttribute<FText>& InText )
+{
+	Text          = InText;
+	DisplayedText = Text.Get();
+	Refresh();
+}
+
+void SMarkdownView::SetDocument( const TSharedRef<const FMarkdownDocument>& InDocument )
+{
+	Text = TAttribute<FText>();
+	DisplayedText = FText::GetEmpty();
+	DisplayedSource.Reset();
+
+	if( InDocument != Document )
+	{
+		Document = InDocument;
+		RebuildRows();
+	}
+}
+
+void SMarkdownView::SetPadding( const FMargin& InPadding )
+{
+	if( InPadding != Padding )
+	{
+		Padding = InPadding;
+
+		// the padding is on the rows, the content can stay
+		ListView->RebuildList();
+	}
+}
+
+void SMarkdownView::SetStyle( const ISlateStyle* InStyle )
+{
+	if( InStyle == nullptr )
+	{
+		InStyle = &FMarkdownViewStyle::Get();
+	}
+
+	if( InStyle != Style )
+	{
+		Style = InStyle;
+		Background->SetBorderImage( Style->GetBrush( "Background" ) );
+
+		// everything in the rows was made with the old style
+		RowContent.Reset();
+		ListView->RebuildList();
+	}
+}
+
+void SMarkdownView::SetOnLinkClicked( const FOnMarkdownLinkClicked& InOnLinkClicked )
+{
+	OnLinkClicked = InOnLinkClicked;
+}
+
+void SMarkdownView::ScrollToTop()
+{
+	ListView->ScrollToTop();
+}
+
+void SMarkdownView::Refresh()
+{
+	FString Source = DisplayedText.ToString();
+
+	if( Source.Equals( DisplayedSource, ESearchCase::CaseSensitive ) )
+	{
+		return;
+	}
+
+	DisplayedSource = MoveTemp( Source );
+	Document = FMarkdownDocumentCache::Get().FindOrParse( DisplayedSource );
+	RebuildRows();
+}
+
+void SMarkdownView::RebuildRows()
+{
+	// top level lists are split into their items so a long list doesn't end up as one huge row
+	Rows.Reset();
+	RowContent.Reset();
+
+	Document->ForEachChild( FMarkdownDocument::Root, [this]( const int32 Node )
+	{
+		if( (*Document)[ Node ].Type == EMarkdownNodeType::List )
+		{
+			int32 Number = (*Document)[ Node ].Value;
+
+			Document->ForEachChild( Node, [this, &Number]( const int32 Item )
+			{
+				Rows.Add( MakeShared<FMarkdownViewRow>( FMarkdownViewRow{ Item, Number++ } ) );
+			});
+		}
+		else
+		{
+			Rows.Add( MakeShared<FMarkdownViewRow>( FMarkdownViewRow{ Node, 0 } ) );
+		}
+	});
+
+	ListView->RequestListRefresh();
+}
+
+
+//-----------------------------------------------------------------------------------------------------------------
+// rows and blocks
+
+TSharedRef<ITableRow> SMarkdownView::MakeRow( TSharedPtr<FMarkdownViewRow> Row, const TSharedRef<STableViewBase>& OwnerTable )
+{
+	const FMarkdownNode& Node = (*Document)[ Row->Node ];
+
+	FMargin Margin( Padding.Left, 0.0f, Padding.Right, MarkdownView::BlockSpacing );
+
+	if( Node.Type == EMarkdownNodeType::ListItem )
+	{
+		const bool bTight = (*Document)[ Node.Parent ].HasFlag( EMarkdownNodeFlags::Tight );
+		const bool bLastItem = Node.NextSibling == INDEX_NONE;
+
+		Margin.Bottom = bTight && !bLastItem ? MarkdownView::TightSpacing : MarkdownView::BlockSpacing;
+	}
+	else if( Node.Type == EMarkdownNodeType::Heading )
+	{
+		Margin.Top = MarkdownView::HeadingSpacing - MarkdownView::BlockSpacing;
+	}
+
+	if( Rows.Num() > 0 && Rows[ 0 ] == Row )
+	{
+		Margin.Top = Padding.Top;
+	}
+
+	if( Rows.Num() > 0 && Rows.Last() == Row )
+	{
+		Margin.Bottom = Padding.Bottom;
+	}
+
+	// rows scrolled back into view get the content they had before, text blocks keep their layout as long as the
+	// width doesn't change so this is what makes scrolling around cheap
+	TSharedPtr<SWidget> Content = RowContent.FindRef( Row->Node );
+
+	if( !Content.IsValid() )
+	{
+		if( RowContent.Num() >= MarkdownView::MaxCachedRows )
+		{
+			RowContent.Reset();
+		}
+
+		Content = Node.Type == EMarkdownNodeType::ListItem ? MakeListItem( Row->Node, Row->Number ) : MakeBlock( Row->Node );
+		RowContent.Add( Row->Node, Content );
+	}
+
+	return SNew( STableRow<TSharedPtr<FMarkdownViewRow>>, OwnerTable )
+		.Style( &Style->GetWidgetStyle<FTableRowStyle>( "Row" ) )
+		.ShowSelection( false )
+		.Padding( Margin )
+		[
+			Content.ToSharedRef()
+		];
+}
+
+TSharedRef<SWidget> SMarkdownView::MakeBlock( const int32 Index )
+{
+	const FMarkdownNode& Node = (*Document)[ Index ];
+
+	switch( Node.Type )
+	{
+		case EMarkdownNodeType::Paragraph:
+			return MakeRichText( Index, TEXT( "Paragraph" ) );
+
+		case EMarkdownNodeType::Heading:
+		{
+			const int32 Level = FMath::Clamp( Node.Value, 1, 6 );
+			const TSharedRef<SWidget> Heading = MakeRichText( Index, FString::Printf( TEXT( "Heading%d" ), Level ) );
+
+			if( Level > 2 )
+			{
+				return Heading;
+			}
+
+			// the top two levels are underlined, like the viewer
+			return SNew( SVerticalBox )
+				+ SVerticalBox::Slot().AutoHeight()
+				[
+					Heading
+				]
+				+ SVerticalBox::Slot().AutoHeight().Padding( 0.0f, 4.0f, 0.0f, 0.0f )
+				[
+					SNew( SBox ).HeightOverride( 1.0f )
+					[
+						SNew( SImage ).Image( Style->GetBrush( "Separator" ) )
+					]
+				];
+		}
+
+		case EMarkdownNodeType::ThematicBreak:
+			return SNew( SBox ).HeightOverride( 2.0f )
+				[
+					SNew( SImage ).Image( Style->GetBrush( "Separator" ) )
+				];
+
+		case EMarkdownNodeType::CodeBlock:
+		case EMarkdownNodeType::HtmlBlock:
+		{
+			FStringView Code = Document->GetLiteral( Index );
+
+			while( Code.Len() > 0 && Code[ Code.Len() - 1 ] == TEXT( '\n' ) )
+			{
+				Code.LeftChopInline( 1 );
+			}
+
+			return SNew( SBorder )
+				.BorderImage( Style->GetBrush( "CodeBackground" ) )
+				.Padding( 8.0f )
+				[
+					SNew( SScrollBox )
+					.Orientation( Orient_Horizontal )
+					+ SScrollBox::Slot()
+					[
+						SNew( STextBlock )
+						.Text( MarkdownView::ToText( Code ) )
+						.TextStyle( Style, "CodeBlock" )
+					]
+				];
+		}
+
+		case EMarkdownNodeType::BlockQuote:
+			return SNew( SHorizontalBox )
+				+ SHorizontalBox::Slot().AutoWidth()
+				[
+					SNew( SBox ).WidthOverride( 3.0f )
+					[
+						SNew( SImage ).Image( Style->GetBrush( "QuoteBar" ) )
+					]
+				]
+				+ SHorizontalBox::Slot().FillWidth( 1.0f ).Padding( 10.0f, 0.0f, 0.0f, 0.0f )
+				[
+					MakeBlocks( Index, false )
+				];
+
+		case EMarkdownNodeType::List:
+		{
+			const bool bTight = Node.HasFlag( EMarkdownNodeFlags::Tight );
+			const TSharedRef<SVerticalBox> Items = SNew( SVerticalBox );
+			int32 Number = Node.Value;
+
+			Document->ForEachChild( Index, [&]( const int32 Item )
+			{
+				Items->AddSlot()
+					.AutoHeight()
+					.Padding( 0.0f, 0.0f, 0.0f, (*Document)[ Item ].NextSibling == INDEX_NONE ? 0.0f : bTight ? MarkdownView::TightSpacing : MarkdownView::BlockSpacing )
+					[
+						MakeListItem( Item, Number++ )
+					];
+			});
+
+			return Items;
+		}
+
+		case EMarkdownNodeType::Table:
+			return MakeTable( Index );
+
+		default:
+			return SNullWidget::NullWidget;
+	}
+}
+
+TSharedRef<SWidget> SMarkdownView::MakeBlocks( const int32 Parent, const bool bTight )
+{
+	const TSharedRef<SVerticalBox> Blocks = SNew( SVerticalBox );
+
+	Document->ForEachChild( Parent, [&]( const int32 Child )
+	{
+		Blocks->AddSlot()
+			.AutoHeight()
+			.Padding( 0.0f, 0.0f, 0.0f, (*Document)[ Child ].NextSibling == INDEX_NONE || bTight ? 0.0f : MarkdownView::BlockSpacing )
+			[
+				MakeBlock( Child )
+			];
+	});
+
+	return Blocks;
+}
+
+TSharedRef<SWidget> SMarkdownView::MakeListItem( const int32 Index, const int32 Number )
+{
+	const FMarkdownNode& Item = (*Document)[ Index ];
+	const FMarkdownNode& List = (*Document)[ Item.Parent ];
+
+	TSharedRef<SWidget> Marker = SNullWidget::NullWidget;
+
+	if( Item.HasFlag( EMarkdownNodeFlags::Task ) )
+	{
+		// not editable, this only shows the state
+		Marker = SNew( SCheckBox )
+			.IsChecked( Item.HasFlag( EMarkdownNodeFlags::Checked ) ? ECheckBoxState::Checked : ECheckBoxState::Unchecked )
+			.Visibility( EVisibility::HitTestInvisible );
+	}
+	else
+	{
+		const FString MarkerText = List.HasFlag( EMarkdownNodeFlags::Ordered ) ? FString::Printf( TEXT( "%d." ), Number ) : FString( TEXT( "\u2022" ) );
+
+		Marker = SNew( STextBlock )
+			.Text( FText::FromString( MarkerText ) )
+			.TextStyle( Style, "Paragraph" );
+	}
+
+	return SNew( SHorizontalBox )
+		+ SHorizontalBox::Slot().AutoWidth().Padding( 0.0f, 0.0f, 6.0f, 0.0f )
+		[
+			SNew( SBox )
+			.MinDesiredWidth( 18.0f )
+			.HAlign( HAlign_Right )
+			[
+				Marker
+			]
+		]
+		+ SHorizontalBox::Slot().FillWidth( 1.0f )
+		[
+			MakeBlocks( Index, List.HasFlag( EMarkdownNodeFlags::Tight ) )
+		];
+}
+
+TSharedRef<SWidget> SMarkdownView::MakeTable( const int32 Index )
+{
+	const TSharedRef<SGridPanel> Grid = SNew( SGridPanel );
+	int32 Row = 0;
+
+	Document->ForEachChild( Index, [&]( const int32 TableRow )
+	{
+		const bool bHeader = (*Document)[ TableRow ].HasFlag( EMarkdownNodeFlags::Header );
+		int32 Column = 0;
+
+		Document->ForEachChild( TableRow, [&]( const int32 Cell )
+		{
+			const FMarkdownNode& CellNode = (*Document)[ Cell ];
+
+			// center is left and right together so it is tested first
+			const EHorizontalAlignment Alignment =
+				CellNode.HasFlag( EMarkdownNodeFlags::AlignCenter ) ? HAlign_Center :
+				CellNode.HasFlag( EMarkdownNodeFlags::AlignRight ) ? HAlign_Right : HAlign_Left;
+
+			Grid->AddSlot( Column++, Row )
+				.Padding( 8.0f, 4.0f )
+				.HAlign( Alignment )
+				[
+					MakeRichText( Cell, bHeader ? TEXT( "TableHeader" ) : TEXT( "Paragraph" ), false )
+				];
+		});
+
+		++Row;
+	});
+
+	return SNew( SScrollBox )
+		.Orientation( Orient_Horizontal )
+		+ SScrollBox::Slot()
+		[
+			SNew( SBorder )
+			.BorderImage( Style->GetBrush( "TableBorder" ) )
+			.Padding( 1.0f )
+			[
+				Grid
+			]
+		];
+}
+
+TSharedRef<SWidget> SMarkdownView::MakeRichText( const int32 Index, const FString& BlockStyle, const bool bWrap )
+{
+	FString Markup;
+
+	Document->ForEachChild( Index, [&]( const int32 Child )
+	{
+		AppendMarkup( Child, BlockStyle, 0, Markup );
+	});
+
+	return SNew( SRichTextBlock )
+		.Text( FText::FromString( MoveTemp( Markup ) ) )
+		.TextStyle( Style, FName( *BlockStyle ) )
+		.DecoratorStyleSet( Style )
+		.AutoWrapText( bWrap )
+		+ SRichTextBlock::HyperlinkDecorator( TEXT( "link" ), FSlateHyperlinkRun::FOnClick::CreateSP( this, &SMarkdownView::HandleLinkClicked ) )
+		+ SRichTextBlock::WidgetDecorator( TEXT( "img" ), FWidgetDecorator::FCreateWidget::CreateSP( this, &SMarkdownView::MakeImage ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------------------------
+// inlines
+//
+// rich text runs can't nest, so formatting is carried down and each piece of text gets the style for everything
+// around it. Links and images refer back to their node rather than carrying the url, which saves escaping it.
+// The recursion is bounded, the parser caps how deep a document can nest (MarkdownParser::MaxNesting).
+
+void SMarkdownView::AppendMarkup( const int32 Index, const FString& BlockStyle, const uint8 Format, FString& Out ) const
+{
+	const FMarkdownNode& Node = (*Document)[ Index ];
+
+	auto AppendRun = [&]( const FStringView RunText, const uint8 RunFormat )
+	{
+		const FString RunStyle = FMarkdownViewStyle::GetInlineStyleName(
+			BlockStyle,
+			( RunFormat & MarkdownView::Strong ) != 0,
+			( RunFormat & MarkdownView::Emphasis ) != 0,
+			( RunFormat & MarkdownView::Strikethrough ) != 0,
+			( RunFormat & MarkdownView::Code ) != 0
+		);
+
+		if( RunStyle == BlockStyle )
+		{
+			MarkdownView::AppendEscaped( RunText, Out );
+		}
+		else
+		{
+			Out += TEXT( "<" ) + RunStyle + TEXT( ">" );
+			MarkdownView::AppendEscaped( RunText, Out );
+			Out += TEXT( "</>" );
+		}
+	};
+
+	auto AppendChildren = [&]( const uint8 ChildFormat )
+	{
+		Document->ForEachChild( Index, [&]( const int32 Child )
+		{
+			AppendMarkup( Child, BlockStyle, ChildFormat, Out );
+		});
+	};
+
+	switch( Node.Type )
+	{
+		case EMarkdownNodeType::Text:
+		case EMarkdownNodeType::Html:
+			AppendRun( Document->GetLiteral( Index ), Format );
+			break;
+
+		case EMarkdownNodeType::Code:
+			AppendRun( Document->GetLiteral( Index ), Format | MarkdownView::Code );
+			break;
+
+		case EMarkdownNodeType::SoftBreak:
+			Out.AppendChar( TEXT( ' ' ) );
+			break;
+
+		case EMarkdownNodeType::HardBreak:
+			Out.AppendChar( TEXT( '\n' ) );
+			break;
+
+		case EMarkdownNodeType::Emphasis:
+			AppendChildren( Format | MarkdownView::Emphasis );
+			break;
+
+		case EMarkdownNodeType::Strong:
+			AppendChildren( Format | MarkdownView::Strong );
+			break;
+
+		case EMarkdownNodeType::Strikethrough:
+			AppendChildren( Format | MarkdownView::Strikethrough );
+			break;
+
+		case EMarkdownNodeType::Link:
+			Out += FString::Printf( TEXT( "<a id=\"link\" style=\"Link\" node=\"%d\">" ), Index );
+			MarkdownView::AppendEscaped( Document->GetPlainText( Index ), Out );
+			Out += TEXT( "</>" );
+			break;
+
+		case EMarkdownNodeType::Image:
+			Out += FString::Printf( TEXT( "<img node=\"%d\"/>" ), Index );
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------------------------
+// decorators
+
+FSlateWidgetRun::FWidgetRunInfo SMarkdownView::MakeImage( const FTextRunInfo& RunInfo, const ISlateStyle* InStyle )
+{
+	const FString* NodeAttribute = RunInfo.MetaData.Find( TEXT( "node" ) );
+	const int32 Index = NodeAttribute != nullptr ? FCString::Atoi( **NodeAttribute ) : INDEX_NONE;
+
+	const FTextBlockStyle& AltStyle = Style->GetWidgetStyle<FTextBlockStyle>( "ImageMissing" );
+	const TSharedRef<FSlateFontMeasure> FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
+	const int16 Baseline = FontMeasure->GetBaseline( AltStyle.Font );
+
+	if( !Document->GetNodes().IsValidIndex( Index ) || (*Document)[ Index ].Type != EMarkdownNodeType::Image )
+	{
+		return FSlateWidgetRun::FWidgetRunInfo( SNullWidget::NullWidget, Baseline );
+	}
+
+	if( const FSlateBrush* Brush = FindImage( Document->GetExtra( Index ) ) )
+	{
+		return FSlateWidgetRun::FWidgetRunInfo( SNew( SImage ).Image( Brush ), Baseline );
+	}
+
+	// not an asset, show the alt text (or the url if there is none) instead
+	FString Alt = Document->GetPlainText( Index );
+
+	if( Alt.IsEmpty() )
+	{
+		Alt.Append( Document->GetExtra( Index ).GetData(), Document->GetExtra( Index ).Len() );
+	}
+
+	return FSlateWidgetRun::FWidgetRunInfo( SNew( STextBlock ).Text( FText::FromString( TEXT( "[" ) + Alt + TEXT( "]" ) ) ).TextStyle( &AltStyle ), Baseline );
+}
+
+const FSlateBrush* SMarkdownView::FindImage( const FStringView Source )
+{
+	FString Path;
+	Path.Append( Source.GetData(), Source.Len() );
+
+	if( const FImage* Found = Images.Find( Path ) )
+	{
+		return Found->Handle.IsValid() ? Style->GetBrush( "ImageLoading" ) : Found->Brush.Get();
+	}
+
+	const FString Key = Path;
+
+	// misses are remembered as well so a missing asset is only looked for once
+	FImage& Image = Images.Add( Path );
+
+	if( !Path.StartsWith( TEXT( "/" ) ) || Path.StartsWith( TEXT( "//" ) ) )
+	{
+		return nullptr;
+	}
+
+	// copied references look like /Script/Engine.Texture2D'/Game/Docs/Diagram.Diagram'
+	int32 QuoteStart = INDEX_NONE;
+	int32 QuoteEnd = INDEX_NONE;
+
+	if( Path.FindChar( TEXT( '\'' ), QuoteStart ) && Path.FindLastChar( TEXT( '\'' ), QuoteEnd ) && QuoteEnd > QuoteStart )
+	{
+		Path = Path.Mid( QuoteStart + 1, QuoteEnd - QuoteStart - 1 );
+	}
+
+	// "/Game/Docs/Diagram" is a package, the texture in it has the same name
+	if( !Path.Contains( TEXT( "." ) ) )
+	{
+		Path = Path + TEXT( "." ) + FPackageName::GetShortName( Path );
+	}
+
+	const FSoftObjectPath ObjectPath( Path );
+
+	if( ObjectPath.IsNull() )
+	{
+		return nullptr;
+	}
+
+	// this is called while the text is laid out, so anything not in memory already is streamed rather than loaded here
+	if( UTexture* Texture = Cast<UTexture>( ObjectPath.ResolveObject() ) )
+	{
+		Image.SetTexture( Texture );
+		return Image.Brush.Get();
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad( ObjectPath, FStreamableDelegate::CreateSP( this, &SMarkdownView::HandleImageLoaded, Key ) );
+
+	// the load can finish before this returns, its callback has nothing to pick up then so the texture is taken here
+	if( !Handle.IsValid() || Handle->HasLoadCompleted() )
+	{
+		if( UTexture* Texture = Cast<UTexture>( Handle.IsValid() ? Handle->GetLoadedAsset() : nullptr ) )
+		{
+			Image.SetTexture( Texture );
+		}
+
+		return Image.Brush.Get();
+	}
+
+	Image.Handle = MoveTemp( Handle );
+
+	return Style->GetBrush( "ImageLoading" );
+}
+
+void SMarkdownView::HandleImageLoaded( FString Source )
+{
+	FImage* Image = Images.Find( Source );
+
+	if( Image == nullptr || Image->Object.IsValid() )
+	{
+		return;
+	}
+
+	UTexture* Texture = Cast<UTexture>( Image->Handle.IsValid() ? Image->Handle->GetLoadedAsset() : nullptr );
+	Image->Handle.Reset();
+
+	// rows are remade either way, a missing asset goes from the placeholder to the alt text
+	if( Texture != nullptr )
+	{
+		Image->SetTexture( Texture );
+	}
+
+	bImagesChanged = true;
+}
+
+void SMarkdownView::FImage::SetTexture( UTexture* Texture )
+{
+	Object.Reset( Texture );
+	Brush = MakeShared<FSlateBrush>();
+	Brush->SetResourceObject( Texture );
+	Brush->ImageSize = FVector2D( Texture->GetSurfaceWidth(), Texture->GetSurfaceHeight() );
+}
+
+void SMarkdownView::HandleLinkClicked( const FSlateHyperlinkRun::FMetadata& Metadata )
+{
+	const FString* NodeAttribute = Metadata.Find( TEXT( "node" ) );
+	const int32 Index = NodeAttribute != nullptr ? FCString::Atoi( **NodeAttribute ) : INDEX_NONE;
+
+	if( !Document->GetNodes().IsValidIndex( Index ) || (*Document)[ Index ].Type != EMarkdownNodeType::Link )
+	{
+		return;
+	}
+
+	FString Url;
+	Url.Append( Document->GetExtra( Index ).GetData(), Document->GetExtra( Index ).Len() );
+
+	if( OnLinkClicked.IsBound() )
+	{
+		OnLinkClicked.Execute( Url );
+	}
+	else if( Url.StartsWith( TEXT( "http://" ) ) || Url.StartsWith( TEXT( "https://" ) ) || Url.StartsWith( TEXT( "mailto:" ) ) )
+	{
+		FPlatformProcess::LaunchURL( *Url, nullptr, nullptr );
+	}
+}
@@ -0,0 +1,77 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Engine/CancellableAsyncAction.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "AsyncActionLoadMarkdown.generated.h"
+
+class FMarkdownLoadRequest;
+class UMarkdownAsset;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FAsyncLoadMarkdownDelegate, UMarkdownAsset*, Markdown );
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FAsyncPrefetchMarkdownDelegate, const TArray<UMarkdownAsset*>&, Markdown );
+
+/**
+ * Loads a markdown asset in the background and parses it off the game thread, so it can be shown without a hitch.
+ */
+UCLASS()
+class MARKDOWNASSET_API UAsyncActionLoadMarkdown : public UCancellableAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+
+	UFUNCTION( BlueprintCallable, Category = "Markdown", meta = ( BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject" ) )
+	static UAsyncActionLoadMarkdown* LoadMarkdownAsync( UObject* WorldContextObject, TSoftObjectPtr<UMarkdownAsset> Markdown );
+
+	UPROPERTY( BlueprintAssignable )
+	FAsyncLoadMarkdownDelegate OnLoaded;
+
+	UPROPERTY( BlueprintAssignable )
+	FAsyncLoadMarkdownDelegate OnFailed;
+
+	//~ UCancellableAsyncAction interface
+	virtual void Activate() override;
+	virtual void Cancel() override;
+	virtual bool IsActive() const override;
+
+private:
+
+	void HandleLoaded( const TArray<UMarkdownAsset*>& Assets );
+
+	TSoftObjectPtr<UMarkdownAsset> Markdown;
+	TSharedPtr<FMarkdownLoadRequest> Request;
+};
+
+/**
+ * Loads and parses a list of markdown assets ahead of time, for example the pages of a help screen before it opens.
+ * Keep a reference to the assets it completes with, otherwise they can be unloaded again.
+ */
+UCLASS()
+class MARKDOWNASSET_API UAsyncActionPrefetchMarkdown : public UCancellableAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+
+	UFUNCTION( BlueprintCallable, Category = "Markdown", meta = ( BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject" ) )
+	static UAsyncActionPrefetchMarkdown* PrefetchMarkdownAsync( UObject* WorldContextObject, const TArray<TSoftObjectPtr<UMarkdownAsset>>& Markdown );
+
+	/** the assets that loaded, in the order they were asked for */
+	UPROPERTY( BlueprintAssignable )
+	FAsyncPrefetchMarkdownDelegate OnCompleted;
+
+	//~ UCancellableAsyncAction interface
+	virtual void Activate() override;
+	virtual void Cancel() override;
+	virtual bool IsActive() const override;
+
+private:
+
+	void HandleLoaded( const TArray<UMarkdownAsset*>& Assets );
+
+	TArray<FSoftObjectPath> Paths;
+	TSharedPtr<FMarkdownLoadRequest> Request;
+};
@@ -0,0 +1,68 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+#include <atomic>
+
+class UMarkdownAsset;
+struct FStreamableHandle;
+
+/** Called on the game thread with the assets in the order they were asked for, null for any that did not load. */
+DECLARE_DELEGATE_OneParam( FOnMarkdownLoaded, const TArray<UMarkdownAsset*>& );
+
+/** A load started by FMarkdownAsyncLoader. The loaded assets are kept in memory for as long as it is held. */
+class MARKDOWNASSET_API FMarkdownLoadRequest
+{
+public:
+
+	/** Stops loading and parsing, the callback will not be called. Game thread only. */
+	void Cancel();
+
+	bool IsCancelled() const
+	{
+		return bCancelled;
+	}
+
+	bool IsComplete() const
+	{
+		return bComplete;
+	}
+
+private:
+
+	friend class FMarkdownAsyncLoader;
+
+	TArray<FSoftObjectPath> Paths;
+	FOnMarkdownLoaded OnLoaded;
+	TSharedPtr<FStreamableHandle> Handle;
+	TSharedPtr<FStreamableHandle> VariantHandle;
+
+	/** read by the worker parsing the documents */
+	std::atomic<bool> bCancelled = false;
+	bool bStreamed = false;
+	bool bParsing = false;
+	bool bComplete = false;
+};
+
+/**
+ * Loads markdown assets without stalling the game thread. Assets are streamed in through the asset manager, then
+ * their variants for the current language, and any that were not cooked with their parsed document (see
+ * UMarkdownAssetSettings) are parsed on a worker. By the time the callback is called, GetLocalized and GetDocument on
+ * the assets return straight away.
+ */
+class MARKDOWNASSET_API FMarkdownAsyncLoader
+{
+public:
+
+	/** Game thread only. The callback can be called before this returns if everything is already loaded and parsed. */
+	static TSharedRef<FMarkdownLoadRequest> Load( const TArray<FSoftObjectPath>& Paths, FOnMarkdownLoaded OnLoaded );
+
+private:
+
+	static void HandleStreamed( const TSharedRef<FMarkdownLoadRequest>& Request );
+	static void ParseDocuments( const TSharedRef<FMarkdownLoadRequest>& Request );
+	static void Complete( const TSharedRef<FMarkdownLoadRequest>& Request );
+};
@@ -0,0 +1,102 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Components/Widget.h"
+#include "Layout/Margin.h"
+
+#include "MarkdownTextBlock.generated.h"
+
+class ISlateStyle;
+class SMarkdownView;
+class UMarkdownAsset;
+struct FMarkdownDocument;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FOnMarkdownTextBlockLinkClicked, const FString&, Url );
+
+/**
+ * Shows a markdown asset in UMG, drawn with Slate so it works in packaged games and without a browser.
+ *
+ * Parsed documents are shared through FMarkdownDocumentCache and the view keeps the rows it has laid out, so scrolling
+ * back does not lay out the text again. Views that are released are parked in FMarkdownViewCache, so opening the
+ * same help page again at the same width and style does not parse, build or lay out anything.
+ */
+UCLASS( meta = ( DisplayName = "Markdown Text Block" ) )
+class MARKDOWNASSET_API UMarkdownTextBlock : public UWidget
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The document to show, in the current language if it has a translation. Text is shown if this is not set. */
+	UPROPERTY( EditAnywhere, BlueprintReadOnly, BlueprintSetter = SetMarkdown, Category = "Content" )
+	TObjectPtr<UMarkdownAsset> Markdown;
+
+	UPROPERTY( EditAnywhere, BlueprintReadOnly, BlueprintSetter = SetText, Category = "Content", meta = ( MultiLine = true ) )
+	FText Text;
+
+	UPROPERTY( EditAnywhere, BlueprintReadOnly, BlueprintSetter = SetPadding, Category = "Appearance" )
+	FMargin Padding = FMargin( 16.0f, 8.0f );
+
+	/**
+	 * Name of a registered Slate style set to draw with, it needs the styles FMarkdownViewStyle has. The default
+	 * markdown style is used if this is empty or the style is not registered.
+	 */
+	UPROPERTY( EditAnywhere, BlueprintReadOnly, BlueprintSetter = SetStyleSetName, Category = "Appearance" )
+	FName StyleSetName;
+
+	/** Called with the destination of a clicked link. If nothing is bound, web links are opened with the platform. */
+	UPROPERTY( BlueprintAssignable, Category = "Markdown|Event" )
+	FOnMarkdownTextBlockLinkClicked OnLinkClicked;
+
+public:
+
+	UFUNCTION( BlueprintCallable, Category = "Markdown" )
+	void SetMarkdown( UMarkdownAsset* InMarkdown );
+
+	UFUNCTION( BlueprintCallable, Category = "Markdown" )
+	void SetText( const FText& InText );
+
+	UFUNCTION( BlueprintCallable, Category = "Markdown" )
+	void SetPadding( const FMargin& InPadding );
+
+	UFUNCTION( BlueprintCallable, Category = "Markdown" )
+	void SetStyleSetName( const FName InStyleSetName );
+
+	UFUNCTION( BlueprintCallable, Category = "Markdown" )
+	void ScrollToTop();
+
+	//~ UWidget interface
+	virtual void SynchronizeProperties() override;
+	virtual void ReleaseSlateResources( bool bReleaseChildren ) override;
+
+#if WITH_EDITOR
+	virtual const FText GetPaletteCategory() override;
+#endif
+
+protected:
+
+	//~ UWidget interface
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+
+private:
+
+	void UpdateDocument();
+	void HandleLinkClicked( const FString& Url );
+
+	TSharedRef<const FMarkdownDocument> GetDocumentToShow() const;
+	const ISlateStyle* GetViewStyle() const;
+
+	/** follows the asset whose translation is being shown, so a new one can be picked up when it has loaded */
+	void WatchMarkdown( UMarkdownAsset* InMarkdown );
+
+private:
+
+	TSharedPtr<SMarkdownView> MyMarkdownView;
+
+	/** the width the last view was laid out at, to ask the cache for one at the same width */
+	float LaidOutWidth = 0.0f;
+
+	TWeakObjectPtr<UMarkdownAsset> WatchedMarkdown;
+	FDelegateHandle LocalizedVariantChangedHandle;
+};
@@ -2,14 +2,24 @@
 
 #pragma once
 
+#include "Async/MarkdownAsyncLoader.h"
 #include "Internationalization/Text.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Parser/MarkdownDocument.h"
+#include "Parser/MarkdownHeadingIndex.h"
 #include "UObject/Object.h"
 #include "UObject/ObjectMacros.h"
 #include "UObject/ObjectSaveContext.h"
 #include "UObject/PropertyAccessUtil.h"
 
+#if !UE_VERSION_OLDER_THAN( 5, 4, 0 )
+#include "UObject/AssetRegistryTagsContext.h"
+#endif
+
 #include "MarkdownAsset.generated.h"
 
+struct FAssetData;
+
 DECLARE_DYNAMIC_DELEGATE(FMarkdownAssetChangedDelegate);
 
 UCLASS( BlueprintType, hidecategories = ( Object ) )
@@ -24,12 +34,135 @@ public:
 
 	UPROPERTY()
 	FMarkdownAssetChangedDelegate OnChanged;
+
+	/**
+	 * Translations of this document by culture ("fr", "pt-BR"). Each is a markdown asset of its own, so only the one
+	 * for the current language is loaded. A language without one uses its parent culture's ("pt-BR" uses "pt"), and
+	 * then this asset.
+	 */
+	UPROPERTY( EditAnywhere, Category = "Localization" )
+	TMap<FString, TSoftObjectPtr<UMarkdownAsset>> LocalizedVariants;
+
+	/** Broadcast when GetLocalized changes what it returns, once a variant has loaded or the language changed. */
+	FSimpleMulticastDelegate OnLocalizedVariantChanged;
+
+	/**
+	 * The version of this document for the current language. While that is loading this asset is returned, and
+	 * OnLocalizedVariantChanged is broadcast once it is in. Game thread only.
+	 */
+	UFUNCTION( BlueprintCallable, Category = "Markdown" )
+	UMarkdownAsset* GetLocalized();
+
+	/** The variant for the current language, null if this asset is used as it is. */
+	TSoftObjectPtr<UMarkdownAsset> FindLocalizedVariant() const;
+
+	/**
+	 * The parsed Text. Cooked assets can carry it with them (see UMarkdownAssetSettings), otherwise it is parsed on
+	 * first use and shared through FMarkdownDocumentCache. Game thread only.
+	 */
+	TSharedRef<const FMarkdownDocument> GetDocument() const;
+
+	/** The parsed Text if it is ready (cooked with the asset or already cached) without parsing it. */
+	TSharedPtr<const FMarkdownDocument> FindDocument() const;
+
+	/** Sets Text, only the lines around the change are scanned again for headings. */
+	void SetText( const FText& InText );
+
+	/**
+	 * Headings of Text in document order. These are saved with the asset, so only a text shown in another language
+	 * than it was saved in has to be scanned. Game thread only, as are the lookups below.
+	 */
+	const TArray<FMarkdownHeading>& GetHeadings() const;
+
+	UFUNCTION( BlueprintPure, Category = "Markdown" )
+	TArray<FMarkdownHeading> GetOutline() const
+	{
+		return GetHeadings();
+	}
+
+	/** Finds a heading by its slug, "getting-started" for "## Getting Started". */
+	UFUNCTION( BlueprintPure, Category = "Markdown" )
+	bool FindHeading( const FString& Slug, FMarkdownHeading& OutHeading ) const;
+
+	/** The markdown under a heading (without the heading itself) up to the next heading of the same or a higher level. */
+	UFUNCTION( BlueprintPure, Category = "Markdown" )
+	bool GetSection( const FString& Slug, FString& OutMarkdown ) const;
+
+	/**
+	 * Plain text from the start of a section, or of the document if Slug is empty, cut at a word to at most MaxLength
+	 * characters. Only the start of the section is parsed.
+	 */
+	UFUNCTION( BlueprintPure, Category = "Markdown" )
+	FString GetPlainTextExcerpt( const FString& Slug, int32 MaxLength = 200 ) const;
+
+	/**
+	 * Asset registry tag with the destinations of the links in Text as of the last save, leaving out external ones.
+	 * Lets the editor know where documentation links to without loading it.
+	 */
+	static const FName LinksTag;
+
+	/** The link destinations in the tag of the asset, false if it was saved before there was one. */
+	static bool GetLinks( const FAssetData& AssetData, TArray<FString>& OutDestinations );
+
+	/**
+	 * Asset registry tag with the slugs of the headings as of the last save, so links to them can be checked. Renamed
+	 * when the slugs became the viewer's, assets saved with the old ones have none.
+	 */
+	static const FName HeadingsTag;
+
+	static bool GetHeadingSlugs( const FAssetData& AssetData, TArray<FString>& OutSlugs );
+
+	/** Asset registry tag with the assets this is the documentation of, so they can be looked up without loading it. */
+	static const FName DocumentedAssetsTag;
+
+	static bool GetDocumentedAssets( const FAssetData& AssetData, TArray<FString>& OutAssets );
+
+	/**
+	 * Asset registry tag with the saved hash of each documented asset's package when this was last saved, in the same
+	 * order, empty where it was not known. An asset saved since then has a different one, and its documentation is stale.
+	 */
+	static const FName DocumentedHashesTag;
+
+	static bool GetDocumentedAssetHashes( const FAssetData& AssetData, TArray<FString>& OutHashes );
+
+#if WITH_EDITORONLY_DATA
+
+	const TArray<FSoftObjectPath>& GetDocumentedAssets() const
+	{
+		return DocumentedAssets;
+	}
+
+	/** Does not mark the asset as modified, that is up to the caller. */
+	void AddDocumentedAsset( const FSoftObjectPath& Asset )
+	{
+		DocumentedAssets.AddUnique( Asset );
+	}
+
+	void RemoveDocumentedAsset( const FSoftObjectPath& Asset )
+	{
+		DocumentedAssets.Remove( Asset );
+	}
+
+#endif
+
+	//~ UObject interface
+	virtual void Serialize( FArchive& Ar ) override;
+	virtual void BeginDestroy() override;
+
+#if UE_VERSION_OLDER_THAN( 5, 4, 0 )
+	virtual void GetAssetRegistryTags( TArray<FAssetRegistryTag>& OutTags ) const override;
+#else
+	virtual void GetAssetRegistryTags( FAssetRegistryTagsContext Context ) const override;
+#endif
 	
 #if WITH_EDITOR
 
+	virtual void PreSave( FObjectPreSaveContext SaveContext ) override;
+
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override
 	{
 		Super::PostEditChangeProperty(PropertyChangedEvent);
+		RefreshHeadings();
 		if (OnChanged.IsBound())
 		{
 			OnChanged.Execute();
@@ -45,4 +178,88 @@ public:
 		}
 	}
 #endif
+
+private:
+
+	/** rebuilds the headings if Text was changed without going through SetText */
+	void RefreshHeadings();
+
+	/** the tags of ours for the asset registry, whichever way the engine asks for them */
+	void GetDocumentationTags( TArray<FAssetRegistryTag>& OutTags ) const;
+
+	const FMarkdownHeading* FindHeadingBySlug( const FString& Slug ) const;
+
+	/** key into LocalizedVariants for the culture, empty if there is none */
+	FString FindVariantCulture( const FString& Culture ) const;
+
+	void RequestVariant( const FString& Culture );
+	void SetActiveVariant( const FString& Culture, UMarkdownAsset* Variant );
+	void HandleCultureChanged();
+
+#if WITH_EDITOR
+	void BuildCultureFallbacks();
+	void BuildLinks();
+	void BuildDocumentedAssetHashes();
+#endif
+
+#if WITH_EDITORONLY_DATA
+
+	/** destinations for LinksTag, as of the last save */
+	UPROPERTY()
+	TArray<FString> Links;
+
+	/**
+	 * The assets Text links to as of the last save. Saved with the asset they are its dependencies in the asset
+	 * registry, so documentation shows up in the reference viewer. Editor only, so the cook does not follow them.
+	 */
+	UPROPERTY()
+	TArray<FSoftObjectPath> LinkedAssets;
+
+	/**
+	 * The assets this is the documentation of. Each document keeps its own, so there is no one file for everyone to
+	 * change, and being saved with the asset they are its dependencies like the linked assets are.
+	 */
+	UPROPERTY()
+	TArray<FSoftObjectPath> DocumentedAssets;
+
+	/** the saved hash of each documented asset's package as of the last save, see DocumentedHashesTag */
+	UPROPERTY()
+	TArray<FString> DocumentedAssetHashes;
+
+#endif
+
+	/** culture to the key in LocalizedVariants it falls back to, made on save so lookups need no culture data */
+	UPROPERTY()
+	TMap<FString, FString> CultureFallbacks;
+
+	/** kept loaded while it is the one being shown */
+	UPROPERTY( Transient )
+	TObjectPtr<UMarkdownAsset> ActiveVariant;
+
+	FString ActiveCulture;
+	FString RequestedCulture;
+	TSharedPtr<FMarkdownLoadRequest> VariantRequest;
+	bool bWatchingCulture = false;
+
+	/** of the source string of Text */
+	UPROPERTY()
+	TArray<FMarkdownHeading> Headings;
+
+	UPROPERTY()
+	uint64 HeadingsSourceHash = 0;
+
+	/** the text the lookups below were made for, they are redone when it changes or is shown in another language */
+	mutable FTextSnapshot IndexedText;
+	mutable TArray<FMarkdownHeading> DisplayedHeadings;
+	mutable TMap<FString, int32> HeadingsBySlug;
+	mutable bool bHeadingsMatchText = true;
+
+	/** loaded from cooked packages */
+	TSharedPtr<const FMarkdownDocument> CookedDocument;
+
+	/** hash of the text the cooked document was parsed from, a translation of it is parsed instead */
+	uint64 CookedSourceHash = 0;
+
+	/** the cooked document is all there is */
+	bool bCookedSourceStripped = false;
 };
@@ -0,0 +1,51 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Engine/DeveloperSettings.h"
+
+#include "MarkdownAssetSettings.generated.h"
+
+/**
+ * Project settings for markdown assets in cooked builds.
+ */
+UCLASS( Config = Game, DefaultConfig, meta = ( DisplayName = "Markdown Asset" ) )
+class MARKDOWNASSET_API UMarkdownAssetSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+
+	static const UMarkdownAssetSettings* Get()
+	{
+		return GetDefault<UMarkdownAssetSettings>();
+	}
+
+	bool ShouldCookParsedDocuments() const
+	{
+		return bCookParsedDocuments;
+	}
+
+	bool ShouldStripSourceText() const
+	{
+		return bCookParsedDocuments && bStripSourceText;
+	}
+
+	virtual FName GetCategoryName() const override
+	{
+		return FName( TEXT( "Plugins" ) );
+	}
+
+protected:
+
+	/** Parse markdown assets when cooking and save the result with them, so nothing is parsed when they are shown. */
+	UPROPERTY( Config, EditAnywhere, Category = Cooking )
+	bool bCookParsedDocuments = false;
+
+	/**
+	 * Leave the markdown text out of cooked assets and only keep the parsed document. Text is then empty at runtime and
+	 * the document is not translated, so this is meant for shipping content that is only ever displayed.
+	 */
+	UPROPERTY( Config, EditAnywhere, Category = Cooking, meta = ( EditCondition = "bCookParsedDocuments" ) )
+	bool bStripSourceText = false;
+};
@@ -0,0 +1,239 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EMarkdownNodeType : uint8
+{
+	Document,
+
+	// blocks
+	BlockQuote,
+	List,
+	ListItem,
+	Paragraph,
+	Heading,
+	ThematicBreak,
+	CodeBlock,
+	HtmlBlock,
+	Table,
+	TableRow,
+	TableCell,
+
+	// inlines
+	Text,
+	SoftBreak,
+	HardBreak,
+	Code,
+	Emphasis,
+	Strong,
+	Strikethrough,
+	Link,
+	Image,
+	Html,
+};
+
+enum class EMarkdownNodeFlags : uint16
+{
+	None        = 0,
+	Ordered     = 1 << 0, // List
+	Tight       = 1 << 1, // List, paragraphs are not wrapped
+	Task        = 1 << 2, // ListItem, has a checkbox
+	Checked     = 1 << 3, // ListItem, the checkbox is ticked
+	Header      = 1 << 4, // TableRow
+	AlignLeft   = 1 << 5, // TableCell
+	AlignRight  = 1 << 6, // TableCell
+	AlignCenter = AlignLeft | AlignRight,
+	Fenced      = 1 << 7, // CodeBlock
+	Setext      = 1 << 8, // Heading, underlined rather than #
+	Autolink    = 1 << 9, // Link, <url> or a bare url
+};
+
+ENUM_CLASS_FLAGS( EMarkdownNodeFlags );
+
+/** A range of characters in the document's string pool. */
+struct FMarkdownStringRef
+{
+	int32 Offset = 0;
+	int32 Length = 0;
+};
+
+/**
+ * One node of the syntax tree. Nodes refer to each other by index into the document, so the whole tree is two flat
+ * arrays (nodes and strings) that can be copied around as they are.
+ *
+ * Literal and Extra depend on the type:
+ *   Text, Code, Html, HtmlBlock - Literal is the content
+ *   CodeBlock                   - Literal is the content, Extra the info string (language)
+ *   Link, Image                 - Literal is the title, Extra the destination, the children are the link text
+ *
+ * Value is the level of a Heading and the start number of an ordered List.
+ */
+struct FMarkdownNode
+{
+	EMarkdownNodeType Type = EMarkdownNodeType::Document;
+	uint8 Reserved = 0; // explicit so nodes have no uninitialized bytes, they are saved to cooked packages as they are
+	EMarkdownNodeFlags Flags = EMarkdownNodeFlags::None;
+	int32 Value = 0;
+
+	int32 Parent = INDEX_NONE;
+	int32 FirstChild = INDEX_NONE;
+	int32 LastChild = INDEX_NONE;
+	int32 NextSibling = INDEX_NONE;
+
+	/** characters of the source text this node came from */
+	int32 SourceOffset = 0;
+	int32 SourceLength = 0;
+
+	FMarkdownStringRef Literal;
+	FMarkdownStringRef Extra;
+
+	bool IsBlock() const
+	{
+		return Type < EMarkdownNodeType::Text;
+	}
+
+	bool HasFlag( const EMarkdownNodeFlags Flag ) const
+	{
+		return EnumHasAllFlags( Flags, Flag );
+	}
+};
+
+/**
+ * Syntax tree of a markdown document, produced by FMarkdownParser. Node 0 is the document itself.
+ */
+class MARKDOWNASSET_API FMarkdownDocument
+{
+public:
+
+	static constexpr int32 Root = 0;
+
+	int32 Num() const
+	{
+		return Nodes.Num();
+	}
+
+	bool IsEmpty() const
+	{
+		return Nodes.Num() <= 1;
+	}
+
+	const FMarkdownNode& operator[]( const int32 Index ) const
+	{
+		return Nodes[ Index ];
+	}
+
+	FStringView GetString( const FMarkdownStringRef& Ref ) const
+	{
+		return FStringView( Strings.GetData() + Ref.Offset, Ref.Length );
+	}
+
+	FStringView GetLiteral( const int32 Index ) const
+	{
+		return GetString( Nodes[ Index ].Literal );
+	}
+
+	FStringView GetExtra( const int32 Index ) const
+	{
+		return GetString( Nodes[ Index ].Extra );
+	}
+
+	/** Text of the node and everything under it with the markup taken out. */
+	FString GetPlainText( const int32 Index = Root ) const;
+	void AppendPlainText( const int32 Index, FString& Out ) const;
+
+	/** Calls Func( Index ) for each direct child. */
+	template<typename FuncType>
+	void ForEachChild( const int32 Index, FuncType&& Func ) const
+	{
+		for( int32 Child = Nodes[ Index ].FirstChild; Child != INDEX_NONE; Child = Nodes[ Child ].NextSibling )
+		{
+			Func( Child );
+		}
+	}
+
+	/** Calls Func( Index ) for the node and everything under it, in document order. */
+	template<typename FuncType>
+	void ForEachDescendant( const int32 Index, FuncType&& Func ) const
+	{
+		// follows the links rather than recursing, so how deep the tree goes does not matter
+		int32 Node = Index;
+
+		while( true )
+		{
+			Func( Node );
+
+			if( Nodes[ Node ].FirstChild != INDEX_NONE )
+			{
+				Node = Nodes[ Node ].FirstChild;
+				continue;
+			}
+
+			while( Node != Index && Nodes[ Node ].NextSibling == INDEX_NONE )
+			{
+				Node = Nodes[ Node ].Parent;
+			}
+
+			if( Node == Index )
+			{
+				return;
+			}
+
+			Node = Nodes[ Node ].NextSibling;
+		}
+	}
+
+	const TArray<FMarkdownNode>& GetNodes() const
+	{
+		return Nodes;
+	}
+
+	const TArray<TCHAR>& GetStrings() const
+	{
+		return Strings;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Nodes.GetAllocatedSize() + Strings.GetAllocatedSize();
+	}
+
+	void Empty();
+
+	/**
+	 * Reads or writes the tree as a small header followed by the node and string arrays exactly as they are in memory,
+	 * so loading is one copy per array. Returns false, leaving the document empty, if the data was written with a
+	 * different node layout or byte order (or can't be written in the archive's byte order).
+	 */
+	bool Serialize( FArchive& Ar );
+
+	//~ building, used by the parser
+
+	/** Adds a node as the last child of Parent, or a root if Parent is INDEX_NONE. */
+	int32 AddNode( const EMarkdownNodeType Type, const int32 Parent );
+
+	FMarkdownStringRef AddString( const FStringView String );
+
+	FMarkdownNode& GetMutableNode( const int32 Index )
+	{
+		return Nodes[ Index ];
+	}
+
+	void Reserve( const int32 NumNodes, const int32 NumChars )
+	{
+		Nodes.Reserve( NumNodes );
+		Strings.Reserve( NumChars );
+	}
+
+	void Shrink()
+	{
+		Nodes.Shrink();
+		Strings.Shrink();
+	}
+
+private:
+
+	TArray<FMarkdownNode> Nodes;
+	TArray<TCHAR> Strings;
+};
@@ -0,0 +1,53 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Parser/MarkdownDocument.h"
+
+/**
+ * Parsed documents shared between views, so showing the same page again (a help screen being reopened, two widgets
+ * on the same asset) does not parse it again. Entries are found by the source text and dropped least recently used
+ * first once they take more than the budget. Game thread only.
+ */
+class MARKDOWNASSET_API FMarkdownDocumentCache
+{
+public:
+
+	static FMarkdownDocumentCache& Get();
+
+	/** The parsed document for the text, parsing it if it is not already cached. */
+	TSharedRef<const FMarkdownDocument> FindOrParse( const FString& Source );
+
+	/** The parsed document for the text if it is cached. */
+	TSharedPtr<const FMarkdownDocument> Find( const FString& Source );
+
+	/** Adds a document parsed elsewhere, for example on a worker thread. */
+	void Add( const FString& Source, const TSharedRef<const FMarkdownDocument>& Document );
+
+	void Empty();
+
+	/** In bytes, the default is 8 MB. */
+	void SetBudget( const SIZE_T InBudget );
+
+private:
+
+	void Trim();
+
+	static uint64 Hash( const FString& Source );
+
+	struct FEntry
+	{
+		FString Source;
+		TSharedPtr<const FMarkdownDocument> Document;
+		SIZE_T Size = 0;
+		uint64 LastUsed = 0;
+	};
+
+	/** by hash of the source, the source is kept to tell collisions apart */
+	TMultiMap<uint64, FEntry> Entries;
+
+	SIZE_T Budget = 8 * 1024 * 1024;
+	SIZE_T Used = 0;
+	uint64 UseCounter = 0;
+};
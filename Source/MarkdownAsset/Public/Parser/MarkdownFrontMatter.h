@@ -0,0 +1,20 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The YAML block a document can start with, between two "---" lines. Only the simple forms are read, "key: value",
+ * "key: [ a, b ]" and a key followed by "- item" lines, which covers titles and tags. Anything else is skipped.
+ */
+class MARKDOWNASSET_API FMarkdownFrontMatter
+{
+public:
+
+	/** Reads the values by key (keys are case-insensitive). The length of the block, or 0 if the text has none. */
+	static int32 Parse( const FStringView Text, TMap<FString, TArray<FString>>& OutValues );
+
+	/** The "tags" of the front matter, "keywords" too since some generators use that. */
+	static void GetTags( const FStringView Text, TArray<FString>& OutTags );
+};
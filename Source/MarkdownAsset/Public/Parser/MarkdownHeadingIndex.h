@@ -0,0 +1,71 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "MarkdownHeadingIndex.generated.h"
+
+/** One heading of a document and the range of the section it starts. Offsets are in characters of the text. */
+USTRUCT( BlueprintType )
+struct MARKDOWNASSET_API FMarkdownHeading
+{
+	GENERATED_BODY()
+
+	/** 1 to 6 */
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	int32 Level = 0;
+
+	/** anchor the viewer gives the heading, "## Getting Started!" is "getting-started!", repeats get "-1", "-2" and so on */
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	FString Slug;
+
+	/** the heading text as written */
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	FString Title;
+
+	/** start of the heading line */
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	int32 Offset = 0;
+
+	/** the heading line (or lines, for underlined headings) up to and including the line break */
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	int32 HeadingLength = 0;
+
+	/** from Offset to the next heading of the same or a higher level, or the end of the text */
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	int32 SectionLength = 0;
+
+	int32 GetBodyOffset() const
+	{
+		return Offset + HeadingLength;
+	}
+
+	int32 GetBodyLength() const
+	{
+		return SectionLength - HeadingLength;
+	}
+};
+
+/**
+ * Finds headings with a line scan rather than a full parse. Only top level headings are found (not ones inside
+ * quotes or lists), and fenced and indented code is skipped.
+ *
+ * Every heading starts from a known state (not in a code block or paragraph), so after an edit only the lines from
+ * the heading before the edit are scanned again, until a heading lines up with one from before the edit.
+ */
+class MARKDOWNASSET_API FMarkdownHeadingIndex
+{
+public:
+
+	static void Build( const FStringView Text, TArray<FMarkdownHeading>& OutHeadings );
+
+	/**
+	 * Updates headings built from an earlier version of the text, where RemovedLength characters at ChangeOffset were
+	 * replaced with InsertedLength characters to give Text.
+	 */
+	static void Update( const FStringView Text, const int32 ChangeOffset, const int32 RemovedLength, const int32 InsertedLength, TArray<FMarkdownHeading>& InOutHeadings );
+
+	/** Anchor for a heading, as markdown-it-anchor makes it in the viewer, so links to it work in both. Not unique. */
+	static FString MakeSlug( const FStringView Title );
+};
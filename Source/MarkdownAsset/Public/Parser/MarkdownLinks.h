@@ -0,0 +1,54 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FMarkdownDocument;
+
+enum class EMarkdownLinkType : uint8
+{
+	/** anything with a scheme, "https://", "mailto:" */
+	External,
+
+	/** "#heading" in the same document */
+	Anchor,
+
+	/** a copied asset reference, "/Script/Engine.Blueprint'/Game/Hero.Hero'" */
+	Asset,
+
+	/** another .md file, relative to this one unless it starts with a "/" */
+	Document,
+
+	/** any other path, images mostly */
+	File,
+};
+
+/** A link or image of a document, sorted by what it goes to. */
+struct FMarkdownLink
+{
+	/** as written */
+	FString Destination;
+
+	/** the object path for an asset, the decoded path for a document or file, empty otherwise */
+	FString Target;
+
+	/** what follows the "#", without it */
+	FString Anchor;
+
+	EMarkdownLinkType Type = EMarkdownLinkType::External;
+
+	/** where the link is in the text */
+	int32 SourceOffset = 0;
+};
+
+/** Finds the links of a document, and what they point at, by the same rules the viewer follows them. */
+class MARKDOWNASSET_API FMarkdownLinks
+{
+public:
+
+	/** Every link and image of the document, in document order. */
+	static void Collect( const FMarkdownDocument& Document, TArray<FMarkdownLink>& OutLinks );
+
+	static FMarkdownLink Classify( const FStringView Destination );
+};
@@ -0,0 +1,33 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Parser/MarkdownDocument.h"
+
+struct FMarkdownParserOptions
+{
+	/** GitHub flavoured extensions, on by default to match the viewer */
+	bool bTables = true;
+	bool bTaskLists = true;
+	bool bStrikethrough = true;
+	bool bAutolinks = true;
+};
+
+/**
+ * CommonMark parser with the GitHub extensions the viewer uses (tables, task lists, strikethrough, bare links).
+ * Lets the editor and runtime get at headings, links and text without going through the browser.
+ */
+class MARKDOWNASSET_API FMarkdownParser
+{
+public:
+
+	static void Parse( const FStringView Text, FMarkdownDocument& OutDocument, const FMarkdownParserOptions& Options = FMarkdownParserOptions() );
+
+	static FMarkdownDocument Parse( const FStringView Text, const FMarkdownParserOptions& Options = FMarkdownParserOptions() )
+	{
+		FMarkdownDocument Document;
+		Parse( Text, Document, Options );
+		return Document;
+	}
+};
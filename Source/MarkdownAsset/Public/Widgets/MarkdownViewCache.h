@@ -0,0 +1,43 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ISlateStyle;
+class SMarkdownView;
+struct FMarkdownDocument;
+
+/**
+ * Views that have been taken off screen, parked with the rows they have laid out. Text layout depends on the document,
+ * the width and the style, so a view asked for with the same three (a help screen being opened again) is handed back
+ * as it was and nothing is built or laid out. A view parked at another width still has its rows, only the text wraps
+ * again. Slate widgets can only be in one place, so a parked view is taken out of the cache while it is used.
+ * Game thread only.
+ */
+class MARKDOWNASSET_API FMarkdownViewCache
+{
+public:
+
+	static FMarkdownViewCache& Get();
+
+	/** A parked view showing the document with the style, one laid out at the width if there is one. */
+	TSharedPtr<SMarkdownView> Take( const FMarkdownDocument& Document, const ISlateStyle* Style, const float Width );
+
+	/** Keeps a view that is no longer shown, the oldest are dropped once there are more than the capacity. */
+	void Park( const TSharedRef<SMarkdownView>& View );
+
+	void Empty();
+
+	/** The default is 8 views. */
+	void SetCapacity( const int32 InCapacity );
+
+private:
+
+	void Trim();
+
+	/** oldest first */
+	TArray<TSharedRef<SMarkdownView>> Views;
+
+	int32 Capacity = 8;
+};
@@ -0,0 +1,30 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Styling/SlateStyle.h"
+
+/**
+ * Text and brush styles for SMarkdownView.
+ *
+ * Block text styles are Paragraph, Heading1 to Heading6, TableHeader and CodeBlock. Inline formatting has its own
+ * style per block style since rich text runs replace the block's font rather than modify it, so bold text in a
+ * heading is Heading2.Strong and inline code in a paragraph is Paragraph.Code (see GetInlineStyleName).
+ */
+class MARKDOWNASSET_API FMarkdownViewStyle : public FSlateStyleSet
+{
+public:
+
+	/** The default style, registered the first time it is asked for. */
+	static const ISlateStyle& Get();
+
+	/** Called by the module on shutdown. */
+	static void Shutdown();
+
+	/** Style for text in a block with the given style and formatting, or the block style itself if there is none. */
+	static FString GetInlineStyleName( const FString& BlockStyle, const bool bStrong, const bool bEmphasis, const bool bStrikethrough, const bool bCode );
+
+	FMarkdownViewStyle();
+	virtual ~FMarkdownViewStyle();
+};
@@ -0,0 +1,155 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Text/SlateHyperlinkRun.h"
+#include "Framework/Text/SlateWidgetRun.h"
+#include "Parser/MarkdownDocument.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+class ISlateStyle;
+class ITableRow;
+class SBorder;
+class STableViewBase;
+class UTexture;
+struct FSlateBrush;
+struct FStreamableHandle;
+struct FTextRunInfo;
+
+DECLARE_DELEGATE_OneParam( FOnMarkdownLinkClicked, const FString& /*Url*/ );
+
+/** A row of the view, a top level block or one item of a top level list. */
+struct FMarkdownViewRow
+{
+	int32 Node = INDEX_NONE;
+
+	/** number shown for items of ordered lists */
+	int32 Number = 0;
+};
+
+/**
+ * Read only markdown view drawn with Slate, for when a browser is more than is needed.
+ *
+ * The text is parsed natively (through FMarkdownDocumentCache) and each top level block (each item, for lists) is a
+ * row of a list view, so long documents only have widgets for the part that has been on screen. Paragraphs, headings and table cells are rich text blocks with
+ * decorators for links and images. Images are looked up as assets ("/Game/Docs/Diagram"), others show their alt text.
+ * Image assets that are not loaded yet are streamed in, with a placeholder shown until they arrive.
+ */
+class MARKDOWNASSET_API SMarkdownView : public SCompoundWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS( SMarkdownView )
+		: _Style( nullptr )
+		, _Padding( FMargin( 16.0f, 8.0f ) )
+	{}
+		/** the markdown source, polled every frame but only parsed again when it changes */
+		SLATE_ATTRIBUTE( FText, Text )
+
+		/** FMarkdownViewStyle::Get() if not set */
+		SLATE_ARGUMENT( const ISlateStyle*, Style )
+
+		SLATE_ARGUMENT( FMargin, Padding )
+
+		/** if not bound, web and mail links are opened with the platform and the rest are ignored */
+		SLATE_EVENT( FOnMarkdownLinkClicked, OnLinkClicked )
+	SLATE_END_ARGS()
+
+	void Construct( const FArguments& InArgs );
+
+	virtual void Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime ) override;
+
+	void SetText( const TAttribute<FText>& InText );
+
+	/** Shows an already parsed document, for example one from FMarkdownDocumentCache. Unbinds the text. */
+	void SetDocument( const TSharedRef<const FMarkdownDocument>& InDocument );
+
+	void SetPadding( const FMargin& InPadding );
+
+	/** FMarkdownViewStyle::Get() if null, rows are made again with the new style. */
+	void SetStyle( const ISlateStyle* InStyle );
+
+	void SetOnLinkClicked( const FOnMarkdownLinkClicked& InOnLinkClicked );
+
+	const FMarkdownDocument& GetDocument() const
+	{
+		return *Document;
+	}
+
+	const ISlateStyle* GetStyle() const
+	{
+		return Style;
+	}
+
+	/** The width the rows were last laid out at, zero if the view has not been drawn yet. */
+	float GetLaidOutWidth() const
+	{
+		return LaidOutWidth;
+	}
+
+	void ScrollToTop();
+
+private:
+
+	void Refresh();
+	void RebuildRows();
+
+	TSharedRef<ITableRow> MakeRow( TSharedPtr<FMarkdownViewRow> Row, const TSharedRef<STableViewBase>& OwnerTable );
+
+	// blocks
+	TSharedRef<SWidget> MakeBlock( const int32 Node );
+	TSharedRef<SWidget> MakeBlocks( const int32 Parent, const bool bTight );
+	TSharedRef<SWidget> MakeListItem( const int32 Node, const int32 Number );
+	TSharedRef<SWidget> MakeTable( const int32 Node );
+	TSharedRef<SWidget> MakeRichText( const int32 Node, const FString& BlockStyle, const bool bWrap = true );
+
+	// inlines, as rich text markup
+	void AppendMarkup( const int32 Node, const FString& BlockStyle, const uint8 Format, FString& Out ) const;
+
+	// decorators
+	FSlateWidgetRun::FWidgetRunInfo MakeImage( const FTextRunInfo& RunInfo, const ISlateStyle* InStyle );
+	const FSlateBrush* FindImage( const FStringView Source );
+	void HandleImageLoaded( FString Source );
+	void HandleLinkClicked( const FSlateHyperlinkRun::FMetadata& Metadata );
+
+private:
+
+	const ISlateStyle* Style = nullptr;
+	FMargin Padding;
+	float LaidOutWidth = 0.0f;
+
+	TAttribute<FText> Text;
+	FText DisplayedText;
+	FString DisplayedSource;
+
+	TSharedRef<const FMarkdownDocument> Document = MakeShared<FMarkdownDocument>();
+	TArray<TSharedPtr<FMarkdownViewRow>> Rows;
+
+	/** content of rows that have been on screen, by node */
+	TMap<int32, TSharedPtr<SWidget>> RowContent;
+	TSharedPtr<SListView<TSharedPtr<FMarkdownViewRow>>> ListView;
+	TSharedPtr<SBorder> Background;
+
+	FOnMarkdownLinkClicked OnLinkClicked;
+
+	/** brushes for image assets by path, kept for as long as the view is since rows being replaced may still use them */
+	struct FImage
+	{
+		void SetTexture( UTexture* Texture );
+
+		TStrongObjectPtr<UObject> Object;
+		TSharedPtr<FSlateBrush> Brush;
+
+		/** set while the asset is streaming in */
+		TSharedPtr<FStreamableHandle> Handle;
+	};
+
+	TMap<FString, FImage> Images;
+
+	/** an image finished loading, rows made while it was are made again on the next tick */
+	bool bImagesChanged = false;
+};
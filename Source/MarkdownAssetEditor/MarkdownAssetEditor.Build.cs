@@ -30,6 +30,8 @@ public class MarkdownAssetEditor : ModuleRules
             "EditorStyle",
             "Engine",
             "InputCore",
+            "Json",
+            "LevelEditor",
             "Projects",
             "Slate",
             "SlateCore",
@@ -43,6 +45,10 @@ public class MarkdownAssetEditor : ModuleRules
             "ContentBrowserData", 
             "GameProjectGeneration",
             "AssetTools",
+            "AssetRegistry",
+            "DirectoryWatcher",
+            "EditorSubsystem",
+            "WorkspaceMenuStructure",
         });
 
         PrivateIncludePathModuleNames.AddRange( new string[] {
@@ -0,0 +1,62 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Commandlets/MarkdownCoverageCommandlet.h"
+
+#include "AssetRegistry/IAssetRegistry.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "Misc/Parse.h"
+#include "Validation/MarkdownCoverage.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UMarkdownCoverageCommandlet::UMarkdownCoverageCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UMarkdownCoverageCommandlet::Main( const FString& Params )
+{
+	FString ReportFilename = FMarkdownCoverageReport::GetDefaultFilename();
+	FParse::Value( *Params, TEXT( "Report=" ), ReportFilename );
+
+	FString Root = TEXT( "/Game" );
+	FParse::Value( *Params, TEXT( "Path=" ), Root );
+
+	float MinCoverage = 0.0f;
+	FParse::Value( *Params, TEXT( "MinCoverage=" ), MinCoverage );
+
+	// commandlets start before the asset registry has looked at anything
+	IAssetRegistry::GetChecked().SearchAllAssets( true );
+
+	FMarkdownCoverage Coverage( Root );
+	FMarkdownCoverageReport Report;
+	Coverage.Build( Report );
+
+	for( int32 Category = 0; Category < int32( EMarkdownCoverageCategory::Num ); ++Category )
+	{
+		const FMarkdownCoverageCounts& Counts = Report.Categories[ Category ];
+
+		UE_LOG( MarkdownEditorLog, Display, TEXT( "  %-10s %6d of %6d documented (%5.1f%%), %d stale" ),
+			FMarkdownCoverageReport::GetCategoryName( EMarkdownCoverageCategory( Category ) ), Counts.NumDocumented, Counts.NumAssets, Counts.GetCoverage() * 100.0f, Counts.NumStale );
+	}
+
+	UE_LOG( MarkdownEditorLog, Display, TEXT( "Markdown coverage: %d of %d assets under %s documented (%.1f%%), %d stale, %d folders in %.2f s" ),
+		Report.Total.NumDocumented, Report.Total.NumAssets, *Report.Root, Report.Total.GetCoverage() * 100.0f, Report.Total.NumStale, Report.Folders.Num(), Report.Seconds );
+
+	if( !Report.Save( ReportFilename ) )
+	{
+		UE_LOG( MarkdownEditorLog, Error, TEXT( "Markdown coverage: could not write the report to %s" ), *ReportFilename );
+		return 2;
+	}
+
+	if( Report.Total.GetCoverage() * 100.0f < MinCoverage )
+	{
+		UE_LOG( MarkdownEditorLog, Error, TEXT( "Markdown coverage: below the minimum of %.1f%%" ), MinCoverage );
+		return 1;
+	}
+
+	return 0;
+}
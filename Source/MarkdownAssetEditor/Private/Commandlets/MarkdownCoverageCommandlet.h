@@ -0,0 +1,29 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "MarkdownCoverageCommandlet.generated.h"
+
+/**
+ * Reports how much of the project's blueprints, data assets and maps is documented and which documentation is older
+ * than its asset, see FMarkdownCoverage. With -MinCoverage it exits with 1 when less than that percentage of the
+ * assets is documented, so it can gate a build.
+ *
+ *   UnrealEditor-Cmd.exe <Project> -run=MarkdownCoverage [-Path=/Game] [-Report=<File>] [-MinCoverage=<Percent>]
+ *
+ * The report goes to Saved/MarkdownCoverage/Report.json unless -Report says otherwise.
+ */
+UCLASS()
+class UMarkdownCoverageCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMarkdownCoverageCommandlet();
+
+	virtual int32 Main( const FString& Params ) override;
+};
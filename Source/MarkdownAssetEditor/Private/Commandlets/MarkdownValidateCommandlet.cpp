@@ -0,0 +1,54 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Commandlets/MarkdownValidateCommandlet.h"
+
+#include "AssetRegistry/IAssetRegistry.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "Misc/Parse.h"
+#include "Validation/MarkdownValidator.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UMarkdownValidateCommandlet::UMarkdownValidateCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UMarkdownValidateCommandlet::Main( const FString& Params )
+{
+	FString ReportFilename = FMarkdownValidationReport::GetDefaultFilename();
+	FParse::Value( *Params, TEXT( "Report=" ), ReportFilename );
+
+	// commandlets start before the asset registry has looked at anything
+	IAssetRegistry::GetChecked().SearchAllAssets( true );
+
+	// there is no editor to stall, so documents saved before their links were in the asset registry are loaded
+	FMarkdownValidator Validator( true );
+	FMarkdownValidationReport Report;
+	Validator.Validate( Report );
+
+	for( const FMarkdownLinkIssue& Issue : Report.Issues )
+	{
+		UE_LOG( MarkdownEditorLog, Warning, TEXT( "%s(%d): %s %s" ), *Issue.Document, Issue.Line, FMarkdownValidationReport::GetProblemName( Issue.Problem ), *Issue.Destination );
+	}
+
+	for( const FString& Path : Report.Unchecked )
+	{
+		UE_LOG( MarkdownEditorLog, Warning, TEXT( "%s: not checked, it could not be loaded" ), *Path );
+	}
+
+	UE_LOG( MarkdownEditorLog, Display, TEXT( "Markdown validate: checked %d links in %d documents in %.2f s, %d problems, %d assets not checked" ),
+		Report.NumLinks, Report.NumDocuments, Report.Seconds, Report.Issues.Num(), Report.Unchecked.Num() );
+
+	if( !Report.Save( ReportFilename ) )
+	{
+		UE_LOG( MarkdownEditorLog, Error, TEXT( "Markdown validate: could not write the report to %s" ), *ReportFilename );
+		return 2;
+	}
+
+	// a document that was not checked could have anything in it
+	return Report.Issues.IsEmpty() && Report.Unchecked.IsEmpty() ? 0 : 1;
+}
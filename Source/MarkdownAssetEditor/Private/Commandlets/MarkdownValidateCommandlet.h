@@ -0,0 +1,29 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "MarkdownValidateCommandlet.generated.h"
+
+/**
+ * Checks every link in the project documentation and writes a JSON report of the broken ones, see FMarkdownValidator.
+ * Exits with 1 if any were found, or if a markdown asset could not be checked, so it can gate a build. Assets saved
+ * before their links were in the asset registry are loaded to check them.
+ *
+ *   UnrealEditor-Cmd.exe <Project> -run=MarkdownValidate [-Report=<File>]
+ *
+ * The report goes to Saved/MarkdownValidate/Report.json unless -Report says otherwise.
+ */
+UCLASS()
+class UMarkdownValidateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMarkdownValidateCommandlet();
+
+	virtual int32 Main( const FString& Params ) override;
+};
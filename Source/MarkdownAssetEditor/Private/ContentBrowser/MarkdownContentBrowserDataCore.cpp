@@ -11,6 +11,8 @@
 #include "ContentBrowserDataUtils.h"
 #include "MarkdownAsset.h"
 #include "ContentBrowser/MarkdownContentBrowserFolderItemDataPayload.h"
+#include "ContentBrowser/MarkdownContentBrowserHierarchy.h"
+#include "Search/MarkdownQuickOpenIndex.h"
 #include "UObject/AssetRegistryTagsContext.h"
 
 #define LOCTEXT_NAMESPACE "MarkdownContentBrowserDataSource"
@@ -528,8 +530,56 @@ bool GetMarkdownFolderItemAttribute(const FMarkdownContentBrowserFolderItemDataP
 	return false;
 }
 
+// the outline of a file, as attributes so the content browser's search box can match it with "Title:", "Headings:"
+// and "Tags:" the way it does asset registry tags. They come from the quick open index, so are empty until the
+// file has been read in the background.
+static const FName NAME_Title = "Title";
+static const FName NAME_Headings = "Headings";
+static const FName NAME_Tags = "Tags";
+
+static bool GetMarkdownFileOutline(const FMarkdownContentBrowserFileItemDataPayload& InClassPayload, FString& OutTitle, TArray<FString>& OutHeadings, TArray<FString>& OutTags)
+{
+	const UMarkdownFile* File = InClassPayload.GetMDFile();
+	const auto Index = File ? File->QuickOpenIndex.Pin() : nullptr;
+
+	return Index.IsValid() && Index->GetOutline(File->GetInternalPath(), OutTitle, OutHeadings, OutTags);
+}
+
+static bool GetMarkdownFileOutlineAttribute(const FMarkdownContentBrowserFileItemDataPayload& InClassPayload, const FName InAttributeKey, FContentBrowserItemDataAttributeValue& OutAttributeValue)
+{
+	if (InAttributeKey != NAME_Title && InAttributeKey != NAME_Headings && InAttributeKey != NAME_Tags)
+	{
+		return false;
+	}
+
+	FString Title;
+	TArray<FString> Headings;
+	TArray<FString> Tags;
+
+	if (!GetMarkdownFileOutline(InClassPayload, Title, Headings, Tags))
+	{
+		return false;
+	}
+
+	if (InAttributeKey == NAME_Title)
+	{
+		OutAttributeValue.SetValue(Title);
+	}
+	else
+	{
+		OutAttributeValue.SetValue(FString::Join(InAttributeKey == NAME_Headings ? Headings : Tags, TEXT(", ")));
+	}
+
+	return true;
+}
+
 bool GetMarkdownFileItemAttribute(IAssetTypeActions* InClassTypeActions, const FMarkdownContentBrowserFileItemDataPayload& InClassPayload, const bool InIncludeMetaData, const FName InAttributeKey, FContentBrowserItemDataAttributeValue& OutAttributeValue)
 {
+	if (GetMarkdownFileOutlineAttribute(InClassPayload, InAttributeKey, OutAttributeValue))
+	{
+		return true;
+	}
+
 	// Hard-coded attribute keys
 	{
 		static const FName NAME_Type = "Type";
@@ -629,6 +679,20 @@ bool GetMarkdownFileItemAttributes(const FMarkdownContentBrowserFileItemDataPayl
 		GetClassItemAttribute(InIncludeMetaData, ClassAttributeValue);
 	}
 
+	// Outline
+	{
+		FString Title;
+		TArray<FString> Headings;
+		TArray<FString> Tags;
+
+		if (GetMarkdownFileOutline(InClassPayload, Title, Headings, Tags))
+		{
+			OutAttributeValues.Add(NAME_Title).SetValue(Title);
+			OutAttributeValues.Add(NAME_Headings).SetValue(FString::Join(Headings, TEXT(", ")));
+			OutAttributeValues.Add(NAME_Tags).SetValue(FString::Join(Tags, TEXT(", ")));
+		}
+	}
+
 	// Generic attribute keys
 	{
 		const FAssetData& AssetData = InClassPayload.GetAssetData();
@@ -14,6 +14,9 @@
 #include "ContentBrowser/MarkdownNewFileContextMenu.h"
 #include "MarkdownAsset.h"
 #include "ContentBrowser/MarkdownContentBrowserFolderItemDataPayload.h"
+#include "Algo/AnyOf.h"
+#include "Editor.h"
+#include "Search/MarkdownSearchSubsystem.h"
 #define UE_ASSET_DATA_GET_SOFT_OBJECT_PATH 0
 #define UE_U_CONTENT_BROWSER_DATA_SOURCE_NOTIFY_ITEM_DATA_REFRESHED 0
 #define DYNAMIC_ROOT_INTERNAL_PATH FString(TEXT("/Documentation"))
@@ -275,8 +278,18 @@ void UMarkdownContentBrowserDataSource::CompileFilter(const FName InPath, const
 
 	if (bIncludeFiles)
 	{
-		if (const auto& MatchingClasses = MarkdownHierarchy->GetMatchingMDFiles(
-			ConvertInternalPath, InFilter.bRecursivePaths); !MatchingClasses.IsEmpty())
+		TArray<UMarkdownFile*> MatchingClasses;
+
+		// with search text, only the files the index finds are looked at, rather than every file under the path
+		const auto TextFilter = InFilter.ExtraFilters.FindFilter<FMarkdownContentBrowserTextFilter>();
+
+		if (!TextFilter || TextFilter->SearchText.IsEmpty() ||
+			!GetFilesMatchingText(*TextFilter, InternalPaths, InFilter.bRecursivePaths, MatchingClasses))
+		{
+			MatchingClasses = MarkdownHierarchy->GetMatchingMDFiles(ConvertInternalPath, InFilter.bRecursivePaths);
+		}
+
+		if (!MatchingClasses.IsEmpty())
 		{
 #if UE_F_TOP_LEVEL_ASSET_PATH
 			TSet<FTopLevelAssetPath> ClassPathsToInclude;
@@ -660,11 +673,29 @@ void UMarkdownContentBrowserDataSource::OnEndGenerator()
 	UpdateHierarchy();
 }
 
+const TSharedPtr<FMarkdownContentBrowserHierarchy>& UMarkdownContentBrowserDataSource::GetHierarchy()
+{
+	if (!MarkdownHierarchy.IsValid())
+	{
+		UpdateHierarchy();
+	}
+
+	return MarkdownHierarchy;
+}
+
 void UMarkdownContentBrowserDataSource::UpdateHierarchy()
 {
+	// the quick open index carries over, only files changed since it was made are read again
+	TSharedPtr<FMarkdownQuickOpenIndex> QuickOpenIndex;
+
+	if (MarkdownHierarchy.IsValid())
+	{
+		QuickOpenIndex = MarkdownHierarchy->GetQuickOpenIndex();
+	}
+
 	MarkdownHierarchy.Reset();
 
-	MarkdownHierarchy = MakeShareable(new FMarkdownContentBrowserHierarchy());
+	MarkdownHierarchy = MakeShareable(new FMarkdownContentBrowserHierarchy(QuickOpenIndex));
 
 	SetVirtualPathTreeNeedsRebuild();
 
@@ -755,6 +786,59 @@ FContentBrowserItemData UMarkdownContentBrowserDataSource::CreateFileItem(UMarkd
 	return {};
 }
 
+bool UMarkdownContentBrowserDataSource::GetFilesMatchingText(const FMarkdownContentBrowserTextFilter& InTextFilter,
+                                                             const TSet<FName>& InInternalPaths, const bool bRecursive,
+                                                             TArray<UMarkdownFile*>& OutFiles) const
+{
+	const auto SearchSubsystem = GEditor ? GEditor->GetEditorSubsystem<UMarkdownSearchSubsystem>() : nullptr;
+
+	const auto SearchIndex = SearchSubsystem ? SearchSubsystem->GetIndex() : nullptr;
+
+	FMarkdownSearchQuery Query;
+
+	// until the index is ready, the content browser's own name matching is all there is
+	if (!SearchIndex.IsValid() || !Query.Parse(InTextFilter.SearchText))
+	{
+		return false;
+	}
+
+	Query.bOutlineOnly = !InTextFilter.bIncludeBody;
+
+	TArray<FMarkdownSearchHit> Hits;
+
+	SearchIndex->Search(Query, SearchIndex->NumDocuments(), Hits);
+
+	for (const auto& Hit : Hits)
+	{
+		// assets are in the index too, only files belong to this data source
+		const auto& Path = SearchIndex->GetDocument(Hit).Path;
+
+		if (!Path.StartsWith(DYNAMIC_ROOT_INTERNAL_PATH / TEXT("")))
+		{
+			continue;
+		}
+
+		const auto Folder = FPaths::GetPath(Path);
+
+		const auto bInPath = Algo::AnyOf(InInternalPaths, [&Folder, bRecursive](const FName& InInternalPath)
+		{
+			const auto InternalPath = InInternalPath.ToString();
+
+			return Folder.Equals(InternalPath) || (bRecursive && Folder.StartsWith(InternalPath / TEXT("")));
+		});
+
+		if (bInPath)
+		{
+			if (const auto File = MarkdownHierarchy->FindMDFile(Path))
+			{
+				OutFiles.Add(File);
+			}
+		}
+	}
+
+	return true;
+}
+
 bool UMarkdownContentBrowserDataSource::GetClassPaths(const TArrayView<const FCollectionNameType>& InCollections,
                                        const bool bIncludeChildCollections,
 #if UE_F_TOP_LEVEL_ASSET_PATH
@@ -1,6 +1,13 @@
 #include "ContentBrowser/MarkdownContentBrowserHierarchy.h"
 #include "MarkdownAsset.h"
 #include "FileHelpers.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Parser/MarkdownFrontMatter.h"
+#include "Parser/MarkdownHeadingIndex.h"
+#include "Search/MarkdownQuickOpenIndex.h"
+#include "Tasks/Task.h"
 
 #define DYNAMIC_ROOT_INTERNAL_PATH FString(TEXT("/Documentation"))
 
@@ -41,9 +48,22 @@ void UMarkdownFile::OnAssetChanged()
 	{
 		FString FullPath = FPaths::ProjectDir() + DYNAMIC_ROOT_INTERNAL_PATH + FilePath.ToString();
 		FFileHelper::SaveStringToFile(Asset->Text.ToString(), *FullPath);
+
+		if (const auto Index = QuickOpenIndex.Pin())
+		{
+			TArray<FString> Tags;
+			FMarkdownFrontMatter::GetTags(Asset->Text.ToString(), Tags);
+
+			Index->AddDocument(GetInternalPath(), Asset->GetHeadings(), IFileManager::Get().GetTimeStamp(*FullPath), Tags);
+		}
 	}
 }
 
+FString UMarkdownFile::GetInternalPath() const
+{
+	return DYNAMIC_ROOT_INTERNAL_PATH + FilePath.ToString();
+}
+
 void FMarkdownContentBrowserHierarchyNode::DestroyUObjects()
 {
 	for (UMarkdownFile* File : MDFiles)
@@ -56,7 +76,11 @@ void FMarkdownContentBrowserHierarchyNode::DestroyUObjects()
 	}
 }
 
-FMarkdownContentBrowserHierarchy::FMarkdownContentBrowserHierarchy()
+FMarkdownContentBrowserHierarchy::FMarkdownContentBrowserHierarchy(
+	const TSharedPtr<FMarkdownQuickOpenIndex>& InQuickOpenIndex)
+	: QuickOpenIndex(InQuickOpenIndex.IsValid()
+		                 ? InQuickOpenIndex.ToSharedRef()
+		                 : MakeShared<FMarkdownQuickOpenIndex>())
 {
 	PopulateHierarchy();
 }
@@ -180,6 +204,30 @@ TArray<UMarkdownFile*> FMarkdownContentBrowserHierarchy::GetMatchingMDFiles(
 	return MatchingClasses;
 }
 
+UMarkdownFile* FMarkdownContentBrowserHierarchy::FindMDFile(const FString& InInternalPath) const
+{
+	if (!InInternalPath.StartsWith(DYNAMIC_ROOT_INTERNAL_PATH / TEXT("")))
+	{
+		return nullptr;
+	}
+
+	const auto FilePath = InInternalPath.RightChop(DYNAMIC_ROOT_INTERNAL_PATH.Len());
+
+	// FindNode stops at the deepest folder it has, so the files there still have to match the whole path
+	if (const auto Node = FindNode(*FPaths::GetPath(InInternalPath)))
+	{
+		for (const auto File : Node->GetMDFiles())
+		{
+			if (File->FilePath.ToString().Equals(FilePath))
+			{
+				return File;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
 FString FMarkdownContentBrowserHierarchy::ConvertInternalPathToFileSystemPath(const FString& InInternalPath)
 {
 	auto FileSystemPath = InInternalPath;
@@ -204,6 +252,33 @@ FString FMarkdownContentBrowserHierarchy::ConvertInternalPathToFileSystemPath(co
 	return FPaths::ConvertRelativePathToFull(FPaths::ProjectDir() + DYNAMIC_ROOT_INTERNAL_PATH) / FileSystemPath;
 }
 
+FString FMarkdownContentBrowserHierarchy::ConvertFileSystemPathToInternalPath(const FString& InFileSystemPath)
+{
+	const auto Root = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir() + DYNAMIC_ROOT_INTERNAL_PATH);
+
+	auto FileSystemPath = FPaths::ConvertRelativePathToFull(InFileSystemPath);
+
+	if (!FileSystemPath.StartsWith(Root / TEXT("")))
+	{
+		return FString();
+	}
+
+	return DYNAMIC_ROOT_INTERNAL_PATH + FileSystemPath.RightChop(Root.Len());
+}
+
+void FMarkdownContentBrowserHierarchy::FindMDFiles(TArray<FString>& OutInternalPaths)
+{
+	const FString Path = FPaths::ProjectDir() + DYNAMIC_ROOT_INTERNAL_PATH;
+
+	IFileManager::Get().FindFilesRecursive(OutInternalPaths, *Path, TEXT("*.md"), true, false);
+
+	for (FString& File : OutInternalPaths)
+	{
+		File.RemoveFromStart(Path);
+		File.InsertAt(0, DYNAMIC_ROOT_INTERNAL_PATH);
+	}
+}
+
 bool FMarkdownContentBrowserHierarchy::EnumeratePath(const FString& InPath, const TFunctionRef<bool(const FName&)>& InCallback)
 {
 	const auto Path = *InPath;
@@ -279,12 +354,11 @@ void FMarkdownContentBrowserHierarchy::PopulateHierarchy()
 	}
 	Root = MakeShared<FMarkdownContentBrowserHierarchyNode>();
 
-	FString Path = FPaths::ProjectDir() + DYNAMIC_ROOT_INTERNAL_PATH;
 	TArray<FString> Files;
-	IFileManager::Get().FindFilesRecursive(Files, *Path , TEXT("*.md"), true, false);
+	FindMDFiles(Files);
 	for (FString File : Files)
 	{
-		File.RemoveFromStart(Path);
+		File.RemoveFromStart(DYNAMIC_ROOT_INTERNAL_PATH);
 		FString ObjectName = File;
 		if (ObjectName.Contains("/"))
 		{
@@ -297,6 +371,103 @@ void FMarkdownContentBrowserHierarchy::PopulateHierarchy()
 		
 		UMarkdownFile* MDFile = NewObject<UMarkdownFile>(GetTransientPackage(), FName(ObjectName), RF_Standalone);
 		MDFile->FilePath = FName(File);
+		MDFile->QuickOpenIndex = QuickOpenIndex;
 		AddMDFile(MDFile);
 	}
+
+	UpdateQuickOpenIndex(Files);
+}
+
+void FMarkdownContentBrowserHierarchy::UpdateQuickOpenIndex(const TArray<FString>& InInternalPaths) const
+{
+	TMap<FString, FDateTime> Timestamps;
+	QuickOpenIndex->GetTimestamps(Timestamps);
+
+	// files gone since the last hierarchy come out, new ones go in by name until their headings have been read
+	const TSet<FString> Found(InInternalPaths);
+
+	for (const auto& [Path, Timestamp] : Timestamps)
+	{
+		if (!Found.Contains(Path))
+		{
+			QuickOpenIndex->RemoveDocument(Path);
+		}
+	}
+
+	for (const auto& Path : InInternalPaths)
+	{
+		if (!Timestamps.Contains(Path))
+		{
+			QuickOpenIndex->AddDocument(Path, {});
+		}
+	}
+
+	struct FReadFile
+	{
+		FString Path;
+		FDateTime Timestamp;
+		TArray<FMarkdownHeading> Headings;
+		TArray<FString> Tags;
+	};
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION,
+	                  [WeakIndex = TWeakPtr<FMarkdownQuickOpenIndex>(QuickOpenIndex), Paths = InInternalPaths,
+		                  Timestamps = MoveTemp(Timestamps)]()
+	                  {
+		                  // in batches, so the first headings turn up quickly and a large tree isn't all in memory
+		                  constexpr int32 BatchSize = 512;
+
+		                  for (int32 First = 0; First < Paths.Num() && WeakIndex.IsValid(); First += BatchSize)
+		                  {
+			                  TArray<FReadFile> Files;
+			                  Files.SetNum(FMath::Min(BatchSize, Paths.Num() - First));
+
+			                  ParallelFor(Files.Num(), [&](const int32 Index)
+			                  {
+				                  const auto& Path = Paths[First + Index];
+				                  const auto FileSystemPath = ConvertInternalPathToFileSystemPath(Path);
+				                  const auto Timestamp = IFileManager::Get().GetTimeStamp(*FileSystemPath);
+				                  const auto Known = Timestamps.Find(Path);
+
+				                  // files are only read again when they have been modified
+				                  if (FString Text; (Known == nullptr || *Known != Timestamp) &&
+					                  FFileHelper::LoadFileToString(Text, *FileSystemPath))
+				                  {
+					                  Files[Index].Path = Path;
+					                  Files[Index].Timestamp = Timestamp;
+					                  FMarkdownHeadingIndex::Build(Text, Files[Index].Headings);
+					                  FMarkdownFrontMatter::GetTags(Text, Files[Index].Tags);
+				                  }
+			                  });
+
+			                  Files.RemoveAll([](const FReadFile& File)
+			                  {
+				                  return File.Path.IsEmpty();
+			                  });
+
+			                  if (Files.IsEmpty())
+			                  {
+				                  continue;
+			                  }
+
+			                  AsyncTask(ENamedThreads::GameThread, [WeakIndex, Files = MoveTemp(Files)]()
+			                  {
+				                  const auto Index = WeakIndex.Pin();
+
+				                  if (!Index.IsValid())
+				                  {
+					                  return;
+				                  }
+
+				                  for (const auto& File : Files)
+				                  {
+					                  // skipped if the file has gone, or was saved from its editor since it was read
+					                  if (Index->Contains(File.Path) && Index->GetTimestamp(File.Path) < File.Timestamp)
+					                  {
+						                  Index->AddDocument(File.Path, File.Headings, File.Timestamp, File.Tags);
+					                  }
+				                  }
+			                  });
+		                  }
+	                  });
 }
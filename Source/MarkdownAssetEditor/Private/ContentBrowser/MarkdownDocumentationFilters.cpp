@@ -0,0 +1,198 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "ContentBrowser/MarkdownDocumentationFilters.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "ContentBrowserItem.h"
+#include "ContentBrowserModule.h"
+#include "Editor.h"
+#include "FrontendFilterBase.h"
+#include "MarkdownAsset.h"
+#include "Modules/ModuleManager.h"
+#include "Search/MarkdownDocumentationSubsystem.h"
+#include "Styling/AppStyle.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/SNullWidget.h"
+#include "Widgets/Text/STextBlock.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownDocumentationFilters"
+
+namespace MarkdownDocumentationFilters
+{
+	static FDelegateHandle StateIndicatorsHandle;
+
+	static const UMarkdownDocumentationSubsystem* GetSubsystem()
+	{
+		const UMarkdownDocumentationSubsystem* Subsystem = GEditor != nullptr ? GEditor->GetEditorSubsystem<UMarkdownDocumentationSubsystem>() : nullptr;
+		return Subsystem != nullptr && Subsystem->IsReady() ? Subsystem : nullptr;
+	}
+
+	// documents are documentation rather than something to document, and redirectors are not really there
+	static bool IsDocumentable( const FAssetData& AssetData )
+	{
+		return AssetData.IsValid() && !AssetData.IsRedirector() && !AssetData.IsInstanceOf( UMarkdownAsset::StaticClass() );
+	}
+
+	static TOptional<EMarkdownDocumentationState> GetState( const FSoftObjectPath& Asset )
+	{
+		const UMarkdownDocumentationSubsystem* Subsystem = GetSubsystem();
+
+		if( Subsystem == nullptr )
+		{
+			return {};
+		}
+
+		return Subsystem->GetDocumentationState( Asset );
+	}
+
+	static TOptional<EMarkdownDocumentationState> GetState( const FAssetData& AssetData )
+	{
+		return IsDocumentable( AssetData ) ? GetState( AssetData.GetSoftObjectPath() ) : TOptional<EMarkdownDocumentationState>();
+	}
+
+	static TSharedRef<SWidget> MakeIcon( const FAssetData& AssetData )
+	{
+		if( !IsDocumentable( AssetData ) )
+		{
+			return SNullWidget::NullWidget;
+		}
+
+		// tiles are made once and kept, so the state is looked at each time they are drawn, which the subsystem keeps
+		return SNew( SImage )
+			.Image_Lambda( [ Asset = AssetData.GetSoftObjectPath() ]()
+			{
+				const EMarkdownDocumentationState State = GetState( Asset ).Get( EMarkdownDocumentationState::Undocumented );
+				return State == EMarkdownDocumentationState::Stale ? FAppStyle::GetBrush( "Icons.Warning" ) : FAppStyle::GetBrush( "Icons.Documentation" );
+			})
+			.Visibility_Lambda( [ Asset = AssetData.GetSoftObjectPath() ]()
+			{
+				const EMarkdownDocumentationState State = GetState( Asset ).Get( EMarkdownDocumentationState::Undocumented );
+				return State != EMarkdownDocumentationState::Undocumented ? EVisibility::HitTestInvisible : EVisibility::Collapsed;
+			});
+	}
+
+	static TSharedRef<SWidget> MakeToolTip( const FAssetData& AssetData )
+	{
+		const UMarkdownDocumentationSubsystem* Subsystem = GetSubsystem();
+
+		if( Subsystem == nullptr || !IsDocumentable( AssetData ) )
+		{
+			return SNullWidget::NullWidget;
+		}
+
+		const FSoftObjectPath Asset = AssetData.GetSoftObjectPath();
+		const FSoftObjectPath Document = Subsystem->FindDocumentation( Asset );
+
+		if( !Document.IsValid() )
+		{
+			return SNullWidget::NullWidget;
+		}
+
+		const FText Text = Subsystem->GetDocumentationState( Asset ) == EMarkdownDocumentationState::Stale
+			? FText::Format( LOCTEXT( "StaleToolTip", "Documentation {0} is older than the asset" ), FText::FromString( Document.GetAssetName() ) )
+			: FText::Format( LOCTEXT( "CurrentToolTip", "Documentation {0}" ), FText::FromString( Document.GetAssetName() ) );
+
+		return SNew( STextBlock ).Text( Text );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+class FFrontendFilter_MarkdownDocumentation : public FFrontendFilter
+{
+public:
+
+	FFrontendFilter_MarkdownDocumentation( TSharedPtr<FFrontendFilterCategory> InCategory, const EMarkdownDocumentationState InState )
+		: FFrontendFilter( InCategory )
+		, State( InState )
+	{
+	}
+
+	virtual FString GetName() const override
+	{
+		switch( State )
+		{
+			case EMarkdownDocumentationState::Undocumented: return TEXT( "MarkdownUndocumented" );
+			case EMarkdownDocumentationState::Stale:        return TEXT( "MarkdownStaleDocumentation" );
+			default:                                        return TEXT( "MarkdownDocumented" );
+		}
+	}
+
+	virtual FText GetDisplayName() const override
+	{
+		switch( State )
+		{
+			case EMarkdownDocumentationState::Undocumented: return LOCTEXT( "UndocumentedName", "Undocumented" );
+			case EMarkdownDocumentationState::Stale:        return LOCTEXT( "StaleName", "Stale Documentation" );
+			default:                                        return LOCTEXT( "DocumentedName", "Documented" );
+		}
+	}
+
+	virtual FText GetToolTipText() const override
+	{
+		switch( State )
+		{
+			case EMarkdownDocumentationState::Undocumented: return LOCTEXT( "UndocumentedToolTip", "Assets no markdown asset is the documentation of" );
+			case EMarkdownDocumentationState::Stale:        return LOCTEXT( "StaleToolTipFilter", "Assets saved since their documentation was" );
+			default:                                        return LOCTEXT( "DocumentedToolTip", "Assets with documentation, stale or not" );
+		}
+	}
+
+	virtual bool PassesFilter( FAssetFilterType InItem ) const override
+	{
+		FAssetData AssetData;
+
+		if( !InItem.Legacy_TryGetAssetData( AssetData ) )
+		{
+			return false;
+		}
+
+		const TOptional<EMarkdownDocumentationState> ItemState = MarkdownDocumentationFilters::GetState( AssetData );
+
+		if( !ItemState.IsSet() )
+		{
+			return false;
+		}
+
+		// documented takes in the stale ones, they have documentation, it just needs looking at
+		return State == EMarkdownDocumentationState::Current ? *ItemState != EMarkdownDocumentationState::Undocumented : *ItemState == State;
+	}
+
+private:
+
+	EMarkdownDocumentationState State;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownDocumentationFilters::AddFrontEndFilterExtensions( TSharedPtr<FFrontendFilterCategory> DefaultCategory, TArray<TSharedRef<FFrontendFilter>>& InOutFilterList ) const
+{
+	TSharedPtr<FFrontendFilterCategory> Category = MakeShared<FFrontendFilterCategory>(
+		LOCTEXT( "CategoryName", "Documentation" ),
+		LOCTEXT( "CategoryToolTip", "Filter assets by their markdown documentation" ) );
+
+	InOutFilterList.Add( MakeShared<FFrontendFilter_MarkdownDocumentation>( Category, EMarkdownDocumentationState::Current ) );
+	InOutFilterList.Add( MakeShared<FFrontendFilter_MarkdownDocumentation>( Category, EMarkdownDocumentationState::Undocumented ) );
+	InOutFilterList.Add( MakeShared<FFrontendFilter_MarkdownDocumentation>( Category, EMarkdownDocumentationState::Stale ) );
+}
+
+void UMarkdownDocumentationFilters::RegisterStateIndicators()
+{
+	FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>( TEXT( "ContentBrowser" ) );
+
+	MarkdownDocumentationFilters::StateIndicatorsHandle = ContentBrowserModule.AddAssetViewExtraStateGenerator( FAssetViewExtraStateGenerator(
+		FOnGenerateAssetViewExtraStateIndicators::CreateStatic( &MarkdownDocumentationFilters::MakeIcon ),
+		FOnGenerateAssetViewExtraStateIndicators::CreateStatic( &MarkdownDocumentationFilters::MakeToolTip ) ) );
+}
+
+void UMarkdownDocumentationFilters::UnregisterStateIndicators()
+{
+	if( FContentBrowserModule* ContentBrowserModule = FModuleManager::GetModulePtr<FContentBrowserModule>( TEXT( "ContentBrowser" ) ) )
+	{
+		ContentBrowserModule->RemoveAssetViewExtraStateGenerator( MarkdownDocumentationFilters::StateIndicatorsHandle );
+	}
+
+	MarkdownDocumentationFilters::StateIndicatorsHandle.Reset();
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,28 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ContentBrowserFrontEndFilterExtension.h"
+
+#include "MarkdownDocumentationFilters.generated.h"
+
+/**
+ * Content browser filters for assets with documentation, without it, and with documentation older than the asset, in
+ * a Documentation category. They go by UMarkdownDocumentationSubsystem, so nothing is loaded however many assets the
+ * view has.
+ */
+UCLASS()
+class UMarkdownDocumentationFilters : public UContentBrowserFrontEndFilterExtension
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ UContentBrowserFrontEndFilterExtension interface
+	virtual void AddFrontEndFilterExtensions( TSharedPtr<FFrontendFilterCategory> DefaultCategory, TArray<TSharedRef<FFrontendFilter>>& InOutFilterList ) const override;
+
+	/** Marks the assets in the content browser that have documentation, and the ones whose documentation is stale. */
+	static void RegisterStateIndicators();
+	static void UnregisterStateIndicators();
+};
@@ -32,14 +32,14 @@ public:
 		return DefaultPrefix;
 	}
 
-	const FSoftObjectPath* GetMarkdownForAsset(const UObject* Asset) const
+	const TMap<FSoftObjectPath, FSoftObjectPath>& GetMarkdownFilesPerAssets() const
 	{
-		return MarkdownFilesPerAssets.Find(Asset);
+		return MarkdownFilesPerAssets;
 	}
 
-	void AddMarkdownAssetForFile(const FSoftObjectPath& Asset, const FSoftObjectPath& MarkdownAsset)
+	void ClearMarkdownFilesPerAssets()
 	{
-		MarkdownFilesPerAssets.Add(Asset, MarkdownAsset);
+		MarkdownFilesPerAssets.Empty();
 	}
 
 protected:
@@ -52,7 +52,9 @@ protected:
 	UPROPERTY(Config, EditDefaultsOnly, Category=AssetCreation )
 	TSoftObjectPtr<UMarkdownAsset> DocumentationMainFile;
 
-	UPROPERTY(Config, EditDefaultsOnly, Category=AssetCreation )
+	// The documentation of assets from before the markdown assets kept it themselves. Only read now, until it is moved
+	// to them with Markdown.MigrateDocumentationSettings (see UMarkdownDocumentationSubsystem).
+	UPROPERTY(Config, VisibleDefaultsOnly, Category=AssetCreation )
 	TMap<FSoftObjectPath, FSoftObjectPath> MarkdownFilesPerAssets;
 
 	UPROPERTY(Config, EditDefaultsOnly, Category=AssetCreation, meta=(InlineEditConditionToggle))
@@ -12,6 +12,7 @@
 #include "Shared/MarkdownAssetEditorSettings.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "LogChannels/MarkdownLogChannels.h"
+#include "Search/MarkdownDocumentationSubsystem.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
 #define LOCTEXT_NAMESPACE "FMarkdownAssetEditorStaticFunctions"
@@ -197,19 +198,25 @@ namespace MarkdownAssetStatics
 
 	static void OpenOrCreateMarkdownFileForAsset(const UObject* Asset)
 	{
-		UMarkdownAssetDeveloperSettings* ProjectSettings = GetMutableDefault<UMarkdownAssetDeveloperSettings>();
-		const FSoftObjectPath* MarkdownAsset = ProjectSettings->GetMarkdownForAsset(Asset);
+		UMarkdownDocumentationSubsystem* DocumentationSubsystem = GEditor->GetEditorSubsystem<UMarkdownDocumentationSubsystem>();
+		const FSoftObjectPath AssetPath(Asset);
+		const FSoftObjectPath MarkdownAsset = DocumentationSubsystem->FindDocumentation(AssetPath);
 		UObject* MarkdownAssetToOpen;
 		
-		if( MarkdownAsset && MarkdownAsset->IsValid() && FPackageName::DoesPackageExist(MarkdownAsset->ToString()) )
+		if( MarkdownAsset.IsValid() && FPackageName::DoesPackageExist(MarkdownAsset.ToString()) )
 		{
-			MarkdownAssetToOpen = MarkdownAsset->TryLoad();
+			MarkdownAssetToOpen = MarkdownAsset.TryLoad();
 		}
 		else
 		{
-			MarkdownAssetToOpen = CreateMarkdownAssetFileForAsset(Asset);
-			ProjectSettings->AddMarkdownAssetForFile(Asset, MarkdownAssetToOpen);
-			ProjectSettings->SaveConfig(CPF_Config, *ProjectSettings->GetDefaultConfigFilename());
+			UMarkdownAsset* NewMarkdownAsset = CreateMarkdownAssetFileForAsset(Asset);
+			MarkdownAssetToOpen = NewMarkdownAsset;
+
+			// The new document keeps the asset, and is saved with it when the user saves it.
+			if (NewMarkdownAsset)
+			{
+				DocumentationSubsystem->SetDocumentation(MakeArrayView(&AssetPath, 1), NewMarkdownAsset);
+			}
 			
 			const UMarkdownAssetEditorSettings* EditorSettings = GetDefault<UMarkdownAssetEditorSettings>();
 			if(!EditorSettings->ShouldOpenNewFiles())
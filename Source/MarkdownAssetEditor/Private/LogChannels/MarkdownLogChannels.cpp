@@ -2,4 +2,5 @@
 
 #include "MarkdownLogChannels.h"
 
-DEFINE_LOG_CATEGORY(MarkdownStaticsLog);
\ No newline at end of file
+DEFINE_LOG_CATEGORY(MarkdownStaticsLog);
+DEFINE_LOG_CATEGORY(MarkdownEditorLog);
\ No newline at end of file
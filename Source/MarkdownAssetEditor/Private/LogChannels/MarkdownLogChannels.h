@@ -2,4 +2,5 @@
 
 #pragma once
 
-MARKDOWNASSETEDITOR_API DECLARE_LOG_CATEGORY_EXTERN(MarkdownStaticsLog, Log, All)
\ No newline at end of file
+MARKDOWNASSETEDITOR_API DECLARE_LOG_CATEGORY_EXTERN(MarkdownStaticsLog, Log, All)
+MARKDOWNASSETEDITOR_API DECLARE_LOG_CATEGORY_EXTERN(MarkdownEditorLog, Log, All)
\ No newline at end of file
@@ -0,0 +1,21 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownAssetEditorCommands.h"
+
+#include "Styling/AppStyle.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownAssetEditorCommands"
+
+FMarkdownAssetEditorCommands::FMarkdownAssetEditorCommands()
+	: TCommands<FMarkdownAssetEditorCommands>( "MarkdownAssetEditor", LOCTEXT( "MarkdownAssetEditorCommands", "Markdown Asset" ), NAME_None, FAppStyle::GetAppStyleSetName() )
+{
+}
+
+void FMarkdownAssetEditorCommands::RegisterCommands()
+{
+	UI_COMMAND( QuickOpen, "Go to Documentation...", "Finds a document or heading by name and opens it.", EUserInterfaceActionType::Button, FInputChord( EModifierKey::Control | EModifierKey::Alt, EKeys::P ) );
+	UI_COMMAND( ValidateDocumentation, "Validate Documentation", "Checks every link in the project documentation and writes a report of the broken ones.", EUserInterfaceActionType::Button, FInputChord() );
+	UI_COMMAND( OpenCoverageReport, "Documentation Coverage", "Shows how much of each folder is documented and which assets have missing or out of date documentation.", EUserInterfaceActionType::Button, FInputChord() );
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Commands/Commands.h"
+
+class FMarkdownAssetEditorCommands : public TCommands<FMarkdownAssetEditorCommands>
+{
+public:
+
+	FMarkdownAssetEditorCommands();
+
+	virtual void RegisterCommands() override;
+
+	/** Goes to a document or heading by name. Ctrl+Alt+P, as Ctrl+P already opens assets. */
+	TSharedPtr<FUICommandInfo> QuickOpen;
+
+	/** Checks every link in the documentation and reports the broken ones, as the MarkdownValidate commandlet does. */
+	TSharedPtr<FUICommandInfo> ValidateDocumentation;
+
+	/** Opens the documentation coverage tab, the same report as the MarkdownCoverage commandlet. */
+	TSharedPtr<FUICommandInfo> OpenCoverageReport;
+};
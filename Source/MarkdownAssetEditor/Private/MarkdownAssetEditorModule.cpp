@@ -2,27 +2,54 @@
 
 #include "MarkdownAssetEditorModule.h"
 
+#include "Async/Async.h"
 #include "Containers/Array.h"
+#include "HAL/PlatformProcess.h"
+#include "Interfaces/IPluginManager.h"
 #include "ISettingsModule.h"
 #include "ISettingsSection.h"
 #include "Modules/ModuleInterface.h"
 #include "Modules/ModuleManager.h"
 #include "Templates/SharedPointer.h"
 #include "Toolkits/AssetEditorToolkit.h"
+#include "Framework/Commands/UICommandList.h"
+#include "LevelEditor.h"
 
+#include "MarkdownAssetEditorCommands.h"
 #include "MarkdownAssetEditorSettings.h"
 #include "ContentBrowser/MarkdownContentBrowserDataSource.h"
+#include "ContentBrowser/MarkdownDocumentationFilters.h"
 #include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
 #include "Toolkits/AssetEditorToolkitMenuContext.h"
 #include "HelperFunctions/MarkdownAssetEditorStatics.h"
 #include "Icons/Icons.h"
+#include "MarkdownAsset.h"
+#include "Tasks/Task.h"
+#include "Validation/MarkdownValidator.h"
+#include "Widgets/MarkdownBrowserPool.h"
+#include "Widgets/MarkdownRenderCache.h"
+#include "Widgets/MarkdownViewerContent.h"
+#include "Widgets/SMarkdownCoverageReport.h"
+#include "Widgets/SMarkdownQuickOpen.h"
+#include "Framework/Docking/TabManager.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "WorkspaceMenuStructure.h"
+#include "WorkspaceMenuStructureModule.h"
 
 #define LOCTEXT_NAMESPACE "FMarkdownAssetEditorModule"
 
 void FMarkdownAssetEditorModule::StartupModule()
 {
+	RegisterCommands();
+	RegisterTabs();
 	RegisterMenuExtensions();
 	RegisterSettings();
+	RegisterAssetIndexer();
+	UMarkdownDocumentationFilters::RegisterStateIndicators();
+	ViewerContent = MakeShared<FMarkdownViewerContent>();
+	ViewerContent->Load();
+	BrowserPool = MakeShared<FMarkdownBrowserPool>( ViewerContent.ToSharedRef() );
+	RenderCache = MakeShared<FMarkdownRenderCache>();
 	auto ContentBrowserSubsystem = GEditor->GetEditorSubsystem<UContentBrowserDataSubsystem>();
 	MarkdownDataSource.Reset(NewObject<UMarkdownContentBrowserDataSource>(GetTransientPackage(), "MarkdownData"));
 	MarkdownDataSource->Initialize();
@@ -33,7 +60,14 @@ void FMarkdownAssetEditorModule::ShutdownModule()
 {
 	UnregisterMenuExtensions();
 	UnregisterSettings();
+	UnregisterCommands();
+	UnregisterTabs();
+	UMarkdownDocumentationFilters::UnregisterStateIndicators();
 	MarkdownDataSource.Reset();
+	BrowserPool.Reset();
+	RenderCache.Reset();
+	ViewerContent->Unregister();
+	ViewerContent.Reset();
 }
 
 void FMarkdownAssetEditorModule::RegisterMenuExtensions()
@@ -54,6 +88,13 @@ void FMarkdownAssetEditorModule::RegisterMenuExtensions()
 
 	
 	
+	UToolMenu* ToolsMenu = UToolMenus::Get()->ExtendMenu("LevelEditor.MainMenu.Tools");
+
+	FToolMenuSection& ToolsDocumentationSection = ToolsMenu->FindOrAddSection("Documentation");
+	ToolsDocumentationSection.AddMenuEntryWithCommandList(FMarkdownAssetEditorCommands::Get().QuickOpen, CommandList);
+	ToolsDocumentationSection.AddMenuEntryWithCommandList(FMarkdownAssetEditorCommands::Get().ValidateDocumentation, CommandList);
+	ToolsDocumentationSection.AddMenuEntryWithCommandList(FMarkdownAssetEditorCommands::Get().OpenCoverageReport, CommandList);
+
 	UToolMenu* AssetEditorToolbar = UToolMenus::Get()->ExtendMenu("AssetEditorToolbar.CommonActions");
 	
 	FToolMenuSection& AssetEditorDocumentationSection = AssetEditorToolbar->FindOrAddSection("Documentation");
@@ -72,6 +113,66 @@ void FMarkdownAssetEditorModule::RegisterMenuExtensions()
 	}));
 }
 
+void FMarkdownAssetEditorModule::RegisterCommands()
+{
+	FMarkdownAssetEditorCommands::Register();
+
+	CommandList = MakeShared<FUICommandList>();
+	CommandList->MapAction(FMarkdownAssetEditorCommands::Get().QuickOpen, FExecuteAction::CreateStatic(&SMarkdownQuickOpen::Open));
+	CommandList->MapAction(FMarkdownAssetEditorCommands::Get().ValidateDocumentation,
+		FExecuteAction::CreateRaw(this, &FMarkdownAssetEditorModule::EditorAction_ValidateDocumentation),
+		FCanExecuteAction::CreateLambda([this]() { return !bValidatingDocumentation; }));
+	CommandList->MapAction(FMarkdownAssetEditorCommands::Get().OpenCoverageReport, FExecuteAction::CreateLambda([]()
+	{
+		FGlobalTabmanager::Get()->TryInvokeTab(SMarkdownCoverageReport::TabName);
+	}));
+
+	// the level editor's global actions are checked wherever the key is pressed, they only hold on to the list weakly
+	FLevelEditorModule& LevelEditorModule = FModuleManager::LoadModuleChecked<FLevelEditorModule>("LevelEditor");
+	LevelEditorModule.GetGlobalLevelEditorActions()->Append(CommandList.ToSharedRef());
+}
+
+void FMarkdownAssetEditorModule::UnregisterCommands()
+{
+	CommandList.Reset();
+	FMarkdownAssetEditorCommands::Unregister();
+}
+
+void FMarkdownAssetEditorModule::RegisterTabs()
+{
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(SMarkdownCoverageReport::TabName, FOnSpawnTab::CreateLambda([](const FSpawnTabArgs& Args)
+	{
+		TSharedRef<SMarkdownCoverageReport> CoverageReport = SNew(SMarkdownCoverageReport);
+		CoverageReport->Refresh();
+
+		return SNew(SDockTab)
+			.TabRole(ETabRole::NomadTab)
+			[
+				CoverageReport
+			];
+	}))
+	.SetDisplayName(LOCTEXT("MarkdownCoverageTabTitle", "Documentation Coverage"))
+	.SetTooltipText(LOCTEXT("MarkdownCoverageTabTooltip", "How much of each folder is documented, and the assets with missing or out of date documentation."))
+	.SetGroup(WorkspaceMenu::GetMenuStructure().GetToolsCategory())
+	.SetIcon(MarkdownIcons::DocumentationIcon);
+}
+
+void FMarkdownAssetEditorModule::UnregisterTabs()
+{
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(SMarkdownCoverageReport::TabName);
+}
+
+void FMarkdownAssetEditorModule::RegisterAssetIndexer()
+{
+	// the indexer links against the Asset Search plugin, which is beta, so it is only loaded if the project turned that on
+	const TSharedPtr<IPlugin> AssetSearchPlugin = IPluginManager::Get().FindPlugin(TEXT("AssetSearch"));
+
+	if (AssetSearchPlugin.IsValid() && AssetSearchPlugin->IsEnabled())
+	{
+		FModuleManager::Get().LoadModule(TEXT("MarkdownAssetSearch"));
+	}
+}
+
 void FMarkdownAssetEditorModule::RegisterSettings()
 {
 	ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>( "Settings" );
@@ -129,5 +230,61 @@ void FMarkdownAssetEditorModule::EditorAction_OpenAssetDocumentation(UAssetEdito
 	MarkdownAssetStatics::OpenOrCreateMarkdownFileForAsset(Object);
 }
 
+void FMarkdownAssetEditorModule::EditorAction_ValidateDocumentation()
+{
+	bValidatingDocumentation = true;
+
+	// the asset registry is read here, the files and links are checked on workers
+	TSharedRef<FMarkdownValidator> Validator = MakeShared<FMarkdownValidator>();
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Validator]()
+	{
+		TSharedRef<FMarkdownValidationReport> Report = MakeShared<FMarkdownValidationReport>();
+		Validator->Validate(*Report);
+
+		const FString Filename = FMarkdownValidationReport::GetDefaultFilename();
+		const bool bSaved = Report->Save(Filename);
+
+		AsyncTask(ENamedThreads::GameThread, [Report, Filename, bSaved]()
+		{
+			if (FMarkdownAssetEditorModule* Module = FModuleManager::GetModulePtr<FMarkdownAssetEditorModule>("MarkdownAssetEditor"))
+			{
+				Module->bValidatingDocumentation = false;
+			}
+
+			for (const FMarkdownLinkIssue& Issue : Report->Issues)
+			{
+				UE_LOG(MarkdownEditorLog, Warning, TEXT("%s(%d): %s %s"), *Issue.Document, Issue.Line, FMarkdownValidationReport::GetProblemName(Issue.Problem), *Issue.Destination);
+			}
+
+			for (const FString& Path : Report->Unchecked)
+			{
+				UE_LOG(MarkdownEditorLog, Display, TEXT("%s: not checked, saved without its links"), *Path);
+			}
+
+			FNotificationInfo Info(FText::Format(LOCTEXT("MarkdownValidateResult", "{0} broken links in {1} documents"), Report->Issues.Num(), Report->NumDocuments));
+			Info.SubText = FText::Format(LOCTEXT("MarkdownValidateDetail", "Checked {0} links in {1} seconds"), Report->NumLinks, FText::AsNumber(Report->Seconds));
+			Info.ExpireDuration = 8.0f;
+			Info.bUseSuccessFailIcons = true;
+
+			if (bSaved)
+			{
+				Info.Hyperlink = FSimpleDelegate::CreateLambda([Filename]()
+				{
+					FPlatformProcess::LaunchFileInDefaultExternalApplication(*Filename);
+				});
+				Info.HyperlinkText = LOCTEXT("MarkdownValidateOpenReport", "Open Report");
+			}
+
+			TSharedPtr<SNotificationItem> Notification = FSlateNotificationManager::Get().AddNotification(Info);
+
+			if (Notification.IsValid())
+			{
+				Notification->SetCompletionState(Report->Issues.IsEmpty() ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+			}
+		});
+	});
+}
+
 #undef LOCTEXT_NAMESPACE
 IMPLEMENT_MODULE( FMarkdownAssetEditorModule, MarkdownAssetEditor );
\ No newline at end of file
@@ -3,7 +3,12 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleInterface.h"
+#include "Modules/ModuleManager.h"
 
+class FMarkdownBrowserPool;
+class FMarkdownRenderCache;
+class FMarkdownViewerContent;
+class FUICommandList;
 class UMarkdownContentBrowserDataSource;
 class UAssetEditorToolkitMenuContext;
 
@@ -15,14 +20,48 @@ public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
 
+	static FMarkdownAssetEditorModule& Get()
+	{
+		return FModuleManager::GetModuleChecked<FMarkdownAssetEditorModule>( "MarkdownAssetEditor" );
+	}
+
+	/** Browsers with the viewer preloaded, shared by all open markdown editors. */
+	FMarkdownBrowserPool& GetBrowserPool() const
+	{
+		return *BrowserPool;
+	}
+
+	/** Rendered diagrams and code blocks, kept for the editor session. */
+	FMarkdownRenderCache& GetRenderCache() const
+	{
+		return *RenderCache;
+	}
+
+	/** The content browser view of the Documentation folder. */
+	UMarkdownContentBrowserDataSource* GetDataSource() const
+	{
+		return MarkdownDataSource.Get();
+	}
+
 protected:
 
 	/** Registers main menu and toolbar menu extensions. */
 	void RegisterMenuExtensions();
 
+	/** Binds the plugin's commands, active anywhere in the editor. */
+	void RegisterCommands();
+	void UnregisterCommands();
+
+	/** Registers the editor wide tabs, the coverage report. */
+	void RegisterTabs();
+	void UnregisterTabs();
+
 	/** Register the EditorSettings screen. */
 	void RegisterSettings();
 
+	/** Lets the Asset Search plugin index the text of markdown assets. It has no way to take an indexer back out. */
+	void RegisterAssetIndexer();
+
 	/** Unregister on mode shutdown */
 	void UnregisterMenuExtensions();
 	void UnregisterSettings();
@@ -30,6 +69,14 @@ protected:
 	void EditorAction_OpenProjectDocumentation();
 	void EditorAction_OpenAssetDocumentation(UAssetEditorToolkitMenuContext* ExecutionContext);
 
+	/** Validates the documentation on workers, then shows how it went and where the report is. */
+	void EditorAction_ValidateDocumentation();
+
 private:
 	TStrongObjectPtr<UMarkdownContentBrowserDataSource> MarkdownDataSource;
+	TSharedPtr<FMarkdownViewerContent> ViewerContent;
+	TSharedPtr<FMarkdownBrowserPool> BrowserPool;
+	TSharedPtr<FMarkdownRenderCache> RenderCache;
+	TSharedPtr<FUICommandList> CommandList;
+	bool bValidatingDocumentation = false;
 };
\ No newline at end of file
@@ -0,0 +1,502 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Search/MarkdownDocumentationSubsystem.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
+#include "Editor.h"
+#include "FileHelpers.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "UObject/Package.h"
+
+namespace MarkdownDocumentationSubsystem
+{
+	static FIoHash ParseHash( const FString& String )
+	{
+		FIoHash Hash;
+
+		if( String.Len() == sizeof( FIoHash::ByteArray ) * 2 )
+		{
+			HexToBytes( String, Hash.GetBytes() );
+		}
+
+		return Hash;
+	}
+
+	static FIoHash GetPackageHash( const FSoftObjectPath& Asset, const IAssetRegistry& AssetRegistry )
+	{
+		const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy( Asset.GetLongPackageFName() );
+		return PackageData.IsSet() ? PackageData->PackageSavedHash : FIoHash();
+	}
+
+	/** the assets the document has and their hashes, from its tags */
+	static void ReadDocument( const FAssetData& Document, TArray<TPair<FSoftObjectPath, FMarkdownDocumentation>>& OutAssets )
+	{
+		TArray<FString> Assets;
+		TArray<FString> Hashes;
+		UMarkdownAsset::GetDocumentedAssets( Document, Assets );
+		UMarkdownAsset::GetDocumentedAssetHashes( Document, Hashes );
+
+		OutAssets.Reset( Assets.Num() );
+
+		for( int32 Index = 0; Index < Assets.Num(); ++Index )
+		{
+			OutAssets.Emplace( FSoftObjectPath( Assets[ Index ] ), FMarkdownDocumentation{ Document.GetSoftObjectPath(), Hashes.IsValidIndex( Index ) ? ParseHash( Hashes[ Index ] ) : FIoHash() } );
+		}
+	}
+
+	static void Migrate()
+	{
+		UMarkdownDocumentationSubsystem* Subsystem = GEditor != nullptr ? GEditor->GetEditorSubsystem<UMarkdownDocumentationSubsystem>() : nullptr;
+
+		if( Subsystem == nullptr || !Subsystem->IsReady() )
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown.MigrateDocumentationSettings: the asset registry has not finished loading yet" ) );
+			return;
+		}
+
+		Subsystem->MigrateSettings();
+	}
+
+	// Markdown.MigrateDocumentationSettings
+	//
+	// moves the documentation of each asset from DefaultDocumentationSettings.ini to the documents
+	static FAutoConsoleCommand MigrateCommand(
+		TEXT( "Markdown.MigrateDocumentationSettings" ),
+		TEXT( "Moves the documentation of assets from the documentation settings to the markdown assets, and saves them" ),
+		FConsoleCommandDelegate::CreateStatic( &Migrate )
+	);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownDocumentation::IsStale( const FSoftObjectPath& Asset, const IAssetRegistry& AssetRegistry ) const
+{
+	// documents saved before they kept the hashes can't tell
+	if( AssetHash.IsZero() )
+	{
+		return false;
+	}
+
+	const FIoHash Current = MarkdownDocumentationSubsystem::GetPackageHash( Asset, AssetRegistry );
+	return !Current.IsZero() && Current != AssetHash;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownDocumentationSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	AssetRegistry.OnAssetAdded().AddUObject( this, &UMarkdownDocumentationSubsystem::HandleAssetAdded );
+	AssetRegistry.OnAssetUpdated().AddUObject( this, &UMarkdownDocumentationSubsystem::HandleAssetUpdated );
+	AssetRegistry.OnAssetRemoved().AddUObject( this, &UMarkdownDocumentationSubsystem::HandleAssetRemoved );
+	AssetRegistry.OnAssetRenamed().AddUObject( this, &UMarkdownDocumentationSubsystem::HandleAssetRenamed );
+
+	UPackage::PackageSavedWithContextEvent.AddUObject( this, &UMarkdownDocumentationSubsystem::HandlePackageSaved );
+
+	if( AssetRegistry.IsLoadingAssets() )
+	{
+		AssetRegistry.OnFilesLoaded().AddUObject( this, &UMarkdownDocumentationSubsystem::HandleFilesLoaded );
+	}
+	else
+	{
+		HandleFilesLoaded();
+	}
+}
+
+void UMarkdownDocumentationSubsystem::Deinitialize()
+{
+	if( IAssetRegistry* AssetRegistry = IAssetRegistry::Get() )
+	{
+		AssetRegistry->OnFilesLoaded().RemoveAll( this );
+		AssetRegistry->OnAssetAdded().RemoveAll( this );
+		AssetRegistry->OnAssetUpdated().RemoveAll( this );
+		AssetRegistry->OnAssetRemoved().RemoveAll( this );
+		AssetRegistry->OnAssetRenamed().RemoveAll( this );
+	}
+
+	UPackage::PackageSavedWithContextEvent.RemoveAll( this );
+
+	Documentation.Empty();
+	DocumentedAssets.Empty();
+	Stale.Empty();
+	bReady = false;
+
+	Super::Deinitialize();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FSoftObjectPath UMarkdownDocumentationSubsystem::FindDocumentation( const FSoftObjectPath& Asset ) const
+{
+	const FMarkdownDocumentation* Found = Documentation.Find( Asset );
+	return Found != nullptr ? Found->Document : FSoftObjectPath();
+}
+
+EMarkdownDocumentationState UMarkdownDocumentationSubsystem::GetDocumentationState( const FSoftObjectPath& Asset ) const
+{
+	const FMarkdownDocumentation* Found = Documentation.Find( Asset );
+
+	if( Found == nullptr )
+	{
+		return EMarkdownDocumentationState::Undocumented;
+	}
+
+	const bool* bFoundStale = Stale.Find( Asset );
+	const bool bStale = bFoundStale != nullptr ? *bFoundStale : Stale.Add( Asset, Found->IsStale( Asset, IAssetRegistry::GetChecked() ) );
+
+	return bStale ? EMarkdownDocumentationState::Stale : EMarkdownDocumentationState::Current;
+}
+
+TArray<FSoftObjectPath> UMarkdownDocumentationSubsystem::GetDocumentedAssets( const FSoftObjectPath& Document ) const
+{
+	const TArray<FSoftObjectPath>* Assets = DocumentedAssets.Find( Document );
+	return Assets != nullptr ? *Assets : TArray<FSoftObjectPath>();
+}
+
+void UMarkdownDocumentationSubsystem::SetDocumentation( TConstArrayView<FSoftObjectPath> Assets, UMarkdownAsset* Document )
+{
+	TArray<UPackage*> Changed;
+	SetDocumentation( Assets, Document, Changed );
+}
+
+void UMarkdownDocumentationSubsystem::SetDocumentation( TConstArrayView<FSoftObjectPath> Assets, UMarkdownAsset* Document, TArray<UPackage*>& OutChanged )
+{
+	check( Document != nullptr );
+
+	const FSoftObjectPath DocumentPath( Document );
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	bool bModified = false;
+
+	for( const FSoftObjectPath& Asset : Assets )
+	{
+		const FSoftObjectPath Previous = FindDocumentation( Asset );
+
+		if( Previous == DocumentPath && Document->GetDocumentedAssets().Contains( Asset ) )
+		{
+			continue;
+		}
+
+		// an asset only has the one document, the other has to give it up
+		if( Previous.IsValid() && Previous != DocumentPath )
+		{
+			if( UMarkdownAsset* PreviousDocument = Cast<UMarkdownAsset>( Previous.TryLoad() ) )
+			{
+				PreviousDocument->Modify();
+				PreviousDocument->RemoveDocumentedAsset( Asset );
+				OutChanged.AddUnique( PreviousDocument->GetPackage() );
+			}
+		}
+
+		if( !bModified )
+		{
+			Document->Modify();
+			bModified = true;
+		}
+
+		// documenting an asset is documenting it as it is now
+		Document->AddDocumentedAsset( Asset );
+		Associate( Asset, { DocumentPath, MarkdownDocumentationSubsystem::GetPackageHash( Asset, AssetRegistry ) } );
+	}
+
+	if( bModified )
+	{
+		OutChanged.AddUnique( Document->GetPackage() );
+	}
+}
+
+int32 UMarkdownDocumentationSubsystem::MigrateSettings()
+{
+	UMarkdownAssetDeveloperSettings* Settings = GetMutableDefault<UMarkdownAssetDeveloperSettings>();
+
+	if( Settings->GetMarkdownFilesPerAssets().IsEmpty() )
+	{
+		return 0;
+	}
+
+	const double Start = FPlatformTime::Seconds();
+
+	// each document is loaded and changed once for all of its assets
+	TMap<FSoftObjectPath, TArray<FSoftObjectPath>> AssetsByDocument;
+
+	for( const TPair<FSoftObjectPath, FSoftObjectPath>& Pair : Settings->GetMarkdownFilesPerAssets() )
+	{
+		AssetsByDocument.FindOrAdd( Pair.Value ).Add( Pair.Key );
+	}
+
+	TArray<UPackage*> Changed;
+	int32 NumMoved = 0;
+
+	for( const TPair<FSoftObjectPath, TArray<FSoftObjectPath>>& Pair : AssetsByDocument )
+	{
+		if( UMarkdownAsset* Document = Cast<UMarkdownAsset>( Pair.Key.TryLoad() ) )
+		{
+			SetDocumentation( Pair.Value, Document, Changed );
+			NumMoved += Pair.Value.Num();
+		}
+		else
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown documentation: %s is gone, dropping it as the documentation of %d assets" ), *Pair.Key.ToString(), Pair.Value.Num() );
+
+			for( const FSoftObjectPath& Asset : Pair.Value )
+			{
+				if( FindDocumentation( Asset ) == Pair.Key )
+				{
+					Associate( Asset, {} );
+				}
+			}
+		}
+	}
+
+	if( !Changed.IsEmpty() && !UEditorLoadingAndSavingUtils::SavePackages( Changed, true ) )
+	{
+		// the settings stay as they were, so nothing is lost and it can be run again
+		UE_LOG( MarkdownEditorLog, Error, TEXT( "Markdown documentation: could not save the documents, the documentation settings are unchanged" ) );
+		return 0;
+	}
+
+	Settings->ClearMarkdownFilesPerAssets();
+	Settings->SaveConfig( CPF_Config, *Settings->GetDefaultConfigFilename() );
+
+	UE_LOG( MarkdownEditorLog, Log, TEXT( "Markdown documentation: moved %d assets to %d documents in %.2f s" ), NumMoved, Changed.Num(), FPlatformTime::Seconds() - Start );
+
+	return NumMoved;
+}
+
+void UMarkdownDocumentationSubsystem::CollectDocumentation( TMap<FSoftObjectPath, FMarkdownDocumentation>& OutDocumentation )
+{
+	// the settings first, so the documents win when they disagree
+	for( const TPair<FSoftObjectPath, FSoftObjectPath>& Pair : GetDefault<UMarkdownAssetDeveloperSettings>()->GetMarkdownFilesPerAssets() )
+	{
+		OutDocumentation.Add( Pair.Key, { Pair.Value } );
+	}
+
+	TArray<FAssetData> Documents;
+	IAssetRegistry::GetChecked().GetAssetsByClass( UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true );
+
+	TArray<TPair<FSoftObjectPath, FMarkdownDocumentation>> Assets;
+
+	for( const FAssetData& Document : Documents )
+	{
+		MarkdownDocumentationSubsystem::ReadDocument( Document, Assets );
+
+		for( const TPair<FSoftObjectPath, FMarkdownDocumentation>& Asset : Assets )
+		{
+			OutDocumentation.Add( Asset.Key, Asset.Value );
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownDocumentationSubsystem::AddDocument( const FAssetData& AssetData )
+{
+	const FSoftObjectPath Document = AssetData.GetSoftObjectPath();
+
+	TArray<TPair<FSoftObjectPath, FMarkdownDocumentation>> Assets;
+	MarkdownDocumentationSubsystem::ReadDocument( AssetData, Assets );
+
+	// assets the document no longer has lose their documentation
+	if( const TArray<FSoftObjectPath>* Previous = DocumentedAssets.Find( Document ) )
+	{
+		for( const FSoftObjectPath& Asset : TArray<FSoftObjectPath>( *Previous ) )
+		{
+			const bool bKept = Assets.ContainsByPredicate( [ &Asset ]( const TPair<FSoftObjectPath, FMarkdownDocumentation>& Pair )
+			{
+				return Pair.Key == Asset;
+			});
+
+			if( !bKept && FindDocumentation( Asset ) == Document )
+			{
+				Associate( Asset, {} );
+			}
+		}
+	}
+
+	for( const TPair<FSoftObjectPath, FMarkdownDocumentation>& Asset : Assets )
+	{
+		Associate( Asset.Key, Asset.Value );
+	}
+}
+
+void UMarkdownDocumentationSubsystem::RemoveDocument( const FSoftObjectPath& Document )
+{
+	TArray<FSoftObjectPath> Assets;
+
+	if( !DocumentedAssets.RemoveAndCopyValue( Document, Assets ) )
+	{
+		return;
+	}
+
+	for( const FSoftObjectPath& Asset : Assets )
+	{
+		if( FindDocumentation( Asset ) == Document )
+		{
+			Associate( Asset, {} );
+		}
+	}
+}
+
+void UMarkdownDocumentationSubsystem::Associate( const FSoftObjectPath& Asset, const FMarkdownDocumentation& NewDocumentation )
+{
+	const FSoftObjectPath& Document = NewDocumentation.Document;
+	const FSoftObjectPath Previous = FindDocumentation( Asset );
+
+	// a new document, or the same one saved again, has a new hash to compare with
+	Stale.Remove( Asset );
+
+	if( Previous == Document )
+	{
+		// it may have come from the settings, and now the document has it too, or been saved again
+		if( Document.IsValid() )
+		{
+			Documentation.Add( Asset, NewDocumentation );
+			DocumentedAssets.FindOrAdd( Document ).AddUnique( Asset );
+		}
+
+		return;
+	}
+
+	if( TArray<FSoftObjectPath>* PreviousAssets = Previous.IsValid() ? DocumentedAssets.Find( Previous ) : nullptr )
+	{
+		PreviousAssets->Remove( Asset );
+
+		if( PreviousAssets->IsEmpty() )
+		{
+			DocumentedAssets.Remove( Previous );
+		}
+	}
+
+	if( Document.IsValid() )
+	{
+		Documentation.Add( Asset, NewDocumentation );
+		DocumentedAssets.FindOrAdd( Document ).AddUnique( Asset );
+	}
+	else
+	{
+		Documentation.Remove( Asset );
+	}
+
+	// everything is new on the first build, nobody needs telling about each one
+	if( bReady )
+	{
+		DocumentationChanged.Broadcast( Asset, Document );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownDocumentationSubsystem::HandleFilesLoaded()
+{
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	AssetRegistry.OnFilesLoaded().RemoveAll( this );
+
+	const double Start = FPlatformTime::Seconds();
+
+	TArray<FAssetData> Documents;
+	AssetRegistry.GetAssetsByClass( UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true );
+
+	for( const FAssetData& Document : Documents )
+	{
+		AddDocument( Document );
+	}
+
+	// from before documents kept their assets, only in the lookup so a document being saved does not drop them
+	const TMap<FSoftObjectPath, FSoftObjectPath>& Settings = GetDefault<UMarkdownAssetDeveloperSettings>()->GetMarkdownFilesPerAssets();
+
+	for( const TPair<FSoftObjectPath, FSoftObjectPath>& Pair : Settings )
+	{
+		if( !Documentation.Contains( Pair.Key ) )
+		{
+			Documentation.Add( Pair.Key, { Pair.Value } );
+		}
+	}
+
+	bReady = true;
+
+	UE_LOG( MarkdownEditorLog, Log, TEXT( "Markdown documentation: %d documented assets in %d documents, %.1f KB in %.3f s" ),
+		Documentation.Num(), DocumentedAssets.Num(), ( Documentation.GetAllocatedSize() + DocumentedAssets.GetAllocatedSize() ) / 1024.0, FPlatformTime::Seconds() - Start );
+
+	if( !Settings.IsEmpty() )
+	{
+		UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown documentation: %d assets still have their documentation in the documentation settings, run Markdown.MigrateDocumentationSettings to move it to the documents" ), Settings.Num() );
+	}
+}
+
+void UMarkdownDocumentationSubsystem::HandleAssetAdded( const FAssetData& AssetData )
+{
+	// the first scan adds everything, that is all read at once when it finishes
+	if( bReady && AssetData.IsInstanceOf( UMarkdownAsset::StaticClass() ) )
+	{
+		AddDocument( AssetData );
+	}
+}
+
+void UMarkdownDocumentationSubsystem::HandleAssetUpdated( const FAssetData& AssetData )
+{
+	HandleAssetAdded( AssetData );
+
+	// the registry has the asset's package as it was saved now
+	Stale.Remove( AssetData.GetSoftObjectPath() );
+}
+
+void UMarkdownDocumentationSubsystem::HandleAssetRemoved( const FAssetData& AssetData )
+{
+	Stale.Remove( AssetData.GetSoftObjectPath() );
+
+	if( bReady && AssetData.IsInstanceOf( UMarkdownAsset::StaticClass() ) )
+	{
+		RemoveDocument( AssetData.GetSoftObjectPath() );
+	}
+}
+
+void UMarkdownDocumentationSubsystem::HandleAssetRenamed( const FAssetData& AssetData, const FString& OldObjectPath )
+{
+	if( !bReady )
+	{
+		return;
+	}
+
+	if( AssetData.IsInstanceOf( UMarkdownAsset::StaticClass() ) )
+	{
+		RemoveDocument( FSoftObjectPath( OldObjectPath ) );
+		AddDocument( AssetData );
+		return;
+	}
+
+	// the document has the old path until it is saved with the references to the asset fixed up
+	const FSoftObjectPath OldPath( OldObjectPath );
+	Stale.Remove( OldPath );
+
+	if( const FMarkdownDocumentation* Found = Documentation.Find( OldPath ) )
+	{
+		const FMarkdownDocumentation Moved = *Found;
+		Associate( OldPath, {} );
+		Associate( AssetData.GetSoftObjectPath(), Moved );
+	}
+}
+
+void UMarkdownDocumentationSubsystem::HandlePackageSaved( const FString& Filename, UPackage* Package, FObjectPostSaveContext SaveContext )
+{
+	if( Package == nullptr || Stale.IsEmpty() )
+	{
+		return;
+	}
+
+	// the asset registry may not have the new hash yet, what is asked for before then is dropped again as it does
+	const FName PackageName = Package->GetFName();
+
+	for( auto It = Stale.CreateIterator(); It; ++It )
+	{
+		if( It->Key.GetLongPackageFName() == PackageName )
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
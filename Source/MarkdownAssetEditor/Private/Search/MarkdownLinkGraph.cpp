@@ -0,0 +1,154 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Search/MarkdownLinkGraph.h"
+
+#include "Misc/Paths.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLinkGraph::SetLinks( const FString& Source, TConstArrayView<FMarkdownLinkEdge> Links )
+{
+	const int32* ExistingId = NodeIds.Find( Source );
+
+	if( ExistingId == nullptr && Links.IsEmpty() )
+	{
+		return;
+	}
+
+	const int32 SourceId = ExistingId != nullptr ? *ExistingId : FindOrAddNode( Source );
+
+	// the old links come out of the backlinks of what they went to, so this is as slow as those have links
+	TArray<FEdge> OldLinks = MoveTemp( Nodes[ SourceId ].Links );
+	Nodes[ SourceId ].Links.Reset();
+
+	for( const FEdge& Link : OldLinks )
+	{
+		Nodes[ Link.Node ].Backlinks.RemoveSingleSwap( FEdge{ SourceId, Link.Kind } );
+	}
+
+	NumEdges -= OldLinks.Num();
+
+	TSet<FEdge> Added;
+	Added.Reserve( Links.Num() );
+
+	for( const FMarkdownLinkEdge& Link : Links )
+	{
+		if( Link.Path.IsEmpty() || Link.Path.Equals( Source ) )
+		{
+			continue;
+		}
+
+		// adding the target can move the nodes, so nothing holds on to one across it
+		const FEdge Edge{ FindOrAddNode( Link.Path ), Link.Kind };
+
+		bool bAlreadyAdded = false;
+		Added.Add( Edge, &bAlreadyAdded );
+
+		if( !bAlreadyAdded )
+		{
+			Nodes[ SourceId ].Links.Add( Edge );
+			Nodes[ Edge.Node ].Backlinks.Add( FEdge{ SourceId, Link.Kind } );
+			++NumEdges;
+		}
+	}
+
+	for( const FEdge& Link : OldLinks )
+	{
+		ReleaseNode( Link.Node );
+	}
+
+	ReleaseNode( SourceId );
+}
+
+void FMarkdownLinkGraph::GetLinks( const FString& Path, TArray<FMarkdownLinkEdge>& OutLinks ) const
+{
+	OutLinks.Reset();
+
+	if( const int32* Id = NodeIds.Find( Path ) )
+	{
+		for( const FEdge& Link : Nodes[ *Id ].Links )
+		{
+			OutLinks.Add( { Nodes[ Link.Node ].Path, Link.Kind } );
+		}
+	}
+}
+
+void FMarkdownLinkGraph::GetBacklinks( const FString& Path, TArray<FMarkdownLinkEdge>& OutBacklinks ) const
+{
+	OutBacklinks.Reset();
+
+	if( const int32* Id = NodeIds.Find( Path ) )
+	{
+		for( const FEdge& Backlink : Nodes[ *Id ].Backlinks )
+		{
+			OutBacklinks.Add( { Nodes[ Backlink.Node ].Path, Backlink.Kind } );
+		}
+	}
+}
+
+SIZE_T FMarkdownLinkGraph::GetAllocatedSize() const
+{
+	SIZE_T Size = Nodes.GetAllocatedSize() + FreeIds.GetAllocatedSize() + NodeIds.GetAllocatedSize();
+
+	for( const FNode& Node : Nodes )
+	{
+		Size += Node.Path.GetAllocatedSize() + Node.Links.GetAllocatedSize() + Node.Backlinks.GetAllocatedSize();
+	}
+
+	for( const TPair<FString, int32>& Id : NodeIds )
+	{
+		Size += Id.Key.GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+FString FMarkdownLinkGraph::ResolvePath( const FString& Source, const FString& Target )
+{
+	if( Target.StartsWith( TEXT( "/" ) ) )
+	{
+		return Target;
+	}
+
+	// assets have no folder of their own in the documentation
+	const FString Folder = Source.EndsWith( TEXT( ".md" ) ) ? FPaths::GetPath( Source ) : FString( TEXT( "/Documentation" ) );
+	FString Path = Folder / Target;
+
+	if( !FPaths::CollapseRelativeDirectories( Path ) || !Path.StartsWith( TEXT( "/Documentation/" ) ) )
+	{
+		return FString();
+	}
+
+	return Path;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+int32 FMarkdownLinkGraph::FindOrAddNode( const FString& Path )
+{
+	if( const int32* Id = NodeIds.Find( Path ) )
+	{
+		return *Id;
+	}
+
+	const int32 Id = FreeIds.IsEmpty() ? Nodes.AddDefaulted() : FreeIds.Pop();
+	Nodes[ Id ].Path = Path;
+	NodeIds.Add( Path, Id );
+
+	return Id;
+}
+
+void FMarkdownLinkGraph::ReleaseNode( const int32 Id )
+{
+	FNode& Node = Nodes[ Id ];
+
+	// already gone, when it was linked to more than one way
+	if( Node.Path.IsEmpty() || !Node.Links.IsEmpty() || !Node.Backlinks.IsEmpty() )
+	{
+		return;
+	}
+
+	NodeIds.Remove( Node.Path );
+	Node = FNode();
+	FreeIds.Add( Id );
+}
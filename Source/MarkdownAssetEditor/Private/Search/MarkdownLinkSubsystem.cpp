@@ -0,0 +1,593 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Search/MarkdownLinkSubsystem.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/Async.h"
+#include "Async/MarkdownAsyncLoader.h"
+#include "Async/ParallelFor.h"
+#include "ContentBrowser/MarkdownContentBrowserHierarchy.h"
+#include "DirectoryWatcherModule.h"
+#include "Editor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "IDirectoryWatcher.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetEditorSettings.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "Parser/MarkdownLinks.h"
+#include "Parser/MarkdownParser.h"
+#include "Search/MarkdownDocumentationSubsystem.h"
+#include "Tasks/Task.h"
+#include "UObject/UObjectHash.h"
+
+#include <atomic>
+
+/** The links of a document or asset, as written. */
+struct FMarkdownLinkSource
+{
+	FString Path;
+	TArray<FString> Destinations;
+	TArray<FMarkdownLinkEdge> Edges;
+};
+
+/** A build or update of the graph. */
+struct FMarkdownLinkJob
+{
+	/** read by the workers */
+	std::atomic<bool> bCancelled = false;
+
+	/** everything from scratch, rather than changes to the current graph */
+	bool bRebuild = false;
+
+	/** markdown assets saved before their links were in the asset registry */
+	TArray<FSoftObjectPath> Assets;
+	TSharedPtr<FMarkdownLoadRequest> Request;
+
+	TArray<FMarkdownLinkSource> Sources;
+
+	/** .md files to read on the workers */
+	TArray<FString> Files;
+
+	/** documents and assets to drop the links of */
+	TArray<FString> Removed;
+
+	/** the links of each source, resolved on the workers */
+	TArray<TArray<FMarkdownLinkEdge>> Links;
+
+	/** the new graph, for a rebuild */
+	FMarkdownLinkGraph Graph;
+
+	double Seconds = 0.0;
+};
+
+namespace MarkdownLinkSubsystem
+{
+	static bool IsFile( const FString& Path )
+	{
+		return Path.EndsWith( TEXT( ".md" ) );
+	}
+
+	static void GetDestinations( const FMarkdownDocument& Document, TArray<FString>& OutDestinations )
+	{
+		TArray<FMarkdownLink> Links;
+		FMarkdownLinks::Collect( Document, Links );
+
+		for( const FMarkdownLink& Link : Links )
+		{
+			if( Link.Type != EMarkdownLinkType::External )
+			{
+				OutDestinations.Add( Link.Destination );
+			}
+		}
+	}
+
+	static void ReadFiles( const TArray<FString>& Files, TArray<FMarkdownLinkSource>& OutSources, TArray<FString>& OutRemoved )
+	{
+		const int32 First = OutSources.Num();
+		OutSources.SetNum( First + Files.Num() );
+
+		ParallelFor( Files.Num(), [ & ]( const int32 Index )
+		{
+			FString Text;
+
+			if( FFileHelper::LoadFileToString( Text, *FMarkdownContentBrowserHierarchy::ConvertInternalPathToFileSystemPath( Files[ Index ] ) ) )
+			{
+				FMarkdownDocument Document;
+				FMarkdownParser::Parse( Text, Document );
+
+				FMarkdownLinkSource& Source = OutSources[ First + Index ];
+				Source.Path = Files[ Index ];
+				GetDestinations( Document, Source.Destinations );
+			}
+		});
+
+		// files that could not be read have gone since they were found
+		for( int32 Index = 0; Index < Files.Num(); ++Index )
+		{
+			if( OutSources[ First + Index ].Path.IsEmpty() )
+			{
+				OutRemoved.Add( Files[ Index ] );
+			}
+		}
+
+		OutSources.RemoveAll( []( const FMarkdownLinkSource& Source )
+		{
+			return Source.Path.IsEmpty();
+		});
+	}
+
+	static void ResolveLinks( const FMarkdownLinkSource& Source, const IAssetRegistry& AssetRegistry, TArray<FMarkdownLinkEdge>& OutLinks )
+	{
+		OutLinks = Source.Edges;
+
+		for( const FString& Destination : Source.Destinations )
+		{
+			const FMarkdownLink Link = FMarkdownLinks::Classify( Destination );
+
+			if( Link.Type == EMarkdownLinkType::Document )
+			{
+				OutLinks.Add( { FMarkdownLinkGraph::ResolvePath( Source.Path, Link.Target ), EMarkdownLinkKind::DocumentToDocument } );
+			}
+			else if( Link.Type == EMarkdownLinkType::Asset )
+			{
+				// only what is on disk, so this can run on the workers, assets that were never saved count as assets
+				const FSoftObjectPath Path( Link.Target );
+				const FAssetData AssetData = Path.IsValid() ? AssetRegistry.GetAssetByObjectPath( Path, true ) : FAssetData();
+				const bool bDocument = AssetData.IsValid() && AssetData.AssetClassPath == UMarkdownAsset::StaticClass()->GetClassPathName();
+
+				OutLinks.Add( { Path.IsValid() ? Path.ToString() : Link.Target, bDocument ? EMarkdownLinkKind::DocumentToDocument : EMarkdownLinkKind::DocumentToAsset } );
+			}
+		}
+	}
+
+	static void PrintLinks( const TArray<FString>& Args )
+	{
+		UMarkdownLinkSubsystem* Subsystem = GEditor != nullptr ? GEditor->GetEditorSubsystem<UMarkdownLinkSubsystem>() : nullptr;
+
+		if( Subsystem == nullptr || !Subsystem->IsGraphReady() || Args.IsEmpty() )
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown.Links: the graph is not ready yet, or no path was given" ) );
+			return;
+		}
+
+		const FString Path = FString::Join( Args, TEXT( " " ) );
+		const UEnum* Kinds = StaticEnum<EMarkdownLinkKind>();
+
+		for( const FMarkdownLinkEdge& Link : Subsystem->GetLinks( Path ) )
+		{
+			UE_LOG( MarkdownEditorLog, Display, TEXT( "  -> %s (%s)" ), *Link.Path, *Kinds->GetNameStringByValue( int64( Link.Kind ) ) );
+		}
+
+		for( const FMarkdownLinkEdge& Backlink : Subsystem->GetBacklinks( Path ) )
+		{
+			UE_LOG( MarkdownEditorLog, Display, TEXT( "  <- %s (%s)" ), *Backlink.Path, *Kinds->GetNameStringByValue( int64( Backlink.Kind ) ) );
+		}
+	}
+
+	// Markdown.Links <Path>
+	//
+	// logs what a document or asset links to and what links to it
+	static FAutoConsoleCommand LinksCommand(
+		TEXT( "Markdown.Links" ),
+		TEXT( "Markdown.Links <Path> - logs the links and backlinks of a .md file (/Documentation/...) or an object" ),
+		FConsoleCommandWithArgsDelegate::CreateStatic( &PrintLinks )
+	);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownLinkSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	if( IsRunningCommandlet() || !GetDefault<UMarkdownAssetEditorSettings>()->ShouldIndexDocumentation() )
+	{
+		return;
+	}
+
+	Collection.InitializeDependency<UMarkdownDocumentationSubsystem>()->OnDocumentationChanged().AddUObject( this, &UMarkdownLinkSubsystem::HandleDocumentationChanged );
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	AssetRegistry.OnAssetRemoved().AddUObject( this, &UMarkdownLinkSubsystem::HandleAssetRemoved );
+	AssetRegistry.OnAssetRenamed().AddUObject( this, &UMarkdownLinkSubsystem::HandleAssetRenamed );
+
+	UPackage::PackageSavedWithContextEvent.AddUObject( this, &UMarkdownLinkSubsystem::HandlePackageSaved );
+
+	WatchedDirectory = FPaths::ConvertRelativePathToFull( FPaths::ProjectDir() / TEXT( "Documentation" ) );
+
+	if( IDirectoryWatcher* DirectoryWatcher = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>( TEXT( "DirectoryWatcher" ) ).Get() )
+	{
+		DirectoryWatcher->RegisterDirectoryChangedCallback_Handle( WatchedDirectory,
+			IDirectoryWatcher::FDirectoryChanged::CreateUObject( this, &UMarkdownLinkSubsystem::HandleDirectoryChanged ), DirectoryChangedHandle );
+	}
+
+	if( AssetRegistry.IsLoadingAssets() )
+	{
+		AssetRegistry.OnFilesLoaded().AddUObject( this, &UMarkdownLinkSubsystem::HandleFilesLoaded );
+	}
+	else
+	{
+		HandleFilesLoaded();
+	}
+}
+
+void UMarkdownLinkSubsystem::Deinitialize()
+{
+	CancelJob();
+
+	if( IAssetRegistry* AssetRegistry = IAssetRegistry::Get() )
+	{
+		AssetRegistry->OnFilesLoaded().RemoveAll( this );
+		AssetRegistry->OnAssetRemoved().RemoveAll( this );
+		AssetRegistry->OnAssetRenamed().RemoveAll( this );
+	}
+
+	UPackage::PackageSavedWithContextEvent.RemoveAll( this );
+
+	if( UMarkdownDocumentationSubsystem* DocumentationSubsystem = GEditor != nullptr ? GEditor->GetEditorSubsystem<UMarkdownDocumentationSubsystem>() : nullptr )
+	{
+		DocumentationSubsystem->OnDocumentationChanged().RemoveAll( this );
+	}
+
+	if( DirectoryChangedHandle.IsValid() )
+	{
+		if( FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>( TEXT( "DirectoryWatcher" ) ) )
+		{
+			DirectoryWatcherModule->Get()->UnregisterDirectoryChangedCallback_Handle( WatchedDirectory, DirectoryChangedHandle );
+		}
+
+		DirectoryChangedHandle.Reset();
+	}
+
+	Graph = FMarkdownLinkGraph();
+	bGraphReady = false;
+	PendingChanges.Empty();
+
+	Super::Deinitialize();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TArray<FMarkdownLinkEdge> UMarkdownLinkSubsystem::GetLinks( const FString& Path ) const
+{
+	TArray<FMarkdownLinkEdge> Links;
+	Graph.GetLinks( Path, Links );
+	return Links;
+}
+
+TArray<FMarkdownLinkEdge> UMarkdownLinkSubsystem::GetBacklinks( const FString& Path ) const
+{
+	TArray<FMarkdownLinkEdge> Backlinks;
+	Graph.GetBacklinks( Path, Backlinks );
+	return Backlinks;
+}
+
+void UMarkdownLinkSubsystem::RebuildGraph()
+{
+	CancelJob();
+
+	// everything is read again, so the build has any earlier changes in it already
+	PendingChanges.Empty();
+
+	TSharedRef<FMarkdownLinkJob> NewJob = MakeShared<FMarkdownLinkJob>();
+	NewJob->bRebuild = true;
+
+	TArray<FAssetData> Assets;
+	IAssetRegistry::GetChecked().GetAssetsByClass( UMarkdownAsset::StaticClass()->GetClassPathName(), Assets, true );
+
+	// the links saved with the asset are enough, only ones saved before they were have to be loaded
+	for( const FAssetData& Asset : Assets )
+	{
+		FMarkdownLinkSource Source;
+		Source.Path = Asset.GetObjectPathString();
+
+		if( UMarkdownAsset::GetLinks( Asset, Source.Destinations ) )
+		{
+			NewJob->Sources.Add( MoveTemp( Source ) );
+		}
+		else
+		{
+			NewJob->Assets.Add( Asset.GetSoftObjectPath() );
+		}
+	}
+
+	// read here rather than from the documentation subsystem, which may not have finished its own first build
+	TMap<FSoftObjectPath, FMarkdownDocumentation> AllDocumentation;
+	UMarkdownDocumentationSubsystem::CollectDocumentation( AllDocumentation );
+
+	for( const TPair<FSoftObjectPath, FMarkdownDocumentation>& Documentation : AllDocumentation )
+	{
+		NewJob->Sources.Add( { Documentation.Key.ToString(), {}, { { Documentation.Value.Document.ToString(), EMarkdownLinkKind::AssetToDocument } } } );
+	}
+
+	Job = NewJob;
+
+	if( NewJob->Assets.IsEmpty() )
+	{
+		BuildGraph( NewJob );
+		return;
+	}
+
+	UE_LOG( MarkdownEditorLog, Log, TEXT( "Markdown links: loading %d markdown assets saved without their links, saving them again saves the load" ), NewJob->Assets.Num() );
+
+	NewJob->Request = FMarkdownAsyncLoader::Load( NewJob->Assets, FOnMarkdownLoaded::CreateUObject( this, &UMarkdownLinkSubsystem::HandleAssetsLoaded, NewJob ) );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownLinkSubsystem::HandleAssetsLoaded( const TArray<UMarkdownAsset*>& Assets, TSharedRef<FMarkdownLinkJob> InJob )
+{
+	if( InJob->bCancelled )
+	{
+		return;
+	}
+
+	// the loader parsed them already
+	for( int32 AssetIndex = 0; AssetIndex < Assets.Num(); ++AssetIndex )
+	{
+		if( const UMarkdownAsset* Asset = Assets[ AssetIndex ] )
+		{
+			FMarkdownLinkSource& Source = InJob->Sources.AddDefaulted_GetRef();
+			Source.Path = InJob->Assets[ AssetIndex ].ToString();
+			MarkdownLinkSubsystem::GetDestinations( *Asset->GetDocument(), Source.Destinations );
+		}
+	}
+
+	// nothing else needs them, they can go at the next garbage collection
+	InJob->Request.Reset();
+
+	BuildGraph( InJob );
+}
+
+void UMarkdownLinkSubsystem::BuildGraph( const TSharedRef<FMarkdownLinkJob>& InJob )
+{
+	TWeakObjectPtr<UMarkdownLinkSubsystem> WeakThis( this );
+
+	UE::Tasks::Launch( UE_SOURCE_LOCATION, [ WeakThis, InJob ]()
+	{
+		using namespace MarkdownLinkSubsystem;
+
+		const double Start = FPlatformTime::Seconds();
+
+		if( InJob->bRebuild )
+		{
+			FMarkdownContentBrowserHierarchy::FindMDFiles( InJob->Files );
+		}
+
+		ReadFiles( InJob->Files, InJob->Sources, InJob->Removed );
+
+		if( InJob->bCancelled )
+		{
+			return;
+		}
+
+		const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+		InJob->Links.SetNum( InJob->Sources.Num() );
+
+		ParallelFor( InJob->Sources.Num(), [ &InJob, &AssetRegistry ]( const int32 Index )
+		{
+			ResolveLinks( InJob->Sources[ Index ], AssetRegistry, InJob->Links[ Index ] );
+		});
+
+		// a new graph is made here, updates are small enough to go straight into the current one
+		if( InJob->bRebuild )
+		{
+			for( int32 Index = 0; Index < InJob->Sources.Num(); ++Index )
+			{
+				InJob->Graph.SetLinks( InJob->Sources[ Index ].Path, InJob->Links[ Index ] );
+			}
+		}
+
+		InJob->Seconds = FPlatformTime::Seconds() - Start;
+
+		AsyncTask( ENamedThreads::GameThread, [ WeakThis, InJob ]()
+		{
+			if( UMarkdownLinkSubsystem* This = WeakThis.Get() )
+			{
+				This->SetGraph( InJob );
+			}
+		});
+	});
+}
+
+void UMarkdownLinkSubsystem::SetGraph( const TSharedRef<FMarkdownLinkJob>& InJob )
+{
+	if( InJob->bCancelled || Job.Get() != &InJob.Get() )
+	{
+		return;
+	}
+
+	Job.Reset();
+
+	if( InJob->bRebuild )
+	{
+		Graph = MoveTemp( InJob->Graph );
+		bGraphReady = true;
+
+		UE_LOG( MarkdownEditorLog, Log, TEXT( "Markdown links: %d links between %d documents and assets, %.1f KB in %.2f s" ),
+			Graph.NumLinks(), Graph.NumNodes(), Graph.GetAllocatedSize() / 1024.0, InJob->Seconds );
+	}
+	else
+	{
+		for( const FString& Path : InJob->Removed )
+		{
+			Graph.RemoveLinks( Path );
+		}
+
+		for( int32 Index = 0; Index < InJob->Sources.Num(); ++Index )
+		{
+			Graph.SetLinks( InJob->Sources[ Index ].Path, InJob->Links[ Index ] );
+		}
+	}
+
+	GraphChanged.Broadcast();
+
+	UpdateGraph();
+}
+
+void UMarkdownLinkSubsystem::UpdateGraph()
+{
+	// changes wait for the job that is running, and until the first build they would be found by that anyway
+	if( Job.IsValid() || !bGraphReady || PendingChanges.IsEmpty() )
+	{
+		return;
+	}
+
+	TSharedRef<FMarkdownLinkJob> NewJob = MakeShared<FMarkdownLinkJob>();
+
+	for( TPair<FString, FMarkdownLinkChange>& Change : PendingChanges )
+	{
+		if( Change.Value.bRemoved )
+		{
+			NewJob->Removed.Add( Change.Key );
+		}
+		else if( MarkdownLinkSubsystem::IsFile( Change.Key ) && Change.Value.Edges.IsEmpty() )
+		{
+			NewJob->Files.Add( Change.Key );
+		}
+		else
+		{
+			NewJob->Sources.Add( { Change.Key, MoveTemp( Change.Value.Destinations ), MoveTemp( Change.Value.Edges ) } );
+		}
+	}
+
+	PendingChanges.Empty();
+
+	Job = NewJob;
+	BuildGraph( NewJob );
+}
+
+void UMarkdownLinkSubsystem::CancelJob()
+{
+	if( !Job.IsValid() )
+	{
+		return;
+	}
+
+	Job->bCancelled = true;
+
+	if( Job->Request.IsValid() )
+	{
+		Job->Request->Cancel();
+		Job->Request.Reset();
+	}
+
+	Job.Reset();
+}
+
+void UMarkdownLinkSubsystem::QueueChange( const FString& Path, FMarkdownLinkChange&& Change )
+{
+	PendingChanges.Add( Path, MoveTemp( Change ) );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownLinkSubsystem::HandleFilesLoaded()
+{
+	IAssetRegistry::GetChecked().OnFilesLoaded().RemoveAll( this );
+	RebuildGraph();
+}
+
+void UMarkdownLinkSubsystem::HandleDocumentationChanged( const FSoftObjectPath& Asset, const FSoftObjectPath& Document )
+{
+	if( Document.IsValid() )
+	{
+		QueueChange( Asset.ToString(), { false, {}, { { Document.ToString(), EMarkdownLinkKind::AssetToDocument } } } );
+	}
+	else
+	{
+		QueueChange( Asset.ToString(), { true } );
+	}
+
+	UpdateGraph();
+}
+
+void UMarkdownLinkSubsystem::HandleAssetRemoved( const FAssetData& AssetData )
+{
+	// documents lose their links, assets their documentation, links to either stay to show where they were
+	const FString Path = AssetData.GetObjectPathString();
+
+	if( AssetData.IsInstanceOf( UMarkdownAsset::StaticClass() ) || Graph.HasLinks( Path ) )
+	{
+		QueueChange( Path, { true } );
+		UpdateGraph();
+	}
+}
+
+void UMarkdownLinkSubsystem::HandleAssetRenamed( const FAssetData& AssetData, const FString& OldObjectPath )
+{
+	if( AssetData.IsInstanceOf( UMarkdownAsset::StaticClass() ) )
+	{
+		QueueChange( OldObjectPath, { true } );
+
+		// renamed assets are loaded, otherwise it will be read when it is saved under the new name
+		if( const UMarkdownAsset* Asset = Cast<UMarkdownAsset>( AssetData.FastGetAsset( false ) ) )
+		{
+			FMarkdownLinkChange Change;
+			MarkdownLinkSubsystem::GetDestinations( *Asset->GetDocument(), Change.Destinations );
+			QueueChange( AssetData.GetObjectPathString(), MoveTemp( Change ) );
+		}
+	}
+	else if( Graph.HasLinks( OldObjectPath ) )
+	{
+		// the documentation goes with the asset, links to it from documents are to the redirector until they are fixed
+		FMarkdownLinkChange Change;
+		Graph.GetLinks( OldObjectPath, Change.Edges );
+
+		QueueChange( OldObjectPath, { true } );
+		QueueChange( AssetData.GetObjectPathString(), MoveTemp( Change ) );
+	}
+	else
+	{
+		return;
+	}
+
+	UpdateGraph();
+}
+
+void UMarkdownLinkSubsystem::HandlePackageSaved( const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext )
+{
+	if( SaveContext.IsProceduralSave() )
+	{
+		return;
+	}
+
+	ForEachObjectWithPackage( Package, [ this ]( UObject* Object )
+	{
+		if( const UMarkdownAsset* Asset = Cast<UMarkdownAsset>( Object ) )
+		{
+			FMarkdownLinkChange Change;
+			MarkdownLinkSubsystem::GetDestinations( *Asset->GetDocument(), Change.Destinations );
+			QueueChange( Asset->GetPathName(), MoveTemp( Change ) );
+		}
+
+		return true;
+	}, false );
+
+	UpdateGraph();
+}
+
+void UMarkdownLinkSubsystem::HandleDirectoryChanged( const TArray<FFileChangeData>& FileChanges )
+{
+	for( const FFileChangeData& FileChange : FileChanges )
+	{
+		if( !MarkdownLinkSubsystem::IsFile( FileChange.Filename ) )
+		{
+			continue;
+		}
+
+		const FString Path = FMarkdownContentBrowserHierarchy::ConvertFileSystemPathToInternalPath( FileChange.Filename );
+
+		if( !Path.IsEmpty() )
+		{
+			QueueChange( Path, { FileChange.Action == FFileChangeData::FCA_Removed } );
+		}
+	}
+
+	UpdateGraph();
+}
@@ -0,0 +1,549 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Search/MarkdownQuickOpenIndex.h"
+
+#include "Algo/Unique.h"
+#include "Misc/Paths.h"
+
+namespace MarkdownQuickOpen
+{
+	// removed entries are only dropped from the trigram lists once there are this many, and they are half the index
+	static constexpr int32 MinCompactEntries = 256;
+
+	// the share of the query's trigrams an entry needs to be looked at, as a divisor
+	static constexpr int32 TrigramShareDivisor = 4;
+
+	static constexpr float WordStartBonus   = 3.0f;
+	static constexpr float ConsecutiveBonus = 2.0f;
+	static constexpr float GapPenalty       = 0.1f;
+	static constexpr float LengthPenalty    = 0.01f;
+	static constexpr float DocumentBonus    = 0.5f;
+
+	// every subsequence match ranks above every typo
+	static constexpr float SubsequenceScore = 1000.0f;
+	static constexpr float TypoScore        = 10.0f;
+
+	// word starts go in with the trigrams, flagged so they can't be mistaken for one
+	static constexpr uint64 WordStartFlag = 1ull << 63;
+
+	static uint64 MakeTrigram( const TCHAR* Chars )
+	{
+		return uint64( uint16( Chars[ 0 ] ) ) | uint64( uint16( Chars[ 1 ] ) ) << 16 | uint64( uint16( Chars[ 2 ] ) ) << 32;
+	}
+
+	static uint64 MakeWordStart( const TCHAR* Chars, const int32 Len )
+	{
+		return WordStartFlag | uint64( uint16( Chars[ 0 ] ) ) | ( Len > 1 ? uint64( uint16( Chars[ 1 ] ) ) << 16 : 0 );
+	}
+
+	/**
+	 * The trigrams of each word in the lowercased text, sorted with repeats removed. Entries also have the first one and
+	 * two characters of each word, which is all a query word too short for a trigram looks for.
+	 */
+	static void GetTrigrams( const FStringView Text, const bool bQuery, TArray<uint64, TInlineAllocator<64>>& OutTrigrams )
+	{
+		OutTrigrams.Reset();
+
+		int32 WordStart = 0;
+
+		for( int32 Index = 0; Index <= Text.Len(); ++Index )
+		{
+			if( Index < Text.Len() && FChar::IsAlnum( Text[ Index ] ) )
+			{
+				continue;
+			}
+
+			const int32 WordLen = Index - WordStart;
+
+			for( int32 Start = WordStart; Start + 3 <= Index; ++Start )
+			{
+				OutTrigrams.Add( MakeTrigram( Text.GetData() + Start ) );
+			}
+
+			if( !bQuery && WordLen > 0 )
+			{
+				OutTrigrams.Add( MakeWordStart( Text.GetData() + WordStart, 1 ) );
+				OutTrigrams.Add( MakeWordStart( Text.GetData() + WordStart, FMath::Min( WordLen, 2 ) ) );
+			}
+			else if( bQuery && WordLen > 0 && WordLen < 3 )
+			{
+				OutTrigrams.Add( MakeWordStart( Text.GetData() + WordStart, WordLen ) );
+			}
+
+			WordStart = Index + 1;
+		}
+
+		OutTrigrams.Sort();
+		OutTrigrams.SetNum( Algo::Unique( OutTrigrams ) );
+	}
+
+	static uint64 GetCharMask( const FStringView Text )
+	{
+		uint64 Mask = 0;
+
+		for( const TCHAR C : Text )
+		{
+			if( C >= TEXT( 'a' ) && C <= TEXT( 'z' ) )
+			{
+				Mask |= 1ull << ( C - TEXT( 'a' ) );
+			}
+			else if( C >= TEXT( '0' ) && C <= TEXT( '9' ) )
+			{
+				Mask |= 1ull << ( 26 + C - TEXT( '0' ) );
+			}
+			else
+			{
+				// everything else shares what is left
+				Mask |= 1ull << ( 36 + uint32( C ) % 28 );
+			}
+		}
+
+		return Mask;
+	}
+
+	// the match loops run over raw characters, they see every character of every candidate
+	static bool IsWordStart( const TCHAR* Key, const int32 Index )
+	{
+		return Index == 0 || !FChar::IsAlnum( Key[ Index - 1 ] );
+	}
+
+	/** the score of matching the query as a subsequence of the key from Start, less than 0 if it doesn't match */
+	static float MatchFrom( const FStringView Key, const FStringView Query, const int32 Start )
+	{
+		const TCHAR* KeyChars   = Key.GetData();
+		const TCHAR* QueryChars = Query.GetData();
+
+		float Score     = 0.0f;
+		float LastBonus = 0.0f;
+		int32 Last      = INDEX_NONE;
+		int32 Matched   = 0;
+
+		for( int32 Index = Start; Index < Key.Len() && Matched < Query.Len(); ++Index )
+		{
+			if( KeyChars[ Index ] != QueryChars[ Matched ] )
+			{
+				continue;
+			}
+
+			// a run keeps the bonus it started with, so the whole of a word counts as much as its first letter
+			float Bonus = 0.0f;
+
+			if( IsWordStart( KeyChars, Index ) )
+			{
+				Bonus = WordStartBonus;
+			}
+			else if( Last != INDEX_NONE && Index == Last + 1 )
+			{
+				Bonus = FMath::Max( LastBonus, ConsecutiveBonus );
+			}
+
+			Score += 1.0f + Bonus;
+			Score -= Last != INDEX_NONE ? ( Index - Last - 1 ) * GapPenalty : 0.0f;
+
+			Last      = Index;
+			LastBonus = Bonus;
+			++Matched;
+		}
+
+		return Matched == Query.Len() ? Score : -1.0f;
+	}
+
+	/** the best of matching from where the query's first character starts a word, less than 0 if it doesn't match */
+	static float MatchSubsequence( const FStringView Key, const FStringView Query )
+	{
+		const TCHAR* KeyChars = Key.GetData();
+		const TCHAR First     = Query[ 0 ];
+
+		float Best = -1.0f;
+
+		for( int32 Start = 0; Start < Key.Len(); ++Start )
+		{
+			// the first place it can start is always tried, later ones only if they start a word
+			if( KeyChars[ Start ] != First || ( Best >= 0.0f && !IsWordStart( KeyChars, Start ) ) )
+			{
+				continue;
+			}
+
+			const float Score = MatchFrom( Key, Query, Start );
+
+			// no match from here means no match from anywhere later either
+			if( Score < 0.0f )
+			{
+				break;
+			}
+
+			Best = FMath::Max( Best, Score );
+		}
+
+		return Best;
+	}
+
+	/** the most matching a query of this length could score, all of it in runs from the starts of words */
+	static float GetBestMatch( const int32 QueryLen )
+	{
+		return QueryLen * ( 1.0f + WordStartBonus );
+	}
+
+	static FString FindTitle( const FString& Path, TConstArrayView<FMarkdownHeading> Headings )
+	{
+		// the first of the highest level headings, as the search index does
+		const FMarkdownHeading* Best = nullptr;
+
+		for( const FMarkdownHeading& Heading : Headings )
+		{
+			if( Best == nullptr || Heading.Level < Best->Level )
+			{
+				Best = &Heading;
+			}
+		}
+
+		return Best != nullptr ? Best->Title : FPaths::GetBaseFilename( Path );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownQuickOpenIndex::AddDocument( const FString& Path, TConstArrayView<FMarkdownHeading> Headings, const FDateTime& Timestamp, TConstArrayView<FString> Tags )
+{
+	using namespace MarkdownQuickOpen;
+
+	RemoveDocument( Path );
+
+	FDocument Added;
+	Added.Timestamp = Timestamp;
+	Added.Tags      = Tags;
+	Added.Ids.Reserve( Headings.Num() + 1 );
+
+	FMarkdownQuickOpenEntry Document;
+	Document.Path  = Path;
+	Document.Title = FindTitle( Path, Headings );
+
+	FString RelativePath = FPaths::GetBaseFilename( Path, false );
+	RelativePath.RemoveFromStart( TEXT( "/Documentation/" ) );
+
+	for( const FMarkdownHeading& Heading : Headings )
+	{
+		FMarkdownQuickOpenEntry Entry;
+		Entry.Path  = Path;
+		Entry.Title = Heading.Title;
+		Entry.Slug  = Heading.Slug;
+		Entry.Level = Heading.Level;
+
+		AddEntry( MoveTemp( Entry ), Document.Title + TEXT( " " ) + Heading.Title, Added.Ids );
+	}
+
+	// the title then the path under the documentation folder, "damage falloff weapons/damage"
+	AddEntry( MoveTemp( Document ), Document.Title + TEXT( " " ) + RelativePath, Added.Ids );
+
+	Documents.Add( Path, MoveTemp( Added ) );
+}
+
+void FMarkdownQuickOpenIndex::RemoveDocument( const FString& Path )
+{
+	FDocument Removed;
+
+	if( !Documents.RemoveAndCopyValue( Path, Removed ) )
+	{
+		return;
+	}
+
+	for( const int32 Id : Removed.Ids )
+	{
+		Entries[ Id ] = FMarkdownQuickOpenEntry();
+		Keys[ Id ].bRemoved = true;
+	}
+
+	NumRemoved += Removed.Ids.Num();
+
+	if( NumRemoved >= MarkdownQuickOpen::MinCompactEntries && NumRemoved * 2 >= Entries.Num() )
+	{
+		Compact();
+	}
+}
+
+bool FMarkdownQuickOpenIndex::GetOutline( const FString& Path, FString& OutTitle, TArray<FString>& OutHeadings, TArray<FString>& OutTags ) const
+{
+	const FDocument* Document = Documents.Find( Path );
+
+	if( Document == nullptr || Document->Ids.IsEmpty() )
+	{
+		return false;
+	}
+
+	OutTitle = Entries[ Document->Ids.Last() ].Title;
+	OutTags  = Document->Tags;
+
+	OutHeadings.Reset( Document->Ids.Num() - 1 );
+
+	for( int32 Index = 0; Index < Document->Ids.Num() - 1; ++Index )
+	{
+		OutHeadings.Add( Entries[ Document->Ids[ Index ] ].Title );
+	}
+
+	return true;
+}
+
+FDateTime FMarkdownQuickOpenIndex::GetTimestamp( const FString& Path ) const
+{
+	const FDocument* Document = Documents.Find( Path );
+	return Document != nullptr ? Document->Timestamp : FDateTime::MinValue();
+}
+
+void FMarkdownQuickOpenIndex::GetTimestamps( TMap<FString, FDateTime>& OutTimestamps ) const
+{
+	OutTimestamps.Reset();
+	OutTimestamps.Reserve( Documents.Num() );
+
+	for( const TPair<FString, FDocument>& Document : Documents )
+	{
+		OutTimestamps.Add( Document.Key, Document.Value.Timestamp );
+	}
+}
+
+void FMarkdownQuickOpenIndex::AddEntry( FMarkdownQuickOpenEntry&& Entry, const FString& Key, TArray<int32>& OutIds )
+{
+	const FString Lowered = Key.ToLower();
+
+	FEntryKey& EntryKey = Keys.AddDefaulted_GetRef();
+	EntryKey.Start     = KeyChars.Num();
+	EntryKey.Length    = Lowered.Len();
+	EntryKey.CharMask  = MarkdownQuickOpen::GetCharMask( Lowered );
+	EntryKey.bDocument = Entry.Slug.IsEmpty();
+
+	KeyChars.Append( *Lowered, Lowered.Len() );
+
+	const int32 Id = Entries.Add( MoveTemp( Entry ) );
+
+	AddTrigrams( Id );
+	OutIds.Add( Id );
+}
+
+void FMarkdownQuickOpenIndex::AddTrigrams( const int32 Id )
+{
+	TArray<uint64, TInlineAllocator<64>> EntryTrigrams;
+	MarkdownQuickOpen::GetTrigrams( GetKey( Keys[ Id ] ), false, EntryTrigrams );
+
+	for( const uint64 Trigram : EntryTrigrams )
+	{
+		Trigrams.FindOrAdd( Trigram ).Add( Id );
+	}
+}
+
+void FMarkdownQuickOpenIndex::Compact()
+{
+	TArray<int32> NewIds;
+	NewIds.Init( INDEX_NONE, Entries.Num() );
+
+	TArray<FMarkdownQuickOpenEntry> KeptEntries;
+	TArray<FEntryKey> KeptKeys;
+	TArray<TCHAR> KeptChars;
+
+	KeptEntries.Reserve( Entries.Num() - NumRemoved );
+	KeptKeys.Reserve( Entries.Num() - NumRemoved );
+	KeptChars.Reserve( KeyChars.Num() );
+
+	for( int32 Id = 0; Id < Entries.Num(); ++Id )
+	{
+		FEntryKey Key = Keys[ Id ];
+
+		if( Key.bRemoved )
+		{
+			continue;
+		}
+
+		KeptChars.Append( KeyChars.GetData() + Key.Start, Key.Length );
+		Key.Start = KeptChars.Num() - Key.Length;
+
+		NewIds[ Id ] = KeptEntries.Add( MoveTemp( Entries[ Id ] ) );
+		KeptKeys.Add( Key );
+	}
+
+	Entries    = MoveTemp( KeptEntries );
+	Keys       = MoveTemp( KeptKeys );
+	KeyChars   = MoveTemp( KeptChars );
+	NumRemoved = 0;
+
+	for( TPair<FString, FDocument>& Document : Documents )
+	{
+		for( int32& Id : Document.Value.Ids )
+		{
+			Id = NewIds[ Id ];
+		}
+	}
+
+	Trigrams.Reset();
+
+	for( int32 Id = 0; Id < Entries.Num(); ++Id )
+	{
+		AddTrigrams( Id );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownQuickOpenIndex::Find( const FStringView Query, const int32 MaxResults, TArray<FMarkdownQuickOpenResult>& OutResults ) const
+{
+	using namespace MarkdownQuickOpen;
+
+	OutResults.Reset();
+
+	const FString Lowered = FString( Query ).ToLower();
+
+	// spaces in the query only split it into words for the trigrams, the subsequence runs over the rest
+	FString Letters;
+	Letters.Reserve( Lowered.Len() );
+
+	for( const TCHAR C : Lowered )
+	{
+		if( !FChar::IsWhitespace( C ) )
+		{
+			Letters.AppendChar( C );
+		}
+	}
+
+	if( Letters.IsEmpty() || MaxResults <= 0 )
+	{
+		return;
+	}
+
+	TArray<uint64, TInlineAllocator<64>> QueryTrigrams;
+	GetTrigrams( Lowered, true, QueryTrigrams );
+	QueryTrigrams.SetNum( FMath::Min( QueryTrigrams.Num(), int32( MAX_uint16 ) ) );
+
+	// how many of the query's trigrams each entry has, for the entries that have any
+	TArray<uint16> Shared;
+	TArray<int32> Candidates;
+
+	if( !QueryTrigrams.IsEmpty() )
+	{
+		Shared.SetNumZeroed( Keys.Num() );
+
+		for( const uint64 Trigram : QueryTrigrams )
+		{
+			if( const TArray<int32>* Ids = Trigrams.Find( Trigram ) )
+			{
+				for( const int32 Id : *Ids )
+				{
+					if( Shared[ Id ]++ == 0 )
+					{
+						Candidates.Add( Id );
+					}
+				}
+			}
+		}
+	}
+
+	const int32 NumTrigrams = QueryTrigrams.Num();
+	const int32 MinShared   = FMath::Max( 1, NumTrigrams / TrigramShareDivisor );
+	const uint64 QueryMask  = GetCharMask( Letters );
+	const float BestMatch   = SubsequenceScore + GetBestMatch( Letters.Len() ) + DocumentBonus;
+
+	auto Worse = []( const FMarkdownQuickOpenResult& A, const FMarkdownQuickOpenResult& Other )
+	{
+		return A.Score != Other.Score ? A.Score < Other.Score : A.Entry > Other.Entry;
+	};
+
+	auto Consider = [ & ]( const int32 Id, const int32 NumShared )
+	{
+		const FEntryKey& Key = Keys[ Id ];
+
+		if( Key.bRemoved )
+		{
+			return;
+		}
+
+		// once the results are full, long keys can't score enough to get in, a typo even less so
+		if( OutResults.Num() == MaxResults && BestMatch - Key.Length * LengthPenalty < OutResults.HeapTop().Score )
+		{
+			return;
+		}
+
+		// without all the query's characters it can only be a typo
+		float Score = ( QueryMask & ~Key.CharMask ) == 0 ? MatchSubsequence( GetKey( Key ), Letters ) : -1.0f;
+
+		if( Score >= 0.0f )
+		{
+			Score += SubsequenceScore - Key.Length * LengthPenalty + ( Key.bDocument ? DocumentBonus : 0.0f );
+		}
+		else if( NumShared >= MinShared )
+		{
+			Score = TypoScore * NumShared / NumTrigrams;
+		}
+		else
+		{
+			return;
+		}
+
+		if( OutResults.Num() < MaxResults )
+		{
+			OutResults.HeapPush( { Id, Score }, Worse );
+		}
+		else if( Worse( OutResults.HeapTop(), { Id, Score } ) )
+		{
+			OutResults.HeapPopDiscard( Worse );
+			OutResults.HeapPush( { Id, Score }, Worse );
+		}
+	};
+
+	// the entries with every trigram of the query first, which is where nearly all the good matches are, then the ones
+	// with half of them, and only the rest when those don't fill the results
+	const int32 Thresholds[] = { NumTrigrams, ( NumTrigrams + 1 ) / 2, 1 };
+	int32 Upper = NumTrigrams + 1;
+
+	for( const int32 Threshold : Thresholds )
+	{
+		if( OutResults.Num() >= MaxResults )
+		{
+			break;
+		}
+
+		for( const int32 Id : Candidates )
+		{
+			if( Shared[ Id ] >= Threshold && Shared[ Id ] < Upper )
+			{
+				Consider( Id, Shared[ Id ] );
+			}
+		}
+
+		Upper = Threshold;
+	}
+
+	if( OutResults.IsEmpty() )
+	{
+		// only matches as a subsequence across words, like an abbreviation, so every entry has to be looked at
+		for( int32 Id = 0; Id < Keys.Num(); ++Id )
+		{
+			if( ( QueryMask & ~Keys[ Id ].CharMask ) == 0 )
+			{
+				Consider( Id, 0 );
+			}
+		}
+	}
+
+	OutResults.Sort( [ &Worse ]( const FMarkdownQuickOpenResult& A, const FMarkdownQuickOpenResult& Other )
+	{
+		return Worse( Other, A );
+	});
+}
+
+SIZE_T FMarkdownQuickOpenIndex::GetAllocatedSize() const
+{
+	SIZE_T Size = Entries.GetAllocatedSize() + Keys.GetAllocatedSize() + KeyChars.GetAllocatedSize() + Documents.GetAllocatedSize() + Trigrams.GetAllocatedSize();
+
+	for( const TPair<FString, FDocument>& Document : Documents )
+	{
+		Size += Document.Key.GetAllocatedSize() + Document.Value.Ids.GetAllocatedSize();
+	}
+
+	for( const FMarkdownQuickOpenEntry& Entry : Entries )
+	{
+		Size += Entry.Path.GetAllocatedSize() + Entry.Title.GetAllocatedSize() + Entry.Slug.GetAllocatedSize();
+	}
+
+	for( const TPair<uint64, TArray<int32>>& Trigram : Trigrams )
+	{
+		Size += Trigram.Value.GetAllocatedSize();
+	}
+
+	return Size;
+}
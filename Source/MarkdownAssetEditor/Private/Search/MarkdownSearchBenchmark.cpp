@@ -0,0 +1,269 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Editor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
+#include "Search/MarkdownQuickOpenIndex.h"
+#include "Search/MarkdownSearchIndex.h"
+#include "Search/MarkdownSearchSubsystem.h"
+
+// Markdown.Search <Query>
+//
+// searches the project documentation and logs the best matches
+//
+// Markdown.Search.Benchmark [Documents] [Iterations]
+//
+// builds an index of generated documents (50,000 by default), saves it and maps it back in, then times a mix of
+// queries against it. Word frequencies are skewed like real text, so there are terms in nearly every document as well
+// as ones in only a few
+//
+// Markdown.QuickOpen.Benchmark [Documents] [Iterations]
+//
+// fills a quick open index with generated documents (50,000 by default, with eight headings each) and times queries
+// as they would be typed, from a single letter up to a few words, with typos and ones that only match across words
+
+namespace MarkdownSearch
+{
+	static void RunSearch( const TArray<FString>& Args )
+	{
+		UMarkdownSearchSubsystem* Subsystem = GEditor != nullptr ? GEditor->GetEditorSubsystem<UMarkdownSearchSubsystem>() : nullptr;
+
+		if( Subsystem == nullptr || !Subsystem->IsIndexReady() )
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown.Search: the index is not ready yet" ) );
+			return;
+		}
+
+		const FString Query = FString::Join( Args, TEXT( " " ) );
+
+		const double Start = FPlatformTime::Seconds();
+		const TArray<FMarkdownSearchResult> Results = Subsystem->Search( Query, 20 );
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+
+		UE_LOG( MarkdownEditorLog, Display, TEXT( "Markdown.Search: '%s', %d results in %.3f ms" ), *Query, Results.Num(), Elapsed * 1000.0 );
+
+		for( const FMarkdownSearchResult& Result : Results )
+		{
+			UE_LOG( MarkdownEditorLog, Display, TEXT( "  %6.2f  %s (%s)" ), Result.Score, *Result.Title, *Result.Path );
+		}
+	}
+
+	static const TCHAR* Words[] =
+	{
+		TEXT( "the" ), TEXT( "of" ), TEXT( "and" ), TEXT( "to" ), TEXT( "actor" ), TEXT( "component" ), TEXT( "damage" ),
+		TEXT( "falloff" ), TEXT( "radius" ), TEXT( "health" ), TEXT( "blueprint" ), TEXT( "spawn" ), TEXT( "weapon" ),
+		TEXT( "projectile" ), TEXT( "material" ), TEXT( "texture" ), TEXT( "mesh" ), TEXT( "level" ), TEXT( "streaming" ),
+		TEXT( "widget" ), TEXT( "input" ), TEXT( "ability" ), TEXT( "animation" ), TEXT( "replication" ),
+	};
+
+	static constexpr int32 NumWords = UE_ARRAY_COUNT( Words );
+	static constexpr int32 NumTerms = 20000;
+
+	static TArray<FMarkdownSearchSource> MakeBenchmarkSources( const int32 NumDocuments )
+	{
+
+		FRandomStream Random( 1234 );
+		TArray<FMarkdownSearchSource> Sources;
+		Sources.SetNum( NumDocuments );
+
+		for( int32 Document = 0; Document < NumDocuments; ++Document )
+		{
+			FMarkdownSearchSource& Source = Sources[ Document ];
+			Source.Path = FString::Printf( TEXT( "/Documentation/Benchmark/Doc%d.md" ), Document );
+			Source.Text = FString::Printf( TEXT( "# %s %s\n\n" ), Words[ Random.RandHelper( NumWords ) ], Words[ Random.RandHelper( NumWords ) ] );
+
+			const int32 Length = Random.RandRange( 100, 800 );
+
+			for( int32 Word = 0; Word < Length; ++Word )
+			{
+				if( Random.FRand() < 0.5f )
+				{
+					Source.Text += Words[ Random.RandHelper( NumWords ) ];
+				}
+				else
+				{
+					// cubing makes the low terms much more common than the high ones
+					Source.Text += FString::Printf( TEXT( "term%d" ), int32( NumTerms * FMath::Cube( Random.FRand() ) ) );
+				}
+
+				Source.Text.AppendChar( Word % 16 == 15 ? TEXT( '\n' ) : TEXT( ' ' ) );
+			}
+		}
+
+		return Sources;
+	}
+
+	static void RunBenchmark( const TArray<FString>& Args )
+	{
+		const int32 NumDocuments = Args.Num() > 0 ? FMath::Max( 1, FCString::Atoi( *Args[ 0 ] ) ) : 50000;
+		const int32 Iterations   = Args.Num() > 1 ? FMath::Max( 1, FCString::Atoi( *Args[ 1 ] ) ) : 20;
+
+		TArray<FMarkdownSearchSource> Sources = MakeBenchmarkSources( NumDocuments );
+
+		const double BuildStart = FPlatformTime::Seconds();
+		const TSharedRef<FMarkdownSearchSegment> Segment = FMarkdownSearchSegment::Build( MoveTemp( Sources ) );
+		const double BuildElapsed = FPlatformTime::Seconds() - BuildStart;
+
+		UE_LOG( MarkdownEditorLog, Display, TEXT( "Markdown.Search.Benchmark: %d documents, %d terms, %.1f MB, built in %.2f s" ),
+			Segment->NumDocuments(), Segment->NumTerms(), Segment->GetAllocatedSize() / ( 1024.0 * 1024.0 ), BuildElapsed );
+
+		const FString Filename = FPaths::ProjectSavedDir() / TEXT( "MarkdownSearchBenchmark.mdseg" );
+
+		const double SaveStart = FPlatformTime::Seconds();
+		const bool bSaved = Segment->Save( Filename );
+		const double SaveElapsed = FPlatformTime::Seconds() - SaveStart;
+
+		const double LoadStart = FPlatformTime::Seconds();
+		TSharedPtr<FMarkdownSearchSegment> Loaded = bSaved ? FMarkdownSearchSegment::Load( Filename ) : nullptr;
+		const double LoadElapsed = FPlatformTime::Seconds() - LoadStart;
+
+		if( !Loaded.IsValid() )
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown.Search.Benchmark: could not save and load %s" ), *Filename );
+			return;
+		}
+
+		UE_LOG( MarkdownEditorLog, Display, TEXT( "  saved in %.1f ms, mapped back in %.1f ms (%.1f MB on disk)" ),
+			SaveElapsed * 1000.0, LoadElapsed * 1000.0, IFileManager::Get().FileSize( *Filename ) / ( 1024.0 * 1024.0 ) );
+
+		// the queries run against the mapped segment
+		TArray<FMarkdownSearchSegmentRef> Segments;
+		Segments.Add( { Loaded.ToSharedRef(), TBitArray<>( false, Loaded->NumDocuments() ), 0 } );
+		TUniquePtr<FMarkdownSearchIndex> Index = MakeUnique<FMarkdownSearchIndex>( MoveTemp( Segments ) );
+
+		static const TCHAR* Queries[] =
+		{
+			TEXT( "damage" ),
+			TEXT( "damage falloff" ),
+			TEXT( "term15000" ),
+			TEXT( "term12 actor" ),
+			TEXT( "dam" ),
+			TEXT( "term1" ),
+			TEXT( "\"damage falloff\"" ),
+			TEXT( "\"the actor\" health" ),
+		};
+
+		TArray<FMarkdownSearchHit> Hits;
+
+		for( const TCHAR* Query : Queries )
+		{
+			const double Start = FPlatformTime::Seconds();
+
+			for( int32 Iteration = 0; Iteration < Iterations; ++Iteration )
+			{
+				Index->Search( Query, 50, Hits );
+			}
+
+			const double Elapsed = FPlatformTime::Seconds() - Start;
+
+			UE_LOG( MarkdownEditorLog, Display, TEXT( "  %-24s %8.3f ms, %d results" ), Query, Elapsed * 1000.0 / Iterations, Hits.Num() );
+		}
+
+		// unmapped before it can be deleted
+		Index.Reset();
+		Loaded.Reset();
+		IFileManager::Get().Delete( *Filename, false, false, true );
+	}
+
+	static FString MakeBenchmarkTitle( FRandomStream& Random )
+	{
+		FString Title;
+		const int32 Length = Random.RandRange( 2, 4 );
+
+		for( int32 Word = 0; Word < Length; ++Word )
+		{
+			Title += Word > 0 ? TEXT( " " ) : TEXT( "" );
+
+			// the common words again, with the odd rarer term
+			Title += Random.FRand() < 0.8f ? Words[ 4 + Random.RandHelper( NumWords - 4 ) ] : *FString::Printf( TEXT( "term%d" ), int32( NumTerms * FMath::Cube( Random.FRand() ) ) );
+		}
+
+		return Title;
+	}
+
+	static void RunQuickOpenBenchmark( const TArray<FString>& Args )
+	{
+		const int32 NumDocuments = Args.Num() > 0 ? FMath::Max( 1, FCString::Atoi( *Args[ 0 ] ) ) : 50000;
+		const int32 Iterations   = Args.Num() > 1 ? FMath::Max( 1, FCString::Atoi( *Args[ 1 ] ) ) : 20;
+
+		FRandomStream Random( 1234 );
+		FMarkdownQuickOpenIndex Index;
+
+		const double BuildStart = FPlatformTime::Seconds();
+
+		for( int32 Document = 0; Document < NumDocuments; ++Document )
+		{
+			TArray<FMarkdownHeading> Headings;
+			Headings.SetNum( 8 );
+
+			for( int32 Heading = 0; Heading < Headings.Num(); ++Heading )
+			{
+				Headings[ Heading ].Level = Heading == 0 ? 1 : 2 + Random.RandHelper( 2 );
+				Headings[ Heading ].Title = MakeBenchmarkTitle( Random );
+				Headings[ Heading ].Slug  = FMarkdownHeadingIndex::MakeSlug( Headings[ Heading ].Title );
+			}
+
+			const FString Path = FString::Printf( TEXT( "/Documentation/%s/%s/Doc%d.md" ), Words[ 4 + Random.RandHelper( NumWords - 4 ) ], Words[ 4 + Random.RandHelper( NumWords - 4 ) ], Document );
+			Index.AddDocument( Path, Headings );
+		}
+
+		const double BuildElapsed = FPlatformTime::Seconds() - BuildStart;
+
+		UE_LOG( MarkdownEditorLog, Display, TEXT( "Markdown.QuickOpen.Benchmark: %d documents, %d entries, %.1f MB, built in %.2f s" ),
+			Index.NumDocuments(), Index.NumEntries(), Index.GetAllocatedSize() / ( 1024.0 * 1024.0 ), BuildElapsed );
+
+		static const TCHAR* Queries[] =
+		{
+			TEXT( "d" ),
+			TEXT( "da" ),
+			TEXT( "dam" ),
+			TEXT( "damage" ),
+			TEXT( "damage fall" ),
+			TEXT( "damagefalloff" ),
+			TEXT( "damgae falloff" ),
+			TEXT( "dmg fall" ),
+			TEXT( "weapon/damage" ),
+			TEXT( "term15000" ),
+			TEXT( "xyzzy" ),
+		};
+
+		TArray<FMarkdownQuickOpenResult> Results;
+
+		for( const TCHAR* Query : Queries )
+		{
+			const double Start = FPlatformTime::Seconds();
+
+			for( int32 Iteration = 0; Iteration < Iterations; ++Iteration )
+			{
+				Index.Find( Query, 50, Results );
+			}
+
+			const double Elapsed = FPlatformTime::Seconds() - Start;
+
+			UE_LOG( MarkdownEditorLog, Display, TEXT( "  %-24s %8.3f ms, %d results%s%s" ), Query, Elapsed * 1000.0 / Iterations, Results.Num(),
+				Results.IsEmpty() ? TEXT( "" ) : TEXT( ", best " ), Results.IsEmpty() ? TEXT( "" ) : *Index.GetEntry( Results[ 0 ].Entry ).Title );
+		}
+	}
+
+	static FAutoConsoleCommand SearchCommand(
+		TEXT( "Markdown.Search" ),
+		TEXT( "Searches the project documentation. Arguments: <Query>" ),
+		FConsoleCommandWithArgsDelegate::CreateStatic( &RunSearch )
+	);
+
+	static FAutoConsoleCommand BenchmarkCommand(
+		TEXT( "Markdown.Search.Benchmark" ),
+		TEXT( "Measures building and searching a markdown search index. Arguments: [Documents] [Iterations]" ),
+		FConsoleCommandWithArgsDelegate::CreateStatic( &RunBenchmark )
+	);
+
+	static FAutoConsoleCommand QuickOpenBenchmarkCommand(
+		TEXT( "Markdown.QuickOpen.Benchmark" ),
+		TEXT( "Measures quick open over a large generated set of documents and headings. Arguments: [Documents] [Iterations]" ),
+		FConsoleCommandWithArgsDelegate::CreateStatic( &RunQuickOpenBenchmark )
+	);
+}
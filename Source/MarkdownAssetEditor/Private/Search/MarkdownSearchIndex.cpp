@@ -0,0 +1,276 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Search/MarkdownSearchIndex.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace MarkdownSearchIndex
+{
+	// "MDIX", bump the version whenever the layout changes
+	static constexpr uint32 FileMagic   = 0x5849444D;
+	static constexpr uint32 FileVersion = 1;
+
+	static FString GetIndexFilename( const FString& Directory )
+	{
+		return Directory / TEXT( "Index.mdidx" );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownSearchIndex::FMarkdownSearchIndex( TArray<FMarkdownSearchSegmentRef>&& InSegments )
+	: Segments( MoveTemp( InSegments ) )
+{
+	int32 NumAllDocuments = 0;
+
+	for( const FMarkdownSearchSegmentRef& Segment : Segments )
+	{
+		NumAllDocuments += Segment.Segment->NumDocuments();
+	}
+
+	DocumentIds.Reserve( NumAllDocuments );
+
+	for( int32 Segment = 0; Segment < Segments.Num(); ++Segment )
+	{
+		const FMarkdownSearchSegmentRef& Ref = Segments[ Segment ];
+
+		for( int32 Document = 0; Document < Ref.Segment->NumDocuments(); ++Document )
+		{
+			if( !Ref.Removed.IsValidIndex( Document ) || !Ref.Removed[ Document ] )
+			{
+				const FMarkdownSearchDocument& Current = Ref.Segment->GetDocument( Document );
+				DocumentIds.Add( Current.Path, FDocumentId{ Segment, Document } );
+				TotalTokens += Current.NumTokens;
+			}
+		}
+	}
+}
+
+TSharedPtr<FMarkdownSearchIndex> FMarkdownSearchIndex::Load( const FString& Directory )
+{
+	using namespace MarkdownSearchIndex;
+
+	TArray<uint8> Bytes;
+
+	if( !FFileHelper::LoadFileToArray( Bytes, *GetIndexFilename( Directory ), FILEREAD_Silent ) )
+	{
+		return nullptr;
+	}
+
+	FMemoryReader Reader( Bytes );
+
+	uint32 Magic      = 0;
+	uint32 Version    = 0;
+	int32 NumSegments = 0;
+	Reader << Magic << Version << NumSegments;
+
+	if( Reader.IsError() || Magic != FileMagic || Version != FileVersion || NumSegments < 0 )
+	{
+		return nullptr;
+	}
+
+	TArray<FMarkdownSearchSegmentRef> Segments;
+	Segments.Reserve( NumSegments );
+
+	for( int32 Index = 0; Index < NumSegments; ++Index )
+	{
+		int32 Id = 0;
+		TBitArray<> Removed;
+		Reader << Id << Removed;
+
+		if( Reader.IsError() )
+		{
+			return nullptr;
+		}
+
+		const TSharedPtr<FMarkdownSearchSegment> Segment = FMarkdownSearchSegment::Load( GetSegmentFilename( Directory, Id ) );
+
+		if( !Segment.IsValid() || Removed.Num() != Segment->NumDocuments() )
+		{
+			return nullptr;
+		}
+
+		Segments.Add( { Segment.ToSharedRef(), MoveTemp( Removed ), Id } );
+	}
+
+	return MakeShared<FMarkdownSearchIndex>( MoveTemp( Segments ) );
+}
+
+bool FMarkdownSearchIndex::Save( const FString& Directory ) const
+{
+	using namespace MarkdownSearchIndex;
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer( Bytes );
+
+	uint32 Magic      = FileMagic;
+	uint32 Version    = FileVersion;
+	int32 NumSegments = Segments.Num();
+	Writer << Magic << Version << NumSegments;
+
+	TSet<FString> Filenames;
+
+	for( const FMarkdownSearchSegmentRef& Segment : Segments )
+	{
+		int32 Id = Segment.Id;
+		Writer << Id << const_cast<TBitArray<>&>( Segment.Removed );
+
+		Filenames.Add( FPaths::GetCleanFilename( GetSegmentFilename( Directory, Segment.Id ) ) );
+	}
+
+	// through a temporary file, so the list on disk is always whole
+	const FString Filename     = GetIndexFilename( Directory );
+	const FString TempFilename = Filename + TEXT( ".tmp" );
+
+	if( !FFileHelper::SaveArrayToFile( Bytes, *TempFilename ) || !IFileManager::Get().Move( *Filename, *TempFilename, true, true, false, true ) )
+	{
+		return false;
+	}
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles( Files, *( Directory / TEXT( "*.mdseg" ) ), true, false );
+
+	for( const FString& File : Files )
+	{
+		if( !Filenames.Contains( File ) )
+		{
+			IFileManager::Get().Delete( *( Directory / File ), false, false, true );
+		}
+	}
+
+	return true;
+}
+
+FString FMarkdownSearchIndex::GetSegmentFilename( const FString& Directory, const int32 Id )
+{
+	return Directory / FString::Printf( TEXT( "Segment%d.mdseg" ), Id );
+}
+
+TSharedRef<FMarkdownSearchIndex> FMarkdownSearchIndex::Update( const TSharedPtr<const FMarkdownSearchSegment>& Segment, const int32 Id, TConstArrayView<FString> RemovedPaths ) const
+{
+	TArray<FMarkdownSearchSegmentRef> NewSegments = Segments;
+
+	for( const FString& Path : RemovedPaths )
+	{
+		if( const FDocumentId* Found = DocumentIds.Find( Path ) )
+		{
+			NewSegments[ Found->Segment ].Removed[ Found->Document ] = true;
+		}
+	}
+
+	// nothing left to find in them
+	NewSegments.RemoveAll( []( const FMarkdownSearchSegmentRef& Ref )
+	{
+		return Ref.Removed.Find( false ) == INDEX_NONE;
+	});
+
+	if( Segment.IsValid() && Segment->NumDocuments() > 0 )
+	{
+		NewSegments.Add( { Segment.ToSharedRef(), TBitArray<>( false, Segment->NumDocuments() ), Id } );
+	}
+
+	return MakeShared<FMarkdownSearchIndex>( MoveTemp( NewSegments ) );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownSearchIndex::Search( const FStringView Query, const int32 MaxResults, TArray<FMarkdownSearchHit>& OutHits ) const
+{
+	FMarkdownSearchQuery ParsedQuery;
+
+	if( ParsedQuery.Parse( Query ) )
+	{
+		Search( ParsedQuery, MaxResults, OutHits );
+	}
+	else
+	{
+		OutHits.Reset();
+	}
+}
+
+void FMarkdownSearchIndex::Search( const FMarkdownSearchQuery& Query, const int32 MaxResults, TArray<FMarkdownSearchHit>& OutHits ) const
+{
+	OutHits.Reset();
+
+	if( MaxResults <= 0 )
+	{
+		return;
+	}
+
+	FMarkdownSearchStats Stats;
+	Stats.NumDocuments  = DocumentIds.Num();
+	Stats.AverageTokens = float( double( TotalTokens ) / FMath::Max( 1, DocumentIds.Num() ) );
+
+	for( const FMarkdownSearchSegmentRef& Segment : Segments )
+	{
+		Segment.Segment->CountDocuments( Query, Segment.Removed, Stats );
+	}
+
+	Stats.Finish();
+
+	TArray<FMarkdownSearchHit> Hits;
+
+	for( int32 Segment = 0; Segment < Segments.Num(); ++Segment )
+	{
+		Segments[ Segment ].Segment->Search( Query, Stats, Segments[ Segment ].Removed, MaxResults, Hits );
+
+		for( FMarkdownSearchHit& Hit : Hits )
+		{
+			Hit.Segment = Segment;
+		}
+
+		OutHits.Append( Hits );
+	}
+
+	if( Segments.Num() > 1 )
+	{
+		// ties go the same way as they would in one merged segment
+		OutHits.Sort( []( const FMarkdownSearchHit& A, const FMarkdownSearchHit& Other )
+		{
+			if( A.Score != Other.Score )
+			{
+				return A.Score > Other.Score;
+			}
+
+			return A.Segment != Other.Segment ? A.Segment < Other.Segment : A.Document < Other.Document;
+		});
+
+		OutHits.SetNum( FMath::Min( OutHits.Num(), MaxResults ) );
+	}
+}
+
+const FMarkdownSearchDocument* FMarkdownSearchIndex::FindDocument( const FStringView Path ) const
+{
+	const FDocumentId* Found = DocumentIds.Find( FString( Path ) );
+	return Found != nullptr ? &Segments[ Found->Segment ].Segment->GetDocument( Found->Document ) : nullptr;
+}
+
+void FMarkdownSearchIndex::ForEachDocument( TFunctionRef<void( const FMarkdownSearchDocument& )> Callback ) const
+{
+	for( const FMarkdownSearchSegmentRef& Segment : Segments )
+	{
+		for( int32 Document = 0; Document < Segment.Segment->NumDocuments(); ++Document )
+		{
+			if( !Segment.Removed.IsValidIndex( Document ) || !Segment.Removed[ Document ] )
+			{
+				Callback( Segment.Segment->GetDocument( Document ) );
+			}
+		}
+	}
+}
+
+SIZE_T FMarkdownSearchIndex::GetAllocatedSize() const
+{
+	SIZE_T Size = Segments.GetAllocatedSize() + DocumentIds.GetAllocatedSize();
+
+	for( const FMarkdownSearchSegmentRef& Segment : Segments )
+	{
+		Size += Segment.Segment->GetAllocatedSize() + Segment.Removed.GetAllocatedSize();
+	}
+
+	return Size;
+}
@@ -0,0 +1,1164 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Search/MarkdownSearchSegment.h"
+
+#include "Algo/Unique.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Memory/MemoryView.h"
+#include "Misc/Paths.h"
+#include "Parser/MarkdownFrontMatter.h"
+#include "Parser/MarkdownHeadingIndex.h"
+#include "Serialization/MemoryReader.h"
+
+namespace MarkdownSearchSegment
+{
+	// terms are merged in shards on separate workers, a term always goes to the same shard
+	static constexpr int32 NumShards = 64;
+
+	// longer runs are hashes, base64 and the like, which nobody searches for
+	static constexpr int32 MaxTokenLength = 48;
+
+	// a prefix with more terms than this is too short to be useful yet, the first ones are enough
+	static constexpr int32 MaxPrefixTerms = 128;
+
+	// more words than this and the rest of the query is ignored
+	static constexpr int32 MaxClauses = 32;
+
+	// BM25
+	static constexpr float K1 = 1.2f;
+	static constexpr float B  = 0.75f;
+
+	static constexpr float TitleWeight = 2.0f;
+
+	// "MDSG", bump the version whenever the layout below or the tokenizer changes
+	static constexpr uint32 FileMagic   = 0x4753444D;
+	static constexpr uint32 FileVersion = 2;
+
+	enum EFileArray
+	{
+		TermCharsArray,
+		TermOffsetsArray,
+		TermStartArray,
+		PostingDocumentsArray,
+		PositionStartArray,
+		PositionsArray,
+		NumFileArrays
+	};
+
+	static constexpr int64 ElementSizes[ NumFileArrays ] = { sizeof( TCHAR ), sizeof( int32 ), sizeof( int32 ), sizeof( int32 ), sizeof( int32 ), sizeof( int32 ) };
+
+	/** the arrays follow the header, each one 8 byte aligned, then the serialized documents */
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 CharSize;
+		int32 NumDocuments;
+		int64 DocumentsOffset;
+		int64 Offsets[ NumFileArrays ];
+		int64 Counts[ NumFileArrays ];
+	};
+
+	template<typename Type>
+	static TArrayView<const Type> MapArray( const uint8* Data, const FFileHeader& Header, const EFileArray Array )
+	{
+		return TArrayView<const Type>( reinterpret_cast<const Type*>( Data + Header.Offsets[ Array ] ), int32( Header.Counts[ Array ] ) );
+	}
+
+	static void SerializeDocument( FArchive& Ar, FMarkdownSearchDocument& Document )
+	{
+		Ar << Document.Path;
+		Ar << Document.Title;
+		Ar << Document.ContentHash;
+		Ar << Document.NumTitleTokens;
+		Ar << Document.NumOutlineTokens;
+		Ar << Document.NumTokens;
+	}
+
+	/** the terms of one document, ordered by shard and then by term */
+	struct FDocumentTerms
+	{
+		TArray<FString> Terms;
+		TArray<int32> PositionStart;
+		TArray<int32> Positions;
+		int32 ShardStart[ NumShards + 1 ];
+	};
+
+	struct FTermPostings
+	{
+		TArray<int32> Documents;
+		TArray<int32> PositionStart;
+		TArray<int32> Positions;
+	};
+
+	struct FShard
+	{
+		TMap<FString, int32> Ids;
+		TArray<FString> Terms;
+		TArray<FTermPostings> Postings;
+	};
+
+	struct FToken
+	{
+		int32 Start;
+		int32 Length;
+		int32 Position;
+	};
+
+	static int32 GetShard( const FString& Term )
+	{
+		return GetTypeHash( Term ) & ( NumShards - 1 );
+	}
+
+	template<typename CallbackType>
+	static void ForEachToken( const FStringView Text, CallbackType&& Callback )
+	{
+		int32 Start = INDEX_NONE;
+
+		for( int32 Index = 0; Index <= Text.Len(); ++Index )
+		{
+			if( Index < Text.Len() && FChar::IsAlnum( Text[ Index ] ) )
+			{
+				Start = Start == INDEX_NONE ? Index : Start;
+				continue;
+			}
+
+			if( Start != INDEX_NONE && Index - Start <= MaxTokenLength )
+			{
+				Callback( Start, Index - Start );
+			}
+
+			Start = INDEX_NONE;
+		}
+	}
+
+	static FString FindTitle( const FMarkdownSearchSource& Source, const TArray<FMarkdownHeading>& Headings )
+	{
+		if( !Source.Title.IsEmpty() )
+		{
+			return Source.Title;
+		}
+
+		// the first of the highest level headings
+		const FMarkdownHeading* Best = nullptr;
+
+		for( const FMarkdownHeading& Heading : Headings )
+		{
+			if( Best == nullptr || Heading.Level < Best->Level )
+			{
+				Best = &Heading;
+			}
+		}
+
+		return Best != nullptr ? Best->Title : FPaths::GetBaseFilename( Source.Path );
+	}
+
+	static void IndexDocument( const FMarkdownSearchSource& Source, FMarkdownSearchDocument& OutDocument, FDocumentTerms& OutTerms )
+	{
+		TArray<FMarkdownHeading> Headings;
+		FMarkdownHeadingIndex::Build( Source.Text, Headings );
+
+		OutDocument.Path        = Source.Path;
+		OutDocument.Title       = FindTitle( Source, Headings );
+		OutDocument.ContentHash = Source.ContentHash;
+
+		// the headings and tags go in again ahead of the text, so a search can look at just them
+		FString Lowered = OutDocument.Title + TEXT( "\n" );
+		const int32 TitleLength = Lowered.Len();
+
+		for( const FMarkdownHeading& Heading : Headings )
+		{
+			Lowered += Heading.Title + TEXT( "\n" );
+		}
+
+		TArray<FString> Tags;
+		FMarkdownFrontMatter::GetTags( Source.Text, Tags );
+
+		for( const FString& Tag : Tags )
+		{
+			Lowered += Tag + TEXT( "\n" );
+		}
+
+		const int32 OutlineLength = Lowered.Len();
+
+		Lowered += Source.Text;
+		Lowered.ToLowerInline();
+
+		const FStringView Text = Lowered;
+
+		TArray<FToken> Tokens;
+		Tokens.Reserve( Lowered.Len() / 6 );
+
+		ForEachToken( Text, [&]( const int32 Start, const int32 Length )
+		{
+			OutDocument.NumTitleTokens   += Start < TitleLength ? 1 : 0;
+			OutDocument.NumOutlineTokens += Start < OutlineLength ? 1 : 0;
+			Tokens.Add( { Start, Length, Tokens.Num() } );
+		});
+
+		OutDocument.NumTokens = Tokens.Num();
+
+		// a sort puts the repeats of a term next to each other, in order, which avoids making a string per token
+		Tokens.Sort( [ &Text ]( const FToken& A, const FToken& Other )
+		{
+			const int32 Order = Text.Mid( A.Start, A.Length ).Compare( Text.Mid( Other.Start, Other.Length ), ESearchCase::CaseSensitive );
+			return Order != 0 ? Order < 0 : A.Position < Other.Position;
+		});
+
+		struct FGroup
+		{
+			int32 Shard;
+			int32 First;
+			int32 Count;
+		};
+
+		TArray<FGroup> Groups;
+
+		for( int32 Index = 0; Index < Tokens.Num(); )
+		{
+			const FStringView Term = Text.Mid( Tokens[ Index ].Start, Tokens[ Index ].Length );
+			int32 End = Index + 1;
+
+			while( End < Tokens.Num() && Text.Mid( Tokens[ End ].Start, Tokens[ End ].Length ).Equals( Term, ESearchCase::CaseSensitive ) )
+			{
+				++End;
+			}
+
+			Groups.Add( { GetShard( FString( Term ) ), Index, End - Index } );
+			Index = End;
+		}
+
+		Groups.StableSort( []( const FGroup& A, const FGroup& Other )
+		{
+			return A.Shard < Other.Shard;
+		});
+
+		OutTerms.Terms.Reserve( Groups.Num() );
+		OutTerms.PositionStart.Reserve( Groups.Num() + 1 );
+		OutTerms.Positions.Reserve( Tokens.Num() );
+
+		int32 Shard = 0;
+
+		for( const FGroup& Group : Groups )
+		{
+			while( Shard <= Group.Shard )
+			{
+				OutTerms.ShardStart[ Shard++ ] = OutTerms.Terms.Num();
+			}
+
+			OutTerms.Terms.Emplace( Text.Mid( Tokens[ Group.First ].Start, Tokens[ Group.First ].Length ) );
+			OutTerms.PositionStart.Add( OutTerms.Positions.Num() );
+
+			for( int32 Index = Group.First; Index < Group.First + Group.Count; ++Index )
+			{
+				OutTerms.Positions.Add( Tokens[ Index ].Position );
+			}
+		}
+
+		while( Shard <= NumShards )
+		{
+			OutTerms.ShardStart[ Shard++ ] = OutTerms.Terms.Num();
+		}
+
+		OutTerms.PositionStart.Add( OutTerms.Positions.Num() );
+	}
+
+	static void MergeShard( const TArray<FDocumentTerms>& DocumentTerms, const int32 ShardIndex, FShard& OutShard )
+	{
+		// documents are visited in order, so the postings of every term come out ordered by document
+		for( int32 Document = 0; Document < DocumentTerms.Num(); ++Document )
+		{
+			const FDocumentTerms& Terms = DocumentTerms[ Document ];
+
+			for( int32 Term = Terms.ShardStart[ ShardIndex ]; Term < Terms.ShardStart[ ShardIndex + 1 ]; ++Term )
+			{
+				int32& Id = OutShard.Ids.FindOrAdd( Terms.Terms[ Term ], INDEX_NONE );
+
+				if( Id == INDEX_NONE )
+				{
+					Id = OutShard.Terms.Add( Terms.Terms[ Term ] );
+					OutShard.Postings.AddDefaulted();
+				}
+
+				FTermPostings& Postings = OutShard.Postings[ Id ];
+				Postings.Documents.Add( Document );
+				Postings.PositionStart.Add( Postings.Positions.Num() );
+				Postings.Positions.Append( Terms.Positions.GetData() + Terms.PositionStart[ Term ], Terms.PositionStart[ Term + 1 ] - Terms.PositionStart[ Term ] );
+			}
+		}
+
+		OutShard.Ids.Empty();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownSearchQuery::Parse( const FStringView Query )
+{
+	Words.Reset();
+	Phrases.Reset();
+	bPrefix = false;
+
+	TArray<FString, TInlineAllocator<8>> Tokens;
+	bool bQuoted = false;
+	int32 Start  = 0;
+
+	for( int32 Index = 0; Index <= Query.Len(); ++Index )
+	{
+		if( Index < Query.Len() && Query[ Index ] != TEXT( '"' ) )
+		{
+			continue;
+		}
+
+		Tokens.Reset();
+		FMarkdownSearchSegment::Tokenize( Query.Mid( Start, Index - Start ), [ &Tokens ]( const FStringView Token )
+		{
+			Tokens.Emplace( Token );
+		});
+
+		if( bQuoted && Tokens.Num() > 1 )
+		{
+			Phrases.AddDefaulted_GetRef().Append( Tokens );
+		}
+		else
+		{
+			Words.Append( Tokens );
+
+			// the last word is still being typed, unless it is in quotes
+			bPrefix = !bQuoted && Index == Query.Len() && !Tokens.IsEmpty() && FChar::IsAlnum( Query[ Query.Len() - 1 ] );
+		}
+
+		bQuoted = !bQuoted;
+		Start   = Index + 1;
+	}
+
+	return !Words.IsEmpty() || !Phrases.IsEmpty();
+}
+
+void FMarkdownSearchStats::Finish()
+{
+	// in the order the segments keep their terms, so these are the ones a merged segment would find first
+	PrefixTerms.Sort( []( const FString& A, const FString& Other )
+	{
+		return A.Compare( Other, ESearchCase::CaseSensitive ) < 0;
+	});
+
+	PrefixTerms.SetNum( Algo::Unique( PrefixTerms, []( const FString& A, const FString& Other )
+	{
+		return A.Equals( Other, ESearchCase::CaseSensitive );
+	}));
+	PrefixTerms.SetNum( FMath::Min( PrefixTerms.Num(), MarkdownSearchSegment::MaxPrefixTerms ) );
+}
+
+float FMarkdownSearchStats::GetWeight( const FStringView Term ) const
+{
+	const float Matching = float( DocumentCounts.FindRef( FString( Term ) ) );
+	return FMath::Loge( 1.0f + ( NumDocuments - Matching + 0.5f ) / ( Matching + 0.5f ) );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct FMarkdownSearchSegment::FClause
+{
+	/** a word matches any of the terms (more than one for a prefix), a phrase has them one after the other */
+	TArray<int32, TInlineAllocator<4>> Terms;
+	TArray<float, TInlineAllocator<4>> Weights;
+	bool bPhrase = false;
+
+	/** see FMarkdownSearchQuery::bOutlineOnly */
+	bool bOutlineOnly = false;
+
+	/** to check the rarest clauses first */
+	int32 NumPostings = 0;
+};
+
+FMarkdownSearchSegment::FMarkdownSearchSegment()
+{
+	Owned.TermOffsets.Add( 0 );
+	Owned.TermStart.Add( 0 );
+	Owned.PositionStart.Add( 0 );
+}
+
+FMarkdownSearchSegment::~FMarkdownSearchSegment()
+{
+	// the views point into the region, which has to go before the file
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TSharedRef<FMarkdownSearchSegment> FMarkdownSearchSegment::Build( TArray<FMarkdownSearchSource>&& Sources )
+{
+	using namespace MarkdownSearchSegment;
+
+	TSharedRef<FMarkdownSearchSegment> Segment = MakeShareable( new FMarkdownSearchSegment() );
+	Segment->Documents.SetNum( Sources.Num() );
+
+	TArray<FDocumentTerms> DocumentTerms;
+	DocumentTerms.SetNum( Sources.Num() );
+
+	ParallelFor( Sources.Num(), [ & ]( const int32 Document )
+	{
+		IndexDocument( Sources[ Document ], Segment->Documents[ Document ], DocumentTerms[ Document ] );
+		Sources[ Document ].Text.Empty();
+	});
+
+	TArray<FShard> Shards;
+	Shards.SetNum( NumShards );
+
+	ParallelFor( NumShards, [ & ]( const int32 Shard )
+	{
+		MergeShard( DocumentTerms, Shard, Shards[ Shard ] );
+	});
+
+	DocumentTerms.Empty();
+
+	struct FTermRef
+	{
+		const FString* Term;
+		const FTermPostings* Postings;
+	};
+
+	TArray<FTermRef> Terms;
+	int32 NumPostings  = 0;
+	int32 NumPositions = 0;
+	int32 NumChars     = 0;
+
+	for( const FShard& Shard : Shards )
+	{
+		for( int32 Term = 0; Term < Shard.Terms.Num(); ++Term )
+		{
+			Terms.Add( { &Shard.Terms[ Term ], &Shard.Postings[ Term ] } );
+			NumPostings  += Shard.Postings[ Term ].Documents.Num();
+			NumPositions += Shard.Postings[ Term ].Positions.Num();
+			NumChars     += Shard.Terms[ Term ].Len();
+		}
+	}
+
+	Terms.Sort( []( const FTermRef& A, const FTermRef& Other )
+	{
+		return A.Term->Compare( *Other.Term, ESearchCase::CaseSensitive ) < 0;
+	});
+
+	FStorage& Out = Segment->Owned;
+	Out.TermChars.Reserve( NumChars );
+	Out.TermOffsets.Reserve( Terms.Num() + 1 );
+	Out.TermStart.Reserve( Terms.Num() + 1 );
+	Out.PostingDocuments.Reserve( NumPostings );
+	Out.PositionStart.Reserve( NumPostings + 1 );
+	Out.Positions.Reserve( NumPositions );
+
+	for( const FTermRef& Term : Terms )
+	{
+		const FTermPostings& Postings = *Term.Postings;
+
+		for( int32 Posting = 0; Posting < Postings.Documents.Num(); ++Posting )
+		{
+			Out.PostingDocuments.Add( Postings.Documents[ Posting ] );
+			Out.PositionStart.Add( Out.Positions.Num() + ( Posting + 1 < Postings.Documents.Num() ? Postings.PositionStart[ Posting + 1 ] : Postings.Positions.Num() ) );
+		}
+
+		Out.Positions.Append( Postings.Positions );
+		Segment->AddTerm( *Term.Term );
+	}
+
+	Segment->Finish();
+	return Segment;
+}
+
+TSharedRef<FMarkdownSearchSegment> FMarkdownSearchSegment::Merge( TConstArrayView<FMarkdownSearchSegmentRef> Segments )
+{
+	TSharedRef<FMarkdownSearchSegment> Merged = MakeShareable( new FMarkdownSearchSegment() );
+	FStorage& Out = Merged->Owned;
+
+	// the new id of each document, removed ones have none
+	TArray<TArray<int32>> DocumentIds;
+	DocumentIds.SetNum( Segments.Num() );
+
+	int32 NumChars     = 0;
+	int32 NumPostings  = 0;
+	int32 NumPositions = 0;
+
+	for( int32 Index = 0; Index < Segments.Num(); ++Index )
+	{
+		const FMarkdownSearchSegment& Segment = *Segments[ Index ].Segment;
+		const TBitArray<>& Removed = Segments[ Index ].Removed;
+
+		DocumentIds[ Index ].SetNumUninitialized( Segment.NumDocuments() );
+
+		for( int32 Document = 0; Document < Segment.NumDocuments(); ++Document )
+		{
+			const bool bRemoved = Removed.IsValidIndex( Document ) && Removed[ Document ];
+			DocumentIds[ Index ][ Document ] = bRemoved ? INDEX_NONE : Merged->Documents.Add( Segment.Documents[ Document ] );
+		}
+
+		NumChars     += Segment.TermChars.Num();
+		NumPostings  += Segment.PostingDocuments.Num();
+		NumPositions += Segment.Positions.Num();
+	}
+
+	Out.TermChars.Reserve( NumChars );
+	Out.PostingDocuments.Reserve( NumPostings );
+	Out.PositionStart.Reserve( NumPostings + 1 );
+	Out.Positions.Reserve( NumPositions );
+
+	TArray<int32, TInlineAllocator<8>> Cursors;
+	Cursors.SetNumZeroed( Segments.Num() );
+
+	for( ;; )
+	{
+		// the lowest term any segment has left
+		FStringView Term;
+		bool bFound = false;
+
+		for( int32 Index = 0; Index < Segments.Num(); ++Index )
+		{
+			const FMarkdownSearchSegment& Segment = *Segments[ Index ].Segment;
+
+			if( Cursors[ Index ] < Segment.NumTerms() )
+			{
+				const FStringView Next = Segment.GetTerm( Cursors[ Index ] );
+
+				if( !bFound || Next.Compare( Term, ESearchCase::CaseSensitive ) < 0 )
+				{
+					Term   = Next;
+					bFound = true;
+				}
+			}
+		}
+
+		if( !bFound )
+		{
+			break;
+		}
+
+		const int32 FirstPosting = Out.PostingDocuments.Num();
+
+		// segments are visited in order and their documents numbered in order, so postings stay ordered by document
+		for( int32 Index = 0; Index < Segments.Num(); ++Index )
+		{
+			const FMarkdownSearchSegment& Segment = *Segments[ Index ].Segment;
+
+			if( Cursors[ Index ] == Segment.NumTerms() || !Segment.GetTerm( Cursors[ Index ] ).Equals( Term, ESearchCase::CaseSensitive ) )
+			{
+				continue;
+			}
+
+			const int32 From = Cursors[ Index ]++;
+			const int32* Ids = DocumentIds[ Index ].GetData();
+
+			for( int32 Posting = Segment.TermStart[ From ]; Posting < Segment.TermStart[ From + 1 ]; ++Posting )
+			{
+				const int32 Document = Ids[ Segment.PostingDocuments[ Posting ] ];
+
+				if( Document == INDEX_NONE )
+				{
+					continue;
+				}
+
+				Out.PostingDocuments.Add( Document );
+				Out.Positions.Append( Segment.Positions.GetData() + Segment.PositionStart[ Posting ], Segment.PositionStart[ Posting + 1 ] - Segment.PositionStart[ Posting ] );
+				Out.PositionStart.Add( Out.Positions.Num() );
+			}
+		}
+
+		// terms only in removed documents are dropped
+		if( Out.PostingDocuments.Num() > FirstPosting )
+		{
+			Merged->AddTerm( Term );
+		}
+	}
+
+	Merged->Finish();
+	return Merged;
+}
+
+void FMarkdownSearchSegment::AddTerm( const FStringView Term )
+{
+	// closes off the postings added since the last term
+	Owned.TermChars.Append( Term.GetData(), Term.Len() );
+	Owned.TermOffsets.Add( Owned.TermChars.Num() );
+	Owned.TermStart.Add( Owned.PostingDocuments.Num() );
+}
+
+void FMarkdownSearchSegment::Finish()
+{
+	TermChars        = Owned.TermChars;
+	TermOffsets      = Owned.TermOffsets;
+	TermStart        = Owned.TermStart;
+	PostingDocuments = Owned.PostingDocuments;
+	PositionStart    = Owned.PositionStart;
+	Positions        = Owned.Positions;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownSearchSegment::Save( const FString& Filename ) const
+{
+	using namespace MarkdownSearchSegment;
+
+	const FString TempFilename = Filename + TEXT( ".tmp" );
+	TUniquePtr<FArchive> Writer( IFileManager::Get().CreateFileWriter( *TempFilename ) );
+
+	if( !Writer.IsValid() )
+	{
+		return false;
+	}
+
+	FFileHeader Header = {};
+	Header.Magic        = FileMagic;
+	Header.Version      = FileVersion;
+	Header.CharSize     = sizeof( TCHAR );
+	Header.NumDocuments = Documents.Num();
+
+	// filled in once the offsets are known
+	Writer->Serialize( &Header, sizeof( Header ) );
+
+	auto WriteArray = [ &Writer, &Header ]( const EFileArray Array, const void* Data, const int32 Count )
+	{
+		// written as they are in memory, aligned so they can be used in place once mapped
+		static uint8 Padding[ 8 ] = {};
+		Writer->Serialize( Padding, Align( Writer->Tell(), 8 ) - Writer->Tell() );
+
+		Header.Offsets[ Array ] = Writer->Tell();
+		Header.Counts[ Array ]  = Count;
+		Writer->Serialize( const_cast<void*>( Data ), Count * ElementSizes[ Array ] );
+	};
+
+	WriteArray( TermCharsArray, TermChars.GetData(), TermChars.Num() );
+	WriteArray( TermOffsetsArray, TermOffsets.GetData(), TermOffsets.Num() );
+	WriteArray( TermStartArray, TermStart.GetData(), TermStart.Num() );
+	WriteArray( PostingDocumentsArray, PostingDocuments.GetData(), PostingDocuments.Num() );
+	WriteArray( PositionStartArray, PositionStart.GetData(), PositionStart.Num() );
+	WriteArray( PositionsArray, Positions.GetData(), Positions.Num() );
+
+	Header.DocumentsOffset = Writer->Tell();
+
+	for( const FMarkdownSearchDocument& Document : Documents )
+	{
+		SerializeDocument( *Writer, const_cast<FMarkdownSearchDocument&>( Document ) );
+	}
+
+	Writer->Seek( 0 );
+	Writer->Serialize( &Header, sizeof( Header ) );
+
+	const bool bWritten = Writer->Close();
+	Writer.Reset();
+
+	if( !bWritten || !IFileManager::Get().Move( *Filename, *TempFilename, true, true, false, true ) )
+	{
+		IFileManager::Get().Delete( *TempFilename, false, false, true );
+		return false;
+	}
+
+	return true;
+}
+
+TSharedPtr<FMarkdownSearchSegment> FMarkdownSearchSegment::Load( const FString& Filename )
+{
+	using namespace MarkdownSearchSegment;
+
+	TUniquePtr<IMappedFileHandle> File( FPlatformFileManager::Get().GetPlatformFile().OpenMapped( *Filename ) );
+
+	if( !File.IsValid() || File->GetFileSize() < int64( sizeof( FFileHeader ) ) )
+	{
+		return nullptr;
+	}
+
+	const int64 Size = File->GetFileSize();
+	TUniquePtr<IMappedFileRegion> Region( File->MapRegion( 0, Size ) );
+
+	if( !Region.IsValid() )
+	{
+		return nullptr;
+	}
+
+	const uint8* Data = Region->GetMappedPtr();
+
+	FFileHeader Header;
+	FMemory::Memcpy( &Header, Data, sizeof( Header ) );
+
+	if( Header.Magic != FileMagic || Header.Version != FileVersion || Header.CharSize != sizeof( TCHAR ) || Header.NumDocuments < 0 ||
+		Header.DocumentsOffset < int64( sizeof( Header ) ) || Header.DocumentsOffset > Size )
+	{
+		return nullptr;
+	}
+
+	for( int32 Array = 0; Array < NumFileArrays; ++Array )
+	{
+		const int64 Offset = Header.Offsets[ Array ];
+		const int64 Count  = Header.Counts[ Array ];
+
+		if( Offset < int64( sizeof( Header ) ) || Offset % 8 != 0 || Count < 0 || Count > MAX_int32 || Offset + Count * ElementSizes[ Array ] > Size )
+		{
+			return nullptr;
+		}
+	}
+
+	TSharedRef<FMarkdownSearchSegment> Segment = MakeShareable( new FMarkdownSearchSegment() );
+	Segment->TermChars        = MapArray<TCHAR>( Data, Header, TermCharsArray );
+	Segment->TermOffsets      = MapArray<int32>( Data, Header, TermOffsetsArray );
+	Segment->TermStart        = MapArray<int32>( Data, Header, TermStartArray );
+	Segment->PostingDocuments = MapArray<int32>( Data, Header, PostingDocumentsArray );
+	Segment->PositionStart    = MapArray<int32>( Data, Header, PositionStartArray );
+	Segment->Positions        = MapArray<int32>( Data, Header, PositionsArray );
+
+	// the arrays are used in place without reading them through, but they have to at least agree on their sizes
+	const int32 NumTerms = Segment->TermStart.Num() - 1;
+
+	if( NumTerms < 0 || Segment->TermOffsets.Num() != NumTerms + 1 || Segment->PositionStart.Num() != Segment->PostingDocuments.Num() + 1 ||
+		Segment->TermOffsets[ NumTerms ] != Segment->TermChars.Num() || Segment->TermStart[ NumTerms ] != Segment->PostingDocuments.Num() ||
+		Segment->PositionStart.Last() != Segment->Positions.Num() )
+	{
+		return nullptr;
+	}
+
+	FMemoryReaderView Reader( FMemoryView( Data + Header.DocumentsOffset, Size - Header.DocumentsOffset ) );
+	Segment->Documents.SetNum( Header.NumDocuments );
+
+	for( FMarkdownSearchDocument& Document : Segment->Documents )
+	{
+		SerializeDocument( Reader, Document );
+	}
+
+	if( Reader.IsError() )
+	{
+		return nullptr;
+	}
+
+	Segment->MappedFile   = MoveTemp( File );
+	Segment->MappedRegion = MoveTemp( Region );
+
+	return Segment;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownSearchSegment::Tokenize( const FStringView Text, TFunctionRef<void( FStringView )> Callback )
+{
+	MarkdownSearchSegment::ForEachToken( Text, [ & ]( const int32 Start, const int32 Length )
+	{
+		TCHAR Token[ MarkdownSearchSegment::MaxTokenLength ];
+
+		for( int32 Index = 0; Index < Length; ++Index )
+		{
+			Token[ Index ] = FChar::ToLower( Text[ Start + Index ] );
+		}
+
+		Callback( FStringView( Token, Length ) );
+	});
+}
+
+int32 FMarkdownSearchSegment::LowerBound( const FStringView Term ) const
+{
+	int32 First = 0;
+	int32 Count = NumTerms();
+
+	while( Count > 0 )
+	{
+		const int32 Step = Count / 2;
+
+		if( GetTerm( First + Step ).Compare( Term, ESearchCase::CaseSensitive ) < 0 )
+		{
+			First += Step + 1;
+			Count -= Step + 1;
+		}
+		else
+		{
+			Count = Step;
+		}
+	}
+
+	return First;
+}
+
+int32 FMarkdownSearchSegment::FindTerm( const FStringView Term ) const
+{
+	const int32 Found = LowerBound( Term );
+	return Found < NumTerms() && GetTerm( Found ).Equals( Term, ESearchCase::CaseSensitive ) ? Found : INDEX_NONE;
+}
+
+void FMarkdownSearchSegment::ForEachPrefixTerm( const FStringView Prefix, TFunctionRef<void( int32 )> Callback ) const
+{
+	const int32 First = LowerBound( Prefix );
+	const int32 Last  = FMath::Min( NumTerms(), First + MarkdownSearchSegment::MaxPrefixTerms );
+
+	for( int32 Term = First; Term < Last && GetTerm( Term ).StartsWith( Prefix, ESearchCase::CaseSensitive ); ++Term )
+	{
+		Callback( Term );
+	}
+}
+
+SIZE_T FMarkdownSearchSegment::GetAllocatedSize() const
+{
+	SIZE_T Size = Documents.GetAllocatedSize();
+
+	for( const FMarkdownSearchDocument& Document : Documents )
+	{
+		Size += Document.Path.GetAllocatedSize() + Document.Title.GetAllocatedSize();
+	}
+
+	return Size + Owned.TermChars.GetAllocatedSize() + Owned.TermOffsets.GetAllocatedSize() + Owned.TermStart.GetAllocatedSize() +
+		Owned.PostingDocuments.GetAllocatedSize() + Owned.PositionStart.GetAllocatedSize() + Owned.Positions.GetAllocatedSize();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float FMarkdownSearchSegment::Score( const int32 Document, const float Weight, const int32 Frequency, const bool bInTitle, const float AverageTokens ) const
+{
+	using namespace MarkdownSearchSegment;
+
+	const float Length = float( Documents[ Document ].NumTokens ) / FMath::Max( AverageTokens, 1.0f );
+	const float Score  = Weight * Frequency * ( K1 + 1.0f ) / ( Frequency + K1 * ( 1.0f - B + B * Length ) );
+
+	return bInTitle ? Score * TitleWeight : Score;
+}
+
+void FMarkdownSearchSegment::ScoreWords( const FClause& Clause, const uint8 ClauseIndex, const float AverageTokens, TArray<float>& Scores, TArray<uint8>& Matched ) const
+{
+	// the loops below run over every posting of a term, so they skip the range checks
+	const int32* Postings = PostingDocuments.GetData();
+	const int32* Starts   = PositionStart.GetData();
+	const int32* Hits     = Positions.GetData();
+	uint8* Matches        = Matched.GetData();
+
+	for( int32 Index = 0; Index < Clause.Terms.Num(); ++Index )
+	{
+		const int32 Term   = Clause.Terms[ Index ];
+		const float Weight = Clause.Weights[ Index ];
+
+		for( int32 Posting = TermStart[ Term ]; Posting < TermStart[ Term + 1 ]; ++Posting )
+		{
+			const int32 Document = Postings[ Posting ];
+
+			// missed an earlier clause
+			if( Matches[ Document ] < ClauseIndex )
+			{
+				continue;
+			}
+
+			int32 Frequency     = Starts[ Posting + 1 ] - Starts[ Posting ];
+			const bool bInTitle = Hits[ Starts[ Posting ] ] < Documents[ Document ].NumTitleTokens;
+
+			if( Clause.bOutlineOnly )
+			{
+				// positions are in order, so the ones in the outline come first
+				int32 InOutline = 0;
+
+				while( InOutline < Frequency && Hits[ Starts[ Posting ] + InOutline ] < Documents[ Document ].NumOutlineTokens )
+				{
+					++InOutline;
+				}
+
+				if( InOutline == 0 )
+				{
+					continue;
+				}
+
+				Frequency = InOutline;
+			}
+
+			Matches[ Document ] = ClauseIndex + 1;
+			Scores[ Document ] += Score( Document, Weight, Frequency, bInTitle, AverageTokens );
+		}
+	}
+}
+
+void FMarkdownSearchSegment::ScorePhrase( const FClause& Clause, const uint8 ClauseIndex, const float AverageTokens, TArray<float>& Scores, TArray<uint8>& Matched ) const
+{
+	const int32* Postings = PostingDocuments.GetData();
+	const int32* Starts   = PositionStart.GetData();
+	const int32* Hits     = Positions.GetData();
+	uint8* Matches        = Matched.GetData();
+
+	// the rarest term of the phrase picks the documents, the postings of the others are walked alongside it
+	int32 Anchor = 0;
+	float Weight = 0.0f;
+
+	TArray<int32, TInlineAllocator<8>> Cursors;
+	TArray<int32, TInlineAllocator<8>> Ends;
+	TArray<int32, TInlineAllocator<8>> HitCursors;
+
+	for( int32 Index = 0; Index < Clause.Terms.Num(); ++Index )
+	{
+		const int32 Term = Clause.Terms[ Index ];
+		Weight += Clause.Weights[ Index ];
+		Cursors.Add( TermStart[ Term ] );
+		Ends.Add( TermStart[ Term + 1 ] );
+		HitCursors.Add( 0 );
+
+		if( Ends[ Index ] - Cursors[ Index ] < Ends[ Anchor ] - Cursors[ Anchor ] )
+		{
+			Anchor = Index;
+		}
+	}
+
+	const int32 NumTerms = Cursors.Num();
+
+	for( int32 Posting = Cursors[ Anchor ]; Posting < Ends[ Anchor ]; ++Posting )
+	{
+		const int32 Document = Postings[ Posting ];
+
+		if( Matches[ Document ] < ClauseIndex )
+		{
+			continue;
+		}
+
+		bool bInDocument = true;
+
+		for( int32 Index = 0; bInDocument && Index < NumTerms; ++Index )
+		{
+			int32& Cursor = Cursors[ Index ];
+
+			while( Cursor < Ends[ Index ] && Postings[ Cursor ] < Document )
+			{
+				++Cursor;
+			}
+
+			// past the last document with this term, nothing further on can match
+			if( Cursor == Ends[ Index ] )
+			{
+				return;
+			}
+
+			bInDocument = Postings[ Cursor ] == Document;
+			HitCursors[ Index ] = Starts[ Cursor ];
+		}
+
+		if( !bInDocument )
+		{
+			continue;
+		}
+
+		// positions are in order too, so they are walked the same way
+		int32 Frequency = 0;
+		bool bInTitle   = false;
+
+		for( int32 Hit = Starts[ Posting ]; Hit < Starts[ Posting + 1 ]; ++Hit )
+		{
+			const int32 Start = Hits[ Hit ] - Anchor;
+			bool bMatch = Start >= 0;
+
+			for( int32 Index = 0; bMatch && Index < NumTerms; ++Index )
+			{
+				int32& Cursor   = HitCursors[ Index ];
+				const int32 End = Starts[ Cursors[ Index ] + 1 ];
+
+				while( Cursor < End && Hits[ Cursor ] < Start + Index )
+				{
+					++Cursor;
+				}
+
+				bMatch = Cursor < End && Hits[ Cursor ] == Start + Index;
+			}
+
+			if( bMatch && Clause.bOutlineOnly && Start + NumTerms > Documents[ Document ].NumOutlineTokens )
+			{
+				break;
+			}
+
+			if( bMatch )
+			{
+				bInTitle |= Start < Documents[ Document ].NumTitleTokens;
+				++Frequency;
+			}
+		}
+
+		if( Frequency > 0 )
+		{
+			Matches[ Document ] = ClauseIndex + 1;
+			Scores[ Document ] += Score( Document, Weight, Frequency, bInTitle, AverageTokens );
+		}
+	}
+}
+
+void FMarkdownSearchSegment::CountDocuments( const FMarkdownSearchQuery& Query, const TBitArray<>& Removed, FMarkdownSearchStats& InOutStats ) const
+{
+	const bool bAnyRemoved = Removed.Find( true ) != INDEX_NONE;
+
+	// a word can be in the query more than once, but its documents only count once
+	TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<32>> Counted;
+
+	auto Count = [ & ]( const int32 Term )
+	{
+		bool bCounted = false;
+		Counted.Add( Term, &bCounted );
+
+		if( bCounted )
+		{
+			return;
+		}
+
+		int32 NumMatching = TermStart[ Term + 1 ] - TermStart[ Term ];
+
+		if( bAnyRemoved )
+		{
+			for( int32 Posting = TermStart[ Term ]; Posting < TermStart[ Term + 1 ]; ++Posting )
+			{
+				NumMatching -= Removed[ PostingDocuments[ Posting ] ] ? 1 : 0;
+			}
+		}
+
+		InOutStats.DocumentCounts.FindOrAdd( FString( GetTerm( Term ) ) ) += NumMatching;
+	};
+
+	for( int32 Word = 0; Word < Query.Words.Num(); ++Word )
+	{
+		if( Query.bPrefix && Word + 1 == Query.Words.Num() )
+		{
+			ForEachPrefixTerm( Query.Words[ Word ], [ & ]( const int32 Term )
+			{
+				InOutStats.PrefixTerms.Add( FString( GetTerm( Term ) ) );
+				Count( Term );
+			});
+		}
+		else if( const int32 Term = FindTerm( Query.Words[ Word ] ); Term != INDEX_NONE )
+		{
+			Count( Term );
+		}
+	}
+
+	for( const TArray<FString>& Phrase : Query.Phrases )
+	{
+		for( const FString& Word : Phrase )
+		{
+			if( const int32 Term = FindTerm( Word ); Term != INDEX_NONE )
+			{
+				Count( Term );
+			}
+		}
+	}
+}
+
+void FMarkdownSearchSegment::Search( const FMarkdownSearchQuery& Query, const FMarkdownSearchStats& Stats, const TBitArray<>& Removed, const int32 MaxResults, TArray<FMarkdownSearchHit>& OutHits ) const
+{
+	using namespace MarkdownSearchSegment;
+
+	OutHits.Reset();
+
+	if( Documents.IsEmpty() || MaxResults <= 0 )
+	{
+		return;
+	}
+
+	TArray<FClause, TInlineAllocator<8>> Clauses;
+
+	auto AddClauseTerm = [ this, &Stats ]( FClause& Clause, const int32 Term )
+	{
+		Clause.Terms.Add( Term );
+		Clause.Weights.Add( Stats.GetWeight( GetTerm( Term ) ) );
+	};
+
+	for( int32 Word = 0; Word < Query.Words.Num(); ++Word )
+	{
+		FClause& Clause = Clauses.AddDefaulted_GetRef();
+		Clause.bOutlineOnly = Query.bOutlineOnly;
+
+		if( Query.bPrefix && Word + 1 == Query.Words.Num() )
+		{
+			// the terms the prefix matches in any of the segments, so every segment stops at the same ones
+			for( const FString& PrefixTerm : Stats.PrefixTerms )
+			{
+				if( const int32 Term = FindTerm( PrefixTerm ); Term != INDEX_NONE )
+				{
+					AddClauseTerm( Clause, Term );
+					Clause.NumPostings += TermStart[ Term + 1 ] - TermStart[ Term ];
+				}
+			}
+		}
+		else if( const int32 Term = FindTerm( Query.Words[ Word ] ); Term != INDEX_NONE )
+		{
+			AddClauseTerm( Clause, Term );
+			Clause.NumPostings = TermStart[ Term + 1 ] - TermStart[ Term ];
+		}
+
+		if( Clause.Terms.IsEmpty() )
+		{
+			return;
+		}
+	}
+
+	for( const TArray<FString>& Phrase : Query.Phrases )
+	{
+		FClause& Clause = Clauses.AddDefaulted_GetRef();
+		Clause.bPhrase      = true;
+		Clause.bOutlineOnly = Query.bOutlineOnly;
+		Clause.NumPostings  = MAX_int32;
+
+		for( const FString& Word : Phrase )
+		{
+			const int32 Term = FindTerm( Word );
+
+			if( Term == INDEX_NONE )
+			{
+				return;
+			}
+
+			AddClauseTerm( Clause, Term );
+			Clause.NumPostings = FMath::Min( Clause.NumPostings, TermStart[ Term + 1 ] - TermStart[ Term ] );
+		}
+	}
+
+	if( Clauses.IsEmpty() )
+	{
+		return;
+	}
+
+	Clauses.Sort( []( const FClause& A, const FClause& Other )
+	{
+		return A.NumPostings < Other.NumPostings;
+	});
+
+	Clauses.SetNum( FMath::Min( Clauses.Num(), MaxClauses ) );
+
+	// a score and the number of clauses matched per document, which is cheaper than sets at any size that matters
+	TArray<float> Scores;
+	TArray<uint8> Matched;
+	Scores.SetNumZeroed( Documents.Num() );
+	Matched.SetNumZeroed( Documents.Num() );
+
+	for( int32 Clause = 0; Clause < Clauses.Num(); ++Clause )
+	{
+		if( Clauses[ Clause ].bPhrase )
+		{
+			ScorePhrase( Clauses[ Clause ], uint8( Clause ), Stats.AverageTokens, Scores, Matched );
+		}
+		else
+		{
+			ScoreWords( Clauses[ Clause ], uint8( Clause ), Stats.AverageTokens, Scores, Matched );
+		}
+	}
+
+	// the best MaxResults, with the worst of them on top of the heap. Ties go to the earlier document
+	auto Worse = []( const FMarkdownSearchHit& A, const FMarkdownSearchHit& Other )
+	{
+		return A.Score != Other.Score ? A.Score < Other.Score : A.Document > Other.Document;
+	};
+
+	for( int32 Document = 0; Document < Documents.Num(); ++Document )
+	{
+		if( Matched[ Document ] != Clauses.Num() || ( Removed.IsValidIndex( Document ) && Removed[ Document ] ) )
+		{
+			continue;
+		}
+
+		if( OutHits.Num() < MaxResults )
+		{
+			OutHits.HeapPush( { 0, Document, Scores[ Document ] }, Worse );
+		}
+		else if( Scores[ Document ] > OutHits.HeapTop().Score )
+		{
+			OutHits.HeapPopDiscard( Worse );
+			OutHits.HeapPush( { 0, Document, Scores[ Document ] }, Worse );
+		}
+	}
+
+	OutHits.Sort( []( const FMarkdownSearchHit& A, const FMarkdownSearchHit& Other )
+	{
+		return A.Score != Other.Score ? A.Score > Other.Score : A.Document < Other.Document;
+	});
+}
@@ -0,0 +1,716 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Search/MarkdownSearchSubsystem.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "ContentBrowser/MarkdownContentBrowserHierarchy.h"
+#include "DirectoryWatcherModule.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Hash/CityHash.h"
+#include "HAL/PlatformTime.h"
+#include "IDirectoryWatcher.h"
+#include "IO/IoHash.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetEditorSettings.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Modules/ModuleManager.h"
+#include "Tasks/Task.h"
+#include "UObject/UObjectHash.h"
+
+#include <atomic>
+
+/** A build, update or merge of the index. */
+struct FMarkdownSearchJob
+{
+	/** read by the workers */
+	std::atomic<bool> bCancelled = false;
+
+	/** everything from scratch, rather than changes added to the current index */
+	bool bRebuild = false;
+
+	/** the saved index checked against the whole project, for changes made while the editor was closed */
+	bool bRefresh = false;
+
+	/** the segments of the current index merged into one */
+	bool bMerge = false;
+
+	bool bLoaded = false;
+
+	/** assets to load and index, with the saved hash of their packages */
+	TArray<FSoftObjectPath> Assets;
+	TArray<uint64> AssetHashes;
+	TSharedPtr<FStreamableHandle> Handle;
+
+	TArray<FMarkdownSearchSource> Sources;
+
+	/** .md files to read on the workers */
+	TArray<FString> Files;
+
+	/** documents to take out of the current index */
+	TArray<FString> Removed;
+
+	/** every markdown asset in the project, for a refresh to find the ones deleted while the editor was closed */
+	TSet<FString> AllAssets;
+
+	/** names the file of the segment the job makes */
+	int32 SegmentId = 0;
+
+	/** documents indexed again or taken out */
+	int32 NumChanged = 0;
+
+	double Seconds = 0.0;
+};
+
+namespace MarkdownSearchSubsystem
+{
+	// each update adds a segment, and every segment is another search
+	static constexpr int32 MaxSegments = 8;
+
+	// held while the index is saved, and to cancel a job, so a cancelled job never overwrites the index of a later one
+	static FCriticalSection SaveLock;
+
+	static bool IsFile( const FString& Path )
+	{
+		// object paths never end in .md, the object name would have to have a dot in it
+		return Path.EndsWith( TEXT( ".md" ) );
+	}
+
+	static uint64 HashText( const FString& Text )
+	{
+		return CityHash64( reinterpret_cast<const char*>( *Text ), Text.Len() * sizeof( TCHAR ) );
+	}
+
+	static uint64 GetPackageHash( const IAssetRegistry& AssetRegistry, const FName PackageName )
+	{
+		// assets can be checked for changes without loading them, 0 leaves them to be indexed again
+		const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy( PackageName );
+
+		if( !PackageData.IsSet() || PackageData->GetPackageSavedHash().IsZero() )
+		{
+			return 0;
+		}
+
+		return CityHash64( reinterpret_cast<const char*>( PackageData->GetPackageSavedHash().GetBytes() ), sizeof( FIoHash::ByteArray ) );
+	}
+
+	static void ReadFiles( const TArray<FString>& Files, TArray<FMarkdownSearchSource>& OutSources )
+	{
+		const int32 First = OutSources.Num();
+		OutSources.SetNum( First + Files.Num() );
+
+		ParallelFor( Files.Num(), [ & ]( const int32 Index )
+		{
+			FMarkdownSearchSource& Source = OutSources[ First + Index ];
+
+			if( FFileHelper::LoadFileToString( Source.Text, *FMarkdownContentBrowserHierarchy::ConvertInternalPathToFileSystemPath( Files[ Index ] ) ) )
+			{
+				Source.Path        = Files[ Index ];
+				Source.ContentHash = HashText( Source.Text );
+			}
+		});
+
+		// files that could not be read have gone since they were found
+		OutSources.RemoveAll( []( const FMarkdownSearchSource& Source )
+		{
+			return Source.Path.IsEmpty();
+		});
+	}
+
+	static void FindChanges( const FMarkdownSearchIndex& Base, FMarkdownSearchJob& Job )
+	{
+		TSet<FString> Read;
+
+		for( const FMarkdownSearchSource& Source : Job.Sources )
+		{
+			Read.Add( Source.Path );
+		}
+
+		// files that could not be read have gone
+		for( const FString& File : Job.Files )
+		{
+			if( !Read.Contains( File ) )
+			{
+				Job.Removed.Add( File );
+			}
+		}
+
+		// a refresh has seen every file and asset, anything else was deleted while the editor was closed
+		if( Job.bRefresh )
+		{
+			Base.ForEachDocument( [ & ]( const FMarkdownSearchDocument& Document )
+			{
+				if( IsFile( Document.Path ) ? !Read.Contains( Document.Path ) : !Job.AllAssets.Contains( Document.Path ) )
+				{
+					Job.Removed.Add( Document.Path );
+				}
+			});
+		}
+
+		// unchanged documents stay where they are, changed ones replace the old version
+		Job.Sources.RemoveAll( [ &Base ]( const FMarkdownSearchSource& Source )
+		{
+			const FMarkdownSearchDocument* Document = Base.FindDocument( Source.Path );
+			return Document != nullptr && Source.ContentHash != 0 && Document->ContentHash == Source.ContentHash;
+		});
+
+		TSet<FString> Removed( Job.Removed );
+
+		for( const FMarkdownSearchSource& Source : Job.Sources )
+		{
+			Removed.Add( Source.Path );
+		}
+
+		Job.Removed.Reset();
+
+		for( const FString& Path : Removed )
+		{
+			if( Base.FindDocument( Path ) != nullptr )
+			{
+				Job.Removed.Add( Path );
+			}
+		}
+
+		Job.NumChanged = Removed.Num();
+	}
+
+	static TSharedRef<FMarkdownSearchIndex> MakeIndex( const TSharedRef<FMarkdownSearchSegment>& Segment, const int32 Id )
+	{
+		TArray<FMarkdownSearchSegmentRef> Segments;
+		Segments.Add( { Segment, TBitArray<>( false, Segment->NumDocuments() ), Id } );
+
+		return MakeShared<FMarkdownSearchIndex>( MoveTemp( Segments ) );
+	}
+
+	static bool ShouldMerge( const FMarkdownSearchIndex& Index )
+	{
+		const TArray<FMarkdownSearchSegmentRef>& Segments = Index.GetSegments();
+
+		if( Segments.Num() > MaxSegments )
+		{
+			return true;
+		}
+
+		int32 Total   = 0;
+		int32 Removed = 0;
+
+		for( const FMarkdownSearchSegmentRef& Segment : Segments )
+		{
+			Total   += Segment.Segment->NumDocuments();
+			Removed += Segment.Removed.CountSetBits();
+		}
+
+		// a merge costs about as much as a build, so it waits for the deltas and deleted documents to add up
+		const int32 Changed = Segments.IsEmpty() ? 0 : Total - Segments[ 0 ].Segment->NumDocuments() + Removed;
+		return Changed * 4 > Total;
+	}
+
+	static void SaveIndex( const FMarkdownSearchJob& Job, const FString& Directory, const FMarkdownSearchSegment* Segment, const FMarkdownSearchIndex& Index )
+	{
+		// the segment is not part of the saved index until the list of segments is written, so only that waits on the lock
+		if( Segment != nullptr && !Segment->Save( FMarkdownSearchIndex::GetSegmentFilename( Directory, Job.SegmentId ) ) )
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown search: could not save the index to %s" ), *Directory );
+			return;
+		}
+
+		FScopeLock Lock( &SaveLock );
+
+		if( !Job.bCancelled && !Index.Save( Directory ) )
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown search: could not save the index to %s" ), *Directory );
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownSearchSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	if( IsRunningCommandlet() || !GetDefault<UMarkdownAssetEditorSettings>()->ShouldIndexDocumentation() )
+	{
+		return;
+	}
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	AssetRegistry.OnAssetRemoved().AddUObject( this, &UMarkdownSearchSubsystem::HandleAssetRemoved );
+	AssetRegistry.OnAssetRenamed().AddUObject( this, &UMarkdownSearchSubsystem::HandleAssetRenamed );
+
+	UPackage::PackageSavedWithContextEvent.AddUObject( this, &UMarkdownSearchSubsystem::HandlePackageSaved );
+
+	// the saved index can be searched straight away, it is checked for changes once the asset registry is ready
+	const double Start = FPlatformTime::Seconds();
+	IndexDirectory = FPaths::ProjectIntermediateDir() / TEXT( "MarkdownSearch" );
+	Index = FMarkdownSearchIndex::Load( IndexDirectory );
+
+	if( Index.IsValid() )
+	{
+		for( const FMarkdownSearchSegmentRef& Segment : Index->GetSegments() )
+		{
+			NextSegmentId = FMath::Max( NextSegmentId, Segment.Id + 1 );
+		}
+
+		UE_LOG( MarkdownEditorLog, Log, TEXT( "Markdown search: loaded %d documents in %d segments in %.1f ms" ),
+			Index->NumDocuments(), Index->GetSegments().Num(), ( FPlatformTime::Seconds() - Start ) * 1000.0 );
+	}
+
+	// picks up edits made outside the editor as well as the ones saved from it
+	WatchedDirectory = FPaths::ConvertRelativePathToFull( FPaths::ProjectDir() / TEXT( "Documentation" ) );
+
+	if( IDirectoryWatcher* DirectoryWatcher = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>( TEXT( "DirectoryWatcher" ) ).Get() )
+	{
+		DirectoryWatcher->RegisterDirectoryChangedCallback_Handle( WatchedDirectory,
+			IDirectoryWatcher::FDirectoryChanged::CreateUObject( this, &UMarkdownSearchSubsystem::HandleDirectoryChanged ), DirectoryChangedHandle );
+	}
+
+	if( AssetRegistry.IsLoadingAssets() )
+	{
+		AssetRegistry.OnFilesLoaded().AddUObject( this, &UMarkdownSearchSubsystem::HandleFilesLoaded );
+	}
+	else
+	{
+		HandleFilesLoaded();
+	}
+}
+
+void UMarkdownSearchSubsystem::Deinitialize()
+{
+	CancelJob();
+
+	if( IAssetRegistry* AssetRegistry = IAssetRegistry::Get() )
+	{
+		AssetRegistry->OnFilesLoaded().RemoveAll( this );
+		AssetRegistry->OnAssetRemoved().RemoveAll( this );
+		AssetRegistry->OnAssetRenamed().RemoveAll( this );
+	}
+
+	UPackage::PackageSavedWithContextEvent.RemoveAll( this );
+
+	if( DirectoryChangedHandle.IsValid() )
+	{
+		if( FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>( TEXT( "DirectoryWatcher" ) ) )
+		{
+			DirectoryWatcherModule->Get()->UnregisterDirectoryChangedCallback_Handle( WatchedDirectory, DirectoryChangedHandle );
+		}
+
+		DirectoryChangedHandle.Reset();
+	}
+
+	Index.Reset();
+	bIndexChecked = false;
+	PendingChanges.Empty();
+
+	Super::Deinitialize();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TArray<FMarkdownSearchResult> UMarkdownSearchSubsystem::Search( const FString& Query, const int32 MaxResults ) const
+{
+	TArray<FMarkdownSearchResult> Results;
+
+	if( !Index.IsValid() )
+	{
+		return Results;
+	}
+
+	TArray<FMarkdownSearchHit> Hits;
+	Index->Search( Query, MaxResults, Hits );
+
+	Results.Reserve( Hits.Num() );
+
+	for( const FMarkdownSearchHit& Hit : Hits )
+	{
+		const FMarkdownSearchDocument& Document = Index->GetDocument( Hit );
+
+		FMarkdownSearchResult& Result = Results.AddDefaulted_GetRef();
+		Result.Path   = Document.Path;
+		Result.Title  = Document.Title;
+		Result.Source = MarkdownSearchSubsystem::IsFile( Document.Path ) ? EMarkdownSearchSource::File : EMarkdownSearchSource::Asset;
+		Result.Score  = Hit.Score;
+	}
+
+	return Results;
+}
+
+void UMarkdownSearchSubsystem::RebuildIndex()
+{
+	CancelJob();
+
+	// everything is read again, so the build has any earlier changes in it already
+	PendingChanges.Empty();
+
+	TSharedRef<FMarkdownSearchJob> NewJob = MakeShared<FMarkdownSearchJob>();
+	NewJob->bRebuild  = true;
+	NewJob->SegmentId = NextSegmentId++;
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssetsByClass( UMarkdownAsset::StaticClass()->GetClassPathName(), Assets, true );
+
+	for( const FAssetData& Asset : Assets )
+	{
+		NewJob->Assets.Add( Asset.GetSoftObjectPath() );
+		NewJob->AssetHashes.Add( MarkdownSearchSubsystem::GetPackageHash( AssetRegistry, Asset.PackageName ) );
+	}
+
+	Job = NewJob;
+	LoadAssets( NewJob );
+}
+
+void UMarkdownSearchSubsystem::RefreshIndex()
+{
+	TSharedRef<FMarkdownSearchJob> NewJob = MakeShared<FMarkdownSearchJob>();
+	NewJob->bRefresh  = true;
+	NewJob->SegmentId = NextSegmentId++;
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssetsByClass( UMarkdownAsset::StaticClass()->GetClassPathName(), Assets, true );
+
+	// assets are compared by the saved hash of their package, so only the ones that changed need loading
+	for( const FAssetData& Asset : Assets )
+	{
+		const FString Path = Asset.GetObjectPathString();
+		const uint64 Hash  = MarkdownSearchSubsystem::GetPackageHash( AssetRegistry, Asset.PackageName );
+		NewJob->AllAssets.Add( Path );
+
+		const FMarkdownSearchDocument* Document = Index->FindDocument( Path );
+
+		if( Hash == 0 || Document == nullptr || Document->ContentHash != Hash )
+		{
+			NewJob->Assets.Add( Asset.GetSoftObjectPath() );
+			NewJob->AssetHashes.Add( Hash );
+		}
+	}
+
+	Job = NewJob;
+	LoadAssets( NewJob );
+}
+
+void UMarkdownSearchSubsystem::MergeIndex()
+{
+	TSharedRef<FMarkdownSearchJob> NewJob = MakeShared<FMarkdownSearchJob>();
+	NewJob->bMerge    = true;
+	NewJob->SegmentId = NextSegmentId++;
+
+	Job = NewJob;
+	BuildIndex( NewJob );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownSearchSubsystem::LoadAssets( const TSharedRef<FMarkdownSearchJob>& InJob )
+{
+	if( InJob->Assets.IsEmpty() )
+	{
+		HandleAssetsLoaded( InJob );
+		return;
+	}
+
+	InJob->Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad( InJob->Assets,
+		FStreamableDelegate::CreateUObject( this, &UMarkdownSearchSubsystem::HandleAssetsLoaded, InJob ) );
+
+	// nothing needed loading, the callback may or may not have been called
+	if( !InJob->Handle.IsValid() )
+	{
+		HandleAssetsLoaded( InJob );
+	}
+}
+
+void UMarkdownSearchSubsystem::HandleAssetsLoaded( TSharedRef<FMarkdownSearchJob> InJob )
+{
+	if( InJob->bCancelled || InJob->bLoaded )
+	{
+		return;
+	}
+
+	InJob->bLoaded = true;
+
+	// texts are copied here, the workers never touch the assets
+	for( int32 AssetIndex = 0; AssetIndex < InJob->Assets.Num(); ++AssetIndex )
+	{
+		const FSoftObjectPath& Path = InJob->Assets[ AssetIndex ];
+
+		if( const UMarkdownAsset* Asset = Cast<UMarkdownAsset>( Path.ResolveObject() ) )
+		{
+			InJob->Sources.Add( { Path.ToString(), FString(), Asset->Text.ToString(), InJob->AssetHashes[ AssetIndex ] } );
+		}
+	}
+
+	// nothing else needs them, they can go at the next garbage collection
+	if( InJob->Handle.IsValid() )
+	{
+		InJob->Handle->ReleaseHandle();
+		InJob->Handle.Reset();
+	}
+
+	BuildIndex( InJob );
+}
+
+void UMarkdownSearchSubsystem::BuildIndex( const TSharedRef<FMarkdownSearchJob>& InJob )
+{
+	TWeakObjectPtr<UMarkdownSearchSubsystem> WeakThis( this );
+	TSharedPtr<const FMarkdownSearchIndex> Base = Index;
+	const FString Directory = IndexDirectory;
+
+	UE::Tasks::Launch( UE_SOURCE_LOCATION, [ WeakThis, InJob, Base, Directory ]()
+	{
+		using namespace MarkdownSearchSubsystem;
+
+		const double Start = FPlatformTime::Seconds();
+
+		TSharedPtr<const FMarkdownSearchIndex> NewIndex = Base;
+		TSharedPtr<FMarkdownSearchSegment> NewSegment;
+
+		if( InJob->bMerge )
+		{
+			NewSegment = FMarkdownSearchSegment::Merge( Base->GetSegments() );
+			NewIndex   = MakeIndex( NewSegment.ToSharedRef(), InJob->SegmentId );
+		}
+		else
+		{
+			if( InJob->bRebuild || InJob->bRefresh )
+			{
+				FMarkdownContentBrowserHierarchy::FindMDFiles( InJob->Files );
+			}
+
+			ReadFiles( InJob->Files, InJob->Sources );
+
+			if( InJob->bCancelled )
+			{
+				return;
+			}
+
+			if( InJob->bRebuild || !Base.IsValid() )
+			{
+				NewSegment = FMarkdownSearchSegment::Build( MoveTemp( InJob->Sources ) );
+				NewIndex   = MakeIndex( NewSegment.ToSharedRef(), InJob->SegmentId );
+			}
+			else
+			{
+				// only what changed goes in the new segment, if nothing did the index stays as it is
+				FindChanges( *Base, *InJob );
+
+				if( !InJob->Sources.IsEmpty() )
+				{
+					NewSegment = FMarkdownSearchSegment::Build( MoveTemp( InJob->Sources ) );
+				}
+
+				if( NewSegment.IsValid() || !InJob->Removed.IsEmpty() )
+				{
+					NewIndex = Base->Update( NewSegment, InJob->SegmentId, InJob->Removed );
+				}
+			}
+		}
+
+		if( InJob->bCancelled )
+		{
+			return;
+		}
+
+		if( NewIndex != Base )
+		{
+			SaveIndex( *InJob, Directory, NewSegment.Get(), *NewIndex );
+		}
+
+		InJob->Seconds = FPlatformTime::Seconds() - Start;
+
+		AsyncTask( ENamedThreads::GameThread, [ WeakThis, InJob, NewIndex ]()
+		{
+			if( UMarkdownSearchSubsystem* This = WeakThis.Get() )
+			{
+				This->SetIndex( InJob, NewIndex );
+			}
+		});
+	});
+}
+
+void UMarkdownSearchSubsystem::SetIndex( const TSharedRef<FMarkdownSearchJob>& InJob, const TSharedPtr<const FMarkdownSearchIndex>& InIndex )
+{
+	if( InJob->bCancelled || Job.Get() != &InJob.Get() )
+	{
+		return;
+	}
+
+	Job.Reset();
+	bIndexChecked |= InJob->bRebuild || InJob->bRefresh;
+
+	if( InJob->bRebuild )
+	{
+		UE_LOG( MarkdownEditorLog, Log, TEXT( "Markdown search: indexed %d documents, %.1f MB in %.2f s" ),
+			InIndex->NumDocuments(), InIndex->GetAllocatedSize() / ( 1024.0 * 1024.0 ), InJob->Seconds );
+	}
+	else if( InJob->bRefresh )
+	{
+		UE_LOG( MarkdownEditorLog, Log, TEXT( "Markdown search: checked the saved index in %.2f s, %d documents had changed" ), InJob->Seconds, InJob->NumChanged );
+	}
+
+	if( InIndex != Index )
+	{
+		Index = InIndex;
+		IndexChanged.Broadcast();
+	}
+
+	// changes come first, merges only happen when there is nothing else to do
+	UpdateIndex();
+
+	if( !Job.IsValid() && Index.IsValid() && MarkdownSearchSubsystem::ShouldMerge( *Index ) )
+	{
+		MergeIndex();
+	}
+}
+
+void UMarkdownSearchSubsystem::UpdateIndex()
+{
+	// changes wait for the job that is running, and until the index has been checked they would be found by that anyway
+	if( Job.IsValid() || !Index.IsValid() || !bIndexChecked || PendingChanges.IsEmpty() )
+	{
+		return;
+	}
+
+	TSharedRef<FMarkdownSearchJob> NewJob = MakeShared<FMarkdownSearchJob>();
+	NewJob->SegmentId = NextSegmentId++;
+
+	for( TPair<FString, FMarkdownSearchChange>& Change : PendingChanges )
+	{
+		if( Change.Value.bRemoved )
+		{
+			NewJob->Removed.Add( Change.Key );
+		}
+		else if( MarkdownSearchSubsystem::IsFile( Change.Key ) )
+		{
+			NewJob->Files.Add( Change.Key );
+		}
+		else
+		{
+			NewJob->Sources.Add( { Change.Key, FString(), MoveTemp( Change.Value.Text ) } );
+		}
+	}
+
+	PendingChanges.Empty();
+
+	Job = NewJob;
+	BuildIndex( NewJob );
+}
+
+void UMarkdownSearchSubsystem::CancelJob()
+{
+	if( !Job.IsValid() )
+	{
+		return;
+	}
+
+	{
+		FScopeLock Lock( &MarkdownSearchSubsystem::SaveLock );
+		Job->bCancelled = true;
+	}
+
+	if( Job->Handle.IsValid() )
+	{
+		Job->Handle->CancelHandle();
+		Job->Handle.Reset();
+	}
+
+	Job.Reset();
+}
+
+void UMarkdownSearchSubsystem::QueueChange( const FString& Path, FMarkdownSearchChange&& Change )
+{
+	PendingChanges.Add( Path, MoveTemp( Change ) );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownSearchSubsystem::HandleFilesLoaded()
+{
+	IAssetRegistry::GetChecked().OnFilesLoaded().RemoveAll( this );
+
+	if( Index.IsValid() )
+	{
+		RefreshIndex();
+	}
+	else
+	{
+		RebuildIndex();
+	}
+}
+
+void UMarkdownSearchSubsystem::HandleAssetRemoved( const FAssetData& AssetData )
+{
+	if( AssetData.IsInstanceOf( UMarkdownAsset::StaticClass() ) )
+	{
+		QueueChange( AssetData.GetObjectPathString(), { true } );
+		UpdateIndex();
+	}
+}
+
+void UMarkdownSearchSubsystem::HandleAssetRenamed( const FAssetData& AssetData, const FString& OldObjectPath )
+{
+	if( !AssetData.IsInstanceOf( UMarkdownAsset::StaticClass() ) )
+	{
+		return;
+	}
+
+	QueueChange( OldObjectPath, { true } );
+
+	// renamed assets are loaded, otherwise it will be indexed when it is saved under the new name
+	if( const UMarkdownAsset* Asset = Cast<UMarkdownAsset>( AssetData.FastGetAsset( false ) ) )
+	{
+		QueueChange( AssetData.GetObjectPathString(), { false, Asset->Text.ToString() } );
+	}
+
+	UpdateIndex();
+}
+
+void UMarkdownSearchSubsystem::HandlePackageSaved( const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext )
+{
+	if( SaveContext.IsProceduralSave() )
+	{
+		return;
+	}
+
+	ForEachObjectWithPackage( Package, [ this ]( UObject* Object )
+	{
+		// the asset registry may not have the package's new hash yet, so the document gets none and the asset is checked
+		// again at the next refresh
+		if( const UMarkdownAsset* Asset = Cast<UMarkdownAsset>( Object ) )
+		{
+			QueueChange( Asset->GetPathName(), { false, Asset->Text.ToString() } );
+		}
+
+		return true;
+	}, false );
+
+	UpdateIndex();
+}
+
+void UMarkdownSearchSubsystem::HandleDirectoryChanged( const TArray<FFileChangeData>& FileChanges )
+{
+	for( const FFileChangeData& FileChange : FileChanges )
+	{
+		if( !MarkdownSearchSubsystem::IsFile( FileChange.Filename ) )
+		{
+			continue;
+		}
+
+		const FString Path = FMarkdownContentBrowserHierarchy::ConvertFileSystemPathToInternalPath( FileChange.Filename );
+
+		if( !Path.IsEmpty() )
+		{
+			QueueChange( Path, { FileChange.Action == FFileChangeData::FCA_Removed } );
+		}
+	}
+
+	UpdateIndex();
+}
@@ -27,6 +27,42 @@ public:
 		return bAutoOpenNewlyCreatedFiles;
 	}
 
+	int32 GetBrowserPoolSize() const
+	{
+		return BrowserPoolSize;
+	}
+
+	float GetBrowserPoolIdleTimeout() const
+	{
+		return BrowserPoolIdleTimeout;
+	}
+
+	bool ShouldSuspendHiddenTabs() const
+	{
+		return bSuspendHiddenTabs;
+	}
+
+	float GetHiddenTabSuspendDelay() const
+	{
+		return HiddenTabSuspendDelay;
+	}
+
+	bool ShouldOpenInReadingView() const
+	{
+		return bOpenInReadingView;
+	}
+
+	/** In bytes. */
+	int64 GetRenderCacheSize() const
+	{
+		return int64( RenderCacheSize ) * 1024 * 1024;
+	}
+
+	bool ShouldIndexDocumentation() const
+	{
+		return bIndexDocumentation;
+	}
+
 	//NOTE (Maxi): Keeping this public so I don't mess with the current code using this directly. Might be refactored later.
 	UPROPERTY( config, EditAnywhere, Category = Appearance )
 	bool bDarkSkin;
@@ -45,4 +81,35 @@ protected:
 	 * Untested. */
 	UPROPERTY(Config, EditDefaultsOnly, Category=Memory, AdvancedDisplay)
 	bool bShouldCacheMarkdownFiles = false;
+
+	/** Number of browsers kept with the viewer already loaded, so opening a document does not wait for a new browser. */
+	UPROPERTY(Config, EditDefaultsOnly, Category=Performance, meta=(ClampMin=0, ClampMax=16))
+	int32 BrowserPoolSize = 2;
+
+	/** Pooled browsers are closed once no document has been opened for this many seconds. */
+	UPROPERTY(Config, EditDefaultsOnly, Category=Performance, meta=(ClampMin=0, ForceUnits=s))
+	float BrowserPoolIdleTimeout = 300.0f;
+
+	/** If true, the browser of a markdown tab that stays hidden is shut down and restored when the tab is shown again.
+	 * Hidden tabs always stop rendering, this also frees their memory. */
+	UPROPERTY(Config, EditDefaultsOnly, Category=Performance)
+	bool bSuspendHiddenTabs = true;
+
+	/** How long a markdown tab has to stay hidden before its browser is shut down. */
+	UPROPERTY(Config, EditDefaultsOnly, Category=Performance, meta=(ClampMin=0, ForceUnits=s, EditCondition=bSuspendHiddenTabs))
+	float HiddenTabSuspendDelay = 60.0f;
+
+	/** If true, documents open in a reading view drawn by the editor itself and only start a browser when switched
+	 * to editing. Much cheaper to open, but diagrams and code highlighting are left to the browser. */
+	UPROPERTY(Config, EditDefaultsOnly, Category=Performance)
+	bool bOpenInReadingView = false;
+
+	/** Memory kept for rendered diagrams and highlighted code, so reopened documents do not render them again. */
+	UPROPERTY(Config, EditDefaultsOnly, Category=Performance, meta=(ClampMin=0, Units=Megabytes))
+	int32 RenderCacheSize = 32;
+
+	/** If true, the text of every markdown file and asset is indexed in the background so it can be searched.
+	 * Takes effect the next time the editor starts. */
+	UPROPERTY(Config, EditDefaultsOnly, Category=Search)
+	bool bIndexDocumentation = true;
 };
@@ -0,0 +1,108 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownAsset.h"
+#include "MarkdownBinding.h"
+#include "MarkdownTextBuffer.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MarkdownBindingTests
+{
+	static int32 GetChecksum( const FString& Text )
+	{
+		FMarkdownTextBuffer Buffer;
+		Buffer.Reset( Text );
+		return int32( Buffer.GetChecksum() );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownTextBufferReplaceTest, "MarkdownAsset.Editor.TextBuffer.Replace", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownTextBufferReplaceTest::RunTest( const FString& Parameters )
+{
+	FMarkdownTextBuffer Buffer;
+	Buffer.Reset( TEXT( "hello world" ) );
+
+	// inserts, deletes and replacements either side of the gap, so it has to move both ways
+	TestTrue( TEXT( "insert at the end" ), Buffer.Replace( 11, 0, TEXT( "!" ) ) );
+	TestTrue( TEXT( "insert at the start" ), Buffer.Replace( 0, 0, TEXT( "oh, " ) ) );
+	TestTrue( TEXT( "replace in the middle" ), Buffer.Replace( 10, 5, TEXT( "there" ) ) );
+	TestTrue( TEXT( "delete" ), Buffer.Replace( 2, 2, TEXT( "" ) ) );
+
+	TestEqual( TEXT( "text" ), Buffer.ToString(), FString( TEXT( "oh hello there!" ) ) );
+	TestEqual( TEXT( "length" ), Buffer.Len(), 15 );
+
+	// the gap is after "oh" now, so these are before, after and across it
+	TestEqual( TEXT( "mid before the gap" ), Buffer.Mid( 0, 2 ), FString( TEXT( "oh" ) ) );
+	TestEqual( TEXT( "mid after the gap" ), Buffer.Mid( 9, 5 ), FString( TEXT( "there" ) ) );
+	TestEqual( TEXT( "mid across the gap" ), Buffer.Mid( 1, 4 ), FString( TEXT( "h he" ) ) );
+
+	TestFalse( TEXT( "negative offset" ), Buffer.Replace( -1, 0, TEXT( "x" ) ) );
+	TestFalse( TEXT( "past the end" ), Buffer.Replace( 16, 0, TEXT( "x" ) ) );
+	TestFalse( TEXT( "deleting past the end" ), Buffer.Replace( 10, 6, TEXT( "" ) ) );
+	TestEqual( TEXT( "rejected replacements leave the text" ), Buffer.ToString(), FString( TEXT( "oh hello there!" ) ) );
+
+	// enough to make it grow
+	const FString Long = FString::ChrN( 5000, TEXT( 'x' ) );
+	TestTrue( TEXT( "long insert" ), Buffer.Replace( 3, 0, Long ) );
+	TestEqual( TEXT( "text after growing" ), Buffer.ToString(), TEXT( "oh " ) + Long + TEXT( "hello there!" ) );
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownTextBufferChecksumTest, "MarkdownAsset.Editor.TextBuffer.Checksum", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownTextBufferChecksumTest::RunTest( const FString& Parameters )
+{
+	// FNV-1a of the empty string and of "a", as checksum() in the viewer has them
+	TestEqual( TEXT( "empty" ), MarkdownBindingTests::GetChecksum( TEXT( "" ) ), int32( 2166136261u ) );
+	TestEqual( TEXT( "a" ), MarkdownBindingTests::GetChecksum( TEXT( "a" ) ), int32( 0xe40c292cu ) );
+
+	// the gap is not part of the text
+	FMarkdownTextBuffer Buffer;
+	Buffer.Reset( TEXT( "one three" ) );
+	Buffer.Replace( 4, 0, TEXT( "two " ) );
+	TestEqual( TEXT( "after an edit" ), int32( Buffer.GetChecksum() ), MarkdownBindingTests::GetChecksum( TEXT( "one two three" ) ) );
+
+	Buffer.Replace( 4, 4, TEXT( "" ) );
+	TestEqual( TEXT( "after taking it out again" ), int32( Buffer.GetChecksum() ), MarkdownBindingTests::GetChecksum( TEXT( "one three" ) ) );
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownBindingRejectedEditTest, "MarkdownAsset.Editor.Binding.RejectedEdit", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownBindingRejectedEditTest::RunTest( const FString& Parameters )
+{
+#if PLATFORM_TCHAR_IS_4_BYTES
+	// edits are never applied here, the viewer always sends the whole text
+	return true;
+#else
+	UMarkdownAsset* Asset = NewObject<UMarkdownAsset>( GetTransientPackage() );
+	Asset->SetText( FText::FromString( TEXT( "hello world" ) ) );
+
+	UMarkdownBinding* Binding = NewObject<UMarkdownBinding>();
+	Binding->SetDocument( Asset );
+
+	TestTrue( TEXT( "accepted" ), Binding->ApplyEdit( 0, 6, 0, TEXT( "there " ), MarkdownBindingTests::GetChecksum( TEXT( "hello there world" ) ) ) );
+	TestTrue( TEXT( "accepted" ), Binding->ApplyEdit( 1, 17, 0, TEXT( "!" ), MarkdownBindingTests::GetChecksum( TEXT( "hello there world!" ) ) ) );
+
+	// the viewer thinks the text is something else, and then sends a range we do not have
+	TestFalse( TEXT( "wrong checksum" ), Binding->ApplyEdit( 2, 0, 5, TEXT( "goodbye" ), 12345 ) );
+	TestFalse( TEXT( "out of range" ), Binding->ApplyEdit( 2, 100, 1, TEXT( "" ), 0 ) );
+
+	TestEqual( TEXT( "the accepted edits are still there" ), Binding->GetText().ToString(), FString( TEXT( "hello there world!" ) ) );
+	TestTrue( TEXT( "committed" ), Binding->CommitText() );
+	TestEqual( TEXT( "the document has the accepted edits" ), Asset->Text.ToString(), FString( TEXT( "hello there world!" ) ) );
+
+	return true;
+#endif
+}
+
+#endif
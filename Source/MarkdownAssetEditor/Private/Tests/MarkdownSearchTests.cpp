@@ -0,0 +1,395 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Parser/MarkdownHeadingIndex.h"
+#include "Search/MarkdownQuickOpenIndex.h"
+#include "Search/MarkdownSearchSegment.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MarkdownSearchTests
+{
+	// the header is magic, version, char size and document count (4 bytes each), the documents offset, then the
+	// offset and count of each of the six arrays (8 bytes each)
+	static constexpr int32 DocumentsOffsetStart = 16;
+	static constexpr int32 OffsetsStart         = DocumentsOffsetStart + 8;
+	static constexpr int32 CountsStart          = OffsetsStart + 6 * 8;
+	static constexpr int32 HeaderSize           = CountsStart + 6 * 8;
+
+	static TSharedRef<FMarkdownSearchSegment> BuildSegment()
+	{
+		TArray<FMarkdownSearchSource> Sources;
+
+		FMarkdownSearchSource& Damage = Sources.AddDefaulted_GetRef();
+		Damage.Path        = TEXT( "/Documentation/Weapons/Damage.md" );
+		Damage.Text        = TEXT( "# Damage Falloff\n\nDamage drops over distance, see the curves.\n" );
+		Damage.ContentHash = 1;
+
+		FMarkdownSearchSource& Setup = Sources.AddDefaulted_GetRef();
+		Setup.Path        = TEXT( "/Documentation/Setup.md" );
+		Setup.Text        = TEXT( "# Getting Started\n\nInstall the plugin, then open a document.\n" );
+		Setup.ContentHash = 2;
+
+		FMarkdownSearchSource& Weapons = Sources.AddDefaulted_GetRef();
+		Weapons.Path  = TEXT( "/Game/Docs/Weapons.Weapons" );
+		Weapons.Title = TEXT( "Weapons" );
+		Weapons.Text  = TEXT( "Every weapon deals damage.\n" );
+
+		return FMarkdownSearchSegment::Build( MoveTemp( Sources ) );
+	}
+
+	/** the paths of the hits, best first, with the scores alongside */
+	static TArray<FString> Search( const FMarkdownSearchSegment& Segment, const TCHAR* Text, TArray<float>* OutScores = nullptr )
+	{
+		TArray<FString> Paths;
+
+		FMarkdownSearchQuery Query;
+
+		if( !Query.Parse( Text ) )
+		{
+			return Paths;
+		}
+
+		const TBitArray<> Removed( false, Segment.NumDocuments() );
+
+		int64 NumTokens = 0;
+
+		for( int32 Index = 0; Index < Segment.NumDocuments(); ++Index )
+		{
+			NumTokens += Segment.GetDocument( Index ).NumTokens;
+		}
+
+		FMarkdownSearchStats Stats;
+		Stats.NumDocuments  = Segment.NumDocuments();
+		Stats.AverageTokens = Segment.NumDocuments() > 0 ? float( NumTokens ) / Segment.NumDocuments() : 0.0f;
+
+		Segment.CountDocuments( Query, Removed, Stats );
+		Stats.Finish();
+
+		TArray<FMarkdownSearchHit> Hits;
+		Segment.Search( Query, Stats, Removed, 10, Hits );
+
+		for( const FMarkdownSearchHit& Hit : Hits )
+		{
+			Paths.Add( Segment.GetDocument( Hit.Document ).Path );
+
+			if( OutScores != nullptr )
+			{
+				OutScores->Add( Hit.Score );
+			}
+		}
+
+		return Paths;
+	}
+
+	static FString GetFilename( const TCHAR* Name )
+	{
+		return FPaths::Combine( FPaths::AutomationTransientDir(), TEXT( "MarkdownSearchTests" ), Name );
+	}
+
+	template<typename Type>
+	static void Poke( TArray<uint8>& Bytes, const int32 Offset, const Type Value )
+	{
+		FMemory::Memcpy( Bytes.GetData() + Offset, &Value, sizeof( Value ) );
+	}
+
+	/** true if the bytes load as a segment */
+	static bool Loads( const TArray<uint8>& Bytes, const TCHAR* Name )
+	{
+		const FString Filename = GetFilename( Name );
+
+		if( !FFileHelper::SaveArrayToFile( Bytes, *Filename ) )
+		{
+			return true;
+		}
+
+		const bool bLoaded = FMarkdownSearchSegment::Load( Filename ).IsValid();
+		IFileManager::Get().Delete( *Filename, false, false, true );
+		return bLoaded;
+	}
+
+	static TArray<FMarkdownHeading> GetHeadings( const TCHAR* Text )
+	{
+		TArray<FMarkdownHeading> Headings;
+		FMarkdownHeadingIndex::Build( Text, Headings );
+		return Headings;
+	}
+
+	/** the entries for the query, best first */
+	static TArray<FMarkdownQuickOpenEntry> Find( const FMarkdownQuickOpenIndex& Index, const TCHAR* Query )
+	{
+		TArray<FMarkdownQuickOpenResult> Results;
+		Index.Find( Query, 10, Results );
+
+		TArray<FMarkdownQuickOpenEntry> Entries;
+
+		for( const FMarkdownQuickOpenResult& Result : Results )
+		{
+			Entries.Add( Index.GetEntry( Result.Entry ) );
+		}
+
+		return Entries;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownSearchSegmentSearchTest, "MarkdownAsset.Editor.Search.Segment.Search", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownSearchSegmentSearchTest::RunTest( const FString& Parameters )
+{
+	using namespace MarkdownSearchTests;
+
+	const TSharedRef<FMarkdownSearchSegment> Segment = BuildSegment();
+
+	TestEqual( TEXT( "documents" ), Segment->NumDocuments(), 3 );
+	TestEqual( TEXT( "title from the first heading" ), Segment->GetDocument( 0 ).Title, FString( TEXT( "Damage Falloff" ) ) );
+	TestEqual( TEXT( "title as given" ), Segment->GetDocument( 2 ).Title, FString( TEXT( "Weapons" ) ) );
+
+	// a match in the title counts for more
+	const TArray<FString> Damage = Search( *Segment, TEXT( "damage " ) );
+
+	if( TestEqual( TEXT( "damage hits" ), Damage.Num(), 2 ) )
+	{
+		TestEqual( TEXT( "title match first" ), Damage[ 0 ], FString( TEXT( "/Documentation/Weapons/Damage.md" ) ) );
+	}
+
+	TestTrue( TEXT( "phrase" ), Search( *Segment, TEXT( "\"drops over\"" ) ) == TArray<FString>{ TEXT( "/Documentation/Weapons/Damage.md" ) } );
+	TestEqual( TEXT( "phrase out of order" ), Search( *Segment, TEXT( "\"over drops\"" ) ).Num(), 0 );
+	TestTrue( TEXT( "every word" ), Search( *Segment, TEXT( "install document " ) ) == TArray<FString>{ TEXT( "/Documentation/Setup.md" ) } );
+	TestTrue( TEXT( "last word as a prefix" ), Search( *Segment, TEXT( "plug" ) ) == TArray<FString>{ TEXT( "/Documentation/Setup.md" ) } );
+	TestEqual( TEXT( "no match" ), Search( *Segment, TEXT( "grenade " ) ).Num(), 0 );
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownSearchSegmentSaveLoadTest, "MarkdownAsset.Editor.Search.Segment.SaveLoad", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownSearchSegmentSaveLoadTest::RunTest( const FString& Parameters )
+{
+	using namespace MarkdownSearchTests;
+
+	const TSharedRef<FMarkdownSearchSegment> Built = BuildSegment();
+	const FString Filename = GetFilename( TEXT( "SaveLoad.seg" ) );
+
+	if( !TestTrue( TEXT( "saved" ), Built->Save( Filename ) ) )
+	{
+		return false;
+	}
+
+	TestFalse( TEXT( "no temporary file left" ), IFileManager::Get().FileExists( *( Filename + TEXT( ".tmp" ) ) ) );
+
+	TSharedPtr<FMarkdownSearchSegment> Loaded = FMarkdownSearchSegment::Load( Filename );
+
+	if( TestTrue( TEXT( "loaded" ), Loaded.IsValid() ) )
+	{
+		TestEqual( TEXT( "documents" ), Loaded->NumDocuments(), Built->NumDocuments() );
+		TestEqual( TEXT( "terms" ), Loaded->NumTerms(), Built->NumTerms() );
+
+		for( int32 Index = 0; Index < FMath::Min( Loaded->NumDocuments(), Built->NumDocuments() ); ++Index )
+		{
+			const FMarkdownSearchDocument& Before = Built->GetDocument( Index );
+			const FMarkdownSearchDocument& After  = Loaded->GetDocument( Index );
+
+			TestEqual( TEXT( "path" ), After.Path, Before.Path );
+			TestEqual( TEXT( "title" ), After.Title, Before.Title );
+			TestTrue( TEXT( "content hash" ), After.ContentHash == Before.ContentHash );
+			TestEqual( TEXT( "title tokens" ), After.NumTitleTokens, Before.NumTitleTokens );
+			TestEqual( TEXT( "outline tokens" ), After.NumOutlineTokens, Before.NumOutlineTokens );
+			TestEqual( TEXT( "tokens" ), After.NumTokens, Before.NumTokens );
+		}
+
+		// the mapped arrays find and score the same as the ones it was built with
+		for( const TCHAR* Query : { TEXT( "damage " ), TEXT( "\"drops over\"" ), TEXT( "plug" ), TEXT( "weapon curves" ), TEXT( "grenade " ) } )
+		{
+			TArray<float> BuiltScores;
+			TArray<float> LoadedScores;
+
+			TestTrue( Query, Search( *Loaded, Query, &LoadedScores ) == Search( *Built, Query, &BuiltScores ) );
+			TestTrue( Query, LoadedScores == BuiltScores );
+		}
+	}
+
+	// the file stays mapped while the segment is alive
+	Loaded.Reset();
+	IFileManager::Get().Delete( *Filename, false, false, true );
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownSearchSegmentCorruptTest, "MarkdownAsset.Editor.Search.Segment.Corrupt", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownSearchSegmentCorruptTest::RunTest( const FString& Parameters )
+{
+	using namespace MarkdownSearchTests;
+
+	const FString Filename = GetFilename( TEXT( "Corrupt.seg" ) );
+	TArray<uint8> Bytes;
+
+	if( !TestTrue( TEXT( "saved" ), BuildSegment()->Save( Filename ) ) || !TestTrue( TEXT( "read back" ), FFileHelper::LoadFileToArray( Bytes, *Filename ) ) )
+	{
+		return false;
+	}
+
+	IFileManager::Get().Delete( *Filename, false, false, true );
+
+	TestTrue( TEXT( "as written" ), Loads( Bytes, TEXT( "Valid.seg" ) ) );
+	TestFalse( TEXT( "missing" ), FMarkdownSearchSegment::Load( GetFilename( TEXT( "Missing.seg" ) ) ).IsValid() );
+
+	auto Corrupt = [ &Bytes ]( TFunctionRef<void( TArray<uint8>& )> Change )
+	{
+		TArray<uint8> Changed = Bytes;
+		Change( Changed );
+		return Changed;
+	};
+
+	TestFalse( TEXT( "empty" ), Loads( TArray<uint8>(), TEXT( "Empty.seg" ) ) );
+	TestFalse( TEXT( "cut short in the header" ), Loads( TArray<uint8>( Bytes.GetData(), HeaderSize - 1 ), TEXT( "Short.seg" ) ) );
+	TestFalse( TEXT( "cut short in the arrays" ), Loads( TArray<uint8>( Bytes.GetData(), HeaderSize + 8 ), TEXT( "Truncated.seg" ) ) );
+
+	TestFalse( TEXT( "magic" ), Loads( Corrupt( []( TArray<uint8>& Changed ) { Poke<uint32>( Changed, 0, 0x4D444D47 ); } ), TEXT( "Magic.seg" ) ) );
+	TestFalse( TEXT( "version" ), Loads( Corrupt( []( TArray<uint8>& Changed ) { Poke<uint32>( Changed, 4, 1 ); } ), TEXT( "Version.seg" ) ) );
+	TestFalse( TEXT( "character size" ), Loads( Corrupt( []( TArray<uint8>& Changed ) { Poke<uint32>( Changed, 8, 3 ); } ), TEXT( "CharSize.seg" ) ) );
+	TestFalse( TEXT( "negative document count" ), Loads( Corrupt( []( TArray<uint8>& Changed ) { Poke<int32>( Changed, 12, -1 ); } ), TEXT( "Documents.seg" ) ) );
+	TestFalse( TEXT( "documents past the end" ), Loads( Corrupt( [ & ]( TArray<uint8>& Changed ) { Poke<int64>( Changed, DocumentsOffsetStart, Bytes.Num() + 1 ); } ), TEXT( "DocumentsOffset.seg" ) ) );
+	TestFalse( TEXT( "documents in the header" ), Loads( Corrupt( []( TArray<uint8>& Changed ) { Poke<int64>( Changed, DocumentsOffsetStart, 8 ); } ), TEXT( "DocumentsHeader.seg" ) ) );
+	TestFalse( TEXT( "array past the end" ), Loads( Corrupt( []( TArray<uint8>& Changed ) { Poke<int64>( Changed, OffsetsStart, int64( 1 ) << 40 ); } ), TEXT( "ArrayOffset.seg" ) ) );
+	TestFalse( TEXT( "array out of line" ), Loads( Corrupt( []( TArray<uint8>& Changed ) { Poke<int64>( Changed, OffsetsStart, HeaderSize + 4 ); } ), TEXT( "ArrayAlign.seg" ) ) );
+	TestFalse( TEXT( "array too long" ), Loads( Corrupt( []( TArray<uint8>& Changed ) { Poke<int64>( Changed, CountsStart + 5 * 8, int64( MAX_int32 ) + 1 ); } ), TEXT( "ArrayCount.seg" ) ) );
+
+	// the term starts one short, so the arrays no longer agree on how many terms there are
+	TestFalse( TEXT( "arrays disagree" ), Loads( Corrupt( [ & ]( TArray<uint8>& Changed )
+	{
+		int64 Count;
+		FMemory::Memcpy( &Count, Bytes.GetData() + CountsStart + 2 * 8, sizeof( Count ) );
+		Poke<int64>( Changed, CountsStart + 2 * 8, Count - 1 );
+	}), TEXT( "ArraySizes.seg" ) ) );
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownQuickOpenFindTest, "MarkdownAsset.Editor.Search.QuickOpen.Find", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownQuickOpenFindTest::RunTest( const FString& Parameters )
+{
+	using namespace MarkdownSearchTests;
+
+	const FString Damage = TEXT( "/Documentation/Weapons/Damage.md" );
+	const FString Setup  = TEXT( "/Documentation/Setup.md" );
+
+	FMarkdownQuickOpenIndex Index;
+	Index.AddDocument( Damage, GetHeadings( TEXT( "# Damage Falloff\n\n## Curves\n" ) ) );
+	Index.AddDocument( Setup, GetHeadings( TEXT( "# Getting Started\n\n## Install\n" ) ) );
+
+	TestEqual( TEXT( "documents" ), Index.NumDocuments(), 2 );
+
+	// the document ahead of its headings when they match as well
+	TArray<FMarkdownQuickOpenEntry> Found = Find( Index, TEXT( "damage" ) );
+
+	if( TestTrue( TEXT( "damage" ), Found.Num() > 0 ) )
+	{
+		TestEqual( TEXT( "damage finds the document" ), Found[ 0 ].Path, Damage );
+		TestTrue( TEXT( "damage finds the document itself" ), Found[ 0 ].Slug.IsEmpty() );
+		TestTrue( TEXT( "damage only finds that document" ), Found.FilterByPredicate( [ & ]( const FMarkdownQuickOpenEntry& Entry ) { return Entry.Path != Damage; } ).IsEmpty() );
+	}
+
+	// headings
+	Found = Find( Index, TEXT( "curves" ) );
+
+	if( TestTrue( TEXT( "curves" ), Found.Num() > 0 ) )
+	{
+		TestEqual( TEXT( "curves finds the heading" ), Found[ 0 ].Slug, FString( TEXT( "curves" ) ) );
+		TestEqual( TEXT( "heading level" ), Found[ 0 ].Level, 2 );
+	}
+
+	// the path under the documentation folder
+	Found = Find( Index, TEXT( "weapons/dam" ) );
+	TestTrue( TEXT( "path" ), Found.Num() > 0 && Found[ 0 ].Path == Damage );
+
+	// a subsequence across words, and one short of a trigram
+	Found = Find( Index, TEXT( "dmgfall" ) );
+	TestTrue( TEXT( "abbreviation" ), Found.Num() > 0 && Found[ 0 ].Path == Damage );
+
+	Found = Find( Index, TEXT( "in" ) );
+	TestTrue( TEXT( "word start" ), Found.Num() > 0 && Found[ 0 ].Slug == TEXT( "install" ) );
+
+	// typos still find it, by the trigrams they share
+	Found = Find( Index, TEXT( "instlal" ) );
+	TestTrue( TEXT( "typo" ), Found.Num() > 0 && Found[ 0 ].Slug == TEXT( "install" ) );
+
+	// and come after anything that does match
+	Index.AddDocument( TEXT( "/Documentation/Notes.md" ), GetHeadings( TEXT( "# Instlal Notes\n" ) ) );
+	Found = Find( Index, TEXT( "instlal" ) );
+	TestTrue( TEXT( "match before typo" ), Found.Num() > 1 && Found[ 0 ].Path == TEXT( "/Documentation/Notes.md" ) && Found.Last().Slug == TEXT( "install" ) );
+
+	TestEqual( TEXT( "nothing like it" ), Find( Index, TEXT( "zzqx" ) ).Num(), 0 );
+	TestEqual( TEXT( "empty query" ), Find( Index, TEXT( "  " ) ).Num(), 0 );
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMarkdownQuickOpenUpdateTest, "MarkdownAsset.Editor.Search.QuickOpen.Update", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter )
+
+bool FMarkdownQuickOpenUpdateTest::RunTest( const FString& Parameters )
+{
+	using namespace MarkdownSearchTests;
+
+	const FString Damage = TEXT( "/Documentation/Weapons/Damage.md" );
+	const FString Setup  = TEXT( "/Documentation/Setup.md" );
+
+	const TArray<FString> Combat = { TEXT( "combat" ) };
+
+	FMarkdownQuickOpenIndex Index;
+	Index.AddDocument( Damage, GetHeadings( TEXT( "## Curves\n\n# Damage Falloff\n" ) ), FDateTime( 2024, 1, 1 ), Combat );
+	Index.AddDocument( Setup, GetHeadings( TEXT( "# Getting Started\n\n## Install\n" ) ) );
+
+	// the first of the highest level headings, wherever it is
+	FString Title;
+	TArray<FString> Headings;
+	TArray<FString> Tags;
+
+	if( TestTrue( TEXT( "outline" ), Index.GetOutline( Damage, Title, Headings, Tags ) ) )
+	{
+		TestEqual( TEXT( "title" ), Title, FString( TEXT( "Damage Falloff" ) ) );
+		TestTrue( TEXT( "headings" ), Headings == TArray<FString>{ TEXT( "Curves" ), TEXT( "Damage Falloff" ) } );
+		TestTrue( TEXT( "tags" ), Tags == Combat );
+	}
+
+	TestTrue( TEXT( "timestamp" ), Index.GetTimestamp( Damage ) == FDateTime( 2024, 1, 1 ) );
+
+	// adding it again replaces what was there
+	Index.AddDocument( Damage, GetHeadings( TEXT( "# Damage\n" ) ) );
+
+	TestEqual( TEXT( "replaced documents" ), Index.NumDocuments(), 2 );
+	TestEqual( TEXT( "replaced headings are gone" ), Find( Index, TEXT( "curves" ) ).Num(), 0 );
+
+	// removed documents are not found
+	Index.RemoveDocument( Setup );
+
+	TestFalse( TEXT( "removed" ), Index.Contains( Setup ) );
+	TestFalse( TEXT( "removed outline" ), Index.GetOutline( Setup, Title, Headings, Tags ) );
+	TestEqual( TEXT( "removed headings" ), Find( Index, TEXT( "install" ) ).Num(), 0 );
+
+	// enough churn that the removed entries are compacted away, leaving the rest findable
+	for( int32 Round = 0; Round < 300; ++Round )
+	{
+		Index.AddDocument( Setup, GetHeadings( TEXT( "# Getting Started\n\n## Install\n" ) ) );
+	}
+
+	TestEqual( TEXT( "entries after compacting" ), Index.NumEntries(), 2 + 3 );
+
+	TArray<FMarkdownQuickOpenEntry> Found = Find( Index, TEXT( "install" ) );
+	TestTrue( TEXT( "found after compacting" ), Found.Num() > 0 && Found[ 0 ].Slug == TEXT( "install" ) );
+
+	Found = Find( Index, TEXT( "damage" ) );
+	TestTrue( TEXT( "others found after compacting" ), Found.Num() > 0 && Found[ 0 ].Path == Damage );
+
+	return true;
+}
+
+#endif
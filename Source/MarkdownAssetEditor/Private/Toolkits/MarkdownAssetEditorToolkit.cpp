@@ -3,11 +3,18 @@
 #include "MarkdownAssetEditorToolkit.h"
 #include "Editor.h"
 #include "EditorReimportHandler.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
 #include "SMarkdownAssetEditor.h"
 #include "MarkdownAsset.h"
+#include "MarkdownAssetEditorSettings.h"
 #include "MarkdownAssetEditorStyle.h"
 #include "UObject/NameTypes.h"
 #include "Widgets/Docking/SDockTab.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/SMarkdownView.h"
+#include "Widgets/SOverlay.h"
+#include "Widgets/SWindow.h"
 
 #define LOCTEXT_NAMESPACE "FMarkdownAssetEditorToolkit"
 
@@ -33,6 +40,7 @@ FMarkdownAssetEditorToolkit::~FMarkdownAssetEditorToolkit()
 {
 	FReimportManager::Instance()->OnPreReimport().RemoveAll( this );
 	FReimportManager::Instance()->OnPostReimport().RemoveAll( this );
+	FTSTicker::GetCoreTicker().RemoveTicker( VisibilityTickerHandle );
 }
 
 
@@ -67,6 +75,8 @@ void FMarkdownAssetEditorToolkit::Initialize( UMarkdownAsset* InMarkdownAsset, c
 	);
 
 	RegenerateMenusAndToolbars();
+
+	VisibilityTickerHandle = FTSTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateSP( this, &FMarkdownAssetEditorToolkit::HandleVisibilityTick ), 0.5f );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -127,14 +137,192 @@ TSharedRef<SDockTab> FMarkdownAssetEditorToolkit::HandleTabManagerSpawnTab( cons
 
 	if( TabIdentifier == MarkdownAssetEditor::TabId )
 	{
-		TabWidget = SNew( SMarkdownAssetEditor, MarkdownAsset, Style.ToSharedRef() );
+		// the reading view is swapped for the editor in place, so the tab content is a box either way
+		TabContent = SNew( SBox );
+
+		if( GetDefault<UMarkdownAssetEditorSettings>()->ShouldOpenInReadingView() )
+		{
+			TabContent->SetContent( MakeReadingView() );
+		}
+		else
+		{
+			EditorWidget = SNew( SMarkdownAssetEditor, MarkdownAsset, Style.ToSharedRef() );
+			TabContent->SetContent( EditorWidget.ToSharedRef() );
+		}
+
+		TabWidget = TabContent;
 	}
 
-	return SNew( SDockTab )
+	TSharedRef<SDockTab> Tab = SNew( SDockTab )
 		.TabRole( ETabRole::PanelTab )
 		[
 			TabWidget.ToSharedRef()
 		];
+
+	if( TabIdentifier == MarkdownAssetEditor::TabId )
+	{
+		EditorTab = Tab;
+	}
+
+	return Tab;
+}
+
+void FMarkdownAssetEditorToolkit::SaveAsset_Execute()
+{
+	if( !EditorWidget.IsValid() )
+	{
+		FAssetEditorToolkit::SaveAsset_Execute();
+		return;
+	}
+
+	TWeakPtr<FMarkdownAssetEditorToolkit> WeakThis = SharedThis( this );
+
+	EditorWidget->FlushEdits( FSimpleDelegate::CreateLambda( [WeakThis]()
+	{
+		if( TSharedPtr<FMarkdownAssetEditorToolkit> This = WeakThis.Pin() )
+		{
+			This->FAssetEditorToolkit::SaveAsset_Execute();
+		}
+	}));
+}
+
+void FMarkdownAssetEditorToolkit::SaveAssetAs_Execute()
+{
+	if( !EditorWidget.IsValid() )
+	{
+		FAssetEditorToolkit::SaveAssetAs_Execute();
+		return;
+	}
+
+	TWeakPtr<FMarkdownAssetEditorToolkit> WeakThis = SharedThis( this );
+
+	EditorWidget->FlushEdits( FSimpleDelegate::CreateLambda( [WeakThis]()
+	{
+		if( TSharedPtr<FMarkdownAssetEditorToolkit> This = WeakThis.Pin() )
+		{
+			This->FAssetEditorToolkit::SaveAssetAs_Execute();
+		}
+	}));
+}
+
+#if UE_VERSION_OLDER_THAN( 5, 3, 0 )
+bool FMarkdownAssetEditorToolkit::OnRequestClose()
+#else
+bool FMarkdownAssetEditorToolkit::OnRequestClose( EAssetEditorCloseReason InCloseReason )
+#endif
+{
+	// an asset that is going away has nothing to keep edits in, otherwise the viewer's last edits go in before closing
+#if UE_VERSION_OLDER_THAN( 5, 3, 0 )
+	const bool bCanWait = true;
+	auto Close = []( FMarkdownAssetEditorToolkit& Toolkit ) { Toolkit.CloseWindow(); };
+#else
+	const bool bCanWait = InCloseReason != EAssetEditorCloseReason::AssetUnloadingOrInvalid;
+	auto Close = [InCloseReason]( FMarkdownAssetEditorToolkit& Toolkit ) { Toolkit.CloseWindow( InCloseReason ); };
+#endif
+
+	if( bCanWait && !bFlushedForClose && EditorWidget.IsValid() && EditorWidget->HasPendingEdits() )
+	{
+		TWeakPtr<FMarkdownAssetEditorToolkit> WeakThis = SharedThis( this );
+
+		EditorWidget->FlushEdits( FSimpleDelegate::CreateLambda( [WeakThis, Close]()
+		{
+			if( TSharedPtr<FMarkdownAssetEditorToolkit> This = WeakThis.Pin() )
+			{
+				This->bFlushedForClose = true;
+				Close( *This );
+			}
+		}));
+
+		return false;
+	}
+
+	bFlushedForClose = false;
+
+#if UE_VERSION_OLDER_THAN( 5, 3, 0 )
+	return FAssetEditorToolkit::OnRequestClose();
+#else
+	return FAssetEditorToolkit::OnRequestClose( InCloseReason );
+#endif
+}
+
+TSharedRef<SWidget> FMarkdownAssetEditorToolkit::MakeReadingView()
+{
+	TWeakObjectPtr<UMarkdownAsset> WeakAsset = MarkdownAsset.Get();
+
+	return SNew( SOverlay )
+		+ SOverlay::Slot()
+		[
+			SNew( SMarkdownView )
+			.Text_Lambda( [WeakAsset]()
+			{
+				return WeakAsset.IsValid() ? WeakAsset->Text : FText::GetEmpty();
+			})
+			.OnLinkClicked( this, &FMarkdownAssetEditorToolkit::HandleReadingViewLinkClicked )
+		]
+		+ SOverlay::Slot()
+		.HAlign( HAlign_Right )
+		.VAlign( VAlign_Top )
+		.Padding( 16.0f, 8.0f )
+		[
+			SNew( SButton )
+			.Text( LOCTEXT( "EditButton", "Edit" ) )
+			.ToolTipText( LOCTEXT( "EditButtonTooltip", "Open the document in the markdown editor" ) )
+			.OnClicked( this, &FMarkdownAssetEditorToolkit::HandleEditClicked )
+		];
+}
+
+FReply FMarkdownAssetEditorToolkit::HandleEditClicked()
+{
+	if( !EditorWidget.IsValid() && TabContent.IsValid() )
+	{
+		EditorWidget = SNew( SMarkdownAssetEditor, MarkdownAsset, Style.ToSharedRef() );
+		TabContent->SetContent( EditorWidget.ToSharedRef() );
+	}
+
+	return FReply::Handled();
+}
+
+void FMarkdownAssetEditorToolkit::HandleReadingViewLinkClicked( const FString& Url )
+{
+	// same rules as the viewer, copied asset references open the asset and anything with a scheme goes to the OS
+	if( Url.StartsWith( TEXT( "/Script" ) ) )
+	{
+		int32 Start = INDEX_NONE;
+		int32 End = INDEX_NONE;
+
+		if( Url.FindChar( TEXT( '\'' ), Start ) && Url.FindLastChar( TEXT( '\'' ), End ) && End > Start )
+		{
+			const FString Path = Url.Mid( Start + 1, End - Start - 1 );
+			MarkdownAssetStatics::TryToOpenAsset( FSoftObjectPath( Path ), FText::FromString( Path ) );
+		}
+	}
+	else if( Url.Contains( TEXT( "://" ) ) || Url.StartsWith( TEXT( "mailto:" ) ) )
+	{
+		FPlatformProcess::LaunchURL( *Url, nullptr, nullptr );
+	}
+}
+
+bool FMarkdownAssetEditorToolkit::HandleVisibilityTick( float DeltaTime )
+{
+	TSharedPtr<SDockTab> Tab = EditorTab.Pin();
+
+	if( !EditorWidget.IsValid() || !Tab.IsValid() )
+	{
+		return true;
+	}
+
+	// the markdown panel sits inside the asset editor tab, so both have to be in front and the window has to be up
+	TSharedPtr<SDockTab> OwnerTab = GetTabManager().IsValid() ? GetTabManager()->GetOwnerTab() : nullptr;
+	TSharedPtr<SWindow>  Window   = Tab->GetParentWindow();
+
+	const bool bVisible =
+		Tab->IsForeground() &&
+		( !OwnerTab.IsValid() || OwnerTab->IsForeground() ) &&
+		Window.IsValid() && Window->IsVisible() && !Window->IsWindowMinimized();
+
+	EditorWidget->UpdateVisibility( bVisible );
+
+	return true;
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include "Containers/Ticker.h"
 #include "EditorUndoClient.h"
+#include "Misc/EngineVersionComparison.h"
 #include "Templates/SharedPointer.h"
 #include "Toolkits/AssetEditorToolkit.h"
 #include "UObject/GCObject.h"
@@ -10,7 +12,9 @@
 class FSpawnTabArgs;
 class ISlateStyle;
 class IToolkitHost;
+class SBox;
 class SDockTab;
+class SMarkdownAssetEditor;
 class UMarkdownAsset;
 
 class FMarkdownAssetEditorToolkit : public FAssetEditorToolkit, public FGCObject
@@ -32,6 +36,20 @@ class FMarkdownAssetEditorToolkit : public FAssetEditorToolkit, public FGCObject
 		virtual void RegisterTabSpawners( const TSharedRef<FTabManager>& InTabManager ) override;
 		virtual void UnregisterTabSpawners( const TSharedRef<FTabManager>& InTabManager ) override;
 
+	protected:
+
+		//~ FAssetEditorToolkit interface, the viewer may still be holding edits so these wait for them first
+		virtual void SaveAsset_Execute() override;
+		virtual void SaveAssetAs_Execute() override;
+
+#if UE_VERSION_OLDER_THAN( 5, 3, 0 )
+		virtual bool OnRequestClose() override;
+#else
+		virtual bool OnRequestClose( EAssetEditorCloseReason InCloseReason ) override;
+#endif
+
+	public:
+
 		//~ IToolkit interface
 		virtual FText GetBaseToolkitName() const override;
 		virtual FName GetToolkitFName() const override;
@@ -50,6 +68,23 @@ class FMarkdownAssetEditorToolkit : public FAssetEditorToolkit, public FGCObject
 
 		TSharedRef<SDockTab> HandleTabManagerSpawnTab( const FSpawnTabArgs& Args, FName TabIdentifier );
 
+		/** The native, read only view of the document, with a button to switch to the editor. */
+		TSharedRef<SWidget> MakeReadingView();
+		FReply HandleEditClicked();
+		void HandleReadingViewLinkClicked( const FString& Url );
+
+		/** Lets the editor widget know whether anyone can see it. */
+		bool HandleVisibilityTick( float DeltaTime );
+
 	private:
 		TObjectPtr<UMarkdownAsset> MarkdownAsset;
+
+		TSharedPtr<SMarkdownAssetEditor> EditorWidget;
+		TSharedPtr<SBox> TabContent;
+		TWeakPtr<SDockTab> EditorTab;
+
+		FTSTicker::FDelegateHandle VisibilityTickerHandle;
+
+		/** the pending edits were flushed for this close, so it can go ahead */
+		bool bFlushedForClose = false;
 };
@@ -0,0 +1,309 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Validation/MarkdownCoverage.h"
+
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Blueprint.h"
+#include "Engine/DataAsset.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+namespace MarkdownCoverage
+{
+	static FDateTime GetTimestamp( const FSoftObjectPath& Asset, const bool bMap )
+	{
+		FString Filename;
+
+		if( !FPackageName::TryConvertLongPackageNameToFilename( Asset.GetLongPackageName(), Filename, bMap ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension() ) )
+		{
+			return FDateTime::MinValue();
+		}
+
+		// MinValue if there is no file
+		return IFileManager::Get().GetTimeStamp( *Filename );
+	}
+
+	static void Count( FMarkdownCoverageCounts& Counts, const EMarkdownDocumentationState State )
+	{
+		++Counts.NumAssets;
+		Counts.NumDocumented += State != EMarkdownDocumentationState::Undocumented ? 1 : 0;
+		Counts.NumStale      += State == EMarkdownDocumentationState::Stale ? 1 : 0;
+	}
+
+	static void WriteCounts( TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Writer, const FMarkdownCoverageCounts& Counts )
+	{
+		Writer.WriteValue( TEXT( "assets" ), Counts.NumAssets );
+		Writer.WriteValue( TEXT( "documented" ), Counts.NumDocumented );
+		Writer.WriteValue( TEXT( "stale" ), Counts.NumStale );
+		Writer.WriteValue( TEXT( "coverage" ), Counts.GetCoverage() );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownCoverageReport::GetDefaultFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT( "MarkdownCoverage" ) / TEXT( "Report.json" );
+}
+
+const TCHAR* FMarkdownCoverageReport::GetCategoryName( const EMarkdownCoverageCategory Category )
+{
+	switch( Category )
+	{
+		case EMarkdownCoverageCategory::Blueprint: return TEXT( "Blueprint" );
+		case EMarkdownCoverageCategory::DataAsset: return TEXT( "DataAsset" );
+		case EMarkdownCoverageCategory::Map:       return TEXT( "Map" );
+		default:                                   break;
+	}
+
+	return TEXT( "" );
+}
+
+bool FMarkdownCoverageReport::Save( const FString& Filename ) const
+{
+	using namespace MarkdownCoverage;
+
+	FString Json;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create( &Json );
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue( TEXT( "root" ), Root );
+	Writer->WriteValue( TEXT( "seconds" ), Seconds );
+	WriteCounts( *Writer, Total );
+
+	Writer->WriteObjectStart( TEXT( "categories" ) );
+
+	for( int32 Category = 0; Category < int32( EMarkdownCoverageCategory::Num ); ++Category )
+	{
+		Writer->WriteObjectStart( GetCategoryName( EMarkdownCoverageCategory( Category ) ) );
+		WriteCounts( *Writer, Categories[ Category ] );
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteObjectEnd();
+
+	Writer->WriteArrayStart( TEXT( "folders" ) );
+
+	for( const FMarkdownCoverageFolder& Folder : Folders )
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue( TEXT( "path" ), Folder.Path );
+		WriteCounts( *Writer, Folder.Total );
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteArrayEnd();
+
+	Writer->WriteArrayStart( TEXT( "assets" ) );
+
+	for( const FMarkdownCoverageEntry& Entry : Entries )
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue( TEXT( "asset" ), Entry.Asset.ToString() );
+		Writer->WriteValue( TEXT( "category" ), GetCategoryName( Entry.Category ) );
+		Writer->WriteValue( TEXT( "state" ), Entry.IsStale() ? TEXT( "stale" ) : TEXT( "undocumented" ) );
+		Writer->WriteValue( TEXT( "assetSaved" ), Entry.AssetTimestamp.ToIso8601() );
+
+		if( Entry.IsStale() )
+		{
+			Writer->WriteValue( TEXT( "document" ), Entry.Document.ToString() );
+			Writer->WriteValue( TEXT( "documentSaved" ), Entry.DocumentTimestamp.ToIso8601() );
+		}
+
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	return FFileHelper::SaveStringToFile( Json, *Filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownCoverage::FMarkdownCoverage( const FString& InRoot )
+	: Root( InRoot )
+{
+	if( Root.Len() > 1 )
+	{
+		Root.RemoveFromEnd( TEXT( "/" ) );
+	}
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	// in the order of EMarkdownCoverageCategory
+	const FTopLevelAssetPath Classes[] =
+	{
+		UBlueprint::StaticClass()->GetClassPathName(),
+		UDataAsset::StaticClass()->GetClassPathName(),
+		UWorld::StaticClass()->GetClassPathName(),
+	};
+
+	static_assert( UE_ARRAY_COUNT( Classes ) == int32( EMarkdownCoverageCategory::Num ) );
+
+	for( int32 Category = 0; Category < UE_ARRAY_COUNT( Classes ); ++Category )
+	{
+		FARFilter Filter;
+		Filter.ClassPaths.Add( Classes[ Category ] );
+		Filter.bRecursiveClasses = true;
+		Filter.PackagePaths.Add( FName( *Root ) );
+		Filter.bRecursivePaths = true;
+		Filter.bIncludeOnlyOnDiskAssets = true;
+
+		AssetRegistry.EnumerateAssets( Filter, [ this, Category ]( const FAssetData& AssetData )
+		{
+			Assets.Add( { AssetData.GetSoftObjectPath(), AssetData.PackagePath, EMarkdownCoverageCategory( Category ) } );
+			return true;
+		});
+	}
+
+	UMarkdownDocumentationSubsystem::CollectDocumentation( Documentation );
+}
+
+void FMarkdownCoverage::Build( FMarkdownCoverageReport& OutReport )
+{
+	using namespace MarkdownCoverage;
+
+	const double Start = FPlatformTime::Seconds();
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	OutReport.Root = Root;
+
+	// there are far fewer documents than assets, each is only looked at once
+	TArray<FSoftObjectPath> Documents;
+	{
+		TSet<FSoftObjectPath> Unique;
+
+		for( const TPair<FSoftObjectPath, FMarkdownDocumentation>& Pair : Documentation )
+		{
+			Unique.Add( Pair.Value.Document );
+		}
+
+		Documents = Unique.Array();
+	}
+
+	TArray<FDateTime> DocumentTimes;
+	DocumentTimes.SetNum( Documents.Num() );
+
+	ParallelFor( Documents.Num(), [ & ]( const int32 Index )
+	{
+		DocumentTimes[ Index ] = GetTimestamp( Documents[ Index ], false );
+	});
+
+	TMap<FSoftObjectPath, FDateTime> DocumentTimestamps;
+	DocumentTimestamps.Reserve( Documents.Num() );
+
+	for( int32 Index = 0; Index < Documents.Num(); ++Index )
+	{
+		DocumentTimestamps.Add( Documents[ Index ], DocumentTimes[ Index ] );
+	}
+
+	// the state of every asset, the documentation and timestamps are only read here
+	TArray<EMarkdownDocumentationState> States;
+	TArray<FDateTime> AssetTimes;
+	States.SetNum( Assets.Num() );
+	AssetTimes.SetNum( Assets.Num() );
+
+	ParallelFor( Assets.Num(), [ & ]( const int32 Index )
+	{
+		const FAsset& Asset = Assets[ Index ];
+		AssetTimes[ Index ] = GetTimestamp( Asset.Path, Asset.Category == EMarkdownCoverageCategory::Map );
+
+		const FMarkdownDocumentation* Found = Documentation.Find( Asset.Path );
+		const FDateTime DocumentTime = Found != nullptr ? DocumentTimestamps.FindRef( Found->Document ) : FDateTime::MinValue();
+
+		// documentation whose document has gone is no documentation
+		if( Found == nullptr || DocumentTime == FDateTime::MinValue() )
+		{
+			States[ Index ] = EMarkdownDocumentationState::Undocumented;
+			return;
+		}
+
+		// timestamps only for documents saved before they kept the hashes, a fresh checkout makes them all the same
+		const bool bStale = Found->AssetHash.IsZero() ? AssetTimes[ Index ] > DocumentTime : Found->IsStale( Asset.Path, AssetRegistry );
+		States[ Index ] = bStale ? EMarkdownDocumentationState::Stale : EMarkdownDocumentationState::Current;
+	});
+
+	// each folder's own assets, then added to every folder above it up to the root
+	TMap<FName, FMarkdownCoverageFolder> OwnAssets;
+
+	for( int32 Index = 0; Index < Assets.Num(); ++Index )
+	{
+		const FAsset& Asset = Assets[ Index ];
+		const int32 Category = int32( Asset.Category );
+
+		FMarkdownCoverageFolder& Folder = OwnAssets.FindOrAdd( Asset.Folder );
+		Count( Folder.Total, States[ Index ] );
+		Count( Folder.Categories[ Category ], States[ Index ] );
+		Count( OutReport.Total, States[ Index ] );
+		Count( OutReport.Categories[ Category ], States[ Index ] );
+
+		if( States[ Index ] != EMarkdownDocumentationState::Current )
+		{
+			FMarkdownCoverageEntry& Entry = OutReport.Entries.AddDefaulted_GetRef();
+			Entry.Asset          = Asset.Path;
+			Entry.Folder         = Asset.Folder;
+			Entry.Category       = Asset.Category;
+			Entry.AssetTimestamp = AssetTimes[ Index ];
+
+			if( States[ Index ] == EMarkdownDocumentationState::Stale )
+			{
+				Entry.Document          = Documentation[ Asset.Path ].Document;
+				Entry.DocumentTimestamp = DocumentTimestamps.FindRef( Entry.Document );
+			}
+		}
+	}
+
+	TMap<FString, FMarkdownCoverageFolder> Folders;
+
+	for( const TPair<FName, FMarkdownCoverageFolder>& Own : OwnAssets )
+	{
+		FString Path = Own.Key.ToString();
+
+		while( true )
+		{
+			FMarkdownCoverageFolder& Folder = Folders.FindOrAdd( Path );
+			Folder.Path = Path;
+			Folder.Total.Add( Own.Value.Total );
+
+			for( int32 Category = 0; Category < int32( EMarkdownCoverageCategory::Num ); ++Category )
+			{
+				Folder.Categories[ Category ].Add( Own.Value.Categories[ Category ] );
+			}
+
+			int32 Slash = INDEX_NONE;
+
+			if( Path.Len() <= Root.Len() || !Path.FindLastChar( TEXT( '/' ), Slash ) || Slash <= 0 )
+			{
+				break;
+			}
+
+			Path.LeftInline( Slash );
+		}
+	}
+
+	Folders.GenerateValueArray( OutReport.Folders );
+
+	OutReport.Folders.Sort( []( const FMarkdownCoverageFolder& A, const FMarkdownCoverageFolder& B )
+	{
+		return A.Path < B.Path;
+	});
+
+	OutReport.Entries.Sort( []( const FMarkdownCoverageEntry& A, const FMarkdownCoverageEntry& B )
+	{
+		const int32 Folder = A.Folder.Compare( B.Folder );
+		return Folder != 0 ? Folder < 0 : A.Asset.GetAssetFName().Compare( B.Asset.GetAssetFName() ) < 0;
+	});
+
+	OutReport.Seconds = FPlatformTime::Seconds() - Start;
+}
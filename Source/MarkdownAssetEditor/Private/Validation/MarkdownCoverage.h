@@ -0,0 +1,130 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Search/MarkdownDocumentationSubsystem.h"
+
+enum class EMarkdownCoverageCategory : uint8
+{
+	/** including animation and widget blueprints */
+	Blueprint,
+
+	/** including primary data assets */
+	DataAsset,
+
+	Map,
+
+	Num,
+};
+
+struct FMarkdownCoverageCounts
+{
+	int32 NumAssets = 0;
+	int32 NumDocumented = 0;
+
+	/** of the documented ones */
+	int32 NumStale = 0;
+
+	/** 0 to 1, and 1 with nothing to document */
+	float GetCoverage() const
+	{
+		return NumAssets > 0 ? float( NumDocumented ) / float( NumAssets ) : 1.0f;
+	}
+
+	void Add( const FMarkdownCoverageCounts& Other )
+	{
+		NumAssets     += Other.NumAssets;
+		NumDocumented += Other.NumDocumented;
+		NumStale      += Other.NumStale;
+	}
+};
+
+struct FMarkdownCoverageFolder
+{
+	/** package path, /Game/... */
+	FString Path;
+
+	/** of the assets in the folder and every folder under it */
+	FMarkdownCoverageCounts Total;
+	FMarkdownCoverageCounts Categories[ int32( EMarkdownCoverageCategory::Num ) ];
+};
+
+/** An asset without documentation, or with documentation older than it. */
+struct FMarkdownCoverageEntry
+{
+	FSoftObjectPath Asset;
+
+	/** package path of the asset */
+	FName Folder;
+
+	EMarkdownCoverageCategory Category = EMarkdownCoverageCategory::Blueprint;
+
+	/** null if the asset is undocumented */
+	FSoftObjectPath Document;
+
+	/** when the packages were last written, MinValue if there is no file */
+	FDateTime AssetTimestamp;
+	FDateTime DocumentTimestamp;
+
+	bool IsStale() const
+	{
+		return Document.IsValid();
+	}
+};
+
+struct FMarkdownCoverageReport
+{
+	/** package path the report is for */
+	FString Root;
+
+	FMarkdownCoverageCounts Total;
+	FMarkdownCoverageCounts Categories[ int32( EMarkdownCoverageCategory::Num ) ];
+
+	/** every folder with something to document in it or under it, by path */
+	TArray<FMarkdownCoverageFolder> Folders;
+
+	/** the undocumented and stale assets, by folder then name */
+	TArray<FMarkdownCoverageEntry> Entries;
+
+	double Seconds = 0.0;
+
+	/** Saved/MarkdownCoverage/Report.json */
+	static FString GetDefaultFilename();
+
+	static const TCHAR* GetCategoryName( const EMarkdownCoverageCategory Category );
+
+	/** Writes the report as JSON, the coverage of each category and folder and a list of the assets to look at. */
+	bool Save( const FString& Filename ) const;
+};
+
+/**
+ * How much of the project is documented, and which documentation is older than its asset, for blueprints, data assets
+ * and maps. Everything comes from the asset registry and the documentation there (UMarkdownDocumentationSubsystem),
+ * so nothing is loaded. Documentation is stale when the asset has been saved since the document was, going by the
+ * package hashes documents keep or, for documents saved before they kept them, the file timestamps, which are read
+ * on workers.
+ */
+class FMarkdownCoverage
+{
+public:
+
+	/** Gathers the assets under the package path and their documentation from the asset registry. Game thread. */
+	explicit FMarkdownCoverage( const FString& InRoot = TEXT( "/Game" ) );
+
+	/** Once, from any thread. */
+	void Build( FMarkdownCoverageReport& OutReport );
+
+private:
+
+	struct FAsset
+	{
+		FSoftObjectPath Path;
+		FName Folder;
+		EMarkdownCoverageCategory Category = EMarkdownCoverageCategory::Blueprint;
+	};
+
+	FString Root;
+	TArray<FAsset> Assets;
+	TMap<FSoftObjectPath, FMarkdownDocumentation> Documentation;
+};
@@ -0,0 +1,419 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Validation/MarkdownValidator.h"
+
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "ContentBrowser/MarkdownContentBrowserHierarchy.h"
+#include "HAL/PlatformTime.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Parser/MarkdownHeadingIndex.h"
+#include "Parser/MarkdownParser.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Search/MarkdownLinkGraph.h"
+#include "Serialization/JsonWriter.h"
+
+namespace MarkdownValidator
+{
+	static bool IsNative( const FSoftObjectPath& Path )
+	{
+		// classes and their defaults, which are not in the asset registry and always there
+		return Path.GetLongPackageName().StartsWith( TEXT( "/Script/" ) );
+	}
+
+	// the anchor as the viewer's link has it, markdown-it encodes destinations (mdurl.encode) and leaves escapes that
+	// are already there, so "#héllo" finds the heading slugged "h%C3%A9llo"
+	static FString EncodeAnchor( const FString& Anchor )
+	{
+		auto IsHex = []( const TCHAR C )
+		{
+			return FChar::IsDigit( C ) || ( C >= TEXT( 'a' ) && C <= TEXT( 'f' ) ) || ( C >= TEXT( 'A' ) && C <= TEXT( 'F' ) );
+		};
+
+		FString Encoded;
+		Encoded.Reserve( Anchor.Len() );
+
+		for( int32 Index = 0; Index < Anchor.Len(); ++Index )
+		{
+			const TCHAR C = Anchor[ Index ];
+
+			if( C == TEXT( '%' ) && Index + 2 < Anchor.Len() && IsHex( Anchor[ Index + 1 ] ) && IsHex( Anchor[ Index + 2 ] ) )
+			{
+				Encoded.Append( *Anchor + Index, 3 );
+				Index += 2;
+			}
+			else if( C < 128 && ( FChar::IsAlnum( C ) || FCString::Strchr( TEXT( ";/?:@&=+$,-_.!~*'()#" ), C ) != nullptr ) )
+			{
+				Encoded.AppendChar( C );
+			}
+			else
+			{
+				// a character at a time, so a pair of surrogates is one code point
+				int32 Length = 1;
+
+				if( C >= 0xD800 && C <= 0xDBFF && Index + 1 < Anchor.Len() && Anchor[ Index + 1 ] >= 0xDC00 && Anchor[ Index + 1 ] <= 0xDFFF )
+				{
+					Length = 2;
+				}
+
+				const FTCHARToUTF8 Utf8( *Anchor + Index, Length );
+
+				for( int32 Byte = 0; Byte < Utf8.Length(); ++Byte )
+				{
+					Encoded.Appendf( TEXT( "%%%02X" ), static_cast<uint8>( Utf8.Get()[ Byte ] ) );
+				}
+
+				Index += Length - 1;
+			}
+		}
+
+		return Encoded;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownValidationReport::GetDefaultFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT( "MarkdownValidate" ) / TEXT( "Report.json" );
+}
+
+const TCHAR* FMarkdownValidationReport::GetProblemName( const EMarkdownLinkProblem Problem )
+{
+	switch( Problem )
+	{
+		case EMarkdownLinkProblem::MissingAsset:    return TEXT( "MissingAsset" );
+		case EMarkdownLinkProblem::RedirectedAsset: return TEXT( "RedirectedAsset" );
+		case EMarkdownLinkProblem::MissingDocument: return TEXT( "MissingDocument" );
+		case EMarkdownLinkProblem::MissingAnchor:   return TEXT( "MissingAnchor" );
+		case EMarkdownLinkProblem::MissingFile:     return TEXT( "MissingFile" );
+	}
+
+	return TEXT( "" );
+}
+
+bool FMarkdownValidationReport::Save( const FString& Filename ) const
+{
+	FString Json;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create( &Json );
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue( TEXT( "documents" ), NumDocuments );
+	Writer->WriteValue( TEXT( "links" ), NumLinks );
+	Writer->WriteValue( TEXT( "problems" ), Issues.Num() );
+	Writer->WriteValue( TEXT( "seconds" ), Seconds );
+
+	Writer->WriteArrayStart( TEXT( "issues" ) );
+
+	for( const FMarkdownLinkIssue& Issue : Issues )
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue( TEXT( "document" ), Issue.Document );
+
+		if( Issue.Line > 0 )
+		{
+			Writer->WriteValue( TEXT( "line" ), Issue.Line );
+		}
+
+		Writer->WriteValue( TEXT( "link" ), Issue.Destination );
+		Writer->WriteValue( TEXT( "problem" ), GetProblemName( Issue.Problem ) );
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteArrayEnd();
+
+	if( Unchecked.Num() > 0 )
+	{
+		Writer->WriteValue( TEXT( "unchecked" ), Unchecked );
+	}
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	return FFileHelper::SaveStringToFile( Json, *Filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownValidator::FMarkdownValidator( const bool bLoadUntagged )
+{
+	TArray<FAssetData> MarkdownAssets;
+	IAssetRegistry::GetChecked().GetAssetsByClass( UMarkdownAsset::StaticClass()->GetClassPathName(), MarkdownAssets, true );
+
+	for( const FAssetData& AssetData : MarkdownAssets )
+	{
+		TArray<FString> Destinations;
+		TArray<FString> Slugs;
+
+		if( !UMarkdownAsset::GetLinks( AssetData, Destinations ) || !UMarkdownAsset::GetHeadingSlugs( AssetData, Slugs ) )
+		{
+			// loading the rest would stall the editor for as long as it takes, saving them again puts the tags in
+			const UMarkdownAsset* Asset = bLoadUntagged ? Cast<UMarkdownAsset>( AssetData.GetAsset() ) : nullptr;
+
+			if( Asset == nullptr )
+			{
+				Unchecked.Add( AssetData.GetObjectPathString() );
+			}
+			else
+			{
+				FSource& Source = Sources.AddDefaulted_GetRef();
+				Source.Path = AssetData.GetObjectPathString();
+				Source.Text = Asset->Text.BuildSourceString();
+			}
+
+			continue;
+		}
+
+		FSource& Source = Sources.AddDefaulted_GetRef();
+		Source.Path      = AssetData.GetObjectPathString();
+		Source.bFromTags = true;
+		Source.Slugs.Append( Slugs );
+
+		for( const FString& Destination : Destinations )
+		{
+			Source.Links.Add( FMarkdownLinks::Classify( Destination ) );
+			Source.Lines.Add( 0 );
+		}
+	}
+
+	if( Unchecked.Num() > 0 )
+	{
+		UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown validate: %d markdown assets were saved without their links and are not checked, saving them again adds them" ), Unchecked.Num() );
+	}
+}
+
+void FMarkdownValidator::Validate( FMarkdownValidationReport& OutReport )
+{
+	const double Start = FPlatformTime::Seconds();
+
+	TArray<FString> Files;
+	FMarkdownContentBrowserHierarchy::FindMDFiles( Files );
+
+	for( FString& File : Files )
+	{
+		Sources.AddDefaulted_GetRef().Path = MoveTemp( File );
+	}
+
+	ParallelFor( Sources.Num(), [ this ]( const int32 Index )
+	{
+		ReadSource( Sources[ Index ] );
+	});
+
+	SourceIds.Reserve( Sources.Num() );
+
+	for( int32 Index = 0; Index < Sources.Num(); ++Index )
+	{
+		SourceIds.Add( Sources[ Index ].Path, Index );
+	}
+
+	FindAssets();
+
+	TArray<TArray<FMarkdownLinkIssue>> Issues;
+	Issues.SetNum( Sources.Num() );
+
+	ParallelFor( Sources.Num(), [ this, &Issues ]( const int32 Index )
+	{
+		CheckLinks( Sources[ Index ], Issues[ Index ] );
+	});
+
+	OutReport.NumDocuments = Sources.Num();
+	OutReport.NumLinks     = 0;
+	OutReport.Issues.Reset();
+	OutReport.Unchecked    = Unchecked;
+
+	for( int32 Index = 0; Index < Sources.Num(); ++Index )
+	{
+		OutReport.NumLinks += Sources[ Index ].Links.Num();
+		OutReport.Issues.Append( MoveTemp( Issues[ Index ] ) );
+	}
+
+	OutReport.Issues.StableSort( []( const FMarkdownLinkIssue& A, const FMarkdownLinkIssue& B )
+	{
+		const int32 Compare = A.Document.Compare( B.Document, ESearchCase::IgnoreCase );
+		return Compare != 0 ? Compare < 0 : A.Line < B.Line;
+	});
+
+	OutReport.Seconds = FPlatformTime::Seconds() - Start;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownValidator::ReadSource( FSource& Source ) const
+{
+	if( Source.bFromTags )
+	{
+		return;
+	}
+
+	// assets that were loaded have their text already, an empty one has nothing to check either way
+	if( Source.Text.IsEmpty() && Source.Path.EndsWith( TEXT( ".md" ) ) )
+	{
+		FFileHelper::LoadFileToString( Source.Text, *FMarkdownContentBrowserHierarchy::ConvertInternalPathToFileSystemPath( Source.Path ) );
+	}
+
+	FMarkdownDocument Document;
+	FMarkdownParser::Parse( Source.Text, Document );
+	FMarkdownLinks::Collect( Document, Source.Links );
+
+	TArray<FMarkdownHeading> Headings;
+	FMarkdownHeadingIndex::Build( Source.Text, Headings );
+
+	for( const FMarkdownHeading& Heading : Headings )
+	{
+		Source.Slugs.Add( Heading.Slug );
+	}
+
+	// links come in document order, so the lines are counted in one pass
+	const TCHAR* Text = *Source.Text;
+	int32 Line   = 1;
+	int32 Offset = 0;
+
+	Source.Lines.Reserve( Source.Links.Num() );
+
+	for( const FMarkdownLink& Link : Source.Links )
+	{
+		if( Link.SourceOffset < Offset )
+		{
+			Line   = 1;
+			Offset = 0;
+		}
+
+		for( ; Offset < Link.SourceOffset && Offset < Source.Text.Len(); ++Offset )
+		{
+			Line += Text[ Offset ] == TEXT( '\n' ) ? 1 : 0;
+		}
+
+		Source.Lines.Add( Line );
+	}
+
+	// nothing needs the text past here
+	Source.Text.Empty();
+}
+
+void FMarkdownValidator::FindAssets()
+{
+	TSet<FName> PackageNames;
+
+	for( const FSource& Source : Sources )
+	{
+		for( const FMarkdownLink& Link : Source.Links )
+		{
+			const FSoftObjectPath Path( Link.Target );
+
+			if( Link.Type == EMarkdownLinkType::Asset && Path.IsValid() && !MarkdownValidator::IsNative( Path ) )
+			{
+				PackageNames.Add( Path.GetLongPackageFName() );
+			}
+		}
+	}
+
+	// an empty filter would be every asset in the project
+	if( PackageNames.IsEmpty() )
+	{
+		return;
+	}
+
+	// one query for all of them, and only what is on disk, which is what would be there in a build
+	FARFilter Filter;
+	Filter.PackageNames = PackageNames.Array();
+	Filter.bIncludeOnlyOnDiskAssets = true;
+
+	TArray<FAssetData> Found;
+	IAssetRegistry::GetChecked().GetAssets( Filter, Found );
+
+	for( const FAssetData& AssetData : Found )
+	{
+		Packages.Add( AssetData.PackageName );
+		( AssetData.IsRedirector() ? Redirectors : Assets ).Add( AssetData.GetSoftObjectPath() );
+	}
+}
+
+void FMarkdownValidator::CheckLinks( const FSource& Source, TArray<FMarkdownLinkIssue>& OutIssues ) const
+{
+	for( int32 Index = 0; Index < Source.Links.Num(); ++Index )
+	{
+		const FMarkdownLink& Link = Source.Links[ Index ];
+		TOptional<EMarkdownLinkProblem> Problem;
+
+		switch( Link.Type )
+		{
+			case EMarkdownLinkType::Asset:
+			{
+				const FSoftObjectPath Path( Link.Target );
+				const FSoftObjectPath AssetPath = Path.GetWithoutSubPath();
+
+				if( !Path.IsValid() )
+				{
+					Problem = EMarkdownLinkProblem::MissingAsset;
+				}
+				else if( MarkdownValidator::IsNative( Path ) )
+				{
+					break;
+				}
+				else if( Path.GetAssetName().IsEmpty() ? !Packages.Contains( Path.GetLongPackageFName() ) : !Assets.Contains( AssetPath ) )
+				{
+					Problem = Redirectors.Contains( AssetPath ) ? EMarkdownLinkProblem::RedirectedAsset : EMarkdownLinkProblem::MissingAsset;
+				}
+
+				break;
+			}
+
+			case EMarkdownLinkType::Anchor:
+			{
+				if( !Link.Anchor.IsEmpty() && !Source.Slugs.Contains( MarkdownValidator::EncodeAnchor( Link.Anchor ) ) )
+				{
+					Problem = EMarkdownLinkProblem::MissingAnchor;
+				}
+
+				break;
+			}
+
+			case EMarkdownLinkType::Document:
+			{
+				const FString Path = FMarkdownLinkGraph::ResolvePath( Source.Path, Link.Target );
+				const int32* Target = Path.IsEmpty() ? nullptr : SourceIds.Find( Path );
+
+				if( Target == nullptr )
+				{
+					Problem = EMarkdownLinkProblem::MissingDocument;
+				}
+				else if( !Link.Anchor.IsEmpty() && !Sources[ *Target ].Slugs.Contains( MarkdownValidator::EncodeAnchor( Link.Anchor ) ) )
+				{
+					Problem = EMarkdownLinkProblem::MissingAnchor;
+				}
+
+				break;
+			}
+
+			case EMarkdownLinkType::File:
+			{
+				// only files in the documentation, anything else is up to whoever shows it
+				const FString Path = FMarkdownLinkGraph::ResolvePath( Source.Path, Link.Target );
+
+				if( Path.IsEmpty() )
+				{
+					Problem = EMarkdownLinkProblem::MissingFile;
+				}
+				else if( Path.StartsWith( TEXT( "/Documentation/" ) ) && !FPaths::FileExists( FMarkdownContentBrowserHierarchy::ConvertInternalPathToFileSystemPath( Path ) ) )
+				{
+					Problem = EMarkdownLinkProblem::MissingFile;
+				}
+
+				break;
+			}
+
+			case EMarkdownLinkType::External:
+				break;
+		}
+
+		if( Problem.IsSet() )
+		{
+			OutIssues.Add( { Source.Path, Source.Lines.IsValidIndex( Index ) ? Source.Lines[ Index ] : 0, Link.Destination, Problem.GetValue() } );
+		}
+	}
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Parser/MarkdownLinks.h"
+
+enum class EMarkdownLinkProblem : uint8
+{
+	/** nothing in the asset registry at the path */
+	MissingAsset,
+
+	/** the path is a redirector, the link works until redirectors are fixed up */
+	RedirectedAsset,
+
+	/** no .md file at the path, or the path is outside the documentation */
+	MissingDocument,
+
+	/** the document has no heading with the slug */
+	MissingAnchor,
+
+	/** no file at the path */
+	MissingFile,
+};
+
+struct FMarkdownLinkIssue
+{
+	/** content browser path of the file (/Documentation/...) or the object path of the asset */
+	FString Document;
+
+	/** from 1, 0 for assets whose links were read from the asset registry rather than their text */
+	int32 Line = 0;
+
+	/** as written */
+	FString Destination;
+
+	EMarkdownLinkProblem Problem = EMarkdownLinkProblem::MissingAsset;
+};
+
+struct FMarkdownValidationReport
+{
+	int32 NumDocuments = 0;
+	int32 NumLinks = 0;
+	double Seconds = 0.0;
+
+	/** by document, then line */
+	TArray<FMarkdownLinkIssue> Issues;
+
+	/** markdown assets saved before their links and headings were in the asset registry, which are not loaded to be checked */
+	TArray<FString> Unchecked;
+
+	/** Saved/MarkdownValidate/Report.json */
+	static FString GetDefaultFilename();
+
+	static const TCHAR* GetProblemName( const EMarkdownLinkProblem Problem );
+
+	/** Writes the report as JSON, a summary and a list of issues. */
+	bool Save( const FString& Filename ) const;
+};
+
+/**
+ * Checks the links of all the project documentation, .md files and markdown assets. Files are read and parsed on
+ * workers, markdown assets only need what they saved in the asset registry, and links to assets are looked up all at
+ * once in the asset registry, so nothing is loaded. Links to documents are checked against the files, and anchors
+ * against their headings, with the slugs the viewer gives them.
+ */
+class FMarkdownValidator
+{
+public:
+
+	/**
+	 * Gathers the markdown assets from the asset registry. Ones saved before their links were in it are loaded if
+	 * bLoadUntagged, which the commandlet does as it has nothing to stall, or else left out and listed in the report.
+	 * Game thread.
+	 */
+	explicit FMarkdownValidator( const bool bLoadUntagged = false );
+
+	/** Once, from any thread. */
+	void Validate( FMarkdownValidationReport& OutReport );
+
+private:
+
+	struct FSource
+	{
+		FString Path;
+
+		/** of the assets that were loaded, files are read on the workers */
+		FString Text;
+
+		/** the links are from the asset registry, so there is no text to read */
+		bool bFromTags = false;
+
+		TArray<FMarkdownLink> Links;
+
+		/** of each link */
+		TArray<int32> Lines;
+
+		TSet<FString> Slugs;
+	};
+
+	void ReadSource( FSource& Source ) const;
+	void CheckLinks( const FSource& Source, TArray<FMarkdownLinkIssue>& OutIssues ) const;
+	void FindAssets();
+
+	TArray<FSource> Sources;
+	TArray<FString> Unchecked;
+
+	/** index of each source in Sources by path */
+	TMap<FString, int32> SourceIds;
+
+	/** the asset links found, by what is at the path */
+	TSet<FSoftObjectPath> Assets;
+	TSet<FSoftObjectPath> Redirectors;
+	TSet<FName> Packages;
+};
@@ -2,6 +2,176 @@
 
 #include "MarkdownBinding.h"
 #include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetEditorModule.h"
+#include "MarkdownRenderCache.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+FText UMarkdownBinding::GetText()
+{
+	if( bTextStale )
+	{
+		Text       = FText::FromString( Buffer.ToString() );
+		bTextStale = false;
+	}
+
+	return Text;
+}
+
+void UMarkdownBinding::SetText( FText text )
+{
+	SetTextInternal( MoveTemp( text ) );
+	bUncommitted = true;
+	OnSetText.Broadcast();
+}
+
+void UMarkdownBinding::SetDocument( UMarkdownAsset* InDocument )
+{
+	Document = InDocument;
+	SetTextInternal( InDocument != nullptr ? CopyTemp( InDocument->Text ) : FText::GetEmpty() );
+}
+
+bool UMarkdownBinding::CommitText()
+{
+	UMarkdownAsset* Asset = Document.Get();
+
+	if( !bUncommitted || Asset == nullptr )
+	{
+		return false;
+	}
+
+	bUncommitted = false;
+
+	Asset->SetText( GetText() );
+	if( Asset->OnChanged.IsBound() )
+	{
+		Asset->OnChanged.Execute();
+	}
+
+	return true;
+}
+
+void UMarkdownBinding::SetTextInternal( FText&& InText )
+{
+	// the buffer is only filled in once the first edit arrives, documents that are just read never need it
+	Text         = MoveTemp( InText );
+	Version       = 0;
+	bBufferValid  = false;
+	bTextStale    = false;
+	bPendingEdits = false;
+	bUncommitted  = false;
+}
+
+bool UMarkdownBinding::ApplyEdit( int32 InVersion, int32 Offset, int32 DeleteLength, FString Insert, int32 Checksum )
+{
+#if PLATFORM_TCHAR_IS_4_BYTES
+	// offsets are UTF-16 code units, they only line up with our characters when TCHAR is 16 bits
+	return false;
+#else
+	if( InVersion != Version )
+	{
+		return false;
+	}
+
+	if( !bBufferValid )
+	{
+		Buffer.Reset( Text.ToString() );
+		bBufferValid = true;
+	}
+
+	if( Offset < 0 || DeleteLength < 0 || Offset > Buffer.Len() - DeleteLength )
+	{
+		RejectEdit();
+		return false;
+	}
+
+	// kept to take the edit back out if it does not leave us with the viewer's text
+	const FString Deleted = Buffer.Mid( Offset, DeleteLength );
+	Buffer.Replace( Offset, DeleteLength, Insert );
+
+	if( int32( Buffer.GetChecksum() ) != Checksum )
+	{
+		Buffer.Replace( Offset, Insert.Len(), Deleted );
+		RejectEdit();
+		return false;
+	}
+
+	++Version;
+	bTextStale    = true;
+	bPendingEdits = false;
+	bUncommitted  = true;
+
+	OnSetText.Broadcast();
+	return true;
+#endif
+}
+
+void UMarkdownBinding::RejectEdit()
+{
+	// we have drifted apart, only the one edit is dropped, the ones before it are still to be committed and Text is
+	// what they are committed from until the viewer sends the full text
+	if( bTextStale )
+	{
+		Text       = FText::FromString( Buffer.ToString() );
+		bTextStale = false;
+	}
+
+	bBufferValid = false;
+}
+
+FString UMarkdownBinding::GetRenderCache( FString Keys )
+{
+	TArray<TSharedPtr<FJsonValue>> KeyValues;
+	if( !FJsonSerializer::Deserialize( TJsonReaderFactory<>::Create( Keys ), KeyValues ) )
+	{
+		return TEXT( "{}" );
+	}
+
+	TArray<FString> KeyStrings;
+	KeyStrings.Reserve( KeyValues.Num() );
+
+	for( const TSharedPtr<FJsonValue>& Value : KeyValues )
+	{
+		KeyStrings.Add( Value->AsString() );
+	}
+
+	TMap<FString, FString> Found;
+	FMarkdownAssetEditorModule::Get().GetRenderCache().Find( KeyStrings, Found );
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	for( const TPair<FString, FString>& Entry : Found )
+	{
+		Result->SetStringField( Entry.Key, Entry.Value );
+	}
+
+	FString Json;
+	FJsonSerializer::Serialize( Result, TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create( &Json ) );
+	return Json;
+}
+
+void UMarkdownBinding::StoreRenderCache( FString Entries )
+{
+	TSharedPtr<FJsonObject> Object;
+	if( !FJsonSerializer::Deserialize( TJsonReaderFactory<>::Create( Entries ), Object ) || !Object.IsValid() )
+	{
+		return;
+	}
+
+	FMarkdownRenderCache& Cache = FMarkdownAssetEditorModule::Get().GetRenderCache();
+
+	for( const TPair<FString, TSharedPtr<FJsonValue>>& Entry : Object->Values )
+	{
+		FString Html;
+		if( Entry.Value.IsValid() && Entry.Value->TryGetString( Html ) )
+		{
+			Cache.Add( Entry.Key, Html );
+		}
+	}
+}
 
 void UMarkdownBinding::OpenURL( FString URL )
 {
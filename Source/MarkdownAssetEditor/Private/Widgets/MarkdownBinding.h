@@ -4,8 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "MarkdownTextBuffer.h"
 #include "MarkdownBinding.generated.h"
 
+class UMarkdownAsset;
+
+/**
+ * What the viewer calls into. Edits from the viewer are kept here and only written to the document with CommitText,
+ * which the editor does when it flushes, saves or lets go of the browser.
+ */
 UCLASS()
 class MARKDOWNASSETEDITOR_API UMarkdownBinding : public UObject
 {
@@ -14,10 +21,48 @@ class MARKDOWNASSETEDITOR_API UMarkdownBinding : public UObject
 public:
 
 	UFUNCTION()
-	FText GetText() { return Text; }
+	FText GetText();
+
+	/** Replaces the whole text, the viewer does this when it first edits a document or after an edit was rejected. */
+	UFUNCTION()
+	void SetText( FText text );
 
+	/**
+	 * Applies one edit from the viewer. The viewer numbers its edits from zero after every SetText and sends the
+	 * checksum of the text it ends up with, if either does not match ours the edit is rejected and the viewer
+	 * sends the whole text again.
+	 */
 	UFUNCTION()
-	void SetText( FText text ) { Text = text; OnSetText.Broadcast(); }
+	bool ApplyEdit( int32 version, int32 offset, int32 deletelength, FString insert, int32 checksum );
+
+	/** The viewer calls this as soon as it has edits it is holding back, they arrive later with SetText or ApplyEdit. */
+	UFUNCTION()
+	void SetPending() { bPendingEdits = true; OnEditPending.Broadcast(); }
+
+	bool HasPendingEdits() const
+	{
+		return bPendingEdits;
+	}
+
+	/** Sets the document being edited, nothing is broadcast. Null when the browser is not showing one. */
+	void SetDocument( UMarkdownAsset* InDocument );
+
+	/** Writes the edits made since the last commit to the document, false if there were none. */
+	bool CommitText();
+
+	UFUNCTION()
+	FString GetState() { return State; }
+
+	UFUNCTION()
+	void SaveState( FString state ) { State = state; OnSaveState.Broadcast(); }
+
+	/** Takes a json array of cache keys and returns a json object with the rendered output for the ones we have. */
+	UFUNCTION()
+	FString GetRenderCache( FString keys );
+
+	/** Takes a json object of cache key to rendered output. */
+	UFUNCTION()
+	void StoreRenderCache( FString entries );
 
 	UFUNCTION()
 	void OpenURL( FString url );
@@ -28,5 +73,32 @@ public:
 	DECLARE_EVENT( UMarkdownBinding, FOnSetTextEvent )
 	FOnSetTextEvent OnSetText;
 
+	DECLARE_EVENT( UMarkdownBinding, FOnEditPendingEvent )
+	FOnEditPendingEvent OnEditPending;
+
+	DECLARE_EVENT( UMarkdownBinding, FOnSaveStateEvent )
+	FOnSaveStateEvent OnSaveState;
+
+	/** opaque viewer state (json), kept while the browser is suspended */
+	FString State;
+
+private:
+
+	void SetTextInternal( FText&& InText );
+	void RejectEdit();
+
+	TWeakObjectPtr<UMarkdownAsset> Document;
+
 	FText Text;
+
+	/** edits are applied here, Text is only rebuilt from it when someone asks for it */
+	FMarkdownTextBuffer Buffer;
+
+	int32 Version = 0;
+	bool bBufferValid = false;
+	bool bTextStale = false;
+	bool bPendingEdits = false;
+
+	/** edits that are not in the document yet */
+	bool bUncommitted = false;
 };
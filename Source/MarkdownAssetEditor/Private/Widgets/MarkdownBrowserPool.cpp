@@ -0,0 +1,233 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownBrowserPool.h"
+
+#include "IWebBrowserSingleton.h"
+#include "IWebBrowserWindow.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAssetEditorSettings.h"
+#include "MarkdownBinding.h"
+#include "MarkdownViewerContent.h"
+#include "WebBrowserModule.h"
+
+namespace MarkdownBrowserPool
+{
+	/** how long a released browser waits for the viewer's last edits, the same as a save does */
+	static constexpr double FlushTimeout = 2.0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownBrowserPool::FMarkdownBrowserPool( const TSharedRef<FMarkdownViewerContent>& InViewerContent )
+	: ViewerContent( InViewerContent )
+{
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateRaw( this, &FMarkdownBrowserPool::Tick ), 1.0f );
+}
+
+FMarkdownBrowserPool::~FMarkdownBrowserPool()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker( TickerHandle );
+	FTSTicker::GetCoreTicker().RemoveTicker( ReleaseTickerHandle );
+	Empty();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TSharedRef<FMarkdownPooledBrowser> FMarkdownBrowserPool::Acquire( const bool bDarkSkin )
+{
+	LastAcquireTime = FPlatformTime::Seconds();
+	bLastDarkSkin   = bDarkSkin;
+
+	// take the browser that has been warm the longest, it is the most likely to have finished loading
+	for( int32 Index = 0; Index < Available.Num(); ++Index )
+	{
+		if( Available[ Index ]->bDarkSkin == bDarkSkin && Available[ Index ]->Window.IsValid() )
+		{
+			TSharedRef<FMarkdownPooledBrowser> Browser = Available[ Index ].ToSharedRef();
+			Available.RemoveAt( Index );
+			Browser->LastUsedTime = LastAcquireTime;
+			Browser->Window->SetIsHidden( false );
+			return Browser;
+		}
+	}
+
+	return CreateBrowser( bDarkSkin );
+}
+
+void FMarkdownBrowserPool::Release( const TSharedPtr<FMarkdownPooledBrowser>& Browser )
+{
+	if( !Browser.IsValid() )
+	{
+		return;
+	}
+
+	// resetting the viewer throws away whatever it is holding, so those edits have to reach the document first
+	if( Browser->Window.IsValid() && Browser->bScriptable && Browser->Binding->HasPendingEdits() )
+	{
+		Browser->Window->ExecuteJavascript( TEXT( "window.markdownviewer && window.markdownviewer.flush()" ) );
+		Browser->ReleaseDeadline = FPlatformTime::Seconds() + MarkdownBrowserPool::FlushTimeout;
+		Browser->Window->SetIsHidden( true );
+
+		Releasing.Add( Browser );
+
+		if( !ReleaseTickerHandle.IsValid() )
+		{
+			ReleaseTickerHandle = FTSTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateRaw( this, &FMarkdownBrowserPool::TickReleasing ) );
+		}
+
+		return;
+	}
+
+	FinishRelease( Browser );
+}
+
+void FMarkdownBrowserPool::FinishRelease( const TSharedPtr<FMarkdownPooledBrowser>& Browser )
+{
+	Browser->Binding->CommitText();
+	Browser->Binding->OnSetText.Clear();
+	Browser->Binding->OnSaveState.Clear();
+	Browser->Binding->OnEditPending.Clear();
+	Browser->Binding->SetDocument( nullptr );
+	Browser->Binding->State.Empty();
+
+	const UMarkdownAssetEditorSettings* Settings = GetDefault<UMarkdownAssetEditorSettings>();
+
+	// the older viewer would keep showing the previous document, and send its text back as the next one's
+	if( !Browser->Window.IsValid() || !Browser->bScriptable || Browser->bDarkSkin != Settings->bDarkSkin || Available.Num() >= Settings->GetBrowserPoolSize() )
+	{
+		CloseBrowser( Browser );
+		return;
+	}
+
+	// clear out the previous document so it does not flash up when the browser is reused
+	Browser->Window->ExecuteJavascript( TEXT( "window.markdownviewer && window.markdownviewer.reset()" ) );
+	Browser->Window->SetIsHidden( true );
+	Browser->LastUsedTime = FPlatformTime::Seconds();
+
+	Available.Add( Browser );
+}
+
+void FMarkdownBrowserPool::Empty()
+{
+	for( const TSharedPtr<FMarkdownPooledBrowser>& Browser : Available )
+	{
+		CloseBrowser( Browser );
+	}
+
+	for( const TSharedPtr<FMarkdownPooledBrowser>& Browser : Releasing )
+	{
+		CloseBrowser( Browser );
+	}
+
+	Available.Empty();
+	Releasing.Empty();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TSharedRef<FMarkdownPooledBrowser> FMarkdownBrowserPool::CreateBrowser( const bool bDarkSkin ) const
+{
+	TSharedRef<FMarkdownPooledBrowser> Browser = MakeShared<FMarkdownPooledBrowser>();
+
+	// the browser singleton is only started when the first document is opened, so that is when the viewer gets served
+	ViewerContent->Register();
+
+	FCreateBrowserWindowSettings WindowSettings;
+	WindowSettings.InitialURL       = ViewerContent->GetViewerURL( bDarkSkin );
+	WindowSettings.BackgroundColor  = bDarkSkin ? FLinearColor( 0.1f, 0.1f, 0.1f, 1.0f ).ToFColor(true) : FLinearColor( 1.0f, 1.0f, 1.0f, 1.0f ).ToFColor(true);
+	WindowSettings.bUseTransparency = false;
+
+	Browser->Window       = IWebBrowserModule::Get().GetSingleton()->CreateBrowserWindow( WindowSettings );
+	Browser->Binding      = TStrongObjectPtr<UMarkdownBinding>( NewObject<UMarkdownBinding>() );
+	Browser->bDarkSkin    = bDarkSkin;
+	Browser->bScriptable  = ViewerContent->IsScriptable( bDarkSkin );
+	Browser->LastUsedTime = FPlatformTime::Seconds();
+
+	if( Browser->Window.IsValid() )
+	{
+		Browser->Window->BindUObject( TEXT( "MarkdownBinding" ), Browser->Binding.Get(), true );
+	}
+
+	return Browser;
+}
+
+void FMarkdownBrowserPool::CloseBrowser( const TSharedPtr<FMarkdownPooledBrowser>& Browser )
+{
+	if( Browser.IsValid() && Browser->Window.IsValid() )
+	{
+		Browser->Window->UnbindUObject( TEXT( "MarkdownBinding" ), Browser->Binding.Get(), true );
+		Browser->Window->CloseBrowser( true );
+		Browser->Window.Reset();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownBrowserPool::Tick( float DeltaTime )
+{
+	const UMarkdownAssetEditorSettings* Settings = GetDefault<UMarkdownAssetEditorSettings>();
+
+	const double Now         = FPlatformTime::Seconds();
+	const double IdleTimeout = Settings->GetBrowserPoolIdleTimeout();
+	const int32  PoolSize    = Settings->GetBrowserPoolSize();
+
+	// close anything that has been sitting around unused, or that is for the wrong skin
+	for( int32 Index = Available.Num() - 1; Index >= 0; --Index )
+	{
+		const TSharedPtr<FMarkdownPooledBrowser>& Browser = Available[ Index ];
+
+		if( !Browser->Window.IsValid() || Browser->bDarkSkin != Settings->bDarkSkin || Now - Browser->LastUsedTime > IdleTimeout || Index >= PoolSize )
+		{
+			CloseBrowser( Browser );
+			Available.RemoveAt( Index );
+		}
+	}
+
+	// only keep the pool topped up while documents are being opened, one browser per tick to spread the cost
+	if( Available.Num() < PoolSize && Now - LastAcquireTime < IdleTimeout && bLastDarkSkin == Settings->bDarkSkin && ViewerContent->IsScriptable( Settings->bDarkSkin ) )
+	{
+		TSharedRef<FMarkdownPooledBrowser> Browser = CreateBrowser( Settings->bDarkSkin );
+
+		// nobody is looking at it yet, the page still loads but does not paint
+		if( Browser->Window.IsValid() )
+		{
+			Browser->Window->SetIsHidden( true );
+		}
+
+		Available.Add( Browser );
+	}
+
+	return true;
+}
+
+bool FMarkdownBrowserPool::TickReleasing( float DeltaTime )
+{
+	const double Now = FPlatformTime::Seconds();
+
+	for( int32 Index = Releasing.Num() - 1; Index >= 0; --Index )
+	{
+		const TSharedPtr<FMarkdownPooledBrowser> Browser = Releasing[ Index ];
+		const bool bFlushed = !Browser->Window.IsValid() || !Browser->Binding->HasPendingEdits();
+
+		if( !bFlushed && Now < Browser->ReleaseDeadline )
+		{
+			continue;
+		}
+
+		if( !bFlushed )
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown viewer did not send its pending edits before its editor closed, they were not kept" ) );
+		}
+
+		Releasing.RemoveAt( Index );
+		FinishRelease( Browser );
+	}
+
+	if( Releasing.IsEmpty() )
+	{
+		ReleaseTickerHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Templates/SharedPointer.h"
+#include "UObject/StrongObjectPtr.h"
+
+class FMarkdownViewerContent;
+class IWebBrowserWindow;
+class UMarkdownBinding;
+
+/** A browser window with the viewer loaded and its binding object attached. */
+struct FMarkdownPooledBrowser
+{
+	TSharedPtr<IWebBrowserWindow> Window;
+	TStrongObjectPtr<UMarkdownBinding> Binding;
+
+	bool bDarkSkin = true;
+
+	/** the viewer can be told to show another document, see FMarkdownViewerContent::IsScriptable */
+	bool bScriptable = false;
+
+	double LastUsedTime = 0.0;
+
+	/** when to stop waiting for the viewer's last edits after the browser was released */
+	double ReleaseDeadline = 0.0;
+};
+
+/**
+ * Keeps a few browser windows with the viewer already loaded so opening a document only has to swap the text.
+ * Windows are handed out with Acquire() and given back with Release() when the editor closes. A window whose viewer
+ * is still holding edits is only reset once they have arrived. The pool refills itself while documents are being
+ * opened and closes windows that have not been used for a while. Only the split viewer build can be reused, with the
+ * older single page every document gets a browser of its own, as it did before there was a pool.
+ */
+class FMarkdownBrowserPool : public TSharedFromThis<FMarkdownBrowserPool>
+{
+public:
+
+	explicit FMarkdownBrowserPool( const TSharedRef<FMarkdownViewerContent>& InViewerContent );
+	~FMarkdownBrowserPool();
+
+	/** Takes a warm browser from the pool, or creates one if there are none for the skin. */
+	TSharedRef<FMarkdownPooledBrowser> Acquire( const bool bDarkSkin );
+
+	/**
+	 * Returns a browser to the pool, or closes it if the pool is full. Edits the viewer has not sent yet are asked for
+	 * first, and everything is committed to the document before the binding is cleared.
+	 */
+	void Release( const TSharedPtr<FMarkdownPooledBrowser>& Browser );
+
+	/** Closes every pooled browser. */
+	void Empty();
+
+private:
+
+	TSharedRef<FMarkdownPooledBrowser> CreateBrowser( const bool bDarkSkin ) const;
+	static void CloseBrowser( const TSharedPtr<FMarkdownPooledBrowser>& Browser );
+
+	/** Clears the binding and the viewer and puts the browser in the pool. */
+	void FinishRelease( const TSharedPtr<FMarkdownPooledBrowser>& Browser );
+
+	bool Tick( float DeltaTime );
+	bool TickReleasing( float DeltaTime );
+
+private:
+
+	TSharedRef<FMarkdownViewerContent> ViewerContent;
+
+	TArray<TSharedPtr<FMarkdownPooledBrowser>> Available;
+
+	/** released, but waiting for the viewer to send its last edits */
+	TArray<TSharedPtr<FMarkdownPooledBrowser>> Releasing;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	FTSTicker::FDelegateHandle ReleaseTickerHandle;
+
+	double LastAcquireTime = -DBL_MAX;
+	bool bLastDarkSkin = true;
+};
@@ -0,0 +1,75 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownRenderCache.h"
+
+#include "MarkdownAssetEditorSettings.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownRenderCache::Find( const TArray<FString>& Keys, TMap<FString, FString>& OutEntries )
+{
+	for( const FString& Key : Keys )
+	{
+		if( FEntry* Entry = Entries.Find( Key ) )
+		{
+			Entry->LastUsed = ++UseCounter;
+			OutEntries.Add( Key, Entry->Html );
+		}
+	}
+}
+
+void FMarkdownRenderCache::Add( const FString& Key, const FString& Html )
+{
+	const int64 Budget = GetDefault<UMarkdownAssetEditorSettings>()->GetRenderCacheSize();
+
+	if( Key.IsEmpty() || GetEntrySize( Key, Html ) > Budget )
+	{
+		return;
+	}
+
+	if( const FEntry* Existing = Entries.Find( Key ) )
+	{
+		TotalSize -= GetEntrySize( Key, Existing->Html );
+	}
+
+	FEntry& Entry = Entries.Add( Key );
+	Entry.Html     = Html;
+	Entry.LastUsed = ++UseCounter;
+
+	TotalSize += GetEntrySize( Key, Html );
+
+	Trim( Budget );
+}
+
+void FMarkdownRenderCache::Empty()
+{
+	Entries.Empty();
+	TotalSize = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownRenderCache::Trim( const int64 Budget )
+{
+	if( TotalSize <= Budget )
+	{
+		return;
+	}
+
+	// drop the oldest entries until we are back under three quarters of the budget, so we do not sort on every add
+
+	Entries.ValueSort( []( const FEntry& A, const FEntry& B ) { return A.LastUsed < B.LastUsed; } );
+
+	for( auto It = Entries.CreateIterator(); It && TotalSize > Budget * 3 / 4; ++It )
+	{
+		TotalSize -= GetEntrySize( It.Key(), It.Value().Html );
+		It.RemoveCurrent();
+	}
+
+	Entries.Compact();
+}
+
+int64 FMarkdownRenderCache::GetEntrySize( const FString& Key, const FString& Html )
+{
+	return ( Key.Len() + Html.Len() ) * sizeof( TCHAR );
+}
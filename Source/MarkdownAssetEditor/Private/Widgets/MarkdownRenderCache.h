@@ -0,0 +1,41 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Rendered output of the expensive viewer plugins (diagrams, code highlighting) keyed by the viewer as
+ * plugin|theme|source hash. Browsers come and go with the tabs, this outlives them so a reopened document does
+ * not have to lay out its diagrams again. Least recently used entries are dropped once the size budget is used.
+ */
+class FMarkdownRenderCache
+{
+public:
+
+	/** Adds every entry found for the keys to the map. */
+	void Find( const TArray<FString>& Keys, TMap<FString, FString>& OutEntries );
+
+	void Add( const FString& Key, const FString& Html );
+
+	void Empty();
+
+private:
+
+	void Trim( const int64 Budget );
+
+	static int64 GetEntrySize( const FString& Key, const FString& Html );
+
+private:
+
+	struct FEntry
+	{
+		FString Html;
+		uint64 LastUsed = 0;
+	};
+
+	TMap<FString, FEntry> Entries;
+
+	int64 TotalSize = 0;
+	uint64 UseCounter = 0;
+};
@@ -0,0 +1,112 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownTextBuffer.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownTextBuffer::Reset( const FString& Text )
+{
+	Data.Reset();
+	Data.Append( *Text, Text.Len() );
+
+	GapStart = Data.Num();
+	GapEnd   = Data.Num();
+}
+
+bool FMarkdownTextBuffer::Replace( const int32 Offset, const int32 Length, const FString& Insert )
+{
+	if( Offset < 0 || Length < 0 || Offset > Len() - Length )
+	{
+		return false;
+	}
+
+	MoveGap( Offset );
+
+	// deleting just widens the gap
+	GapEnd += Length;
+
+	Reserve( Insert.Len() );
+	FMemory::Memcpy( Data.GetData() + GapStart, *Insert, Insert.Len() * sizeof( TCHAR ) );
+	GapStart += Insert.Len();
+
+	return true;
+}
+
+FString FMarkdownTextBuffer::ToString() const
+{
+	FString Result;
+	Result.Reserve( Len() );
+	Result.AppendChars( Data.GetData(), GapStart );
+	Result.AppendChars( Data.GetData() + GapEnd, Data.Num() - GapEnd );
+	return Result;
+}
+
+FString FMarkdownTextBuffer::Mid( const int32 Offset, const int32 Length ) const
+{
+	check( Offset >= 0 && Length >= 0 && Offset <= Len() - Length );
+
+	// the range can be either side of the gap or straddle it
+	const int32 Before = FMath::Clamp( GapStart - Offset, 0, Length );
+
+	FString Result;
+	Result.Reserve( Length );
+	Result.AppendChars( Data.GetData() + Offset, Before );
+	Result.AppendChars( Data.GetData() + GapEnd + FMath::Max( Offset - GapStart, 0 ), Length - Before );
+	return Result;
+}
+
+uint32 FMarkdownTextBuffer::GetChecksum() const
+{
+	uint32 Hash = 2166136261u;
+
+	auto Accumulate = [&Hash]( const TCHAR* Chars, const int32 Count )
+	{
+		for( int32 Index = 0; Index < Count; ++Index )
+		{
+			Hash = ( Hash ^ uint32( Chars[ Index ] ) ) * 16777619u;
+		}
+	};
+
+	Accumulate( Data.GetData(), GapStart );
+	Accumulate( Data.GetData() + GapEnd, Data.Num() - GapEnd );
+
+	return Hash;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownTextBuffer::MoveGap( const int32 Offset )
+{
+	if( Offset < GapStart )
+	{
+		// text between the offset and the gap moves to after it
+		const int32 Count = GapStart - Offset;
+		FMemory::Memmove( Data.GetData() + GapEnd - Count, Data.GetData() + Offset, Count * sizeof( TCHAR ) );
+		GapStart -= Count;
+		GapEnd   -= Count;
+	}
+	else if( Offset > GapStart )
+	{
+		const int32 Count = Offset - GapStart;
+		FMemory::Memmove( Data.GetData() + GapStart, Data.GetData() + GapEnd, Count * sizeof( TCHAR ) );
+		GapStart += Count;
+		GapEnd   += Count;
+	}
+}
+
+void FMarkdownTextBuffer::Reserve( const int32 Length )
+{
+	if( GapLength() >= Length )
+	{
+		return;
+	}
+
+	// grow by at least half the text so typing does not reallocate on every edit
+	const int32 Tail   = Data.Num() - GapEnd;
+	const int32 Growth = FMath::Max( Length - GapLength(), FMath::Max( Data.Num() / 2, 1024 ) );
+
+	Data.AddUninitialized( Growth );
+	FMemory::Memmove( Data.GetData() + Data.Num() - Tail, Data.GetData() + GapEnd, Tail * sizeof( TCHAR ) );
+
+	GapEnd = Data.Num() - Tail;
+}
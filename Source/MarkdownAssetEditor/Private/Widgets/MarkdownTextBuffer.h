@@ -0,0 +1,51 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Gap buffer holding the document while it is being edited in the viewer. Edits arrive as small replacements near
+ * the caret, so moving the gap to them is cheap and the rest of the text is never copied.
+ * Offsets and lengths are in TCHARs, which is what the browser sends (UTF-16 code units) on platforms where
+ * TCHAR is 16 bits.
+ */
+class FMarkdownTextBuffer
+{
+public:
+
+	void Reset( const FString& Text );
+
+	/** Removes Length characters at Offset and inserts Insert there, fails if the range is outside the text. */
+	bool Replace( const int32 Offset, const int32 Length, const FString& Insert );
+
+	int32 Len() const
+	{
+		return Data.Num() - GapLength();
+	}
+
+	FString ToString() const;
+
+	/** Length characters at Offset, which have to be in the text. */
+	FString Mid( const int32 Offset, const int32 Length ) const;
+
+	/** 32 bit FNV-1a over the characters, matches checksum() in the viewer. */
+	uint32 GetChecksum() const;
+
+private:
+
+	int32 GapLength() const
+	{
+		return GapEnd - GapStart;
+	}
+
+	void MoveGap( const int32 Offset );
+	void Reserve( const int32 Length );
+
+private:
+
+	TArray<TCHAR> Data;
+
+	int32 GapStart = 0;
+	int32 GapEnd = 0;
+};
@@ -0,0 +1,218 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownViewerContent.h"
+
+#include "HAL/FileManager.h"
+#include "IWebBrowserSingleton.h"
+#include "Interfaces/IPluginManager.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "WebBrowserModule.h"
+
+const TCHAR* FMarkdownViewerContent::Scheme = TEXT( "https" );
+const TCHAR* FMarkdownViewerContent::Domain = TEXT( "markdownasset.local" );
+
+namespace MarkdownViewerContent
+{
+	/** Serves one file out of memory. */
+	class FSchemeHandler : public IWebBrowserSchemeHandler
+	{
+	public:
+
+		explicit FSchemeHandler( const TSharedPtr<const FMarkdownViewerContent::FFile>& InFile )
+			: File( InFile )
+		{
+		}
+
+		virtual bool ProcessRequest( const FString& Verb, const FString& Url, const FSimpleDelegate& OnHeadersReady ) override
+		{
+			OnHeadersReady.Execute();
+			return true;
+		}
+
+		virtual void GetResponseHeaders( IHeaders& OutHeaders ) override
+		{
+			if( !File.IsValid() )
+			{
+				OutHeaders.SetStatusCode( 404 );
+				OutHeaders.SetContentLength( 0 );
+				return;
+			}
+
+			OutHeaders.SetStatusCode( 200 );
+			OutHeaders.SetMimeType( *File->MimeType );
+			OutHeaders.SetContentLength( File->Data.Num() );
+			OutHeaders.SetHeader( TEXT( "Access-Control-Allow-Origin" ), TEXT( "*" ) );
+
+			// chunks have a content hash in their name so they never change, the pages that reference them do
+			// the handler is not given the request headers, so there is no revalidating a page against an etag
+			OutHeaders.SetHeader( TEXT( "Cache-Control" ), File->bImmutable ? TEXT( "public, max-age=31536000, immutable" ) : TEXT( "no-store" ) );
+		}
+
+		virtual bool ReadResponse( uint8* OutBytes, int32 BytesToRead, int32& BytesRead, const FSimpleDelegate& OnMoreDataReady ) override
+		{
+			BytesRead = 0;
+
+			if( !File.IsValid() || Offset >= File->Data.Num() )
+			{
+				return false;
+			}
+
+			BytesRead = FMath::Min( BytesToRead, File->Data.Num() - Offset );
+			FMemory::Memcpy( OutBytes, File->Data.GetData() + Offset, BytesRead );
+			Offset += BytesRead;
+
+			return true;
+		}
+
+		virtual void Cancel() override
+		{
+			File.Reset();
+		}
+
+	private:
+
+		TSharedPtr<const FMarkdownViewerContent::FFile> File;
+		int32 Offset = 0;
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownViewerContent::Load()
+{
+	Files.Empty();
+
+	ContentDir = FPaths::ConvertRelativePathToFull( IPluginManager::Get().FindPlugin( TEXT( "MarkdownAsset" ) )->GetContentDir() );
+
+	FString Root = ContentDir;
+	if( !Root.EndsWith( TEXT( "/" ) ) )
+	{
+		Root += TEXT( "/" );
+	}
+
+	TArray<FString> Found;
+	IFileManager::Get().FindFilesRecursive( Found, *ContentDir, TEXT( "*" ), true, false );
+
+	int64 TotalSize = 0;
+
+	for( const FString& Filename : Found )
+	{
+		FString Path = FPaths::ConvertRelativePathToFull( Filename );
+
+		if( !Path.RemoveFromStart( Root ) || GetMimeType( Path ) == nullptr )
+		{
+			continue;
+		}
+
+		TSharedPtr<FFile> File = MakeShared<FFile>();
+
+		if( !FFileHelper::LoadFileToArray( File->Data, *Filename ) )
+		{
+			UE_LOG( MarkdownEditorLog, Warning, TEXT( "Failed to load viewer file '%s'" ), *Filename );
+			continue;
+		}
+
+		File->MimeType   = GetMimeType( Path );
+		File->bImmutable = Path.Contains( TEXT( "/assets/" ) );
+
+		TotalSize += File->Data.Num();
+		Files.Add( Path, File );
+	}
+
+	UE_LOG( MarkdownEditorLog, Log, TEXT( "Loaded %d viewer files (%lld bytes)" ), Files.Num(), TotalSize );
+}
+
+void FMarkdownViewerContent::Register()
+{
+	if( bRegistered || Files.IsEmpty() )
+	{
+		return;
+	}
+
+	bRegistered = IWebBrowserModule::Get().GetSingleton()->RegisterSchemeHandlerFactory( Scheme, Domain, this );
+
+	if( !bRegistered )
+	{
+		UE_LOG( MarkdownEditorLog, Warning, TEXT( "Failed to register the markdown viewer scheme handler, falling back to loading from disk" ) );
+	}
+}
+
+void FMarkdownViewerContent::Unregister()
+{
+	if( bRegistered && IWebBrowserModule::IsAvailable() )
+	{
+		IWebBrowserModule::Get().GetSingleton()->UnregisterSchemeHandlerFactory( this );
+	}
+
+	bRegistered = false;
+}
+
+FString FMarkdownViewerContent::GetViewerURL( const bool bDarkSkin ) const
+{
+	// the viewer is built into <skin>/index.html with its chunks alongside, older builds produced a single
+	// <skin>.html with everything inlined so fall back to that if the split build is not there
+
+	const FString Page = HasSplitPage( bDarkSkin ) ? GetSplitPage( bDarkSkin ) : FString( bDarkSkin ? TEXT( "dark.html" ) : TEXT( "light.html" ) );
+
+	if( bRegistered && Files.Contains( Page ) )
+	{
+		return FString::Printf( TEXT( "%s://%s/%s" ), Scheme, Domain, *Page );
+	}
+
+	return IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead( *( ContentDir / Page ) );
+}
+
+bool FMarkdownViewerContent::IsScriptable( const bool bDarkSkin ) const
+{
+	return HasSplitPage( bDarkSkin );
+}
+
+FString FMarkdownViewerContent::GetSplitPage( const bool bDarkSkin )
+{
+	return FString( bDarkSkin ? TEXT( "dark" ) : TEXT( "light" ) ) / TEXT( "index.html" );
+}
+
+bool FMarkdownViewerContent::HasSplitPage( const bool bDarkSkin ) const
+{
+	const FString SplitPage = GetSplitPage( bDarkSkin );
+	return Files.Contains( SplitPage ) || FPaths::FileExists( ContentDir / SplitPage );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TUniquePtr<IWebBrowserSchemeHandler> FMarkdownViewerContent::Create( FString Verb, FString Url )
+{
+	// https://markdownasset.local/dark/index.html?query#fragment -> dark/index.html
+
+	FString Path = Url;
+	Path.RemoveFromStart( FString::Printf( TEXT( "%s://%s/" ), Scheme, Domain ) );
+
+	int32 Index;
+	if( Path.FindChar( TEXT( '?' ), Index ) || Path.FindChar( TEXT( '#' ), Index ) )
+	{
+		Path.LeftInline( Index );
+	}
+
+	const TSharedPtr<const FFile>* File = Files.Find( Path );
+
+	return MakeUnique<MarkdownViewerContent::FSchemeHandler>( File ? *File : TSharedPtr<const FFile>() );
+}
+
+const TCHAR* FMarkdownViewerContent::GetMimeType( const FString& Path )
+{
+	const FString Extension = FPaths::GetExtension( Path ).ToLower();
+
+	if( Extension == TEXT( "html" ) )  return TEXT( "text/html" );
+	if( Extension == TEXT( "js" ) )    return TEXT( "text/javascript" );
+	if( Extension == TEXT( "css" ) )   return TEXT( "text/css" );
+	if( Extension == TEXT( "json" ) )  return TEXT( "application/json" );
+	if( Extension == TEXT( "svg" ) )   return TEXT( "image/svg+xml" );
+	if( Extension == TEXT( "png" ) )   return TEXT( "image/png" );
+	if( Extension == TEXT( "woff" ) )  return TEXT( "font/woff" );
+	if( Extension == TEXT( "woff2" ) ) return TEXT( "font/woff2" );
+	if( Extension == TEXT( "ttf" ) )   return TEXT( "font/ttf" );
+
+	return nullptr;
+}
@@ -0,0 +1,61 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IWebBrowserSchemeHandler.h"
+
+/**
+ * The viewer build (html, scripts, styles) held in memory and served to the embedded browser from
+ * https://markdownasset.local/ rather than file:// so every tab shares one copy and the browser can cache it.
+ */
+class FMarkdownViewerContent : public IWebBrowserSchemeHandlerFactory
+{
+public:
+
+	static const TCHAR* Scheme;
+	static const TCHAR* Domain;
+
+	struct FFile
+	{
+		TArray<uint8> Data;
+		FString MimeType;
+		bool bImmutable = false;
+	};
+
+	/** Reads the viewer build from the plugin content folder. */
+	void Load();
+
+	/** Registers the scheme handler with the browser singleton, does nothing if it is already registered. */
+	void Register();
+	void Unregister();
+
+	/** Where to point a browser to show the viewer for the skin. */
+	FString GetViewerURL( const bool bDarkSkin ) const;
+
+	/**
+	 * Whether the viewer for the skin is the split build, which has window.markdownviewer to reset, reload, flush and
+	 * snapshot it and sends its edits as they are made. The single page from older builds only shows the document it
+	 * was opened with and sends the whole text back, so its browsers cannot be reused or suspended.
+	 */
+	bool IsScriptable( const bool bDarkSkin ) const;
+
+	//~ IWebBrowserSchemeHandlerFactory interface
+	virtual TUniquePtr<IWebBrowserSchemeHandler> Create( FString Verb, FString Url ) override;
+
+private:
+
+	static FString GetSplitPage( const bool bDarkSkin );
+	bool HasSplitPage( const bool bDarkSkin ) const;
+
+	static const TCHAR* GetMimeType( const FString& Path );
+
+private:
+
+	FString ContentDir;
+
+	/** keyed by path relative to the content folder */
+	TMap<FString, TSharedPtr<const FFile>> Files;
+
+	bool bRegistered = false;
+};
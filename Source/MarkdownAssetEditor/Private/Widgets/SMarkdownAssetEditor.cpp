@@ -6,25 +6,27 @@
 #include "Internationalization/Text.h"
 #include "MarkdownAsset.h"
 #include "UObject/Class.h"
+#include "UObject/Package.h"
 #include "Widgets/SBoxPanel.h"
 #include "Widgets/Input/SMultiLineEditableTextBox.h"
-#include "Interfaces/IPluginManager.h"
+#include "IWebBrowserWindow.h"
+#include "MarkdownAssetEditorModule.h"
 #include "MarkdownAssetEditorSettings.h"
 #include "MarkdownBinding.h"
+#include "MarkdownBrowserPool.h"
+#include "LogChannels/MarkdownLogChannels.h"
 
 #define LOCTEXT_NAMESPACE "SMarkdownAssetEditor"
 
-
 //---------------------------------------------------------------------------------------------------------------------
 
 SMarkdownAssetEditor::~SMarkdownAssetEditor()
 {
 	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll( this );
+	UPackage::PreSavePackageWithContextEvent.RemoveAll( this );
+	FTSTicker::GetCoreTicker().RemoveTicker( FlushTimeoutHandle );
 
-	if( WebBrowser.IsValid() )
-	{
-		WebBrowser->CloseBrowser();
-	}
+	ReleaseBrowser();
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -39,31 +41,105 @@ void SMarkdownAssetEditor::Construct( const FArguments& InArgs, UMarkdownAsset*
         return;
 	}
 
+	AttachBrowser();
+
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddSP( this, &SMarkdownAssetEditor::HandleMarkdownAssetPropertyChanged );
+
+	// the package can be saved from anywhere (save all, the content browser, the prompt on exit), not only the toolkit
+	UPackage::PreSavePackageWithContextEvent.AddSP( this, &SMarkdownAssetEditor::HandlePreSavePackage );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownAssetEditor::UpdateVisibility( const bool bVisible )
+{
+	if( !FModuleManager::Get().IsModuleLoaded( "WebBrowser" ) )
+	{
+		return;
+	}
+
+	if( bVisible )
+	{
+		if( bSuspended )
+		{
+			AttachBrowser();
+		}
+		else if( bHidden && PooledBrowser.IsValid() && PooledBrowser->Window.IsValid() )
+		{
+			PooledBrowser->Window->SetIsHidden( false );
+		}
+
+		bHidden           = false;
+		bSuspendRequested = false;
+		return;
+	}
+
+	// hidden browsers stop painting and have their timers throttled straight away, so get their edits in first
+	// and into the asset, anything else that wants the text will be looking at it now rather than at the editor
+	if( !bHidden )
+	{
+		bHidden    = true;
+		HiddenTime = FPlatformTime::Seconds();
+
+		FlushEdits( FSimpleDelegate() );
+
+		if( PooledBrowser.IsValid() && PooledBrowser->Window.IsValid() )
+		{
+			PooledBrowser->Window->SetIsHidden( true );
+		}
+
+		return;
+	}
+
+	// and after a while they are given up entirely, the viewer saves its state first and we suspend once it has
+	const UMarkdownAssetEditorSettings* Settings = GetDefault<UMarkdownAssetEditorSettings>();
+
+	if( !bSuspended && !bSuspendRequested && Settings->ShouldSuspendHiddenTabs() && FPlatformTime::Seconds() - HiddenTime > Settings->GetHiddenTabSuspendDelay() )
+	{
+		// the older viewer cannot save its state, or show the document again in the browser it would get back
+		if( PooledBrowser.IsValid() && PooledBrowser->Window.IsValid() && PooledBrowser->bScriptable )
+		{
+			bSuspendRequested = true;
+			PooledBrowser->Window->ExecuteJavascript( TEXT( "window.markdownviewer && window.markdownviewer.snapshot()" ) );
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownAssetEditor::AttachBrowser()
+{
 	auto Settings = GetDefault<UMarkdownAssetEditorSettings>();
 
-	FString ContentDir = IPluginManager::Get().FindPlugin( TEXT( "MarkdownAsset" ) )->GetContentDir();
-	FString FullPath   = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead( *ContentDir );
-	FString URL        = FullPath / ( Settings->bDarkSkin ? TEXT( "dark.html" ) : TEXT( "light.html" ) );
+	// take a browser that already has the viewer loaded
+	PooledBrowser = FMarkdownAssetEditorModule::Get().GetBrowserPool().Acquire( Settings->bDarkSkin );
 
-	WebBrowser = SAssignNew( WebBrowser, SWebBrowserView )
-		.InitialURL( URL )
+	WebBrowser = SAssignNew( WebBrowser, SWebBrowserView, PooledBrowser->Window )
 		.BackgroundColor( Settings->bDarkSkin ? FLinearColor( 0.1f, 0.1f, 0.1f, 1.0f ).ToFColor(true) : FLinearColor( 1.0f, 1.0f, 1.0f, 1.0f ).ToFColor(true) )
 		.OnConsoleMessage( this, &SMarkdownAssetEditor::HandleConsoleMessage )
 	;
 
 	// setup binding
-	UMarkdownBinding* Binding = NewObject<UMarkdownBinding>();
-	Binding->Text = MarkdownAsset->Text;
-	Binding->OnSetText.AddLambda( [this, Binding]()
+	UMarkdownBinding* Binding = PooledBrowser->Binding.Get();
+	Binding->SetDocument( MarkdownAsset );
+	Binding->State = SavedState;
+	// the edits stay in the binding until they are committed, but the asset should look modified as soon as one is made
+	Binding->OnSetText.AddWeakLambda( MarkdownAsset, [Asset = MarkdownAsset]()
 	{
-		MarkdownAsset->MarkPackageDirty();
-		MarkdownAsset->Text = Binding->GetText();
-		if(MarkdownAsset->OnChanged.IsBound())
-		{
-			MarkdownAsset->OnChanged.Execute();
-		}
+		Asset->MarkPackageDirty();
 	});
-	WebBrowser->BindUObject( TEXT( "MarkdownBinding" ), Binding, true );
+	Binding->OnSetText.AddSP( this, &SMarkdownAssetEditor::HandleSetText );
+	Binding->OnEditPending.AddWeakLambda( MarkdownAsset, [Asset = MarkdownAsset]()
+	{
+		Asset->MarkPackageDirty();
+	});
+	Binding->OnSaveState.AddSP( this, &SMarkdownAssetEditor::HandleSaveState );
+
+	// a warm browser has already asked for its text, so tell it to fetch the new document
+	if( PooledBrowser->Window.IsValid() && PooledBrowser->bScriptable )
+	{
+		PooledBrowser->Window->ExecuteJavascript( TEXT( "window.markdownviewer && window.markdownviewer.reload()" ) );
+	}
 
 	ChildSlot
 	[
@@ -75,7 +151,142 @@ void SMarkdownAssetEditor::Construct( const FArguments& InArgs, UMarkdownAsset*
 		]
 	];
 
-	FCoreUObjectDelegates::OnObjectPropertyChanged.AddSP( this, &SMarkdownAssetEditor::HandleMarkdownAssetPropertyChanged );
+	bSuspended = false;
+}
+
+void SMarkdownAssetEditor::ReleaseBrowser()
+{
+	if( !PooledBrowser.IsValid() )
+	{
+		return;
+	}
+
+	// hand the browser back so the next document can open without starting a new one
+	if( FModuleManager::Get().IsModuleLoaded( "MarkdownAssetEditor" ) )
+	{
+		FMarkdownAssetEditorModule::Get().GetBrowserPool().Release( PooledBrowser );
+	}
+	else if( PooledBrowser->Window.IsValid() )
+	{
+		CommitEdits();
+		PooledBrowser->Window->CloseBrowser( true );
+	}
+
+	PooledBrowser.Reset();
+}
+
+void SMarkdownAssetEditor::HandleSaveState()
+{
+	if( !bSuspendRequested || !PooledBrowser.IsValid() )
+	{
+		return;
+	}
+
+	bSuspendRequested = false;
+	SavedState = PooledBrowser->Binding->State;
+
+	// tab came back while the state was being saved
+	if( !bHidden )
+	{
+		return;
+	}
+
+	ChildSlot
+	[
+		SNullWidget::NullWidget
+	];
+
+	WebBrowser.Reset();
+	ReleaseBrowser();
+
+	bSuspended = true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownAssetEditor::FlushEdits( const FSimpleDelegate& OnFlushed )
+{
+	if( !HasPendingEdits() )
+	{
+		CommitEdits();
+		OnFlushed.ExecuteIfBound();
+		return;
+	}
+
+	FlushCallbacks.Add( OnFlushed );
+
+	if( !FlushTimeoutHandle.IsValid() )
+	{
+		PooledBrowser->Window->ExecuteJavascript( TEXT( "window.markdownviewer && window.markdownviewer.flush()" ) );
+		FlushTimeoutHandle = FTSTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateSP( this, &SMarkdownAssetEditor::HandleFlushTimeout ), 2.0f );
+	}
+}
+
+bool SMarkdownAssetEditor::HasPendingEdits() const
+{
+	// only the split viewer holds edits back and can be asked to flush them, the older one sends the text as it changes
+	return PooledBrowser.IsValid() && PooledBrowser->Window.IsValid() && PooledBrowser->bScriptable && PooledBrowser->Binding->HasPendingEdits();
+}
+
+void SMarkdownAssetEditor::HandlePreSavePackage( UPackage* Package, FObjectPreSaveContext SaveContext )
+{
+	if( MarkdownAsset == nullptr || Package != MarkdownAsset->GetPackage() || SaveContext.IsProceduralSave() )
+	{
+		return;
+	}
+
+	// the save cannot wait for the browser, so it gets everything the binding has now, before the asset's own PreSave
+	CommitEdits();
+
+	// and anything the viewer is still holding arrives after it, which marks the package as modified again
+	if( HasPendingEdits() )
+	{
+		UE_LOG( MarkdownEditorLog, Log, TEXT( "Markdown viewer was still holding edits when %s was saved, they will be in the next save" ), *Package->GetName() );
+		FlushEdits( FSimpleDelegate() );
+	}
+}
+
+void SMarkdownAssetEditor::HandleSetText()
+{
+	// edits that arrive on their own are left in the binding, only a flush someone is waiting on commits them
+	if( FlushTimeoutHandle.IsValid() && PooledBrowser.IsValid() && !PooledBrowser->Binding->HasPendingEdits() )
+	{
+		CompleteFlush();
+	}
+}
+
+void SMarkdownAssetEditor::CommitEdits()
+{
+	if( PooledBrowser.IsValid() )
+	{
+		PooledBrowser->Binding->CommitText();
+	}
+}
+
+void SMarkdownAssetEditor::CompleteFlush()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker( FlushTimeoutHandle );
+	FlushTimeoutHandle.Reset();
+
+	CommitEdits();
+
+	TArray<FSimpleDelegate> Callbacks = MoveTemp( FlushCallbacks );
+
+	for( const FSimpleDelegate& Callback : Callbacks )
+	{
+		Callback.ExecuteIfBound();
+	}
+}
+
+bool SMarkdownAssetEditor::HandleFlushTimeout( float DeltaTime )
+{
+	// do not hold the save up forever if the viewer is not answering
+	UE_LOG( MarkdownEditorLog, Warning, TEXT( "Markdown viewer did not send its pending edits in time, continuing with the text we have" ) );
+
+	FlushTimeoutHandle.Reset();
+	CompleteFlush();
+
+	return false;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
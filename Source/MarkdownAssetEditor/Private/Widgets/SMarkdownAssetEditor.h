@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "Containers/Ticker.h"
+#include "UObject/ObjectSaveContext.h"
 #include "Templates/SharedPointer.h"
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "Widgets/SCompoundWidget.h"
@@ -11,6 +13,7 @@
 class FText;
 class ISlateStyle;
 class UMarkdownAsset;
+struct FMarkdownPooledBrowser;
 
 class SMarkdownAssetEditor : public SCompoundWidget
 {
@@ -26,13 +29,46 @@ class SMarkdownAssetEditor : public SCompoundWidget
 		void Construct( const FArguments& InArgs, UMarkdownAsset* InMarkdownAsset, const TSharedRef<ISlateStyle>& InStyle );
 		virtual FReply OnKeyDown( const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent ) override;
 
+		/** Called by the toolkit as the tab is shown or hidden, hidden browsers are throttled and eventually suspended. */
+		void UpdateVisibility( const bool bVisible );
+
+		/**
+		 * Asks the viewer for any edits it has not sent yet and calls back once they are in the asset. Edits are kept
+		 * in the binding as they arrive, this is what writes them to the asset.
+		 */
+		void FlushEdits( const FSimpleDelegate& OnFlushed );
+
+		/** The viewer has edits it has not sent yet. */
+		bool HasPendingEdits() const;
+
 	private:
 
+		void AttachBrowser();
+		void ReleaseBrowser();
+		void HandleSaveState();
+		void HandleSetText();
+		void HandlePreSavePackage( UPackage* Package, FObjectPreSaveContext SaveContext );
+		void CommitEdits();
+		void CompleteFlush();
+		bool HandleFlushTimeout( float DeltaTime );
+
 		void HandleMarkdownAssetPropertyChanged( UObject* Object, FPropertyChangedEvent& PropertyChangedEvent );
 		void HandleConsoleMessage( const FString& Message, const FString& Source, int32 Line, EWebBrowserConsoleLogSeverity Serverity );
 
 	private:
 
 		TSharedPtr<SWebBrowserView> WebBrowser;
+		TSharedPtr<FMarkdownPooledBrowser> PooledBrowser;
 		UMarkdownAsset* MarkdownAsset;
+
+		/** viewer state (mode, scroll position, selection) saved when the browser was suspended */
+		FString SavedState;
+
+		double HiddenTime = 0.0;
+		bool bHidden = false;
+		bool bSuspended = false;
+		bool bSuspendRequested = false;
+
+		TArray<FSimpleDelegate> FlushCallbacks;
+		FTSTicker::FDelegateHandle FlushTimeoutHandle;
 };
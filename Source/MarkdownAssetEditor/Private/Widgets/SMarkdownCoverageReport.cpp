@@ -0,0 +1,527 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "SMarkdownCoverageReport.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/Async.h"
+#include "ContentBrowserModule.h"
+#include "IContentBrowserSingleton.h"
+#include "Modules/ModuleManager.h"
+#include "Tasks/Task.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SSegmentedControl.h"
+#include "Widgets/Layout/SSplitter.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "SMarkdownCoverageReport"
+
+const FName SMarkdownCoverageReport::TabName( TEXT( "MarkdownCoverage" ) );
+
+namespace MarkdownCoverageColumns
+{
+	static const FName Folder( TEXT( "Folder" ) );
+	static const FName Assets( TEXT( "Assets" ) );
+	static const FName Documented( TEXT( "Documented" ) );
+	static const FName Coverage( TEXT( "Coverage" ) );
+	static const FName Stale( TEXT( "Stale" ) );
+
+	static const FName Asset( TEXT( "Asset" ) );
+	static const FName Type( TEXT( "Type" ) );
+	static const FName Document( TEXT( "Document" ) );
+	static const FName AssetSaved( TEXT( "AssetSaved" ) );
+	static const FName DocumentSaved( TEXT( "DocumentSaved" ) );
+
+	static FText GetCategoryText( const EMarkdownCoverageCategory Category )
+	{
+		switch( Category )
+		{
+			case EMarkdownCoverageCategory::Blueprint: return LOCTEXT( "Blueprints", "Blueprints" );
+			case EMarkdownCoverageCategory::DataAsset: return LOCTEXT( "DataAssets", "Data Assets" );
+			case EMarkdownCoverageCategory::Map:       return LOCTEXT( "Maps", "Maps" );
+			default:                                   return LOCTEXT( "All", "All" );
+		}
+	}
+
+	static FText GetTimeText( const FDateTime& Time )
+	{
+		return Time == FDateTime::MinValue() ? FText::GetEmpty() : FText::AsDateTime( Time );
+	}
+
+	template<typename T>
+	static int32 Compare( const T& A, const T& B )
+	{
+		return A < B ? -1 : ( B < A ? 1 : 0 );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+class SMarkdownCoverageFolderRow : public SMultiColumnTableRow<TSharedPtr<FMarkdownCoverageFolder>>
+{
+public:
+
+	SLATE_BEGIN_ARGS( SMarkdownCoverageFolderRow ) {}
+		SLATE_ARGUMENT( FString, Path )
+		SLATE_ARGUMENT( FMarkdownCoverageCounts, Counts )
+	SLATE_END_ARGS()
+
+	void Construct( const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable )
+	{
+		Path   = InArgs._Path;
+		Counts = InArgs._Counts;
+
+		SMultiColumnTableRow::Construct( FSuperRowType::FArguments(), InOwnerTable );
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn( const FName& ColumnName ) override
+	{
+		using namespace MarkdownCoverageColumns;
+
+		FText Text;
+
+		if( ColumnName == Folder )
+		{
+			Text = FText::FromString( Path );
+		}
+		else if( ColumnName == Assets )
+		{
+			Text = FText::AsNumber( Counts.NumAssets );
+		}
+		else if( ColumnName == Documented )
+		{
+			Text = FText::AsNumber( Counts.NumDocumented );
+		}
+		else if( ColumnName == Coverage )
+		{
+			Text = FText::AsPercent( Counts.GetCoverage() );
+		}
+		else if( ColumnName == Stale )
+		{
+			Text = FText::AsNumber( Counts.NumStale );
+		}
+
+		return SNew( STextBlock ).Text( Text ).OverflowPolicy( ETextOverflowPolicy::Ellipsis );
+	}
+
+private:
+
+	FString Path;
+	FMarkdownCoverageCounts Counts;
+};
+
+class SMarkdownCoverageEntryRow : public SMultiColumnTableRow<TSharedPtr<FMarkdownCoverageEntry>>
+{
+public:
+
+	SLATE_BEGIN_ARGS( SMarkdownCoverageEntryRow ) {}
+		SLATE_ARGUMENT( TSharedPtr<FMarkdownCoverageEntry>, Entry )
+	SLATE_END_ARGS()
+
+	void Construct( const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable )
+	{
+		Entry = InArgs._Entry;
+
+		SMultiColumnTableRow::Construct( FSuperRowType::FArguments(), InOwnerTable );
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn( const FName& ColumnName ) override
+	{
+		using namespace MarkdownCoverageColumns;
+
+		FText Text;
+
+		if( ColumnName == Asset )
+		{
+			Text = FText::FromString( Entry->Asset.GetAssetName() );
+		}
+		else if( ColumnName == Type )
+		{
+			Text = GetCategoryText( Entry->Category );
+		}
+		else if( ColumnName == Folder )
+		{
+			Text = FText::FromName( Entry->Folder );
+		}
+		else if( ColumnName == Document )
+		{
+			Text = FText::FromString( Entry->Document.GetAssetName() );
+		}
+		else if( ColumnName == AssetSaved )
+		{
+			Text = GetTimeText( Entry->AssetTimestamp );
+		}
+		else if( ColumnName == DocumentSaved )
+		{
+			Text = GetTimeText( Entry->DocumentTimestamp );
+		}
+
+		return SNew( STextBlock ).Text( Text ).OverflowPolicy( ETextOverflowPolicy::Ellipsis );
+	}
+
+private:
+
+	TSharedPtr<FMarkdownCoverageEntry> Entry;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownCoverageReport::Construct( const FArguments& InArgs )
+{
+	using namespace MarkdownCoverageColumns;
+
+	ChildSlot
+	[
+		SNew( SVerticalBox )
+
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding( 4.0f )
+		[
+			SNew( SHorizontalBox )
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding( 0.0f, 0.0f, 8.0f, 0.0f )
+			[
+				SNew( SButton )
+				.Text( LOCTEXT( "Refresh", "Refresh" ) )
+				.IsEnabled_Lambda( [ this ]() { return !bBuilding; } )
+				.OnClicked_Lambda( [ this ]() { Refresh(); return FReply::Handled(); } )
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding( 0.0f, 0.0f, 8.0f, 0.0f )
+			[
+				SNew( SSegmentedControl<EMarkdownCoverageCategory> )
+				.Value_Lambda( [ this ]() { return Category; } )
+				.OnValueChanged_Lambda( [ this ]( const EMarkdownCoverageCategory InCategory )
+				{
+					Category = InCategory;
+					UpdateFolders();
+					UpdateEntries();
+				})
+				+ SSegmentedControl<EMarkdownCoverageCategory>::Slot( EMarkdownCoverageCategory::Num ).Text( GetCategoryText( EMarkdownCoverageCategory::Num ) )
+				+ SSegmentedControl<EMarkdownCoverageCategory>::Slot( EMarkdownCoverageCategory::Blueprint ).Text( GetCategoryText( EMarkdownCoverageCategory::Blueprint ) )
+				+ SSegmentedControl<EMarkdownCoverageCategory>::Slot( EMarkdownCoverageCategory::DataAsset ).Text( GetCategoryText( EMarkdownCoverageCategory::DataAsset ) )
+				+ SSegmentedControl<EMarkdownCoverageCategory>::Slot( EMarkdownCoverageCategory::Map ).Text( GetCategoryText( EMarkdownCoverageCategory::Map ) )
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding( 0.0f, 0.0f, 8.0f, 0.0f )
+			[
+				SNew( SSegmentedControl<bool> )
+				.Value_Lambda( [ this ]() { return bShowStale; } )
+				.OnValueChanged_Lambda( [ this ]( const bool bInShowStale )
+				{
+					bShowStale = bInShowStale;
+					UpdateEntries();
+				})
+				+ SSegmentedControl<bool>::Slot( false ).Text( LOCTEXT( "Undocumented", "Undocumented" ) )
+				+ SSegmentedControl<bool>::Slot( true ).Text( LOCTEXT( "StaleDocumentation", "Stale" ) )
+			]
+
+			+ SHorizontalBox::Slot()
+			.FillWidth( 1.0f )
+			.VAlign( VAlign_Center )
+			[
+				SAssignNew( StatusText, STextBlock )
+				.ColorAndOpacity( FSlateColor::UseSubduedForeground() )
+			]
+		]
+
+		+ SVerticalBox::Slot()
+		.FillHeight( 1.0f )
+		.Padding( 4.0f, 0.0f, 4.0f, 4.0f )
+		[
+			SNew( SSplitter )
+
+			+ SSplitter::Slot()
+			.Value( 0.4f )
+			[
+				SAssignNew( FolderList, SListView<FFolderPtr> )
+				.ListItemsSource( &Folders )
+				.SelectionMode( ESelectionMode::Single )
+				.OnGenerateRow( this, &SMarkdownCoverageReport::HandleGenerateFolderRow )
+				.OnSelectionChanged( this, &SMarkdownCoverageReport::HandleFolderSelectionChanged )
+				.HeaderRow
+				(
+					SNew( SHeaderRow )
+
+					+ SHeaderRow::Column( Folder ).DefaultLabel( LOCTEXT( "FolderColumn", "Folder" ) ).FillWidth( 3.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetFolderSortMode, Folder ).OnSort( this, &SMarkdownCoverageReport::HandleFolderSort )
+
+					+ SHeaderRow::Column( Assets ).DefaultLabel( LOCTEXT( "AssetsColumn", "Assets" ) ).FillWidth( 1.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetFolderSortMode, Assets ).OnSort( this, &SMarkdownCoverageReport::HandleFolderSort )
+
+					+ SHeaderRow::Column( Documented ).DefaultLabel( LOCTEXT( "DocumentedColumn", "Documented" ) ).FillWidth( 1.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetFolderSortMode, Documented ).OnSort( this, &SMarkdownCoverageReport::HandleFolderSort )
+
+					+ SHeaderRow::Column( Coverage ).DefaultLabel( LOCTEXT( "CoverageColumn", "Coverage" ) ).FillWidth( 1.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetFolderSortMode, Coverage ).OnSort( this, &SMarkdownCoverageReport::HandleFolderSort )
+
+					+ SHeaderRow::Column( Stale ).DefaultLabel( LOCTEXT( "StaleColumn", "Stale" ) ).FillWidth( 1.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetFolderSortMode, Stale ).OnSort( this, &SMarkdownCoverageReport::HandleFolderSort )
+				)
+			]
+
+			+ SSplitter::Slot()
+			.Value( 0.6f )
+			[
+				SAssignNew( EntryList, SListView<FEntryPtr> )
+				.ListItemsSource( &Entries )
+				.SelectionMode( ESelectionMode::Single )
+				.OnGenerateRow( this, &SMarkdownCoverageReport::HandleGenerateEntryRow )
+				.OnMouseButtonDoubleClick( this, &SMarkdownCoverageReport::HandleEntryDoubleClick )
+				.HeaderRow
+				(
+					SNew( SHeaderRow )
+
+					+ SHeaderRow::Column( Asset ).DefaultLabel( LOCTEXT( "AssetColumn", "Asset" ) ).FillWidth( 2.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetEntrySortMode, Asset ).OnSort( this, &SMarkdownCoverageReport::HandleEntrySort )
+
+					+ SHeaderRow::Column( Type ).DefaultLabel( LOCTEXT( "TypeColumn", "Type" ) ).FillWidth( 1.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetEntrySortMode, Type ).OnSort( this, &SMarkdownCoverageReport::HandleEntrySort )
+
+					+ SHeaderRow::Column( Folder ).DefaultLabel( LOCTEXT( "EntryFolderColumn", "Folder" ) ).FillWidth( 2.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetEntrySortMode, Folder ).OnSort( this, &SMarkdownCoverageReport::HandleEntrySort )
+
+					+ SHeaderRow::Column( Document ).DefaultLabel( LOCTEXT( "DocumentColumn", "Document" ) ).FillWidth( 2.0f )
+					.SortMode( this, &SMarkdownCoverageReport::GetEntrySortMode, Document ).OnSort( this, &SMarkdownCoverageReport::HandleEntrySort )
+
+					+ SHeaderRow::Column( AssetSaved ).DefaultLabel( LOCTEXT( "AssetSavedColumn", "Asset Saved" ) ).FillWidth( 1.5f )
+					.SortMode( this, &SMarkdownCoverageReport::GetEntrySortMode, AssetSaved ).OnSort( this, &SMarkdownCoverageReport::HandleEntrySort )
+
+					+ SHeaderRow::Column( DocumentSaved ).DefaultLabel( LOCTEXT( "DocumentSavedColumn", "Document Saved" ) ).FillWidth( 1.5f )
+					.SortMode( this, &SMarkdownCoverageReport::GetEntrySortMode, DocumentSaved ).OnSort( this, &SMarkdownCoverageReport::HandleEntrySort )
+				)
+			]
+		]
+	];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownCoverageReport::Refresh()
+{
+	if( bBuilding )
+	{
+		return;
+	}
+
+	bBuilding = true;
+
+	StatusText->SetText( IAssetRegistry::GetChecked().IsLoadingAssets()
+		? LOCTEXT( "BuildingLoading", "Building the report, the asset registry is still loading so it will not have everything..." )
+		: LOCTEXT( "Building", "Building the report..." ) );
+
+	// the asset registry is read here, the timestamps and everything else on workers
+	TSharedRef<FMarkdownCoverage> Coverage = MakeShared<FMarkdownCoverage>();
+	TWeakPtr<SMarkdownCoverageReport> WeakThis = StaticCastSharedRef<SMarkdownCoverageReport>( AsShared() );
+
+	UE::Tasks::Launch( UE_SOURCE_LOCATION, [ Coverage, WeakThis ]()
+	{
+		TSharedRef<FMarkdownCoverageReport> NewReport = MakeShared<FMarkdownCoverageReport>();
+		Coverage->Build( *NewReport );
+
+		AsyncTask( ENamedThreads::GameThread, [ WeakThis, NewReport ]()
+		{
+			if( const TSharedPtr<SMarkdownCoverageReport> This = WeakThis.Pin() )
+			{
+				This->SetReport( NewReport );
+			}
+		});
+	});
+}
+
+void SMarkdownCoverageReport::SetReport( const TSharedRef<FMarkdownCoverageReport>& InReport )
+{
+	Report = InReport;
+	bBuilding = false;
+
+	UpdateFolders();
+	UpdateEntries();
+
+	FNumberFormattingOptions Seconds;
+	Seconds.SetMaximumFractionalDigits( 2 );
+
+	StatusText->SetText( FText::Format( LOCTEXT( "Status", "{0} of {1} assets documented ({2}), {3} stale, built in {4} s" ),
+		Report->Total.NumDocumented, Report->Total.NumAssets, FText::AsPercent( Report->Total.GetCoverage() ), Report->Total.NumStale,
+		FText::AsNumber( Report->Seconds, &Seconds ) ) );
+}
+
+const FMarkdownCoverageCounts& SMarkdownCoverageReport::GetCounts( const FMarkdownCoverageFolder& Folder ) const
+{
+	return Category == EMarkdownCoverageCategory::Num ? Folder.Total : Folder.Categories[ int32( Category ) ];
+}
+
+bool SMarkdownCoverageReport::PassesFilter( const FMarkdownCoverageEntry& Entry ) const
+{
+	if( Entry.IsStale() != bShowStale || ( Category != EMarkdownCoverageCategory::Num && Entry.Category != Category ) )
+	{
+		return false;
+	}
+
+	if( SelectedFolder.IsEmpty() )
+	{
+		return true;
+	}
+
+	// the folder or one under it, not one that only starts the same
+	const FString Folder = Entry.Folder.ToString();
+	return Folder.StartsWith( SelectedFolder ) && ( Folder.Len() == SelectedFolder.Len() || Folder[ SelectedFolder.Len() ] == TEXT( '/' ) );
+}
+
+void SMarkdownCoverageReport::UpdateFolders()
+{
+	using namespace MarkdownCoverageColumns;
+
+	Folders.Reset();
+
+	if( Report.IsValid() )
+	{
+		for( const FMarkdownCoverageFolder& Folder : Report->Folders )
+		{
+			if( GetCounts( Folder ).NumAssets > 0 )
+			{
+				Folders.Add( MakeShared<FMarkdownCoverageFolder>( Folder ) );
+			}
+		}
+	}
+
+	if( FolderSortMode != EColumnSortMode::None )
+	{
+		const bool bAscending = FolderSortMode == EColumnSortMode::Ascending;
+
+		Folders.StableSort( [ this, bAscending ]( const FFolderPtr& A, const FFolderPtr& B )
+		{
+			const FMarkdownCoverageCounts& CountsA = GetCounts( *A );
+			const FMarkdownCoverageCounts& CountsB = GetCounts( *B );
+
+			int32 Result = 0;
+
+			if( FolderSortColumn == Folder )          Result = Compare( A->Path, B->Path );
+			else if( FolderSortColumn == Assets )     Result = Compare( CountsA.NumAssets, CountsB.NumAssets );
+			else if( FolderSortColumn == Documented ) Result = Compare( CountsA.NumDocumented, CountsB.NumDocumented );
+			else if( FolderSortColumn == Coverage )   Result = Compare( CountsA.GetCoverage(), CountsB.GetCoverage() );
+			else if( FolderSortColumn == Stale )      Result = Compare( CountsA.NumStale, CountsB.NumStale );
+
+			return bAscending ? Result < 0 : Result > 0;
+		});
+	}
+
+	// the counts are copied into the rows, so they are made again rather than refreshed
+	FolderList->RebuildList();
+}
+
+void SMarkdownCoverageReport::UpdateEntries()
+{
+	using namespace MarkdownCoverageColumns;
+
+	Entries.Reset();
+
+	if( Report.IsValid() )
+	{
+		for( const FMarkdownCoverageEntry& Entry : Report->Entries )
+		{
+			if( PassesFilter( Entry ) )
+			{
+				Entries.Add( MakeShared<FMarkdownCoverageEntry>( Entry ) );
+			}
+		}
+	}
+
+	if( EntrySortMode != EColumnSortMode::None )
+	{
+		const bool bAscending = EntrySortMode == EColumnSortMode::Ascending;
+
+		Entries.StableSort( [ this, bAscending ]( const FEntryPtr& A, const FEntryPtr& B )
+		{
+			int32 Result = 0;
+
+			if( EntrySortColumn == Asset )              Result = A->Asset.GetAssetFName().Compare( B->Asset.GetAssetFName() );
+			else if( EntrySortColumn == Type )          Result = Compare( A->Category, B->Category );
+			else if( EntrySortColumn == Folder )        Result = A->Folder.Compare( B->Folder );
+			else if( EntrySortColumn == Document )      Result = A->Document.GetAssetFName().Compare( B->Document.GetAssetFName() );
+			else if( EntrySortColumn == AssetSaved )    Result = Compare( A->AssetTimestamp, B->AssetTimestamp );
+			else if( EntrySortColumn == DocumentSaved ) Result = Compare( A->DocumentTimestamp, B->DocumentTimestamp );
+
+			return bAscending ? Result < 0 : Result > 0;
+		});
+	}
+
+	EntryList->RequestListRefresh();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+EColumnSortMode::Type SMarkdownCoverageReport::GetFolderSortMode( const FName ColumnId ) const
+{
+	return ColumnId == FolderSortColumn ? FolderSortMode : EColumnSortMode::None;
+}
+
+EColumnSortMode::Type SMarkdownCoverageReport::GetEntrySortMode( const FName ColumnId ) const
+{
+	return ColumnId == EntrySortColumn ? EntrySortMode : EColumnSortMode::None;
+}
+
+void SMarkdownCoverageReport::HandleFolderSort( EColumnSortPriority::Type Priority, const FName& ColumnId, EColumnSortMode::Type Mode )
+{
+	FolderSortColumn = ColumnId;
+	FolderSortMode = Mode;
+	UpdateFolders();
+}
+
+void SMarkdownCoverageReport::HandleEntrySort( EColumnSortPriority::Type Priority, const FName& ColumnId, EColumnSortMode::Type Mode )
+{
+	EntrySortColumn = ColumnId;
+	EntrySortMode = Mode;
+	UpdateEntries();
+}
+
+void SMarkdownCoverageReport::HandleFolderSelectionChanged( FFolderPtr Folder, ESelectInfo::Type SelectInfo )
+{
+	// the lists are made again when the report changes, which clears the selection without anyone choosing to
+	if( SelectInfo == ESelectInfo::Direct )
+	{
+		return;
+	}
+
+	SelectedFolder = Folder.IsValid() ? Folder->Path : FString();
+	UpdateEntries();
+}
+
+void SMarkdownCoverageReport::HandleEntryDoubleClick( FEntryPtr Entry )
+{
+	if( !Entry.IsValid() )
+	{
+		return;
+	}
+
+	const FAssetData AssetData = IAssetRegistry::GetChecked().GetAssetByObjectPath( Entry->Asset );
+
+	if( AssetData.IsValid() )
+	{
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>( TEXT( "ContentBrowser" ) );
+		ContentBrowserModule.Get().SyncBrowserToAssets( { AssetData } );
+	}
+}
+
+TSharedRef<ITableRow> SMarkdownCoverageReport::HandleGenerateFolderRow( FFolderPtr Folder, const TSharedRef<STableViewBase>& OwnerTable )
+{
+	return SNew( SMarkdownCoverageFolderRow, OwnerTable )
+		.Path( Folder->Path )
+		.Counts( GetCounts( *Folder ) );
+}
+
+TSharedRef<ITableRow> SMarkdownCoverageReport::HandleGenerateEntryRow( FEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable )
+{
+	return SNew( SMarkdownCoverageEntryRow, OwnerTable )
+		.Entry( Entry );
+}
+
+#undef LOCTEXT_NAMESPACE
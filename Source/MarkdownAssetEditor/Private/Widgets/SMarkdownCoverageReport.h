@@ -0,0 +1,85 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Validation/MarkdownCoverage.h"
+#include "Templates/SharedPointer.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/SListView.h"
+
+class ITableRow;
+class STableViewBase;
+class STextBlock;
+
+/**
+ * The documentation coverage of each folder, and the assets without documentation or with documentation older than
+ * them, see FMarkdownCoverage. The report is built on workers when the tab opens and on refresh. Selecting a folder
+ * shows only what is under it, both lists sort by any column, and double clicking an asset finds it in the content
+ * browser.
+ */
+class SMarkdownCoverageReport : public SCompoundWidget
+{
+	public:
+
+		SLATE_BEGIN_ARGS( SMarkdownCoverageReport ) {}
+		SLATE_END_ARGS()
+
+	public:
+
+		static const FName TabName;
+
+		void Construct( const FArguments& InArgs );
+
+		/** Builds the report again from the asset registry. */
+		void Refresh();
+
+	private:
+
+		using FFolderPtr = TSharedPtr<FMarkdownCoverageFolder>;
+		using FEntryPtr  = TSharedPtr<FMarkdownCoverageEntry>;
+
+		void SetReport( const TSharedRef<FMarkdownCoverageReport>& InReport );
+		void UpdateFolders();
+		void UpdateEntries();
+
+		const FMarkdownCoverageCounts& GetCounts( const FMarkdownCoverageFolder& Folder ) const;
+		bool PassesFilter( const FMarkdownCoverageEntry& Entry ) const;
+
+		EColumnSortMode::Type GetFolderSortMode( const FName ColumnId ) const;
+		EColumnSortMode::Type GetEntrySortMode( const FName ColumnId ) const;
+		void HandleFolderSort( EColumnSortPriority::Type Priority, const FName& ColumnId, EColumnSortMode::Type Mode );
+		void HandleEntrySort( EColumnSortPriority::Type Priority, const FName& ColumnId, EColumnSortMode::Type Mode );
+
+		void HandleFolderSelectionChanged( FFolderPtr Folder, ESelectInfo::Type SelectInfo );
+		void HandleEntryDoubleClick( FEntryPtr Entry );
+		TSharedRef<ITableRow> HandleGenerateFolderRow( FFolderPtr Folder, const TSharedRef<STableViewBase>& OwnerTable );
+		TSharedRef<ITableRow> HandleGenerateEntryRow( FEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable );
+
+	private:
+
+		TSharedPtr<FMarkdownCoverageReport> Report;
+		bool bBuilding = false;
+
+		/** all of a category, or everything with Num */
+		EMarkdownCoverageCategory Category = EMarkdownCoverageCategory::Num;
+
+		/** which of the entries to list, undocumented or stale */
+		bool bShowStale = false;
+
+		/** only entries under this, everything when empty */
+		FString SelectedFolder;
+
+		TArray<FFolderPtr> Folders;
+		TArray<FEntryPtr> Entries;
+
+		FName FolderSortColumn;
+		EColumnSortMode::Type FolderSortMode = EColumnSortMode::None;
+		FName EntrySortColumn;
+		EColumnSortMode::Type EntrySortMode = EColumnSortMode::None;
+
+		TSharedPtr<SListView<FFolderPtr>> FolderList;
+		TSharedPtr<SListView<FEntryPtr>> EntryList;
+		TSharedPtr<STextBlock> StatusText;
+};
@@ -0,0 +1,268 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "SMarkdownQuickOpen.h"
+
+#include "ContentBrowser/MarkdownContentBrowserDataSource.h"
+#include "Editor.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Docking/TabManager.h"
+#include "HAL/PlatformTime.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetEditorModule.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/SWindow.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "SMarkdownQuickOpen"
+
+namespace MarkdownQuickOpenWindow
+{
+	static constexpr int32 MaxResults = 50;
+
+	// there is only ever one, opening it again brings it back
+	static TWeakPtr<SWindow> Window;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownQuickOpen::Open()
+{
+	if( const TSharedPtr<SWindow> Existing = MarkdownQuickOpenWindow::Window.Pin() )
+	{
+		Existing->BringToFront( true );
+		return;
+	}
+
+	UMarkdownContentBrowserDataSource* DataSource = FMarkdownAssetEditorModule::Get().GetDataSource();
+
+	if( DataSource == nullptr || !DataSource->GetHierarchy().IsValid() )
+	{
+		return;
+	}
+
+	TSharedRef<SMarkdownQuickOpen> QuickOpen = SNew( SMarkdownQuickOpen, DataSource->GetHierarchy()->GetQuickOpenIndex() );
+
+	TSharedRef<SWindow> Window = SNew( SWindow )
+		.Title( LOCTEXT( "QuickOpenTitle", "Go to Documentation" ) )
+		.ClientSize( FVector2D( 640.0f, 420.0f ) )
+		.SizingRule( ESizingRule::UserSized )
+		.SupportsMaximize( false )
+		.SupportsMinimize( false )
+		.FocusWhenFirstShown( true )
+		[
+			QuickOpen
+		];
+
+	// it goes as soon as anything else is clicked on, like a menu
+	Window->GetOnWindowDeactivatedEvent().AddLambda( [ WeakWindow = TWeakPtr<SWindow>( Window ) ]()
+	{
+		if( const TSharedPtr<SWindow> Deactivated = WeakWindow.Pin() )
+		{
+			Deactivated->RequestDestroyWindow();
+		}
+	});
+
+	if( const TSharedPtr<SWindow> Parent = FGlobalTabmanager::Get()->GetRootWindow() )
+	{
+		FSlateApplication::Get().AddWindowAsNativeChild( Window, Parent.ToSharedRef() );
+	}
+	else
+	{
+		FSlateApplication::Get().AddWindow( Window );
+	}
+
+	MarkdownQuickOpenWindow::Window = Window;
+
+	FSlateApplication::Get().SetKeyboardFocus( QuickOpen->SearchBox, EFocusCause::SetDirectly );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownQuickOpen::Construct( const FArguments& InArgs, const TSharedRef<FMarkdownQuickOpenIndex>& InIndex )
+{
+	Index = InIndex;
+
+	ChildSlot
+	[
+		SNew( SVerticalBox )
+
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding( 4.0f )
+		[
+			SAssignNew( SearchBox, SSearchBox )
+			.HintText( LOCTEXT( "QuickOpenHint", "Document or heading" ) )
+			.OnTextChanged( this, &SMarkdownQuickOpen::HandleTextChanged )
+			.OnTextCommitted( this, &SMarkdownQuickOpen::HandleTextCommitted )
+			.OnKeyDownHandler( this, &SMarkdownQuickOpen::HandleKeyDown )
+		]
+
+		+ SVerticalBox::Slot()
+		.FillHeight( 1.0f )
+		.Padding( 4.0f, 0.0f )
+		[
+			SAssignNew( ResultsList, SListView<TSharedPtr<FItem>> )
+			.ListItemsSource( &Items )
+			.SelectionMode( ESelectionMode::Single )
+			.OnGenerateRow( this, &SMarkdownQuickOpen::HandleGenerateRow )
+			.OnMouseButtonClick( this, &SMarkdownQuickOpen::OpenItem )
+		]
+
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding( 4.0f )
+		[
+			SAssignNew( StatusText, STextBlock )
+			.ColorAndOpacity( FSlateColor::UseSubduedForeground() )
+		]
+	];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownQuickOpen::Refresh()
+{
+	const double Start = FPlatformTime::Seconds();
+	Index->Find( Query, MarkdownQuickOpenWindow::MaxResults, Results );
+	const double Elapsed = FPlatformTime::Seconds() - Start;
+
+	Items.Reset( Results.Num() );
+
+	for( const FMarkdownQuickOpenResult& Result : Results )
+	{
+		Items.Add( MakeShared<FItem>( FItem{ Index->GetEntry( Result.Entry ) } ) );
+	}
+
+	ResultsList->RequestListRefresh();
+
+	if( !Items.IsEmpty() )
+	{
+		ResultsList->SetSelection( Items[ 0 ] );
+		ResultsList->RequestScrollIntoView( Items[ 0 ] );
+	}
+
+	FNumberFormattingOptions Milliseconds;
+	Milliseconds.SetMaximumFractionalDigits( 2 );
+
+	StatusText->SetText( Query.IsEmpty()
+		? FText::Format( LOCTEXT( "QuickOpenDocuments", "{0} documents" ), Index->NumDocuments() )
+		: FText::Format( LOCTEXT( "QuickOpenResults", "{0} of {1} documents and headings, {2} ms" ),
+			Items.Num(), Index->NumEntries(), FText::AsNumber( Elapsed * 1000.0, &Milliseconds ) ) );
+}
+
+void SMarkdownQuickOpen::MoveSelection( const int32 Delta )
+{
+	if( Items.IsEmpty() )
+	{
+		return;
+	}
+
+	const TArray<TSharedPtr<FItem>> Selected = ResultsList->GetSelectedItems();
+	const int32 Current = Selected.IsEmpty() ? INDEX_NONE : Items.Find( Selected[ 0 ] );
+	const int32 Next    = FMath::Clamp( Current + Delta, 0, Items.Num() - 1 );
+
+	ResultsList->SetSelection( Items[ Next ] );
+	ResultsList->RequestScrollIntoView( Items[ Next ] );
+}
+
+void SMarkdownQuickOpen::OpenItem( TSharedPtr<FItem> Item )
+{
+	if( !Item.IsValid() )
+	{
+		return;
+	}
+
+	UMarkdownContentBrowserDataSource* DataSource = FMarkdownAssetEditorModule::Get().GetDataSource();
+	UMarkdownFile* File = DataSource != nullptr ? DataSource->GetHierarchy()->FindMDFile( Item->Entry.Path ) : nullptr;
+
+	// headings open their document, the editor has no way to be sent to one yet
+	UMarkdownAsset* Asset = File != nullptr ? File->GetMarkdownAsset() : nullptr;
+
+	Close();
+
+	if( Asset != nullptr )
+	{
+		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset( Asset );
+	}
+}
+
+void SMarkdownQuickOpen::Close()
+{
+	if( const TSharedPtr<SWindow> Window = FSlateApplication::Get().FindWidgetWindow( AsShared() ) )
+	{
+		Window->RequestDestroyWindow();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void SMarkdownQuickOpen::HandleTextChanged( const FText& InText )
+{
+	Query = InText.ToString();
+	Refresh();
+}
+
+void SMarkdownQuickOpen::HandleTextCommitted( const FText& InText, ETextCommit::Type InCommitType )
+{
+	if( InCommitType == ETextCommit::OnEnter )
+	{
+		const TArray<TSharedPtr<FItem>> Selected = ResultsList->GetSelectedItems();
+		OpenItem( Selected.IsEmpty() ? nullptr : Selected[ 0 ] );
+	}
+}
+
+FReply SMarkdownQuickOpen::HandleKeyDown( const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent )
+{
+	if( InKeyEvent.GetKey() == EKeys::Up || InKeyEvent.GetKey() == EKeys::Down )
+	{
+		MoveSelection( InKeyEvent.GetKey() == EKeys::Up ? -1 : 1 );
+		return FReply::Handled();
+	}
+
+	if( InKeyEvent.GetKey() == EKeys::Escape )
+	{
+		Close();
+		return FReply::Handled();
+	}
+
+	return FReply::Unhandled();
+}
+
+TSharedRef<ITableRow> SMarkdownQuickOpen::HandleGenerateRow( TSharedPtr<FItem> Item, const TSharedRef<STableViewBase>& OwnerTable )
+{
+	const FMarkdownQuickOpenEntry& Entry = Item->Entry;
+
+	// documents show where they are, headings the document and anchor they go to
+	const FString Location = Entry.Slug.IsEmpty() ? Entry.Path : Entry.Path + TEXT( "#" ) + Entry.Slug;
+
+	return SNew( STableRow<TSharedPtr<FItem>>, OwnerTable )
+	.Padding( FMargin( 4.0f, 2.0f ) )
+	[
+		SNew( SHorizontalBox )
+
+		+ SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding( Entry.Level > 1 ? 12.0f : 0.0f, 0.0f, 12.0f, 0.0f )
+		[
+			SNew( STextBlock )
+			.Text( FText::FromString( Entry.Title ) )
+			.Font( Entry.Slug.IsEmpty() ? FAppStyle::GetFontStyle( "BoldFont" ) : FAppStyle::GetFontStyle( "NormalFont" ) )
+			.HighlightText_Lambda( [ this ]() { return FText::FromString( Query ); } )
+		]
+
+		+ SHorizontalBox::Slot()
+		.FillWidth( 1.0f )
+		.HAlign( HAlign_Right )
+		[
+			SNew( STextBlock )
+			.Text( FText::FromString( Location ) )
+			.ColorAndOpacity( FSlateColor::UseSubduedForeground() )
+			.OverflowPolicy( ETextOverflowPolicy::Ellipsis )
+		]
+	];
+}
+
+#undef LOCTEXT_NAMESPACE
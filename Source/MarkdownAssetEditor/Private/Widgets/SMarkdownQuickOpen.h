@@ -0,0 +1,60 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Search/MarkdownQuickOpenIndex.h"
+#include "Templates/SharedPointer.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+class ITableRow;
+class SSearchBox;
+class STableViewBase;
+class STextBlock;
+class SWindow;
+
+/** Goes to a document, or the document with a heading, by typing part of its name. */
+class SMarkdownQuickOpen : public SCompoundWidget
+{
+	public:
+
+		SLATE_BEGIN_ARGS( SMarkdownQuickOpen ) {}
+		SLATE_END_ARGS()
+
+	public:
+
+		/** Shows the quick open window over the editor, or brings it back to the front if it is already open. */
+		static void Open();
+
+		void Construct( const FArguments& InArgs, const TSharedRef<FMarkdownQuickOpenIndex>& InIndex );
+
+	private:
+
+		struct FItem
+		{
+			FMarkdownQuickOpenEntry Entry;
+		};
+
+		void Refresh();
+		void MoveSelection( const int32 Delta );
+		void OpenItem( TSharedPtr<FItem> Item );
+		void Close();
+
+		void HandleTextChanged( const FText& InText );
+		void HandleTextCommitted( const FText& InText, ETextCommit::Type InCommitType );
+		FReply HandleKeyDown( const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent );
+		TSharedRef<ITableRow> HandleGenerateRow( TSharedPtr<FItem> Item, const TSharedRef<STableViewBase>& OwnerTable );
+
+	private:
+
+		TSharedPtr<FMarkdownQuickOpenIndex> Index;
+
+		TSharedPtr<SSearchBox> SearchBox;
+		TSharedPtr<SListView<TSharedPtr<FItem>>> ResultsList;
+		TSharedPtr<STextBlock> StatusText;
+
+		FString Query;
+		TArray<TSharedPtr<FItem>> Items;
+		TArray<FMarkdownQuickOpenResult> Results;
+};
@@ -20,6 +20,25 @@ struct FMarkdownContentBrowserDataFilter
 	TSet<FName> Folders;
 };
 
+/**
+ * Search text for the markdown data source, for code that enumerates items itself: add it to
+ * FContentBrowserDataFilter::ExtraFilters and files are matched through the documentation search index, on their
+ * titles, headings and front matter tags, rather than their names. The content browser's search box does not use
+ * this, it matches the Title, Headings and Tags attributes of the items instead ("Headings:setup", "Tags:network").
+ */
+USTRUCT()
+struct MARKDOWNASSETEDITOR_API FMarkdownContentBrowserTextFilter
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString SearchText;
+
+	/** match the body text of the files too */
+	UPROPERTY()
+	bool bIncludeBody = false;
+};
+
 UCLASS()
 class UMarkdownContentBrowserDataSource : public UContentBrowserDataSource
 {
@@ -76,6 +95,9 @@ public:
 
 	virtual void BuildRootPathVirtualTree() override;
 
+	/** The hierarchy of the Documentation folder, made on first use. */
+	const TSharedPtr<FMarkdownContentBrowserHierarchy>& GetHierarchy();
+
 private:
 	static void OnNewClassRequested(const FName& InSelectedPath);
 
@@ -101,6 +123,9 @@ private:
 
 	FContentBrowserItemData CreateFileItem(UMarkdownFile* InFile);
 
+	bool GetFilesMatchingText(const FMarkdownContentBrowserTextFilter& InTextFilter, const TSet<FName>& InInternalPaths,
+	                          const bool bRecursive, TArray<UMarkdownFile*>& OutFiles) const;
+
 	bool GetClassPaths(const TArrayView<const FCollectionNameType>& InCollections,
 	                   const bool bIncludeChildCollections,
 #if UE_F_TOP_LEVEL_ASSET_PATH
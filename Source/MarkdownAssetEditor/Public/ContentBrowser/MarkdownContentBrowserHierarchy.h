@@ -4,6 +4,7 @@
 
 
 class UMarkdownAsset;
+class FMarkdownQuickOpenIndex;
 
 UCLASS()
 class MARKDOWNASSETEDITOR_API UMarkdownFile : public UObject
@@ -22,6 +23,12 @@ public:
 
 	UFUNCTION()
 	void OnAssetChanged();
+
+	/** The content browser path of the file, /Documentation/... */
+	FString GetInternalPath() const;
+
+	/** updated with the headings of the asset as it is edited */
+	TWeakPtr<FMarkdownQuickOpenIndex> QuickOpenIndex;
 };
 
 struct FMarkdownContentBrowserHierarchyNode
@@ -46,7 +53,17 @@ struct FMarkdownContentBrowserHierarchyNode
 class FMarkdownContentBrowserHierarchy
 {
 public:
-	FMarkdownContentBrowserHierarchy();
+	/** InQuickOpenIndex comes from the hierarchy this one replaces, so only the files changed since are read again. */
+	explicit FMarkdownContentBrowserHierarchy(const TSharedPtr<FMarkdownQuickOpenIndex>& InQuickOpenIndex = nullptr);
+
+	/**
+	 * Documents and their headings by approximate name. Files are in it by name as soon as they are found, with their
+	 * headings once they have been read in the background.
+	 */
+	const TSharedRef<FMarkdownQuickOpenIndex>& GetQuickOpenIndex() const
+	{
+		return QuickOpenIndex;
+	}
 
 	TSharedPtr<FMarkdownContentBrowserHierarchyNode> FindNode(const FName& InPath) const;
 
@@ -58,8 +75,16 @@ public:
 
 	TArray<UMarkdownFile*> GetMatchingMDFiles(const FName& InPath, const bool bRecurse = false) const;
 
+	/** The file at the internal path (/Documentation/...), null if there is none. */
+	UMarkdownFile* FindMDFile(const FString& InInternalPath) const;
+
 	static FString ConvertInternalPathToFileSystemPath(const FString& InInternalPath);
 
+	static FString ConvertFileSystemPathToInternalPath(const FString& InFileSystemPath);
+
+	/** Internal paths (/Documentation/...) of the .md files under the project's Documentation folder. */
+	static void FindMDFiles(TArray<FString>& OutInternalPaths);
+
 private:
 	static bool EnumeratePath(const FString& InPath, const TFunctionRef<bool(const FName&)>& InCallback);
 
@@ -67,6 +92,10 @@ private:
 
 	void PopulateHierarchy();
 
+	void UpdateQuickOpenIndex(const TArray<FString>& InInternalPaths) const;
+
 private:
 	TSharedPtr<FMarkdownContentBrowserHierarchyNode> Root;
+
+	TSharedRef<FMarkdownQuickOpenIndex> QuickOpenIndex;
 };
@@ -0,0 +1,152 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorSubsystem.h"
+#include "IO/IoHash.h"
+#include "UObject/ObjectSaveContext.h"
+
+#include "MarkdownDocumentationSubsystem.generated.h"
+
+struct FAssetData;
+class IAssetRegistry;
+class UMarkdownAsset;
+class UPackage;
+
+UENUM( BlueprintType )
+enum class EMarkdownDocumentationState : uint8
+{
+	/** no document has the asset */
+	Undocumented,
+
+	/** the asset has been saved since its document was */
+	Stale,
+
+	Current,
+};
+
+/** The documentation of an asset. */
+struct FMarkdownDocumentation
+{
+	FSoftObjectPath Document;
+
+	/** the saved hash of the asset's package when the document was last saved, zero if it was not known */
+	FIoHash AssetHash;
+
+	/** Whether the asset has been saved since, from the package data in the asset registry. */
+	bool IsStale( const FSoftObjectPath& Asset, const IAssetRegistry& AssetRegistry ) const;
+};
+
+/** Called with the asset and its new documentation, or a null path when it has none any more. */
+DECLARE_MULTICAST_DELEGATE_TwoParams( FOnMarkdownDocumentationChanged, const FSoftObjectPath& /* Asset */, const FSoftObjectPath& /* Document */ );
+
+/**
+ * Which markdown asset is the documentation of each asset. Documents keep the assets they are for themselves, saved
+ * with them and in the asset registry (UMarkdownAsset::DocumentedAssetsTag), and this turns that around once the
+ * registry has finished its first scan so an asset's documentation is a single lookup, kept up to date as documents
+ * are saved, renamed or deleted. Nothing is loaded to build it.
+ *
+ * Documents also keep the saved hash of each asset's package as of their own last save, so whether the documentation
+ * is older than the asset comes from the asset registry too, which is enough for content browser filters over any
+ * number of assets.
+ *
+ * Associations in the documentation settings from before documents kept them are still found, until they are moved
+ * to their documents with Markdown.MigrateDocumentationSettings.
+ */
+UCLASS()
+class MARKDOWNASSETEDITOR_API UMarkdownDocumentationSubsystem : public UEditorSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ USubsystem interface
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Deinitialize() override;
+
+	/** The markdown asset documenting the asset, a null path if it has none. */
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Documentation" )
+	FSoftObjectPath FindDocumentation( const FSoftObjectPath& Asset ) const;
+
+	/** The assets the markdown asset is the documentation of. */
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Documentation" )
+	TArray<FSoftObjectPath> GetDocumentedAssets( const FSoftObjectPath& Document ) const;
+
+	/**
+	 * Whether the asset has documentation, and if so whether the asset has been saved since it was. Kept until the
+	 * asset or its documentation changes, so it is cheap enough to ask for every frame.
+	 */
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Documentation" )
+	EMarkdownDocumentationState GetDocumentationState( const FSoftObjectPath& Asset ) const;
+
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Documentation" )
+	bool HasDocumentation( const FSoftObjectPath& Asset ) const
+	{
+		return Documentation.Contains( Asset );
+	}
+
+	/**
+	 * Makes the document the documentation of the assets, taking them from any other documents that had them. The
+	 * documents that change are marked dirty rather than saved, so they go with everything else the user saves.
+	 */
+	void SetDocumentation( TConstArrayView<FSoftObjectPath> Assets, UMarkdownAsset* Document );
+
+	/**
+	 * Moves the associations in the documentation settings to their documents and saves those together, then empties
+	 * them from the settings. Returns how many were moved, ones to documents that no longer exist are dropped.
+	 */
+	int32 MigrateSettings();
+
+	/**
+	 * The document of every asset from what is in the asset registry and the documentation settings, without the
+	 * subsystem, for commandlets and anything else that has to have it all before the subsystem is ready.
+	 */
+	static void CollectDocumentation( TMap<FSoftObjectPath, FMarkdownDocumentation>& OutDocumentation );
+
+	/** False until the asset registry has finished its first scan. */
+	bool IsReady() const
+	{
+		return bReady;
+	}
+
+	/** Every asset with documentation and its document. */
+	const TMap<FSoftObjectPath, FMarkdownDocumentation>& GetAllDocumentation() const
+	{
+		return Documentation;
+	}
+
+	/** Called on the game thread for each asset that gets, changes or loses its documentation. */
+	FOnMarkdownDocumentationChanged& OnDocumentationChanged()
+	{
+		return DocumentationChanged;
+	}
+
+private:
+
+	void SetDocumentation( TConstArrayView<FSoftObjectPath> Assets, UMarkdownAsset* Document, TArray<UPackage*>& OutChanged );
+
+	void AddDocument( const FAssetData& AssetData );
+	void RemoveDocument( const FSoftObjectPath& Document );
+	void Associate( const FSoftObjectPath& Asset, const FMarkdownDocumentation& NewDocumentation );
+
+	void HandleFilesLoaded();
+	void HandleAssetAdded( const FAssetData& AssetData );
+	void HandleAssetUpdated( const FAssetData& AssetData );
+	void HandleAssetRemoved( const FAssetData& AssetData );
+	void HandleAssetRenamed( const FAssetData& AssetData, const FString& OldObjectPath );
+	void HandlePackageSaved( const FString& Filename, UPackage* Package, FObjectPostSaveContext SaveContext );
+
+	/** the document of each asset */
+	TMap<FSoftObjectPath, FMarkdownDocumentation> Documentation;
+
+	/** the assets of each document, to know what to take out when it changes */
+	TMap<FSoftObjectPath, TArray<FSoftObjectPath>> DocumentedAssets;
+
+	/** whether documented assets are stale, as they are asked for, since it takes the asset registry's package data */
+	mutable TMap<FSoftObjectPath, bool> Stale;
+
+	bool bReady = false;
+
+	FOnMarkdownDocumentationChanged DocumentationChanged;
+};
@@ -0,0 +1,116 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "MarkdownLinkGraph.generated.h"
+
+UENUM( BlueprintType )
+enum class EMarkdownLinkKind : uint8
+{
+	/** a document links to another, a .md file or a markdown asset */
+	DocumentToDocument,
+
+	/** a document links to an asset */
+	DocumentToAsset,
+
+	/** the asset is documented by the document */
+	AssetToDocument,
+};
+
+/** One end of a link, the target of a link or the source of a backlink. */
+USTRUCT( BlueprintType )
+struct MARKDOWNASSETEDITOR_API FMarkdownLinkEdge
+{
+	GENERATED_BODY()
+
+	/** content browser path of a file (/Documentation/...) or an object path */
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	FString Path;
+
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	EMarkdownLinkKind Kind = EMarkdownLinkKind::DocumentToDocument;
+};
+
+/**
+ * What documents link to, and what links to them. Each node keeps both its links and its backlinks, so either is
+ * found in time proportional to their number, and replacing the links of a document only touches the nodes it linked
+ * to. Nodes are there for as long as anything links from or to them. Game thread only.
+ */
+class MARKDOWNASSETEDITOR_API FMarkdownLinkGraph
+{
+public:
+
+	/** Replaces the links from Source. Links to itself and repeats are left out. */
+	void SetLinks( const FString& Source, TConstArrayView<FMarkdownLinkEdge> Links );
+
+	void RemoveLinks( const FString& Source )
+	{
+		SetLinks( Source, {} );
+	}
+
+	bool HasLinks( const FString& Path ) const
+	{
+		const int32* Id = NodeIds.Find( Path );
+		return Id != nullptr && !Nodes[ *Id ].Links.IsEmpty();
+	}
+
+	void GetLinks( const FString& Path, TArray<FMarkdownLinkEdge>& OutLinks ) const;
+	void GetBacklinks( const FString& Path, TArray<FMarkdownLinkEdge>& OutBacklinks ) const;
+
+	int32 NumNodes() const
+	{
+		return NodeIds.Num();
+	}
+
+	int32 NumLinks() const
+	{
+		return NumEdges;
+	}
+
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * The content browser path of a .md file linked to from Source. Relative paths are from the folder of a file, or
+	 * the documentation root for an asset. Empty if the path goes above the root.
+	 */
+	static FString ResolvePath( const FString& Source, const FString& Target );
+
+private:
+
+	struct FEdge
+	{
+		int32 Node = INDEX_NONE;
+		EMarkdownLinkKind Kind = EMarkdownLinkKind::DocumentToDocument;
+
+		bool operator==( const FEdge& Other ) const
+		{
+			return Node == Other.Node && Kind == Other.Kind;
+		}
+
+		friend uint32 GetTypeHash( const FEdge& Edge )
+		{
+			return HashCombine( ::GetTypeHash( Edge.Node ), ::GetTypeHash( Edge.Kind ) );
+		}
+	};
+
+	struct FNode
+	{
+		FString Path;
+		TArray<FEdge> Links;
+		TArray<FEdge> Backlinks;
+	};
+
+	int32 FindOrAddNode( const FString& Path );
+	void ReleaseNode( const int32 Id );
+
+	TArray<FNode> Nodes;
+
+	/** of nodes that went, for the next ones */
+	TArray<int32> FreeIds;
+
+	TMap<FString, int32> NodeIds;
+
+	int32 NumEdges = 0;
+};
@@ -0,0 +1,110 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorSubsystem.h"
+#include "Search/MarkdownLinkGraph.h"
+#include "UObject/ObjectSaveContext.h"
+
+#include "MarkdownLinkSubsystem.generated.h"
+
+struct FAssetData;
+struct FFileChangeData;
+struct FMarkdownLinkJob;
+class FMarkdownLoadRequest;
+class UMarkdownAsset;
+
+/** New links for a document or an asset, or its links to drop. */
+struct FMarkdownLinkChange
+{
+	bool bRemoved = false;
+
+	/** the link destinations of a markdown asset as written, files are read again from disk */
+	TArray<FString> Destinations;
+
+	/** links that need no resolving, the documentation of an asset */
+	TArray<FMarkdownLinkEdge> Edges;
+};
+
+/**
+ * Which documents link to which, which assets they link to and which documents the assets are documented by, for
+ * both the .md files in the content browser and every markdown asset. The graph is built on workers once the asset
+ * registry has finished its first scan, then kept up to date as files change on disk and assets are saved, renamed
+ * or deleted. Which document each asset has comes from UMarkdownDocumentationSubsystem.
+ *
+ * Markdown assets keep their links in the asset registry (UMarkdownAsset::LinksTag), so only ones saved before that
+ * are loaded. Their links to assets are also saved as dependencies, which is how they show in the reference viewer.
+ */
+UCLASS()
+class MARKDOWNASSETEDITOR_API UMarkdownLinkSubsystem : public UEditorSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ USubsystem interface
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Deinitialize() override;
+
+	/** What the document or asset links to, a file by content browser path (/Documentation/...) or an object path. */
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Links" )
+	TArray<FMarkdownLinkEdge> GetLinks( const FString& Path ) const;
+
+	/** What links to the document or asset. */
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Links" )
+	TArray<FMarkdownLinkEdge> GetBacklinks( const FString& Path ) const;
+
+	UFUNCTION( BlueprintPure, Category = "Markdown|Links" )
+	bool IsGraphReady() const
+	{
+		return bGraphReady;
+	}
+
+	/** Drops the graph and builds it again from everything in the project. */
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Links" )
+	void RebuildGraph();
+
+	/** Empty until the first build has finished. */
+	const FMarkdownLinkGraph& GetGraph() const
+	{
+		return Graph;
+	}
+
+	/** Called on the game thread each time the graph changes. */
+	FSimpleMulticastDelegate& OnGraphChanged()
+	{
+		return GraphChanged;
+	}
+
+private:
+
+	void HandleAssetsLoaded( const TArray<UMarkdownAsset*>& Assets, TSharedRef<FMarkdownLinkJob> InJob );
+	void BuildGraph( const TSharedRef<FMarkdownLinkJob>& InJob );
+	void UpdateGraph();
+	void SetGraph( const TSharedRef<FMarkdownLinkJob>& InJob );
+	void CancelJob();
+
+	void QueueChange( const FString& Path, FMarkdownLinkChange&& Change );
+
+	void HandleFilesLoaded();
+	void HandleDocumentationChanged( const FSoftObjectPath& Asset, const FSoftObjectPath& Document );
+	void HandleAssetRemoved( const FAssetData& AssetData );
+	void HandleAssetRenamed( const FAssetData& AssetData, const FString& OldObjectPath );
+	void HandlePackageSaved( const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext );
+	void HandleDirectoryChanged( const TArray<FFileChangeData>& FileChanges );
+
+	FMarkdownLinkGraph Graph;
+	bool bGraphReady = false;
+
+	/** the build or update running on the workers, there is only ever one */
+	TSharedPtr<FMarkdownLinkJob> Job;
+
+	/** changes that came in while a job was running, they go into the next update */
+	TMap<FString, FMarkdownLinkChange> PendingChanges;
+
+	FSimpleMulticastDelegate GraphChanged;
+
+	FString WatchedDirectory;
+	FDelegateHandle DirectoryChangedHandle;
+};
@@ -0,0 +1,132 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Parser/MarkdownHeadingIndex.h"
+
+/** A document, or a heading in one, that quick open can go to. */
+struct FMarkdownQuickOpenEntry
+{
+	/** content browser path of the file (/Documentation/...) */
+	FString Path;
+
+	/** the document title, or the text of the heading */
+	FString Title;
+
+	/** empty for the document itself */
+	FString Slug;
+
+	/** the heading level, 0 for the document itself */
+	int32 Level = 0;
+};
+
+struct FMarkdownQuickOpenResult
+{
+	int32 Entry = INDEX_NONE;
+	float Score = 0.0f;
+};
+
+/**
+ * Finds documents and headings by approximate name, for quick open. The words of each entry (the title and path of a
+ * document, or a heading and the title of its document) are split into trigrams, so a query only looks at the entries
+ * that share enough of its trigrams, or start a word the way a query too short for a trigram does. Those are ranked by
+ * how well the query matches them as a subsequence, favouring the starts of words and runs of characters, and ones
+ * that only match because of a typo come last.
+ *
+ * Documents are added and removed one at a time as the files change, replaced entries are dropped for good once there
+ * are enough of them. Game thread only.
+ */
+class MARKDOWNASSETEDITOR_API FMarkdownQuickOpenIndex
+{
+public:
+
+	/**
+	 * Adds the document and its headings, replacing what the index had for the path. Tags (from the front matter) are
+	 * not matched by quick open, they are kept for GetOutline.
+	 */
+	void AddDocument( const FString& Path, TConstArrayView<FMarkdownHeading> Headings, const FDateTime& Timestamp = FDateTime::MinValue(), TConstArrayView<FString> Tags = {} );
+
+	void RemoveDocument( const FString& Path );
+
+	bool Contains( const FString& Path ) const
+	{
+		return Documents.Contains( Path );
+	}
+
+	/** When the file was last modified as of the headings in the index, MinValue if they haven't been read. */
+	FDateTime GetTimestamp( const FString& Path ) const;
+
+	/** The title, heading titles and tags of the document, false if it is not in the index. */
+	bool GetOutline( const FString& Path, FString& OutTitle, TArray<FString>& OutHeadings, TArray<FString>& OutTags ) const;
+
+	/** Every document in the index and its timestamp. */
+	void GetTimestamps( TMap<FString, FDateTime>& OutTimestamps ) const;
+
+	/** The best matches for the query, best first. */
+	void Find( const FStringView Query, const int32 MaxResults, TArray<FMarkdownQuickOpenResult>& OutResults ) const;
+
+	const FMarkdownQuickOpenEntry& GetEntry( const int32 Index ) const
+	{
+		return Entries[ Index ];
+	}
+
+	int32 NumDocuments() const
+	{
+		return Documents.Num();
+	}
+
+	int32 NumEntries() const
+	{
+		return Entries.Num() - NumRemoved;
+	}
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	/** what a query looks at for each entry, apart from the entry itself so more of them fit in the cache */
+	struct FEntryKey
+	{
+		/** what queries are matched against, lowercased, in KeyChars */
+		int32 Start = 0;
+		int32 Length = 0;
+
+		/** a bit for each character in the key, so entries missing one of the query's are skipped without a look */
+		uint64 CharMask = 0;
+
+		bool bDocument = false;
+		bool bRemoved = false;
+	};
+
+	FStringView GetKey( const FEntryKey& Key ) const
+	{
+		return FStringView( KeyChars.GetData() + Key.Start, Key.Length );
+	}
+
+	void AddEntry( FMarkdownQuickOpenEntry&& Entry, const FString& Key, TArray<int32>& OutIds );
+	void AddTrigrams( const int32 Id );
+	void Compact();
+
+	TArray<FMarkdownQuickOpenEntry> Entries;
+	TArray<FEntryKey> Keys;
+
+	/** the keys of all the entries back to back, which keeps a scan over them in order in memory */
+	TArray<TCHAR> KeyChars;
+
+	struct FDocument
+	{
+		/** the headings, then the document itself */
+		TArray<int32> Ids;
+		TArray<FString> Tags;
+		FDateTime Timestamp;
+	};
+
+	/** the entries of each document by path */
+	TMap<FString, FDocument> Documents;
+
+	/** the entries with each trigram (and word start), in the order they were added */
+	TMap<uint64, TArray<int32>> Trigrams;
+
+	int32 NumRemoved = 0;
+};
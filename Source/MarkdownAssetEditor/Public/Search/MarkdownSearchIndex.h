@@ -0,0 +1,80 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Search/MarkdownSearchSegment.h"
+
+/**
+ * The full-text index of the project documentation, a list of immutable segments. The first holds most documents,
+ * the ones after it are small deltas with documents added or changed since, and each segment flags its documents
+ * that a later one replaced or that were deleted. Searches run over every segment with counts taken across all of
+ * them, so results rank the same as if the segments were merged, which they are every so often in the background.
+ *
+ * An index never changes once made. Updates make a new one sharing the old segments, so a search can go on with the
+ * old index on any thread while the new one is made. Saved indexes are a small file listing the segments, which are
+ * mapped in as they are, so a saved index can be searched moments after loading.
+ */
+class MARKDOWNASSETEDITOR_API FMarkdownSearchIndex
+{
+public:
+
+	explicit FMarkdownSearchIndex( TArray<FMarkdownSearchSegmentRef>&& InSegments );
+
+	/** Maps in the index saved in the directory. Null if there is none, or any part of it can't be used. */
+	static TSharedPtr<FMarkdownSearchIndex> Load( const FString& Directory );
+
+	/**
+	 * Writes out the list of segments and their removed documents, the segments have to be saved already. Files of
+	 * segments no longer in the index are deleted, or left for a later save while they are still mapped.
+	 */
+	bool Save( const FString& Directory ) const;
+
+	static FString GetSegmentFilename( const FString& Directory, const int32 Id );
+
+	/** A new index with the documents at the removed paths taken out, then the segment (if any) added after the others. */
+	TSharedRef<FMarkdownSearchIndex> Update( const TSharedPtr<const FMarkdownSearchSegment>& Segment, const int32 Id, TConstArrayView<FString> RemovedPaths ) const;
+
+	/** See FMarkdownSearchQuery for the syntax. Documents that have every word of the query, best first. */
+	void Search( const FStringView Query, const int32 MaxResults, TArray<FMarkdownSearchHit>& OutHits ) const;
+	void Search( const FMarkdownSearchQuery& Query, const int32 MaxResults, TArray<FMarkdownSearchHit>& OutHits ) const;
+
+	/** The current version of the document, null if it is not in the index. */
+	const FMarkdownSearchDocument* FindDocument( const FStringView Path ) const;
+
+	/** Calls back with every current document, skipping the ones replaced or removed. */
+	void ForEachDocument( TFunctionRef<void( const FMarkdownSearchDocument& )> Callback ) const;
+
+	const FMarkdownSearchDocument& GetDocument( const FMarkdownSearchHit& Hit ) const
+	{
+		return Segments[ Hit.Segment ].Segment->GetDocument( Hit.Document );
+	}
+
+	const TArray<FMarkdownSearchSegmentRef>& GetSegments() const
+	{
+		return Segments;
+	}
+
+	int32 NumDocuments() const
+	{
+		return DocumentIds.Num();
+	}
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	struct FDocumentId
+	{
+		int32 Segment;
+		int32 Document;
+	};
+
+	TArray<FMarkdownSearchSegmentRef> Segments;
+
+	/** current documents by path */
+	TMap<FString, FDocumentId> DocumentIds;
+
+	/** over the current documents, for the average length */
+	int64 TotalTokens = 0;
+};
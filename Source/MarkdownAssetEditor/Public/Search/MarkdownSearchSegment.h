@@ -0,0 +1,199 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FMarkdownSearchSegment;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/** Text handed to FMarkdownSearchSegment::Build. */
+struct FMarkdownSearchSource
+{
+	/** content browser path of a file (/Documentation/...) or the object path of an asset */
+	FString Path;
+
+	/** left empty to use the first heading of the text */
+	FString Title;
+
+	FString Text;
+
+	/** see FMarkdownSearchDocument */
+	uint64 ContentHash = 0;
+};
+
+/** A document in the search index. */
+struct FMarkdownSearchDocument
+{
+	FString Path;
+	FString Title;
+
+	/** the hash of a file's text or of the saved asset package, used to skip documents that have not changed. 0 if unknown */
+	uint64 ContentHash = 0;
+
+	/** the title is indexed ahead of the text, so positions below this are in the title */
+	int32 NumTitleTokens = 0;
+
+	/** then the headings and front matter tags, positions below this are in the title or them */
+	int32 NumOutlineTokens = 0;
+
+	int32 NumTokens = 0;
+};
+
+struct FMarkdownSearchHit
+{
+	/** the segment of the index the document is in */
+	int32 Segment = 0;
+	int32 Document = INDEX_NONE;
+	float Score = 0.0f;
+};
+
+/** A query broken into its words and phrases, once for all the segments it runs against. */
+struct FMarkdownSearchQuery
+{
+	TArray<FString> Words;
+	TArray<TArray<FString>> Phrases;
+
+	/** the last word is still being typed, so it matches as a prefix */
+	bool bPrefix = false;
+
+	/** only match the title, headings and front matter tags, not the body text */
+	bool bOutlineOnly = false;
+
+	/** False if there is nothing to search for. */
+	bool Parse( const FStringView Query );
+};
+
+/** Counts over all the segments searched together, so a document scores the same whichever segment it is in. */
+struct FMarkdownSearchStats
+{
+	int32 NumDocuments = 0;
+	float AverageTokens = 0.0f;
+
+	/** how many documents each term of the query is in, see FMarkdownSearchSegment::CountDocuments */
+	TMap<FString, int32> DocumentCounts;
+
+	/** the terms the last word of the query matches as a prefix */
+	TArray<FString> PrefixTerms;
+
+	/** Called once every segment has been counted, keeps the first of the prefix terms over all of them. */
+	void Finish();
+
+	float GetWeight( const FStringView Term ) const;
+};
+
+/** A segment as part of an index, with the documents that have been replaced or deleted since it was made. */
+struct FMarkdownSearchSegmentRef
+{
+	TSharedRef<const FMarkdownSearchSegment> Segment;
+	TBitArray<> Removed;
+
+	/** names the segment's file, see FMarkdownSearchIndex::GetSegmentFilename */
+	int32 Id = 0;
+};
+
+/**
+ * Full-text index over a set of markdown documents. Terms are lowercased runs of letters and digits, each one keeps
+ * the documents it is in and where, so queries are ranked (BM25, with matches in the title counting double) and can
+ * ask for phrases.
+ *
+ * A segment never changes once built. Everything but the document list is kept in flat arrays, which are written to
+ * disk as they are and mapped back in when loaded, so a saved segment can be searched without reading it all first.
+ */
+class MARKDOWNASSETEDITOR_API FMarkdownSearchSegment
+{
+public:
+
+	~FMarkdownSearchSegment();
+
+	/** Tokenizes and indexes the sources in parallel. Can be called from any thread. */
+	static TSharedRef<FMarkdownSearchSegment> Build( TArray<FMarkdownSearchSource>&& Sources );
+
+	/** One segment with the documents of all of them, in order, leaving out the removed ones. */
+	static TSharedRef<FMarkdownSearchSegment> Merge( TConstArrayView<FMarkdownSearchSegmentRef> Segments );
+
+	/** Writes the segment out for Load, through a temporary file so a segment on disk is always whole. */
+	bool Save( const FString& Filename ) const;
+
+	/** Maps a file written by Save. Null if it is missing, damaged or from another version. */
+	static TSharedPtr<FMarkdownSearchSegment> Load( const FString& Filename );
+
+	/** Adds how many documents of this segment have each term of the query, skipping the removed ones. */
+	void CountDocuments( const FMarkdownSearchQuery& Query, const TBitArray<>& Removed, FMarkdownSearchStats& InOutStats ) const;
+
+	/** The documents that have every word and phrase of the query, best first, skipping the removed ones. */
+	void Search( const FMarkdownSearchQuery& Query, const FMarkdownSearchStats& Stats, const TBitArray<>& Removed, const int32 MaxResults, TArray<FMarkdownSearchHit>& OutHits ) const;
+
+	/** Calls back with each lowercased token in the text. */
+	static void Tokenize( const FStringView Text, TFunctionRef<void( FStringView )> Callback );
+
+	const FMarkdownSearchDocument& GetDocument( const int32 Index ) const
+	{
+		return Documents[ Index ];
+	}
+
+	int32 NumDocuments() const
+	{
+		return Documents.Num();
+	}
+
+	int32 NumTerms() const
+	{
+		return TermStart.Num() - 1;
+	}
+
+	/** Memory allocated by the segment, mapped files are not counted. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	struct FClause;
+
+	FMarkdownSearchSegment();
+
+	FStringView GetTerm( const int32 Term ) const
+	{
+		return FStringView( TermChars.GetData() + TermOffsets[ Term ], TermOffsets[ Term + 1 ] - TermOffsets[ Term ] );
+	}
+
+	int32 FindTerm( const FStringView Term ) const;
+	int32 LowerBound( const FStringView Term ) const;
+	void ForEachPrefixTerm( const FStringView Prefix, TFunctionRef<void( int32 )> Callback ) const;
+
+	void AddTerm( const FStringView Term );
+	void Finish();
+
+	float Score( const int32 Document, const float Weight, const int32 Frequency, const bool bInTitle, const float AverageTokens ) const;
+	void ScoreWords( const FClause& Clause, const uint8 ClauseIndex, const float AverageTokens, TArray<float>& Scores, TArray<uint8>& Matched ) const;
+	void ScorePhrase( const FClause& Clause, const uint8 ClauseIndex, const float AverageTokens, TArray<float>& Scores, TArray<uint8>& Matched ) const;
+
+	TArray<FMarkdownSearchDocument> Documents;
+
+	// terms are sorted and stored back to back, TermOffsets has one more entry than there are terms
+	TArrayView<const TCHAR> TermChars;
+	TArrayView<const int32> TermOffsets;
+
+	// the postings of term T are TermStart[ T ] to TermStart[ T + 1 ], ordered by document. The positions of posting
+	// P are PositionStart[ P ] to PositionStart[ P + 1 ], which is also how many times the term is in the document
+	TArrayView<const int32> TermStart;
+	TArrayView<const int32> PostingDocuments;
+	TArrayView<const int32> PositionStart;
+	TArrayView<const int32> Positions;
+
+	// what the views above point at, unless the segment was loaded from a file
+	struct FStorage
+	{
+		TArray<TCHAR> TermChars;
+		TArray<int32> TermOffsets;
+		TArray<int32> TermStart;
+		TArray<int32> PostingDocuments;
+		TArray<int32> PositionStart;
+		TArray<int32> Positions;
+	};
+
+	FStorage Owned;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+};
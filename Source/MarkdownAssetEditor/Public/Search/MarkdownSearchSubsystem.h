@@ -0,0 +1,137 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorSubsystem.h"
+#include "Search/MarkdownSearchIndex.h"
+#include "UObject/ObjectSaveContext.h"
+
+#include "MarkdownSearchSubsystem.generated.h"
+
+struct FAssetData;
+struct FFileChangeData;
+struct FMarkdownSearchJob;
+
+UENUM( BlueprintType )
+enum class EMarkdownSearchSource : uint8
+{
+	/** a .md file under the project's Documentation folder */
+	File,
+
+	/** a markdown asset */
+	Asset,
+};
+
+USTRUCT( BlueprintType )
+struct MARKDOWNASSETEDITOR_API FMarkdownSearchResult
+{
+	GENERATED_BODY()
+
+	/** content browser path of the file (/Documentation/...) or the object path of the asset */
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	FString Path;
+
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	FString Title;
+
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	EMarkdownSearchSource Source = EMarkdownSearchSource::File;
+
+	UPROPERTY( BlueprintReadOnly, Category = "Markdown" )
+	float Score = 0.0f;
+};
+
+/** A document to index again, or to drop from the index. */
+struct FMarkdownSearchChange
+{
+	bool bRemoved = false;
+
+	/** the text of an asset, files are read again from disk */
+	FString Text;
+};
+
+/**
+ * Full-text search over the project documentation, both the .md files in the content browser and every markdown
+ * asset. The index is built on workers once the asset registry has finished its first scan, then kept up to date as
+ * files change on disk and assets are saved, renamed or deleted.
+ *
+ * Each update adds a small segment to the index, saved under Intermediate/MarkdownSearch, and segments are merged in
+ * the background once there are enough of them. The saved index is loaded at startup and can be searched right away,
+ * then the documents whose content hash changed while the editor was closed are indexed again.
+ */
+UCLASS()
+class MARKDOWNASSETEDITOR_API UMarkdownSearchSubsystem : public UEditorSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ USubsystem interface
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Deinitialize() override;
+
+	/** See FMarkdownSearchQuery for the query syntax. Finds nothing until the saved index is loaded or the first build has finished. */
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Search" )
+	TArray<FMarkdownSearchResult> Search( const FString& Query, int32 MaxResults = 50 ) const;
+
+	UFUNCTION( BlueprintPure, Category = "Markdown|Search" )
+	bool IsIndexReady() const
+	{
+		return Index.IsValid();
+	}
+
+	/** Drops the index and builds it again from everything in the project. */
+	UFUNCTION( BlueprintCallable, Category = "Markdown|Search" )
+	void RebuildIndex();
+
+	/** The index is replaced rather than changed, so this can be held on to and searched from any thread. */
+	TSharedPtr<const FMarkdownSearchIndex> GetIndex() const
+	{
+		return Index;
+	}
+
+	/** Called on the game thread each time the index is replaced. */
+	FSimpleMulticastDelegate& OnIndexChanged()
+	{
+		return IndexChanged;
+	}
+
+private:
+
+	void RefreshIndex();
+	void MergeIndex();
+	void LoadAssets( const TSharedRef<FMarkdownSearchJob>& InJob );
+	void HandleAssetsLoaded( TSharedRef<FMarkdownSearchJob> InJob );
+	void BuildIndex( const TSharedRef<FMarkdownSearchJob>& InJob );
+	void UpdateIndex();
+	void SetIndex( const TSharedRef<FMarkdownSearchJob>& InJob, const TSharedPtr<const FMarkdownSearchIndex>& InIndex );
+	void CancelJob();
+
+	void QueueChange( const FString& Path, FMarkdownSearchChange&& Change );
+
+	void HandleFilesLoaded();
+	void HandleAssetRemoved( const FAssetData& AssetData );
+	void HandleAssetRenamed( const FAssetData& AssetData, const FString& OldObjectPath );
+	void HandlePackageSaved( const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext );
+	void HandleDirectoryChanged( const TArray<FFileChangeData>& FileChanges );
+
+	TSharedPtr<const FMarkdownSearchIndex> Index;
+
+	/** set once the index has been built, or loaded and checked for changes made while the editor was closed */
+	bool bIndexChecked = false;
+
+	FString IndexDirectory;
+	int32 NextSegmentId = 0;
+
+	/** the build, update or merge running on the workers, there is only ever one */
+	TSharedPtr<FMarkdownSearchJob> Job;
+
+	/** changes that came in while a job was running, they go into the next update */
+	TMap<FString, FMarkdownSearchChange> PendingChanges;
+
+	FSimpleMulticastDelegate IndexChanged;
+
+	FString WatchedDirectory;
+	FDelegateHandle DirectoryChangedHandle;
+};
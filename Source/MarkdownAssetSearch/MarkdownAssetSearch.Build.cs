@@ -0,0 +1,21 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+using UnrealBuildTool;
+
+// the Asset Search indexer, in a module of its own so the (beta) Asset Search plugin is optional, the plugin does not
+// enable it, projects turn it on themselves and MarkdownAssetEditor only loads this when they have
+public class MarkdownAssetSearch : ModuleRules
+{
+    public MarkdownAssetSearch( ReadOnlyTargetRules Target ) : base( Target )
+    {
+        PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        PrivateDependencyModuleNames.AddRange( new string[] {
+            "AssetSearch",
+            "Core",
+            "CoreUObject",
+            "Engine",
+            "MarkdownAsset",
+        });
+    }
+}
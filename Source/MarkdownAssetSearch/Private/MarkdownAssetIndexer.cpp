@@ -0,0 +1,106 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownAssetIndexer.h"
+
+#include "MarkdownAsset.h"
+#include "Parser/MarkdownFrontMatter.h"
+#include "SearchSerializer.h"
+
+namespace MarkdownAssetIndexer
+{
+	// 2 - front matter tags
+	static constexpr int32 Version = 2;
+
+	// every record is kept in the search database, so very long sections only have their start in it
+	static constexpr int32 MaxSectionLength = 4096;
+
+	// text before the first heading
+	static const TCHAR* IntroductionName = TEXT( "Text" );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+int32 FMarkdownAssetIndexer::GetVersion() const
+{
+	return MarkdownAssetIndexer::Version;
+}
+
+void FMarkdownAssetIndexer::IndexAsset( const UObject* InAssetObject, FSearchSerializer& Serializer ) const
+{
+	using namespace MarkdownAssetIndexer;
+
+	const UMarkdownAsset* Asset = CastChecked<UMarkdownAsset>( InAssetObject );
+	const TSharedRef<const FMarkdownDocument> Document = Asset->GetDocument();
+
+	Serializer.BeginIndexingObject( Asset, TEXT( "$self" ) );
+
+	TArray<FString> Tags;
+	FMarkdownFrontMatter::GetTags( Asset->Text.ToString(), Tags );
+
+	for( const FString& Tag : Tags )
+	{
+		Serializer.IndexProperty( TEXT( "Tag" ), Tag );
+	}
+
+	// each section's text is a record named after its heading, so a match shows where in the document it is
+	FString Section = IntroductionName;
+	FString Text;
+
+	auto IndexSection = [ & ]()
+	{
+		Text.TrimStartAndEndInline();
+
+		if( !Text.IsEmpty() )
+		{
+			Serializer.IndexProperty( Section, Text.Left( MaxSectionLength ) );
+		}
+
+		Text.Reset();
+	};
+
+	Document->ForEachChild( FMarkdownDocument::Root, [ & ]( const int32 Block )
+	{
+		switch( ( *Document )[ Block ].Type )
+		{
+			case EMarkdownNodeType::Heading:
+				IndexSection();
+				Section = Document->GetPlainText( Block ).TrimStartAndEnd();
+				Serializer.IndexProperty( TEXT( "Heading" ), Section );
+				break;
+
+			case EMarkdownNodeType::HtmlBlock:
+			case EMarkdownNodeType::ThematicBreak:
+				break;
+
+			default:
+				Document->AppendPlainText( Block, Text );
+				break;
+		}
+	});
+
+	IndexSection();
+
+	// links from anywhere in the document, headings and tables included, each once
+	TSet<FString> Links;
+
+	Document->ForEachDescendant( FMarkdownDocument::Root, [ & ]( const int32 Index )
+	{
+		const FMarkdownNode& Node = ( *Document )[ Index ];
+
+		if( ( Node.Type != EMarkdownNodeType::Link && Node.Type != EMarkdownNodeType::Image ) || Node.Extra.Length == 0 )
+		{
+			return;
+		}
+
+		bool bAlreadyIndexed = false;
+		const FString Destination( Document->GetExtra( Index ) );
+		Links.Add( Destination, &bAlreadyIndexed );
+
+		if( !bAlreadyIndexed )
+		{
+			Serializer.IndexProperty( Node.Type == EMarkdownNodeType::Link ? TEXT( "Link" ) : TEXT( "Image" ), Destination );
+		}
+	});
+
+	Serializer.EndIndexingObject();
+}
@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IAssetIndexer.h"
+
+/**
+ * Makes markdown assets searchable in the Asset Search plugin. Each heading, the plain text of the section under it,
+ * the front matter tags and every link become records of the asset, so the global search finds documentation text
+ * without loading anything when it runs.
+ *
+ * The search plugin only indexes an asset again when its package changes or the indexer's version does, so the
+ * version goes up whenever what is written here changes.
+ */
+class FMarkdownAssetIndexer : public IAssetIndexer
+{
+public:
+
+	virtual FString GetName() const override
+	{
+		return TEXT( "MarkdownAsset" );
+	}
+
+	virtual int32 GetVersion() const override;
+	virtual void IndexAsset( const UObject* InAssetObject, FSearchSerializer& Serializer ) const override;
+};
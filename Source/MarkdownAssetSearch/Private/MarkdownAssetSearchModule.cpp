@@ -0,0 +1,20 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "IAssetSearchModule.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetIndexer.h"
+#include "Modules/ModuleInterface.h"
+#include "Modules/ModuleManager.h"
+
+class FMarkdownAssetSearchModule : public IModuleInterface
+{
+	public:
+
+		virtual void StartupModule() override
+		{
+			IAssetSearchModule& AssetSearchModule = FModuleManager::LoadModuleChecked<IAssetSearchModule>( "AssetSearch" );
+			AssetSearchModule.RegisterAssetIndexer( UMarkdownAsset::StaticClass(), MakeUnique<FMarkdownAssetIndexer>() );
+		}
+};
+
+IMPLEMENT_MODULE( FMarkdownAssetSearchModule, MarkdownAssetSearch );
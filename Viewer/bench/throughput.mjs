@@ -0,0 +1,42 @@
+// markdown-it throughput, to compare against the native parser
+//
+//   yarn bench <file.md> [iterations]
+//
+// run Markdown.Parser.Benchmark <file.md> [iterations] in the editor console on the same file for the native numbers,
+// both report MB/s in characters
+
+import { readFileSync } from 'fs'
+import markdownit from 'markdown-it'
+import md_tasklists from 'markdown-it-task-lists'
+
+const [ file, count ] = process.argv.slice( 2 )
+
+if( !file ) {
+  console.error( 'usage: yarn bench <file.md> [iterations]' )
+  process.exit( 1 )
+}
+
+const text       = readFileSync( file, 'utf8' )
+const iterations = Math.max( 1, parseInt( count ) || 20 )
+
+// the same core setup as the viewer, without the plugins that only change the output
+const md = markdownit({ html: false, linkify: true, typography: false })
+  .use( md_tasklists, { enabled: true } )
+
+const measure = (name, fn) => {
+
+  fn() // warm up
+
+  const start = performance.now()
+  for( let i = 0; i < iterations; i++ ) {
+    fn()
+  }
+  const ms = ( performance.now() - start ) / iterations
+
+  const mb = text.length / ( 1024 * 1024 )
+  console.log( `${name.padEnd( 7 )} ${ms.toFixed( 2 )} ms, ${( mb / ( ms / 1000 ) ).toFixed( 1 )} MB/s` )
+}
+
+console.log( `${file}, ${text.length} characters` )
+measure( 'parse', () => md.parse( text, {} ) )
+measure( 'render', () => md.render( text ) )
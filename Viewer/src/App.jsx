@@ -1,10 +1,7 @@
-import { useState, useEffect } from 'react'
+import { useState, useEffect, useRef, lazy, Suspense } from 'react'
 import { useTheme } from '@mui/material/styles'
 import Box from '@mui/material/Box'
-import Grid from '@mui/material/Grid'
 import Fab from '@mui/material/Fab'
-import Editor from 'react-simple-code-editor'
-import throttle from 'lodash/throttle'
 
 import {
   IconEdit,
@@ -12,156 +9,161 @@ import {
   IconBoxAlignLeft
 } from '@tabler/icons-react'
 
+import { prepare, fetchCached, flushCache, render } from './renderer'
+
+const EditChunk = lazy( () => import('./Edit.jsx') )
+
+const Edit = (props) => (
+  <Suspense>
+    <EditChunk {...props}/>
+  </Suspense>
+)
+
+
 //-----------------------------------------------------------------------------
 // style
 
 import 'Highlight.css' // resolved in vite.config.js
 import 'App.css'       // resolved in vite.config.js
-const math_style = import.meta.env.VITE_THEME == 'light' ? '' : 'color=white&';
 
 
 //-----------------------------------------------------------------------------
-// highlight.js
 
-import hljs from 'highlight.js'
-import javascript from 'highlight.js/lib/languages/javascript'
-import markdown from 'highlight.js/lib/languages/markdown'
+const View = (props) => {
 
-hljs.registerLanguage( 'markdown', markdown )
-hljs.registerLanguage( 'javascript', javascript )
-hljs.registerLanguage( 'js', javascript )
+  const theme = useTheme()
+  const {code} = props
+  const [, setRevision] = useState( 0 )
 
+  // pull in any plugins or languages the document needs, then render again once they have arrived
+  useEffect(() => {
+    let active = true
+    prepare( code ).then( (changed) => changed && active && setRevision( (revision) => revision + 1 ) )
+    return () => { active = false }
+  },[code])
 
-//-----------------------------------------------------------------------------
-// setup markdown-it and plugins
-
-// import mermaid from 'mermaid'
-// mermaid.initialize({
-//   startOnLoad: true,
-//   theme      : 'forest'
-// })
-
-import markdownit from 'markdown-it'
-import md_tasklists from 'markdown-it-task-lists'
-import md_video from '@vrcd-community/markdown-it-video'
-import md_diagrams from 'markdown-it-textual-uml'
-import md_highlight from 'markdown-it-highlightjs'
-import md_anchors  from 'markdown-it-anchor'
-import md_toc  from 'markdown-it-table-of-contents'
-import md_replace_link from './markdown-it-replace-link'
-import md_math from 'markdown-it-math'
-
-const opts_math = {
-  inlineOpen    : '$',
-  inlineClose   : '$',
-  blockOpen     : '$$',
-  blockClose    : '$$',
-  inlineRenderer: (str) => `<img src="https://math.vercel.app?${math_style}inline=${encodeURIComponent(str)}" alt="${str}" />`,
-  blockRenderer : (str) => `<img src="https://math.vercel.app?${math_style}from=${encodeURIComponent(str)}" alt="${str}" />`,
+  return (
+    <Box
+      style={{
+        // width     : '100%',
+        minHeight : '100vh',
+        padding   : theme.spacing(3),
+        overflowY : 'auto',
+      }}
+      dangerouslySetInnerHTML={{__html: render( code )}}
+    />
+  )
 }
 
-const opts_video = {
-  youtube: { width: 640, height: 390 },
-  vimeo  : { width: 500, height: 281 },
-  vine   : { width: 600, height: 600, embed: 'simple' },
-  prezi  : { width: 550, height: 400 }
+
+//-----------------------------------------------------------------------------
+// batching the update makes the UI more responsive
+//
+// only the part of the document that changed is sent, as (offset, delete length, insert), with a version and a
+// checksum of the result so the editor can tell when we have drifted apart and ask for the whole text again
+
+let synced  = null  // the text the editor has, null if it needs the full text
+let version = 0     // edits sent since the last full text
+
+// 32 bit FNV-1a over the UTF-16 code units, matches FMarkdownTextBuffer::GetChecksum()
+const checksum = (text) => {
+  let hash = 0x811c9dc5
+  for( let i = 0; i < text.length; i++ ) {
+    hash = Math.imul( hash ^ text.charCodeAt( i ), 16777619 )
+  }
+  return hash | 0
 }
 
-const opts_highlight = {
-  auto          : true,
-  hljs          : hljs,
-  code          : true,
-  inline        : true,
-  ignoreIllegals: true,
+// typing changes one run of text, so trimming the common prefix and suffix gives the edit
+const diff = (from, to) => {
+  const max = Math.min( from.length, to.length )
+  let start = 0
+  while( start < max && from.charCodeAt( start ) == to.charCodeAt( start ) ) start++
+  let end = 0
+  while( end < max - start && from.charCodeAt( from.length - 1 - end ) == to.charCodeAt( to.length - 1 - end ) ) end++
+  return { offset: start, remove: from.length - start - end, insert: to.substring( start, to.length - end ) }
 }
 
-const opts_replace_link = {
-  processHTML: true,
-  replaceLink: (link, env) => {
-    if( link.startsWith('/Script') )
-      return `javascript:window.ue.markdownbinding.openasset('${link.substring(link.indexOf("'")+1,link.lastIndexOf("'"))}')`;
-    if( /^[a-z]+:\/\//i.test(link) && !env.image )
-      return `javascript:window.ue.markdownbinding.openurl('${link}')`;
-    return link;
-  }
+// keeps a moving average of how long the editor takes to answer, which is what a push really costs
+let bridge_cost = 0
+
+const measure = (promise) => {
+  const start = performance.now()
+  return promise.then( (result) => {
+    bridge_cost = bridge_cost * 0.8 + ( performance.now() - start ) * 0.2
+    return result
+  })
 }
 
-const md_opts = {
-  html      : false,
-  linkify   : true,
-  typography: false
+const sendText = (text) => {
+  synced  = text
+  version = 0
+  measure( window.ue.markdownbinding.settext( text ) )
 }
 
-const md = markdownit(md_opts)
-  .use( md_highlight, opts_highlight )
-  .use( md_tasklists, { enabled: true } )
-  .use( md_video, opts_video )
-  .use( md_math, opts_math )
-  .use( md_diagrams )
-  .use( md_anchors.default )
-  .use( md_toc )
-  .use( md_replace_link, opts_replace_link )
-;
+const updateUnreal = (text) => {
 
+  if( !window.ue || !window.ue.markdownbinding ) {
+    return
+  }
 
-//-----------------------------------------------------------------------------
+  if( synced === null ) {
+    sendText( text )
+    return
+  }
 
-const Edit = (props) => {
+  // an empty edit still tells the editor nothing is pending any more
+  const edit = diff( synced, text )
 
-  const {code, setCode} = props
-  const theme = useTheme()
+  measure( window.ue.markdownbinding.applyedit( version++, edit.offset, edit.remove, edit.insert, checksum( text ) ) )
+    .then( (applied) => applied || synced === null || sendText( synced ) )
 
-  return (
-    <Editor
-      value         = {code}
-      onValueChange = {setCode}
-      highlight     = {code => hljs.highlight(code, {language: 'markdown', ignoreIllegals: true }).value}
-      padding       = {theme.spacing(3)}
-      autoFocus     = {true}
-      style         = {{
-        fontFamily: '"Fira code", "Fira Mono", monospace',
-        fontSize  : 12,
-        // width     : '100%',
-        minHeight : '100vh',
-        overflowY : 'auto',
-      }}
-    />
-  )
+  synced = text
 }
 
+const resetSync = (text) => {
+  synced  = text
+  version = 0
+}
 
-//-----------------------------------------------------------------------------
+// small documents are pushed almost straight away, the bigger the document and the slower the editor is to answer
+// the longer edits are held back, so the bridge stays a small fraction of the time spent typing
+// the editor is told as soon as something is held back, and asks for it with flush() before saving
 
-const View = (props) => {
+const min_interval = 100
+const max_interval = 5000
 
-  const theme = useTheme()
-  const {code} = props
+const updateScheduler = {
+  pending: null,
+  timer  : null,
 
-  return (
-    <Box
-      style={{
-        // width     : '100%',
-        minHeight : '100vh',
-        padding   : theme.spacing(3),
-        overflowY : 'auto',
-      }}
-      dangerouslySetInnerHTML={{__html: md.render( code )}}
-    />
-  )
-}
+  interval: (text) => Math.min( max_interval, Math.max( min_interval, bridge_cost * 20 + text.length / 1000 ) ),
 
+  schedule: (text) => {
+    if( updateScheduler.pending === null && window.ue && window.ue.markdownbinding ) {
+      window.ue.markdownbinding.setpending()
+    }
+    updateScheduler.pending = text
+    if( updateScheduler.timer === null ) {
+      updateScheduler.timer = setTimeout( updateScheduler.flush, updateScheduler.interval( text ) )
+    }
+  },
 
-//-----------------------------------------------------------------------------
-// throttling the update makes the UI more responsive
+  flush: () => {
+    const text = updateScheduler.pending
+    updateScheduler.cancel()
+    if( text !== null ) {
+      updateUnreal( text )
+    }
+  },
 
-const updateUnreal = (text) => {
-  if( window.ue && window.ue.markdownbinding ) {
-    window.ue.markdownbinding.settext( text )
-  }
+  cancel: () => {
+    clearTimeout( updateScheduler.timer )
+    updateScheduler.timer   = null
+    updateScheduler.pending = null
+  },
 }
 
-const updateUnrealThrottled = throttle( updateUnreal, 1000, { leading: true, trailing: true } );
-
 const Mode = {
   View: 'view',
   Edit: 'edit',
@@ -176,14 +178,73 @@ export default function App() {
   const [mode, setMode] = useState( Mode.View )
   const [text, setText] = useState( '' )
 
+  // the hooks below are installed once, so they read the mode through a ref
+  const modeRef = useRef( mode )
+  modeRef.current = mode
+
   useEffect(() => {
-    if( window.ue && window.ue.markdownbinding ) {
-      window.ue.markdownbinding.gettext().then( (text) => setText(text) )
+
+    const load = () => {
+      if( window.ue && window.ue.markdownbinding ) {
+        // the first render of the document can use whatever the editor has kept from last time
+        window.ue.markdownbinding.gettext()
+          .then( (text) => {
+            resetSync( text )
+            return prepare( text ).then( () => fetchCached( text ) ).finally( () => setText(text) )
+          })
+      }
     }
+
+    // a hidden tab gives its browser back after a while, the editor keeps this and hands it to the next one
+    const restore = () => {
+      if( window.ue && window.ue.markdownbinding ) {
+        window.ue.markdownbinding.getstate().then( (json) => {
+          const state = json ? JSON.parse( json ) : null
+          if( state ) {
+            setMode( state.mode || Mode.View )
+            requestAnimationFrame( () => requestAnimationFrame( () => window.scrollTo( 0, state.scroll || 0 ) ) )
+          }
+        })
+      }
+    }
+
+    // the editor keeps browsers around between documents and calls these when one is reused
+    window.markdownviewer = {
+      reload: () => {
+        updateScheduler.cancel()
+        resetSync( null )
+        setMode( Mode.View )
+        load()
+        restore()
+      },
+      reset: () => {
+        updateScheduler.cancel()
+        resetSync( null )
+        setMode( Mode.View )
+        setText( '' )
+      },
+      snapshot: () => {
+        // push any pending edit before the browser goes away
+        updateScheduler.flush()
+        flushCache()
+        if( window.ue && window.ue.markdownbinding ) {
+          window.ue.markdownbinding.savestate( JSON.stringify({ mode: modeRef.current, scroll: window.scrollY }) )
+        }
+      },
+      flush: () => {
+        updateScheduler.flush()
+      },
+    }
+
+    // leaving the editor is a good moment to push, nothing is being typed
+    window.addEventListener( 'blur', updateScheduler.flush )
+    document.addEventListener( 'visibilitychange', () => document.hidden && updateScheduler.flush() )
+
+    load()
   },[])
 
   const onUpdate = (text) => {
-    updateUnrealThrottled( text );
+    updateScheduler.schedule( text )
     setText( text )
   }
 
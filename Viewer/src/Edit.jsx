@@ -0,0 +1,28 @@
+import { useTheme } from '@mui/material/styles'
+import Editor from 'react-simple-code-editor'
+import { highlightMarkdown } from './renderer'
+
+// the editor is split into its own chunk, documents opened only to be read never load it
+
+export default function Edit(props) {
+
+  const {code, setCode} = props
+  const theme = useTheme()
+
+  return (
+    <Editor
+      value         = {code}
+      onValueChange = {setCode}
+      highlight     = {highlightMarkdown}
+      padding       = {theme.spacing(3)}
+      autoFocus     = {true}
+      style         = {{
+        fontFamily: '"Fira code", "Fira Mono", monospace',
+        fontSize  : 12,
+        // width     : '100%',
+        minHeight : '100vh',
+        overflowY : 'auto',
+      }}
+    />
+  )
+}
@@ -0,0 +1,358 @@
+// markdown-it pipeline
+//
+// only the core parser and the cheap plugins are bundled into the entry chunk, everything heavy (highlight
+// languages, diagrams, math, video) is split into separate chunks and pulled in the first time a document
+// actually uses that syntax
+
+import markdownit from 'markdown-it'
+import throttle from 'lodash/throttle'
+import hljs from 'highlight.js/lib/core'
+import hljs_markdown from 'highlight.js/lib/languages/markdown'
+import md_highlight from 'markdown-it-highlightjs/core'
+import md_tasklists from 'markdown-it-task-lists'
+import md_anchors  from 'markdown-it-anchor'
+import md_toc  from 'markdown-it-table-of-contents'
+import md_replace_link from './markdown-it-replace-link'
+
+// the editor always needs markdown highlighting, so that one is loaded up front
+hljs.registerLanguage( 'markdown', hljs_markdown )
+
+const theme = import.meta.env.VITE_THEME == 'light' ? 'light' : 'dark'
+const math_style = theme == 'light' ? '' : 'color=white&';
+
+
+//-----------------------------------------------------------------------------
+// highlight.js languages (loaded on demand)
+
+const languages = {
+  bash      : () => import('highlight.js/lib/languages/bash'),
+  c         : () => import('highlight.js/lib/languages/c'),
+  cmake     : () => import('highlight.js/lib/languages/cmake'),
+  cpp       : () => import('highlight.js/lib/languages/cpp'),
+  csharp    : () => import('highlight.js/lib/languages/csharp'),
+  css       : () => import('highlight.js/lib/languages/css'),
+  diff      : () => import('highlight.js/lib/languages/diff'),
+  dos       : () => import('highlight.js/lib/languages/dos'),
+  glsl      : () => import('highlight.js/lib/languages/glsl'),
+  ini       : () => import('highlight.js/lib/languages/ini'),
+  java      : () => import('highlight.js/lib/languages/java'),
+  javascript: () => import('highlight.js/lib/languages/javascript'),
+  json      : () => import('highlight.js/lib/languages/json'),
+  lua       : () => import('highlight.js/lib/languages/lua'),
+  plaintext : () => import('highlight.js/lib/languages/plaintext'),
+  powershell: () => import('highlight.js/lib/languages/powershell'),
+  python    : () => import('highlight.js/lib/languages/python'),
+  shell     : () => import('highlight.js/lib/languages/shell'),
+  sql       : () => import('highlight.js/lib/languages/sql'),
+  typescript: () => import('highlight.js/lib/languages/typescript'),
+  xml       : () => import('highlight.js/lib/languages/xml'),
+  yaml      : () => import('highlight.js/lib/languages/yaml'),
+}
+
+const language_aliases = {
+  'c++': 'cpp', 'cc': 'cpp', 'h': 'cpp', 'hpp': 'cpp',
+  'c#' : 'csharp', 'cs': 'csharp',
+  'js' : 'javascript', 'jsx': 'javascript',
+  'ts' : 'typescript', 'tsx': 'typescript',
+  'sh' : 'bash', 'zsh': 'bash',
+  'bat': 'dos', 'cmd': 'dos',
+  'ps1': 'powershell',
+  'py' : 'python',
+  'html': 'xml', 'svg': 'xml',
+  'yml': 'yaml',
+  'text': 'plaintext', 'txt': 'plaintext',
+  'hlsl': 'glsl', 'usf': 'glsl', 'ush': 'glsl',
+}
+
+// fences without a language are auto detected, which only works against registered languages
+const auto_languages = [ 'cpp', 'csharp', 'javascript', 'json', 'ini', 'python' ]
+
+const fence_pattern = /^[ \t]*(?:```|~~~)[ \t]*([^\s`{]*)/gm
+
+
+//-----------------------------------------------------------------------------
+// optional plugins (loaded on demand)
+
+const opts_math = {
+  inlineOpen    : '$',
+  inlineClose   : '$',
+  blockOpen     : '$$',
+  blockClose    : '$$',
+  inlineRenderer: (str) => `<img src="https://math.vercel.app?${math_style}inline=${encodeURIComponent(str)}" alt="${str}" />`,
+  blockRenderer : (str) => `<img src="https://math.vercel.app?${math_style}from=${encodeURIComponent(str)}" alt="${str}" />`,
+}
+
+const opts_video = {
+  youtube: { width: 640, height: 390 },
+  vimeo  : { width: 500, height: 281 },
+  vine   : { width: 600, height: 600, embed: 'simple' },
+  prezi  : { width: 550, height: 400 }
+}
+
+// order matters, this is the order the plugins are applied to markdown-it
+const features = [
+  {
+    name   : 'video',
+    test   : (text) => /@\[(youtube|vimeo|vine|prezi|osf)\]/i.test( text ),
+    load   : () => import('@vrcd-community/markdown-it-video'),
+    options: opts_video,
+  },
+  {
+    name   : 'math',
+    test   : (text) => text.includes( '$' ),
+    load   : () => import('markdown-it-math'),
+    options: opts_math,
+  },
+  {
+    name   : 'diagrams',
+    test   : (text) => /^[ \t]*(```|~~~)[ \t]*(plantuml|dot|ditaa|mermaid)\b/im.test( text ),
+    load   : () => import('markdown-it-textual-uml'),
+  },
+]
+
+
+//-----------------------------------------------------------------------------
+// setup markdown-it and plugins
+
+const opts_highlight = {
+  auto          : true,
+  hljs          : hljs,
+  code          : true,
+  inline        : true,
+  ignoreIllegals: true,
+}
+
+const opts_replace_link = {
+  processHTML: true,
+  replaceLink: (link, env) => {
+    if( link.startsWith('/Script') )
+      return `javascript:window.ue.markdownbinding.openasset('${link.substring(link.indexOf("'")+1,link.lastIndexOf("'"))}')`;
+    if( /^[a-z]+:\/\//i.test(link) && !env.image )
+      return `javascript:window.ue.markdownbinding.openurl('${link}')`;
+    return link;
+  }
+}
+
+// these are markdown-it-anchor's defaults, spelled out since FMarkdownHeadingIndex::MakeSlug makes the same slugs
+// in the editor for outlines and link checks, so changing them means changing that too
+const opts_anchors = {
+  slugify              : (s) => encodeURIComponent( String(s).trim().toLowerCase().replace( /\s+/g, '-' ) ),
+  uniqueSlugStartIndex : 1,
+}
+
+const md_opts = {
+  html      : false,
+  linkify   : true,
+  typography: false
+}
+
+const loaded  = {}  // feature name -> markdown-it plugin
+const pending = {}  // feature name or language -> promise
+
+
+//-----------------------------------------------------------------------------
+// render cache
+//
+// diagrams and highlighted code are rendered once per source and reused while the rest of the document is being
+// edited. entries are keyed by plugin|theme|hash of the fence, new ones are handed to the editor which keeps them
+// for the session so documents that are opened again skip the work as well
+
+const cache_limit = 1000
+const cache       = new Map()  // key -> html, in least recently used order
+let   unsaved     = {}         // key -> html, not yet sent to the editor
+
+const uml_languages = /^(plantuml|dot|ditaa|mermaid)$/i
+
+// cyrb53, good enough to tell sources apart without keeping them around
+const hash = (str) => {
+  let h1 = 0xdeadbeef, h2 = 0x41c6ce57
+  for( let i = 0; i < str.length; i++ ) {
+    const ch = str.charCodeAt( i )
+    h1 = Math.imul( h1 ^ ch, 2654435761 )
+    h2 = Math.imul( h2 ^ ch, 1597334677 )
+  }
+  h1  = Math.imul( h1 ^ (h1 >>> 16), 2246822507 )
+  h1 ^= Math.imul( h2 ^ (h2 >>> 13), 3266489909 )
+  h2  = Math.imul( h2 ^ (h2 >>> 16), 2246822507 )
+  h2 ^= Math.imul( h1 ^ (h1 >>> 13), 3266489909 )
+  return (4294967296 * (2097151 & h2) + (h1 >>> 0)).toString( 36 )
+}
+
+// null if the fence would render differently once something is loaded, so must not be cached yet
+const cacheKey = (token) => {
+
+  const lang = token.info.trim().split( /\s+/ )[0]
+
+  if( lang && uml_languages.test( lang ) && loaded.diagrams ) {
+    return `uml|${theme}|${hash( token.info + '\n' + token.content )}`
+  }
+
+  const ready = lang && hljs.getLanguage( lang )
+    ? true
+    : !( lang && resolveLanguage( lang ) ) && auto_languages.every( (name) => hljs.getLanguage( name ) )
+
+  return ready ? `hljs|${theme}|${hash( token.info + '\n' + token.content )}` : null
+}
+
+const remember = (key, html) => {
+  cache.delete( key )
+  cache.set( key, html )
+  if( cache.size > cache_limit ) {
+    cache.delete( cache.keys().next().value )
+  }
+}
+
+const storeCache = () => {
+  const entries = unsaved
+  unsaved = {}
+  if( Object.keys( entries ).length && window.ue && window.ue.markdownbinding ) {
+    window.ue.markdownbinding.storerendercache( JSON.stringify( entries ) )
+  }
+}
+
+const storeCacheThrottled = throttle( storeCache, 2000, { leading: false, trailing: true } )
+
+const useCache = (md) => {
+
+  const fence = md.renderer.rules.fence
+
+  md.renderer.rules.fence = (tokens, idx, options, env, self) => {
+
+    const key = cacheKey( tokens[idx] )
+
+    if( !key ) {
+      return fence( tokens, idx, options, env, self )
+    }
+
+    let html = cache.get( key )
+
+    if( html === undefined ) {
+      html = fence( tokens, idx, options, env, self )
+      unsaved[ key ] = html
+      storeCacheThrottled()
+    }
+
+    remember( key, html )
+    return html
+  }
+
+  return md
+}
+
+
+//-----------------------------------------------------------------------------
+
+const build = () => {
+
+  let md = markdownit(md_opts)
+    .use( md_highlight, opts_highlight )
+    .use( md_tasklists, { enabled: true } )
+
+  for( const feature of features ) {
+    if( loaded[ feature.name ] ) {
+      md = md.use( loaded[ feature.name ], feature.options )
+    }
+  }
+
+  return md
+    .use( md_anchors.default, opts_anchors )
+    .use( md_toc )
+    .use( md_replace_link, opts_replace_link )
+    .use( useCache )
+}
+
+let md = build()
+
+
+//-----------------------------------------------------------------------------
+
+const resolveLanguage = (name) => {
+  const lang = name.toLowerCase()
+  return languages[ lang ] ? lang : language_aliases[ lang ]
+}
+
+const loadLanguage = (lang) => {
+  if( !pending[ lang ] ) {
+    pending[ lang ] = languages[ lang ]().then( (module) => {
+      hljs.registerLanguage( lang, module.default )
+      return true
+    })
+  }
+  return pending[ lang ]
+}
+
+const loadFeature = (feature) => {
+  if( !pending[ feature.name ] ) {
+    pending[ feature.name ] = feature.load().then( (module) => {
+      loaded[ feature.name ] = module.default
+      md = build()
+      return true
+    })
+  }
+  return pending[ feature.name ]
+}
+
+// loads everything the text needs that is not loaded yet
+// resolves to true if anything new was loaded (ie. the text should be rendered again)
+export const prepare = (text) => {
+
+  const requests = []
+
+  for( const feature of features ) {
+    if( !loaded[ feature.name ] && feature.test( text ) ) {
+      requests.push( loadFeature( feature ) )
+    }
+  }
+
+  for( const match of text.matchAll( fence_pattern ) ) {
+    const wanted = match[1] ? [ resolveLanguage( match[1] ) ] : auto_languages
+    for( const lang of wanted ) {
+      if( lang && !hljs.getLanguage( lang ) ) {
+        requests.push( loadLanguage( lang ) )
+      }
+    }
+  }
+
+  if( requests.length == 0 ) {
+    return Promise.resolve( false )
+  }
+
+  return Promise.allSettled( requests ).then( () => true )
+}
+
+// asks the editor for anything it has already rendered for the text, call after prepare() so the keys are final
+export const fetchCached = (text) => {
+
+  if( !window.ue || !window.ue.markdownbinding ) {
+    return Promise.resolve( false )
+  }
+
+  const keys = md.parse( text, {} )
+    .filter( (token) => token.type == 'fence' )
+    .map( cacheKey )
+    .filter( (key) => key && !cache.has( key ) )
+
+  if( keys.length == 0 ) {
+    return Promise.resolve( false )
+  }
+
+  return window.ue.markdownbinding.getrendercache( JSON.stringify( keys ) )
+    .then( (json) => {
+      const entries = JSON.parse( json || '{}' )
+      for( const key in entries ) {
+        remember( key, entries[ key ] )
+      }
+      return Object.keys( entries ).length > 0
+    })
+    .catch( () => false )
+}
+
+// sends any new entries to the editor now rather than waiting
+export const flushCache = () => {
+  storeCacheThrottled.cancel()
+  storeCache()
+}
+
+export const render = (text) => md.render( text )
+
+export const highlightMarkdown = (text) => hljs.highlight( text, { language: 'markdown', ignoreIllegals: true } ).value
@@ -1,24 +1,41 @@
-import { defineConfig } from 'vite'
+import { defineConfig, loadEnv } from 'vite'
 import path from 'path'
 import react from '@vitejs/plugin-react'
-import { viteSingleFile } from "vite-plugin-singlefile"
-import dotenv from 'dotenv';
 
-// load environment variables for the theme that was passed in (light or dark)
-dotenv.config({ path: `.env.${(process.env.THEME || 'dark').trim()}` });
+// the theme is the build mode (vite build --mode light), which also picks up .env.light or .env.dark
+export default defineConfig(({ mode }) => {
+  const theme = mode === 'light' ? 'light' : 'dark';
+  const env   = loadEnv(theme, __dirname);
 
-export default defineConfig({
-  plugins: [
-    react(),
-    viteSingleFile()
-  ],
-  optimizeDeps: {
-  },
-  resolve: {
-    alias: [
-      // make sure css files resolve to the correct version based on the theme
-      { find: 'App.css',        replacement: path.resolve( __dirname, `./src/${process.env.VITE_CSS_PATH}` )  },
-      { find: 'Highlight.css',  replacement: `highlight.js/styles/${process.env.VITE_HIGHLIGHT_THEME}.css`    },
-    ]
-  }
+  return {
+    plugins: [
+      react(),
+    ],
+    // assets are loaded relative to index.html, the editor opens it straight from the plugin content folder
+    base: './',
+    optimizeDeps: {
+    },
+    build: {
+      outDir       : path.resolve( __dirname, `../Content/${theme}` ),
+      emptyOutDir  : true,
+      // the viewer only ever runs in the engine's embedded browser, there is nothing to preload for
+      modulePreload: false,
+      rollupOptions: {
+        output: {
+          // keep the core markdown pipeline out of the react chunk so the entry stays small and cacheable
+          manualChunks: {
+            react   : [ 'react', 'react-dom' ],
+            markdown: [ 'markdown-it', 'markdown-it-anchor', 'markdown-it-table-of-contents', 'markdown-it-task-lists' ],
+          }
+        }
+      }
+    },
+    resolve: {
+      alias: [
+        // make sure css files resolve to the correct version based on the theme
+        { find: 'App.css',        replacement: path.resolve( __dirname, `./src/${env.VITE_CSS_PATH}` )  },
+        { find: 'Highlight.css',  replacement: `highlight.js/styles/${env.VITE_HIGHLIGHT_THEME}.css`    },
+      ]
+    }
+  };
 })